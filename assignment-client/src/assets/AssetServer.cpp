@@ -355,6 +355,11 @@ void AssetServer::aboutToFinish() {
         QCoreApplication::processEvents();
     }
 
+    // let a running compaction finish writing the map file
+    if (_mappingJournal) {
+        _mappingJournal->waitForCompaction();
+    }
+
     // re-set defaults in image library
     image::setColorTexturesCompressionEnabled(_wasCubeTextureCompressionEnabled);
     image::setGrayscaleTexturesCompressionEnabled(_wasGrayscaleTextureCompressionEnabled);
@@ -889,7 +894,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _filesDirectory, _hotAssetCache);
     _transferTaskPool.start(task);
 }
 
@@ -994,6 +999,26 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     }
 
+    static const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+    auto cacheStats = _hotAssetCache->getStats();
+    auto numRequests = cacheStats.hits + cacheStats.misses;
+    QJsonObject cacheStatsObject;
+    cacheStatsObject["1. Hits"] = (double)cacheStats.hits;
+    cacheStatsObject["2. Misses"] = (double)cacheStats.misses;
+    cacheStatsObject["3. Hit Rate (%)"] = numRequests > 0 ? 100.0 * cacheStats.hits / numRequests : 0.0;
+    cacheStatsObject["4. Evictions"] = (double)cacheStats.evictions;
+    cacheStatsObject["5. Cached Assets"] = cacheStats.numEntries;
+    cacheStatsObject["6. Cached (MB)"] = (double)cacheStats.size / BYTES_PER_MEGABYTE;
+    serverStats["Hot Asset Cache"] = cacheStatsObject;
+
+    if (_mappingJournal) {
+        QJsonObject mappingStats;
+        mappingStats["1. Mappings"] = (int)_fileMappings.size();
+        mappingStats["2. Journaled Ops"] = _mappingJournal->getNumOperations();
+        mappingStats["3. Compacting"] = _mappingJournal->isCompacting();
+        serverStats["Mappings"] = mappingStats;
+    }
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -1044,43 +1069,39 @@ bool AssetServer::loadMappingsFromFile() {
                 }
 
                 qCInfo(asset_server) << "Loaded" << _fileMappings.size() << "mappings from map file at" << mapFilePath;
-                return true;
+            } else {
+                qCCritical(asset_server) << "Failed to read mapping file at" << mapFilePath;
+                return false;
             }
+        } else {
+            qCCritical(asset_server) << "Failed to read mapping file at" << mapFilePath;
+            return false;
         }
-
-        qCCritical(asset_server) << "Failed to read mapping file at" << mapFilePath;
-        return false;
     } else {
         qCInfo(asset_server) << "No existing mappings loaded from file since no file was found at" << mapFilePath;
     }
 
+    // apply the changes made since the map file was last written
+    _mappingJournal.reset(new AssetMappingJournal(mapFilePath));
+    if (!_mappingJournal->replay(_fileMappings)) {
+        qCCritical(asset_server) << "Failed to replay the mapping journal for" << mapFilePath;
+        return false;
+    }
+
     return true;
 }
 
-bool AssetServer::writeMappingsToFile() {
-    auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
-
-    QFile mapFile { mapFilePath };
-    if (mapFile.open(QIODevice::WriteOnly)) {
-        QJsonObject root;
-
-        for (auto it : _fileMappings) {
-            root[it.first] = it.second;
-        }
-
-        QJsonDocument jsonDocument { root };
+bool AssetServer::commitMappingOperations() {
+    if (!_mappingJournal || !_mappingJournal->commit()) {
+        return false;
+    }
 
-        if (mapFile.write(jsonDocument.toJson()) != -1) {
-            qCDebug(asset_server) << "Wrote JSON mappings to file at" << mapFilePath;
-            return true;
-        } else {
-            qCWarning(asset_server) << "Failed to write JSON mappings to file at" << mapFilePath;
-        }
-    } else {
-        qCWarning(asset_server) << "Failed to open map file at" << mapFilePath;
+    // fold the journal back into the map file once in a while, so that it doesn't grow without bound
+    if (_mappingJournal->needsCompaction()) {
+        _mappingJournal->compact(_fileMappings);
     }
 
-    return false;
+    return true;
 }
 
 bool AssetServer::setMapping(AssetUtils::AssetPath path, AssetUtils::AssetHash hash) {
@@ -1104,7 +1125,8 @@ bool AssetServer::setMapping(AssetUtils::AssetPath path, AssetUtils::AssetHash h
     _fileMappings[path] = hash;
 
     // attempt to write to file
-    if (writeMappingsToFile()) {
+    _mappingJournal->set(path, hash);
+    if (commitMappingOperations()) {
         // persistence succeeded, we are good to go
         qCDebug(asset_server) << "Set mapping:" << path << "=>" << hash;
         maybeBake(path, hash);
@@ -1149,6 +1171,9 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
     for (const auto& rawPath : paths) {
         auto path = rawPath.trimmed();
 
+        // the journal handles folders the same way
+        _mappingJournal->remove(path);
+
         // figure out if this path will delete a file or folder
         if (pathIsFolder(path)) {
             // enumerate the in memory file mappings and remove anything that matches
@@ -1189,7 +1214,7 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
     }
 
     // deleted the old mappings, attempt to persist to file
-    if (writeMappingsToFile()) {
+    if (commitMappingOperations()) {
         // persistence succeeded we are good to go
 
         // TODO iterate through hashesToCheckForDeletion instead
@@ -1204,6 +1229,7 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
         for (auto& hash : hashesToCheckForDeletion) {
             // remove the unmapped file
             QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
+            _hotAssetCache->remove(hash);
 
             if (removeableFile.remove()) {
                 qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
@@ -1260,12 +1286,15 @@ bool AssetServer::renameMapping(AssetUtils::AssetPath oldPath, AssetUtils::Asset
                 // remove the old version from the in memory file mappings
                 _fileMappings.erase(_fileMappings.find(oldKey));
                 _fileMappings[newKey] = it->second;
+
+                _mappingJournal->remove(oldKey);
+                _mappingJournal->set(newKey, it->second);
             }
 
             ++it;
         }
 
-        if (writeMappingsToFile()) {
+        if (commitMappingOperations()) {
             // persisted the changed mappings, return success
             qCDebug(asset_server) << "Renamed folder mapping:" << oldPath << "=>" << newPath;
 
@@ -1297,7 +1326,9 @@ bool AssetServer::renameMapping(AssetUtils::AssetPath oldPath, AssetUtils::Asset
         if (!oldSourceMapping.isEmpty()) {
             _fileMappings[newPath] = oldSourceMapping;
 
-            if (writeMappingsToFile()) {
+            _mappingJournal->remove(oldPath);
+            _mappingJournal->set(newPath, oldSourceMapping);
+            if (commitMappingOperations()) {
                 // persisted the renamed mapping, return success
                 qCDebug(asset_server) << "Renamed mapping:" << oldPath << "=>" << newPath;
 
@@ -18,7 +18,9 @@
 
 #include <ThreadedAssignment.h>
 
+#include "AssetMappingJournal.h"
 #include "AssetUtils.h"
+#include "HotAssetCache.h"
 #include "ReceivedMessage.h"
 
 #include "RegisteredMetaTypes.h"
@@ -106,7 +108,9 @@ private:
 
     // Mapping file operations must be called from main assignment thread only
     bool loadMappingsFromFile();
-    bool writeMappingsToFile();
+
+    /// Persist the operations queued on the mapping journal since the last commit
+    bool commitMappingOperations();
 
     /// Set the mapping for path to hash
     bool setMapping(AssetUtils::AssetPath path, AssetUtils::AssetHash hash);
@@ -150,6 +154,7 @@ private:
     void removeBakedPathsForDeletedAsset(AssetUtils::AssetHash originalAssetHash);
 
     AssetUtils::Mappings _fileMappings;
+    std::unique_ptr<AssetMappingJournal> _mappingJournal;
 
     QDir _resourcesDirectory;
     QDir _filesDirectory;
@@ -157,6 +162,9 @@ private:
     /// Task pool for handling uploads and downloads of assets
     QThreadPool _transferTaskPool;
 
+    /// Mapped files of the most requested assets, shared by the send tasks
+    std::shared_ptr<HotAssetCache> _hotAssetCache { std::make_shared<HotAssetCache>() };
+
     QHash<AssetUtils::AssetHash, std::shared_ptr<BakeAssetTask>> _pendingBakes;
     QThreadPool _bakingTaskPool;
 
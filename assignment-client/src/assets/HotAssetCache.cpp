@@ -0,0 +1,101 @@
+//
+//  HotAssetCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "HotAssetCache.h"
+
+#include <algorithm>
+
+#include "AssetServerLogging.h"
+
+HotAssetCache::HotAssetCache(qint64 maxSize, qint64 maxEntrySize) :
+    _maxSize(maxSize),
+    _maxEntrySize(std::min(maxSize, maxEntrySize))
+{
+}
+
+HotAssetCache::EntryPointer HotAssetCache::get(const AssetUtils::AssetHash& hash, const QString& filePath) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _index.find(hash);
+        if (it != _index.end()) {
+            // move it to the front of the LRU list
+            _entries.splice(_entries.begin(), _entries, it.value());
+            ++_hits;
+            return _entries.front().second;
+        }
+    }
+
+    ++_misses;
+
+    // map the file outside of the lock, so that a slow disk doesn't hold up the hits
+    std::unique_ptr<QFile> file { new QFile(filePath) };
+    if (!file->open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    auto size = file->size();
+    if (size <= 0 || size > _maxEntrySize) {
+        return nullptr;
+    }
+
+    auto data = file->map(0, size);
+    if (!data) {
+        qCDebug(asset_server) << "Failed to map asset" << hash << "-" << file->errorString();
+        return nullptr;
+    }
+
+    // the mapping stays valid after the file handle is closed
+    file->close();
+    auto entry = std::make_shared<const Entry>(std::move(file), reinterpret_cast<const char*>(data), size);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _index.find(hash);
+    if (it != _index.end()) {
+        // another task mapped it in the meantime, keep theirs
+        _entries.splice(_entries.begin(), _entries, it.value());
+        return _entries.front().second;
+    }
+
+    _entries.emplace_front(hash, entry);
+    _index.insert(hash, _entries.begin());
+    _size += size;
+    evict();
+
+    return entry;
+}
+
+void HotAssetCache::remove(const AssetUtils::AssetHash& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _index.find(hash);
+    if (it != _index.end()) {
+        _size -= it.value()->second->size();
+        _entries.erase(it.value());
+        _index.erase(it);
+    }
+}
+
+HotAssetCache::Stats HotAssetCache::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return { _hits, _misses, _evictions, (int)_entries.size(), _size };
+}
+
+void HotAssetCache::evict() {
+    // never evict the entry that was just added
+    while (_size > _maxSize && _entries.size() > 1) {
+        auto& last = _entries.back();
+        _size -= last.second->size();
+        _index.remove(last.first);
+        _entries.pop_back();
+        ++_evictions;
+    }
+}
@@ -0,0 +1,87 @@
+//
+//  HotAssetCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_HotAssetCache_h
+#define hifi_HotAssetCache_h
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+
+#include "AssetUtils.h"
+
+// Bounded LRU cache of memory-mapped asset files, shared by the SendAssetTasks.
+//   Popular assets are requested by many clients at once; instead of opening and reading the file for every request,
+//   the file is mapped once and every range read is served straight out of the mapping.
+//   Entries are reference counted, so an entry evicted while a task is still sending from it stays mapped until
+//   that task is done with it.
+class HotAssetCache {
+public:
+    class Entry {
+    public:
+        Entry(std::unique_ptr<QFile> file, const char* data, qint64 size) :
+            _file(std::move(file)), _data(data), _size(size) {}
+
+        const char* data() const { return _data; }
+        qint64 size() const { return _size; }
+
+    private:
+        std::unique_ptr<QFile> _file; // the mapping goes away with the file
+        const char* _data;
+        qint64 _size;
+    };
+    using EntryPointer = std::shared_ptr<const Entry>;
+
+    struct Stats {
+        quint64 hits;
+        quint64 misses;
+        quint64 evictions;
+        int numEntries;
+        qint64 size;
+    };
+
+    static const qint64 DEFAULT_MAX_SIZE = 512 * 1024 * 1024;
+    static const qint64 DEFAULT_MAX_ENTRY_SIZE = 64 * 1024 * 1024;
+
+    HotAssetCache(qint64 maxSize = DEFAULT_MAX_SIZE, qint64 maxEntrySize = DEFAULT_MAX_ENTRY_SIZE);
+
+    // returns the mapped asset, mapping the file at filePath if it isn't cached yet.
+    // returns nullptr if the file doesn't exist, can't be mapped or is too large to be cached.
+    // safe to call from any thread
+    EntryPointer get(const AssetUtils::AssetHash& hash, const QString& filePath);
+
+    // drops the asset from the cache, for when its file is deleted
+    void remove(const AssetUtils::AssetHash& hash);
+
+    Stats getStats() const;
+
+private:
+    using LRUList = std::list<std::pair<AssetUtils::AssetHash, EntryPointer>>; // most recently used first
+
+    void evict(); // expects _mutex to be locked
+
+    const qint64 _maxSize;
+    const qint64 _maxEntrySize;
+
+    mutable std::mutex _mutex;
+    LRUList _entries; // guarded by _mutex
+    QHash<AssetUtils::AssetHash, LRUList::iterator> _index; // guarded by _mutex
+    qint64 _size { 0 }; // guarded by _mutex
+    quint64 _evictions { 0 }; // guarded by _mutex
+
+    std::atomic<quint64> _hits { 0 };
+    std::atomic<quint64> _misses { 0 };
+};
+
+#endif // hifi_HotAssetCache_h
@@ -26,11 +26,13 @@
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             std::shared_ptr<HotAssetCache> hotAssetCache) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _hotAssetCache(hotAssetCache)
 {
     
 }
@@ -64,10 +66,33 @@ void SendAssetTask::run() {
         replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
     } else {
         QString filePath = _resourcesDir.filePath(QString(hexHash));
+
+        // popular assets are served straight out of their mapping, the rest are read from the file
+        auto cachedAsset = _hotAssetCache ? _hotAssetCache->get(hexHash, filePath) : nullptr;
         
         QFile file { filePath };
 
-        if (file.open(QIODevice::ReadOnly)) {
+        if (cachedAsset) {
+            byteRange.fixupRange(cachedAsset->size());
+
+            if (cachedAsset->size() < byteRange.fromInclusive || cachedAsset->size() < byteRange.toExclusive) {
+                replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
+                qCDebug(networking) << "Bad byte range: " << hexHash << " "
+                    << byteRange.fromInclusive << ":" << byteRange.toExclusive;
+            } else {
+                auto size = byteRange.size();
+
+                // a negative range starts that far back from the end of the asset
+                auto offset = byteRange.fromInclusive >= 0 ? byteRange.fromInclusive
+                                                           : cachedAsset->size() + byteRange.fromInclusive;
+
+                replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+                replyPacketList->writePrimitive(size);
+                replyPacketList->write(cachedAsset->data() + offset, size);
+
+                qCDebug(networking) << "Sending asset: " << hexHash;
+            }
+        } else if (file.open(QIODevice::ReadOnly)) {
 
             // first fixup the range based on the now known file size
             byteRange.fixupRange(file.size());
@@ -76,11 +76,7 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
 
     // packets whose consequences are limited to their own node can be parallelized
     packetReceiver.registerListenerForTypes({
-            PacketType::MicrophoneAudioNoEcho,
-            PacketType::MicrophoneAudioWithEcho,
-            PacketType::InjectAudio,
             PacketType::AudioStreamStats,
-            PacketType::SilentAudioFrame,
             PacketType::NegotiateAudioFormat,
             PacketType::MuteEnvironment,
             PacketType::NodeIgnoreRequest,
@@ -89,6 +85,15 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
             PacketType::PerAvatarGainSet },
             this, "queueAudioPacket");
 
+    // stream packets go straight from the network thread to the client queues when decoding on arrival,
+    //   and are otherwise handed to queueStreamPacket
+    packetReceiver.registerDirectListenerForTypes({
+            PacketType::MicrophoneAudioNoEcho,
+            PacketType::MicrophoneAudioWithEcho,
+            PacketType::InjectAudio,
+            PacketType::SilentAudioFrame },
+            &_ingest, "ingestAudioPacket");
+
     // packets whose consequences are global should be processed on the main thread
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
     packetReceiver.registerListener(PacketType::NodeMuteRequest, this, "handleNodeMuteRequestPacket");
@@ -104,14 +109,21 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
     );
 
     connect(nodeList.data(), &NodeList::nodeKilled, this, &AudioMixer::handleNodeKilled);
+
+    // the ingest may need client data for a node before its first packet reaches this thread
+    nodeList->linkedDataCreateCallback = [&](Node* node) { createClientData(node); };
 }
 
 void AudioMixer::queueAudioPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+    getOrCreateClientData(node.data())->queuePacket(message, node);
+}
+
+void AudioMixer::queueStreamPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
     if (message->getType() == PacketType::SilentAudioFrame) {
         _numSilentPackets++;
     }
 
-    getOrCreateClientData(node.data())->queuePacket(message, node);
+    getOrCreateClientData(node.data())->queueStreamPacket(message, node);
 }
 
 void AudioMixer::queueReplicatedAudioPacket(QSharedPointer<ReceivedMessage> message) {
@@ -274,6 +286,8 @@ void AudioMixer::sendStatsPacket() {
     statsObject["avg_listeners_per_frame"] = (float)_stats.sumListeners / (float)_numStatFrames;
     statsObject["avg_listeners_(silent)_per_frame"] = (float)_stats.sumListenersSilent / (float)_numStatFrames;
 
+    _numSilentPackets += _ingest.takeNumSilentPackets();
+    _numFallbackPackets += _ingest.takeNumFallbackPackets();
     statsObject["silent_packets_per_frame"] = (float)_numSilentPackets / (float)_numStatFrames;
 
     // timing stats
@@ -290,9 +304,11 @@ void AudioMixer::sendStatsPacket() {
     addTiming(_sleepTiming, "sleep");
     addTiming(_frameTiming, "frame");
     addTiming(_prepareTiming, "prepare");
+    addTiming(_indexTiming, "index");
     addTiming(_mixTiming, "mix");
     addTiming(_eventsTiming, "events");
     addTiming(_packetsTiming, "packets");
+    addTiming(_decodeTiming, "decode");
 
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     timingStats["ns_per_mix"] = (_stats.totalMixes > 0) ?  (float)(_stats.mixTime / _stats.totalMixes) : 0;
@@ -313,9 +329,31 @@ void AudioMixer::sendStatsPacket() {
     mixStats["total_mixes"] = _stats.totalMixes;
     mixStats["avg_mixes_per_block"] = _stats.totalMixes / _numStatFrames;
 
+    mixStats["audibility_radius"] = _audibilityIndex.getAudibilityRadius();
+    mixStats["avg_candidate_pairs_per_frame"] = (float)_stats.indexCandidates / (float)_numStatFrames;
+    mixStats["avg_pruned_pairs_per_frame"] = (float)_stats.indexPruned / (float)_numStatFrames;
+
+    mixStats["avg_encode_groups_per_frame"] = (float)_stats.encodeGroups / (float)_numStatFrames;
+    mixStats["avg_encodes_saved_per_frame"] = (float)_stats.encodesSaved / (float)_numStatFrames;
+
     statsObject["mix_stats"] = mixStats;
 
-    _numStatFrames = _numSilentPackets = 0;
+    // decode stats
+    QJsonObject decodeStats;
+
+    decodeStats["decode_on_arrival"] = _decodeOnArrival;
+    decodeStats["avg_packets_per_frame"] = (float)_stats.decodedPackets / (float)_numStatFrames;
+    decodeStats["avg_queue_depth"] = (_stats.decodeDrains > 0) ?
+        (float)_stats.sumDecodeQueueDepth / (float)_stats.decodeDrains : 0.0f;
+    decodeStats["max_queue_depth"] = _stats.maxDecodeQueueDepth;
+    decodeStats["us_to_decode_p50"] = _stats.getDecodeDelayPercentile(0.5f);
+    decodeStats["us_to_decode_p90"] = _stats.getDecodeDelayPercentile(0.9f);
+    decodeStats["us_to_decode_p99"] = _stats.getDecodeDelayPercentile(0.99f);
+    decodeStats["fallback_packets"] = _numFallbackPackets;
+
+    statsObject["decode_stats"] = decodeStats;
+
+    _numStatFrames = _numSilentPackets = _numFallbackPackets = 0;
     _stats.reset();
 
     // add stats for each listerner
@@ -357,11 +395,19 @@ void AudioMixer::run() {
 }
 
 AudioMixerClientData* AudioMixer::getOrCreateClientData(Node* node) {
+    // the ingest reads (and creates) client data on the network thread, so it is only published under the node's lock
+    QMutexLocker lock(&node->getMutex());
+    return createClientData(node);
+}
+
+AudioMixerClientData* AudioMixer::createClientData(Node* node) {
     auto clientData = dynamic_cast<AudioMixerClientData*>(node->getLinkedData());
 
     if (!clientData) {
         node->setLinkedData(std::unique_ptr<NodeData> { new AudioMixerClientData(node->getUUID()) });
         clientData = dynamic_cast<AudioMixerClientData*>(node->getLinkedData());
+        // it may have been created on the network thread
+        clientData->moveToThread(thread());
         connect(clientData, &AudioMixerClientData::injectorStreamFinished, this, &AudioMixer::removeHRTFsForFinishedInjector);
     }
 
@@ -376,13 +422,16 @@ void AudioMixer::start() {
         NodeType::Agent, NodeType::EntityScriptServer,
         NodeType::UpstreamAudioMixer, NodeType::DownstreamAudioMixer
     });
-    nodeList->linkedDataCreateCallback = [&](Node* node) { getOrCreateClientData(node); };
 
     // parse out any AudioMixer settings
     {
         DomainHandler& domainHandler = nodeList->getDomainHandler();
         const QJsonObject& settingsObject = domainHandler.getSettingsObject();
         parseSettingsObject(settingsObject);
+
+        // settings received from here on (on reconnecting to the domain) are applied between frames
+        disconnect(&domainHandler, &DomainHandler::settingsReceived, this, &AudioMixer::start);
+        connect(&domainHandler, &DomainHandler::settingsReceived, this, &AudioMixer::handleSettings);
     }
 
     // mix state
@@ -409,10 +458,16 @@ void AudioMixer::start() {
                 });
             }
 
+            // index the prepared streams by position, so listeners can skip inaudible nodes
+            {
+                auto indexTimer = _indexTiming.timer();
+                _audibilityIndex.build(cbegin, cend);
+            }
+
             // mix across slave threads
             {
                 auto mixTimer = _mixTiming.timer();
-                _slavePool.mix(cbegin, cend, frame, _throttlingRatio);
+                _slavePool.mix(cbegin, cend, frame, _throttlingRatio, _audibilityIndex);
             }
         });
 
@@ -461,13 +516,40 @@ std::chrono::microseconds AudioMixer::timeFrame(p_high_resolution_clock::time_po
     timestamp = std::max(now, nextTimestamp);
 
     // sleep until the next frame should start
-    // WIN32 sleep_until is broken until VS2015 Update 2
-    // instead, std::max (above) guarantees that timestamp >= now, so we can sleep_for
-    std::this_thread::sleep_for(timestamp - now);
+    if (_decodeOnArrival) {
+        decodeUntil(timestamp);
+    } else {
+        // WIN32 sleep_until is broken until VS2015 Update 2
+        // instead, std::max (above) guarantees that timestamp >= now, so we can sleep_for
+        std::this_thread::sleep_for(timestamp - now);
+    }
 
     return duration;
 }
 
+void AudioMixer::decodeUntil(p_high_resolution_clock::time_point timestamp) {
+    // the streams are written here, and at the end of the frame, but never while they are mixed
+    const auto DECODE_INTERVAL = std::chrono::duration_cast<p_high_resolution_clock::duration>(std::chrono::milliseconds(1));
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    auto now = p_high_resolution_clock::now();
+    while (now < timestamp) {
+        if (_ingest.takeNumPendingPackets() > 0) {
+            auto decodeTimer = _decodeTiming.timer();
+            nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
+                _slavePool.decodePackets(cbegin, cend);
+            });
+            now = p_high_resolution_clock::now();
+            if (now >= timestamp) {
+                break;
+            }
+        }
+
+        std::this_thread::sleep_for(std::min(timestamp - now, DECODE_INTERVAL));
+        now = p_high_resolution_clock::now();
+    }
+}
+
 void AudioMixer::throttle(std::chrono::microseconds duration, int frame) {
     // throttle using a modified proportional-integral controller
     const float FRAME_TIME = 10000.0f;
@@ -524,7 +606,14 @@ int AudioMixer::prepareFrame(const SharedNodePointer& node, unsigned int frame)
     return data->checkBuffersBeforeFrameSend();
 }
 
+void AudioMixer::handleSettings(const QJsonObject& settingsObject) {
+    clearDomainSettings();
+    parseSettingsObject(settingsObject);
+}
+
 void AudioMixer::clearDomainSettings() {
+    _decodeOnArrival = false;
+    _ingest.setDecodeOnArrival(false);
     _numStaticJitterFrames = DISABLE_STATIC_JITTER_FRAMES;
     _attenuationPerDoublingInDistance = DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE;
     _noiseMutingThreshold = DEFAULT_NOISE_MUTING_THRESHOLD;
@@ -549,6 +638,11 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
                 _slavePool.setNumThreads(numThreads);
             }
         }
+
+        const QString DECODE_ON_ARRIVAL = "decode_on_arrival";
+        _decodeOnArrival = audioThreadingGroupObject[DECODE_ON_ARRIVAL].toBool();
+        _ingest.setDecodeOnArrival(_decodeOnArrival);
+        qCDebug(audio) << "Decode on arrival:" << (_decodeOnArrival ? "enabled" : "disabled");
     }
 
     if (settingsObject.contains(AUDIO_BUFFER_GROUP_KEY)) {
@@ -20,6 +20,8 @@
 
 #include <plugins/Forward.h>
 
+#include "AudioMixerIngest.h"
+#include "AudioMixerSpatialIndex.h"
 #include "AudioMixerStats.h"
 #include "AudioMixerSlavePool.h"
 
@@ -70,19 +72,25 @@ private slots:
     void handleKillAvatarPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
 
     void queueAudioPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
+    void queueStreamPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
     void queueReplicatedAudioPacket(QSharedPointer<ReceivedMessage> packet);
     void removeHRTFsForFinishedInjector(const QUuid& streamID);
     void start();
+    void handleSettings(const QJsonObject& settingsObject);
 
 private:
     // mixing helpers
     std::chrono::microseconds timeFrame(p_high_resolution_clock::time_point& timestamp);
     void throttle(std::chrono::microseconds frameDuration, int frame);
+    // decode ingested packets across slave threads until the next frame
+    void decodeUntil(p_high_resolution_clock::time_point timestamp);
     // pop a frame from any streams on the node
     // returns the number of available streams
     int prepareFrame(const SharedNodePointer& node, unsigned int frame);
 
     AudioMixerClientData* getOrCreateClientData(Node* node);
+    // expects the node's lock to be held
+    AudioMixerClientData* createClientData(Node* node);
 
     QString percentageForMixStats(int counter);
 
@@ -93,11 +101,16 @@ private:
     float _throttlingRatio { 0.0f };
 
     int _numSilentPackets { 0 };
+    int _numFallbackPackets { 0 };
+
+    bool _decodeOnArrival { false };
+    AudioMixerIngest _ingest { this };
 
     int _numStatFrames { 0 };
     AudioMixerStats _stats;
 
     AudioMixerSlavePool _slavePool;
+    AudioMixerSpatialIndex _audibilityIndex;
 
     class Timer {
     public:
@@ -124,9 +137,11 @@ private:
     Timer _sleepTiming;
     Timer _frameTiming;
     Timer _prepareTiming;
+    Timer _indexTiming;
     Timer _mixTiming;
     Timer _eventsTiming;
     Timer _packetsTiming;
+    Timer _decodeTiming;
 
     static int _numStaticJitterFrames; // -1 denotes dynamic jitter buffering
     static float _noiseMutingThreshold;
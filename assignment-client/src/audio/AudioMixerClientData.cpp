@@ -56,59 +56,103 @@ void AudioMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message,
     _packetQueue.push(message);
 }
 
-void AudioMixerClientData::processPackets() {
+void AudioMixerClientData::queueStreamPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+    queuePacket(message, node);
+    _packetQueue.numStreamPackets++;
+}
+
+void AudioMixerClientData::processPackets(AudioMixerStats& stats) {
+    // pick up any stream packets ingested since the last decode;
+    // they all arrived before any stream packets in the queue, which were handed off while ingesting was held
+    decodePackets(stats);
+
     SharedNodePointer node = _packetQueue.node;
     assert(_packetQueue.empty() || node);
     _packetQueue.node.clear();
 
+    if (!_packetQueue.empty()) {
+        stats.addDecodeQueueDepth((int)_packetQueue.size());
+    }
     while (!_packetQueue.empty()) {
-        auto& packet = _packetQueue.front();
+        processPacket(_packetQueue.front(), node, stats);
+        _packetQueue.pop();
+    }
+    assert(_packetQueue.empty());
 
-        switch (packet->getType()) {
-            case PacketType::MicrophoneAudioNoEcho:
-            case PacketType::MicrophoneAudioWithEcho:
-            case PacketType::InjectAudio:
-            case PacketType::SilentAudioFrame: {
+    // release the hold on ingesting for the handed off packets processed above
+    _numHandedOffPackets -= _packetQueue.numStreamPackets;
+    _packetQueue.numStreamPackets = 0;
+}
 
-                if (node->isUpstream()) {
-                    setupCodecForReplicatedAgent(packet);
-                }
+bool AudioMixerClientData::ingestPacket(QSharedPointer<ReceivedMessage> packet, const SharedNodePointer& node) {
+    if (_numHandedOffPackets > 0) {
+        return false;
+    }
+    return _ingestQueue.push({ packet, node });
+}
+
+void AudioMixerClientData::decodePackets(AudioMixerStats& stats) {
+    int depth = (int)_ingestQueue.size();
+    if (depth == 0) {
+        return;
+    }
+    stats.addDecodeQueueDepth(depth);
 
-                QMutexLocker lock(&getMutex());
-                parseData(*packet);
+    IngestedPacket ingested;
+    while (_ingestQueue.pop(ingested)) {
+        SharedNodePointer node = ingested.node.lock();
+        if (node) {
+            processPacket(ingested.packet, node, stats);
+        }
+    }
+}
 
-                optionallyReplicatePacket(*packet, *node);
+void AudioMixerClientData::processPacket(QSharedPointer<ReceivedMessage> packet, const SharedNodePointer& node,
+        AudioMixerStats& stats) {
+    switch (packet->getType()) {
+        case PacketType::MicrophoneAudioNoEcho:
+        case PacketType::MicrophoneAudioWithEcho:
+        case PacketType::InjectAudio:
+        case PacketType::SilentAudioFrame: {
 
-                break;
+            if (node->isUpstream()) {
+                setupCodecForReplicatedAgent(packet);
             }
-            case PacketType::AudioStreamStats: {
-                QMutexLocker lock(&getMutex());
-                parseData(*packet);
 
-                break;
-            }
-            case PacketType::NegotiateAudioFormat:
-                negotiateAudioFormat(*packet, node);
-                break;
-            case PacketType::RequestsDomainListData:
-                parseRequestsDomainListData(*packet);
-                break;
-            case PacketType::PerAvatarGainSet:
-                parsePerAvatarGainSet(*packet, node);
-                break;
-            case PacketType::NodeIgnoreRequest:
-                parseNodeIgnoreRequest(packet, node);
-                break;
-            case PacketType::RadiusIgnoreRequest:
-                parseRadiusIgnoreRequest(packet, node);
-                break;
-            default:
-                Q_UNREACHABLE();
+            QMutexLocker lock(&getMutex());
+            parseData(*packet);
+
+            optionallyReplicatePacket(*packet, *node);
+
+            auto decodeDelay = p_high_resolution_clock::now() - packet->getFirstPacketReceiveTime();
+            stats.addDecodeDelay(std::chrono::duration_cast<std::chrono::microseconds>(decodeDelay).count());
+
+            break;
         }
+        case PacketType::AudioStreamStats: {
+            QMutexLocker lock(&getMutex());
+            parseData(*packet);
 
-        _packetQueue.pop();
+            break;
+        }
+        case PacketType::NegotiateAudioFormat:
+            negotiateAudioFormat(*packet, node);
+            break;
+        case PacketType::RequestsDomainListData:
+            parseRequestsDomainListData(*packet);
+            break;
+        case PacketType::PerAvatarGainSet:
+            parsePerAvatarGainSet(*packet, node);
+            break;
+        case PacketType::NodeIgnoreRequest:
+            parseNodeIgnoreRequest(packet, node);
+            break;
+        case PacketType::RadiusIgnoreRequest:
+            parseRadiusIgnoreRequest(packet, node);
+            break;
+        default:
+            Q_UNREACHABLE();
     }
-    assert(_packetQueue.empty());
 }
 
 bool isReplicatedPacket(PacketType packetType) {
@@ -198,6 +242,11 @@ void AudioMixerClientData::parsePerAvatarGainSet(ReceivedMessage& message, const
     } else {
         // set the per-source avatar gain
         hrtfForStream(avatarUuid, QUuid()).setGainAdjustment(gain);
+        if (gain > 1.0f) {
+            _boostedNodes.insert(avatarUuid);
+        } else {
+            _boostedNodes.erase(avatarUuid);
+        }
         qCDebug(audio) << "Setting avatar gain adjustment for hrtf[" << uuid << "][" << avatarUuid << "] to " << gain;
     }
 }
@@ -575,6 +624,7 @@ void AudioMixerClientData::setupCodec(CodecPluginPointer codec, const QString& c
         _encoder = codec->createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
         _decoder = codec->createDecoder(AudioConstants::SAMPLE_RATE, AudioConstants::MONO);
     }
+    _isEncoderStateless = !_encoder || _encoder == dynamic_cast<Encoder*>(codec.get());
 
     auto avatarAudioStream = getAvatarAudioStream();
     if (avatarAudioStream) {
@@ -607,6 +657,7 @@ void AudioMixerClientData::cleanupCodec() {
             _encoder = nullptr;
         }
     }
+    _isEncoderStateless = true;
 }
 
 AudioMixerClientData::IgnoreZone& AudioMixerClientData::IgnoreZoneMemo::get(unsigned int frame) {
@@ -647,20 +698,20 @@ AudioMixerClientData::IgnoreZone& AudioMixerClientData::IgnoreZoneMemo::get(unsi
     return _zone;
 }
 
-void AudioMixerClientData::IgnoreNodeCache::cache(bool shouldIgnore) {
-    if (!_isCached) {
+void AudioMixerClientData::IgnoreNodeCache::cache(bool shouldIgnore, unsigned int frame) {
+    if (!isCached(frame)) {
         _shouldIgnore = shouldIgnore;
-        _isCached = true;
+        _frame.store(frame, std::memory_order_release);
     }
 }
 
-bool AudioMixerClientData::IgnoreNodeCache::isCached() {
-    return _isCached;
+bool AudioMixerClientData::IgnoreNodeCache::isCached(unsigned int frame) {
+    return _frame.load(std::memory_order_acquire) == frame;
 }
 
 bool AudioMixerClientData::IgnoreNodeCache::shouldIgnore() {
     bool ignore = _shouldIgnore;
-    _isCached = false;
+    _frame.store(0, std::memory_order_release);
     return ignore;
 }
 
@@ -669,7 +720,7 @@ bool AudioMixerClientData::shouldIgnore(const SharedNodePointer self, const Shar
 
     // check the cache to avoid computation
     auto& cache = _nodeSourcesIgnoreMap[node->getUUID()];
-    if (cache.isCached()) {
+    if (cache.isCached(frame)) {
         return cache.shouldIgnore();
     }
 
@@ -697,7 +748,7 @@ bool AudioMixerClientData::shouldIgnore(const SharedNodePointer self, const Shar
     }
 
     // cache in node
-    nodeData->_nodeSourcesIgnoreMap[self->getUUID()].cache(shouldIgnore);
+    nodeData->_nodeSourcesIgnoreMap[self->getUUID()].cache(shouldIgnore, frame);
 
     return shouldIgnore;
 }
@@ -12,13 +12,16 @@
 #ifndef hifi_AudioMixerClientData_h
 #define hifi_AudioMixerClientData_h
 
+#include <atomic>
 #include <queue>
+#include <unordered_set>
 
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioLimiter.h>
+#include <SPSCQueue.h>
 #include <UUIDHasher.h>
 
 #include <plugins/Forward.h>
@@ -26,6 +29,7 @@
 
 #include "PositionalAudioStream.h"
 #include "AvatarAudioStream.h"
+#include "AudioMixerStats.h"
 
 class AudioMixerClientData : public NodeData {
     Q_OBJECT
@@ -37,7 +41,17 @@ public:
     using AudioStreamMap = std::unordered_map<QUuid, SharedStreamPointer>;
 
     void queuePacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer node);
-    void processPackets();
+    void processPackets(AudioMixerStats& stats);
+
+    // stream packets can also be pushed straight from the network thread (the only producer), to be decoded on arrival
+    // returns false if the ingest queue is full, or if stream packets handed off to the mixer thread are still queued
+    bool ingestPacket(QSharedPointer<ReceivedMessage> packet, const SharedNodePointer& node);
+    void decodePackets(AudioMixerStats& stats);
+
+    // a stream packet that was not ingested is handed off (on the network thread) and then queued (on the mixer thread);
+    //   ingesting resumes once every handed off packet has been processed
+    void handOffPacket() { _numHandedOffPackets++; }
+    void queueStreamPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer node);
 
     // locks the mutex to make a copy
     AudioStreamMap getAudioStreams() { QReadLocker readLock { &_streamsLock }; return _audioStreams; }
@@ -57,7 +71,14 @@ public:
     void removeHRTFForStream(const QUuid& nodeID, const QUuid& streamID = QUuid());
 
     // remove all sources and data from this node
-    void removeNode(const QUuid& nodeID) { _nodeSourcesIgnoreMap.unsafe_erase(nodeID); _nodeSourcesHRTFMap.erase(nodeID); }
+    void removeNode(const QUuid& nodeID) {
+        _nodeSourcesIgnoreMap.unsafe_erase(nodeID);
+        _nodeSourcesHRTFMap.erase(nodeID);
+        _boostedNodes.erase(nodeID);
+    }
+
+    // the nodes this listener has turned up past unity gain, which can be heard from further than the audibility radius
+    const std::unordered_set<QUuid>& getBoostedNodes() const { return _boostedNodes; }
 
     void removeAgentAvatarAudioStream();
 
@@ -102,6 +123,12 @@ public:
     }
     void encodeFrameOfZeros(QByteArray& encodedZeros);
     bool shouldFlushEncoder() { return _shouldFlushEncoder; }
+    void setShouldFlushEncoder(bool shouldFlush) { _shouldFlushEncoder = shouldFlush; }
+
+    // the PCM and zlib codecs hand every listener the codec itself as its encoder, which keeps no state between frames,
+    //   so what it encodes depends only on the frame, and can be shared with other listeners of the same encoder
+    const Encoder* getEncoder() const { return _encoder; }
+    bool isEncoderStateless() const { return _isEncoderStateless; }
 
     QString getCodecName() { return _selectedCodecName; }
 
@@ -123,8 +150,19 @@ public slots:
 private:
     struct PacketQueue : public std::queue<QSharedPointer<ReceivedMessage>> {
         QWeakPointer<Node> node;
+        int numStreamPackets { 0 };
     };
     PacketQueue _packetQueue;
+    std::atomic<int> _numHandedOffPackets { 0 };
+
+    struct IngestedPacket {
+        QSharedPointer<ReceivedMessage> packet;
+        QWeakPointer<Node> node;
+    };
+    static const int INGEST_QUEUE_CAPACITY = 64;
+    SPSCQueue<IngestedPacket> _ingestQueue { INGEST_QUEUE_CAPACITY };
+
+    void processPacket(QSharedPointer<ReceivedMessage> packet, const SharedNodePointer& node, AudioMixerStats& stats);
 
     QReadWriteLock _streamsLock;
     AudioStreamMap _audioStreams; // microphone stream from avatar is stored under key of null UUID
@@ -156,12 +194,14 @@ private:
         IgnoreNodeCache() {}
         IgnoreNodeCache(const IgnoreNodeCache& other) {}
 
-        void cache(bool shouldIgnore);
-        bool isCached();
+        // the cache is stamped with the frame it was computed for, so entries left unconsumed
+        // (e.g. when the listener skipped this node as inaudible) expire on the next frame
+        void cache(bool shouldIgnore, unsigned int frame);
+        bool isCached(unsigned int frame);
         bool shouldIgnore();
 
     private:
-        std::atomic<bool> _isCached { false };
+        std::atomic<unsigned int> _frame { 0 }; // 0 denotes uncached
         bool _shouldIgnore { false };
     };
     struct IgnoreNodeCacheHasher { std::size_t operator()(const QUuid& key) const { return qHash(key); } };
@@ -172,6 +212,7 @@ private:
     using HRTFMap = std::unordered_map<QUuid, AudioHRTF>;
     using NodeSourcesHRTFMap = std::unordered_map<QUuid, HRTFMap>;
     NodeSourcesHRTFMap _nodeSourcesHRTFMap;
+    std::unordered_set<QUuid> _boostedNodes;
 
     quint16 _outgoingMixedAudioSequenceNumber;
 
@@ -184,6 +225,7 @@ private:
     CodecPluginPointer _codec;
     QString _selectedCodecName;
     Encoder* _encoder{ nullptr }; // for outbound mixed stream
+    bool _isEncoderStateless { true };
     Decoder* _decoder{ nullptr }; // for mic stream
 
     bool _shouldFlushEncoder { false };
@@ -0,0 +1,41 @@
+//
+//  AudioMixerIngest.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerIngest.h"
+
+#include <NodeList.h>
+
+#include "AudioMixerClientData.h"
+
+void AudioMixerIngest::ingestAudioPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+    // the client data is created under the node's lock, wherever the node's first packet lands
+    auto nodeList = DependencyManager::get<NodeList>();
+    auto data = static_cast<AudioMixerClientData*>(nodeList->getOrCreateLinkedData(node));
+
+    bool decodeOnArrival = _decodeOnArrival;
+    if (decodeOnArrival && data->ingestPacket(message, node)) {
+        if (message->getType() == PacketType::SilentAudioFrame) {
+            _numSilentPackets++;
+        }
+        _numPendingPackets++;
+        return;
+    }
+
+    if (decodeOnArrival) {
+        _numFallbackPackets++;
+    }
+
+    // hold off ingesting until this packet is processed, so the stream sees its packets in order
+    data->handOffPacket();
+
+    // queueStreamPacket counts it as silent if it is
+    QMetaObject::invokeMethod(_mixer, "queueStreamPacket", Qt::QueuedConnection,
+        Q_ARG(QSharedPointer<ReceivedMessage>, message), Q_ARG(SharedNodePointer, node));
+}
@@ -0,0 +1,52 @@
+//
+//  AudioMixerIngest.h
+//  assignment-client/src/audio
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerIngest_h
+#define hifi_AudioMixerIngest_h
+
+#include <atomic>
+
+#include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+
+#include <Node.h>
+#include <ReceivedMessage.h>
+
+// Takes the audio stream packets straight off the network thread (it is registered as a direct listener), and pushes
+//   them onto the ingest queue of their sender, to be decoded by the slaves while the mixer sleeps between frames.
+//   When decode on arrival is off, or a packet can't be ingested (its sender's queue is full, or packets handed over
+//   before it are still waiting), it is handed to the mixer thread instead, so nothing is dropped or reordered here.
+class AudioMixerIngest : public QObject {
+    Q_OBJECT
+public:
+    AudioMixerIngest(QObject* mixer) : _mixer(mixer) {}
+
+    // may be toggled at any time, as settings are received
+    void setDecodeOnArrival(bool decodeOnArrival) { _decodeOnArrival = decodeOnArrival; }
+
+    // on the mixer thread
+    int takeNumPendingPackets() { return _numPendingPackets.exchange(0); }
+    int takeNumSilentPackets() { return _numSilentPackets.exchange(0); }
+    int takeNumFallbackPackets() { return _numFallbackPackets.exchange(0); }
+
+public slots:
+    // on the network thread
+    void ingestAudioPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
+
+private:
+    QObject* _mixer;
+
+    std::atomic<bool> _decodeOnArrival { false };
+    std::atomic<int> _numPendingPackets { 0 };
+    std::atomic<int> _numSilentPackets { 0 };
+    std::atomic<int> _numFallbackPackets { 0 };
+};
+
+#endif // hifi_AudioMixerIngest_h
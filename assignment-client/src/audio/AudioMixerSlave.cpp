@@ -38,6 +38,8 @@
 
 using AudioStreamMap = AudioMixerClientData::AudioStreamMap;
 
+static const int HRTF_DATASET_INDEX = 1;
+
 // packet helpers
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec);
 void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer);
@@ -56,15 +58,24 @@ inline float computeAzimuth(const AvatarAudioStream& listeningNodeStream, const
 void AudioMixerSlave::processPackets(const SharedNodePointer& node) {
     AudioMixerClientData* data = (AudioMixerClientData*)node->getLinkedData();
     if (data) {
-        data->processPackets();
+        data->processPackets(stats);
+    }
+}
+
+void AudioMixerSlave::decodePackets(const SharedNodePointer& node) {
+    AudioMixerClientData* data = (AudioMixerClientData*)node->getLinkedData();
+    if (data) {
+        data->decodePackets(stats);
     }
 }
 
-void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        const AudioMixerSpatialIndex* index) {
     _begin = begin;
     _end = end;
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _index = index;
 }
 
 void AudioMixerSlave::mix(const SharedNodePointer& node) {
@@ -102,10 +113,11 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
             if (mixHasAudio) {
                 // encode the audio
                 QByteArray decodedBuffer(reinterpret_cast<char*>(_bufferSamples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                data->encode(decodedBuffer, encodedBuffer);
+                encodeMix(*data, decodedBuffer, encodedBuffer, false);
             } else {
                 // time to flush (resets shouldFlush until the next encode)
-                data->encodeFrameOfZeros(encodedBuffer);
+                static const QByteArray zeros(AudioConstants::NETWORK_FRAME_BYTES_STEREO, 0);
+                encodeMix(*data, zeros, encodedBuffer, true);
             }
 
             sendMixPacket(node, *data, encodedBuffer);
@@ -155,7 +167,29 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     auto mixStart = p_high_resolution_clock::now();
 #endif
 
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
+    // only visit the nodes with a stream inside the audibility radius of the listener
+    // (the listener itself is always a candidate, as its own stream is at distance 0)
+    _index->query(listenerAudioStream->getPosition(), _candidates);
+    int numNodes = (int)std::distance(_begin, _end);
+
+    // the sources this listener has turned up may be audible from outside the radius, so they are always candidates
+    const auto& boostedNodes = listenerData->getBoostedNodes();
+    if (_index->isEnabled() && !boostedNodes.empty()) {
+        int offset = 0;
+        std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
+            if (boostedNodes.find(node->getUUID()) != boostedNodes.end()) {
+                _candidates.push_back(offset);
+            }
+            ++offset;
+        });
+        std::sort(_candidates.begin(), _candidates.end());
+        _candidates.erase(std::unique(_candidates.begin(), _candidates.end()), _candidates.end());
+    }
+    stats.indexCandidates += (int)_candidates.size();
+    stats.indexPruned += numNodes - (int)_candidates.size();
+
+    std::for_each(_candidates.cbegin(), _candidates.cend(), [&](int offset) {
+        const SharedNodePointer& node = *(_begin + offset);
         AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
         if (!nodeData) {
             return;
@@ -201,7 +235,8 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
 
     if (isThrottling) {
         // pop the loudest nodes off the heap and mix their streams
-        int numToRetain = (int)(std::distance(_begin, _end) * (1 - _throttlingRatio));
+        // (the ratio applies to the candidates, the pruned nodes are inaudible and were never going to be mixed)
+        int numToRetain = (int)(_candidates.size() * (1 - _throttlingRatio));
         for (int i = 0; i < numToRetain; i++) {
             if (throttledNodes.empty()) {
                 break;
@@ -224,6 +259,8 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         }
     }
 
+    renderHRTFSources();
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     auto mixEnd = p_high_resolution_clock::now();
     auto mixTime = std::chrono::duration_cast<std::chrono::nanoseconds>(mixEnd - mixStart);
@@ -278,7 +315,6 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
     float distance = glm::max(glm::length(relativePosition), EPSILON);
     float gain = computeGain(listenerNodeData, listeningNodeStream, streamToAdd, relativePosition, distance, isEcho);
     float azimuth = isEcho ? 0.0f : computeAzimuth(listeningNodeStream, listeningNodeStream, relativePosition);
-    const int HRTF_DATASET_INDEX = 1;
 
     if (!streamToAdd.lastPopSucceeded()) {
         bool forceSilentBlock = true;
@@ -365,12 +401,58 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
         return;
     }
 
-    hrtf.render(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    // queue the render, to batch it with the other sources heard by this listener
+    _hrtfInputs.insert(_hrtfInputs.end(), _bufferSamples, _bufferSamples + AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    _hrtfSources.push_back({ &hrtf, nullptr, azimuth, distance, gain });
 
     ++stats.hrtfRenders;
 }
 
+void AudioMixerSlave::renderHRTFSources() {
+    for (size_t i = 0; i < _hrtfSources.size(); ++i) {
+        _hrtfSources[i].input = &_hrtfInputs[i * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    }
+
+    AudioHRTF::renderBatch(_hrtfSources.data(), (int)_hrtfSources.size(), _mixSamples, HRTF_DATASET_INDEX,
+                           AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+    _hrtfSources.clear();
+    _hrtfInputs.clear();
+}
+
+void AudioMixerSlave::encodeMix(AudioMixerClientData& listenerData, const QByteArray& decodedBuffer,
+        QByteArray& encodedBuffer, bool isFrameOfZeros) {
+    EncodedMix& lastEncoded = isFrameOfZeros ? _lastEncodedZeros : _lastEncodedMix;
+    const Encoder* encoder = listenerData.getEncoder();
+    bool isStateless = listenerData.isEncoderStateless();
+
+    // a stateless encoder encodes the same frame to the same bytes, so take them from the last listener that had it
+    if (isStateless && lastEncoded.isValid && lastEncoded.encoder == encoder && lastEncoded.decoded == decodedBuffer) {
+        encodedBuffer = lastEncoded.encoded;
+        listenerData.setShouldFlushEncoder(!isFrameOfZeros);
+        if (!lastEncoded.isShared) {
+            lastEncoded.isShared = true;
+            ++stats.encodeGroups;
+        }
+        ++stats.encodesSaved;
+        return;
+    }
+
+    if (isFrameOfZeros) {
+        listenerData.encodeFrameOfZeros(encodedBuffer);
+    } else {
+        listenerData.encode(decodedBuffer, encodedBuffer);
+    }
+
+    if (isStateless) {
+        lastEncoded.isValid = true;
+        lastEncoded.isShared = false;
+        lastEncoded.encoder = encoder;
+        lastEncoded.decoded = decodedBuffer;
+        lastEncoded.encoded = encodedBuffer;
+    }
+}
+
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec) {
     auto audioPacket = NLPacket::create(type, size);
     audioPacket->writePrimitive(sequence);
@@ -18,7 +18,9 @@
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
 #include <NodeList.h>
+#include <plugins/CodecPlugin.h>
 
+#include "AudioMixerSpatialIndex.h"
 #include "AudioMixerStats.h"
 
 class PositionalAudioStream;
@@ -33,8 +35,12 @@ public:
     // process packets for a given node (requires no configuration)
     void processPackets(const SharedNodePointer& node);
 
+    // decode the stream packets ingested on arrival for a given node (requires no configuration)
+    void decodePackets(const SharedNodePointer& node);
+
     // configure a round of mixing
-    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            const AudioMixerSpatialIndex* index);
 
     // mix and broadcast non-ignored streams to the node (requires configuration using configureMix, above)
     // returns true if a mixed packet was sent to the node
@@ -52,16 +58,40 @@ private:
     void addStream(AudioMixerClientData& listenerData, const QUuid& streamerID,
             const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer,
             bool throttle);
+    void renderHRTFSources();
+
+    // the last frame this slave encoded through a stateless encoder; it is kept per slave, so it needs no lock,
+    //   and listeners are mixed in the same order every frame, so those with the same frame tend to be mixed together
+    struct EncodedMix {
+        bool isValid { false };
+        bool isShared { false };
+        const Encoder* encoder { nullptr };
+        QByteArray decoded;
+        QByteArray encoded;
+    };
+    void encodeMix(AudioMixerClientData& listenerData, const QByteArray& decodedBuffer, QByteArray& encodedBuffer,
+            bool isFrameOfZeros);
+    // flushes of silence are kept apart, as they are the same from frame to frame
+    EncodedMix _lastEncodedMix;
+    EncodedMix _lastEncodedZeros;
 
     // mixing buffers
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
+    // HRTF renders queued for the current listener, rendered together by AudioHRTF::renderBatch
+    std::vector<AudioHRTF::Source> _hrtfSources;
+    std::vector<int16_t> _hrtfInputs;
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    const AudioMixerSpatialIndex* _index { nullptr };
+
+    // offsets (from _begin) of the nodes that may be audible to the current listener
+    std::vector<int> _candidates;
 };
 
 #endif // hifi_AudioMixerSlave_h
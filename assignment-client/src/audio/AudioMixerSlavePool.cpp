@@ -74,13 +74,21 @@ void AudioMixerSlavePool::processPackets(ConstIter begin, ConstIter end) {
     run(begin, end);
 }
 
-void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlavePool::decodePackets(ConstIter begin, ConstIter end) {
+    _function = &AudioMixerSlave::decodePackets;
+    _configure = [](AudioMixerSlave& slave) {};
+    run(begin, end);
+}
+
+void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        const AudioMixerSpatialIndex& index) {
     _function = &AudioMixerSlave::mix;
     _configure = [=](AudioMixerSlave& slave) {
-        slave.configureMix(_begin, _end, _frame, _throttlingRatio);
+        slave.configureMix(_begin, _end, _frame, _throttlingRatio, _index);
     };
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _index = &index;
 
     run(begin, end);
 }
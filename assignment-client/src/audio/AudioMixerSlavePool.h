@@ -64,8 +64,12 @@ public:
     // process packets on slave threads
     void processPackets(ConstIter begin, ConstIter end);
 
+    // decode ingested stream packets on slave threads
+    void decodePackets(ConstIter begin, ConstIter end);
+
     // mix on slave threads
-    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            const AudioMixerSpatialIndex& index);
 
     // iterate over all slaves
     void each(std::function<void(AudioMixerSlave& slave)> functor);
@@ -98,6 +102,7 @@ private:
     Queue _queue;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    const AudioMixerSpatialIndex* _index { nullptr };
     ConstIter _begin;
     ConstIter _end;
 };
@@ -0,0 +1,132 @@
+//
+//  AudioMixerSpatialIndex.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerSpatialIndex.h"
+
+#include <algorithm>
+
+#include <glm/gtx/norm.hpp>
+
+#include <AudioHelpers.h>
+#include <GLMHelpers.h>
+
+#include "AudioMixer.h"
+#include "AudioMixerClientData.h"
+#include "InjectedAudioStream.h"
+
+const float AudioMixerSpatialIndex::INAUDIBLE_GAIN = 0.001f;
+
+// cell coordinates are packed into 21 bits per axis
+static const int CELL_BITS = 21;
+static const int CELL_OFFSET = 1 << (CELL_BITS - 1);
+static const int CELL_MAX = CELL_OFFSET - 1;
+
+void AudioMixerSpatialIndex::build(ConstIter begin, ConstIter end) {
+    _entries.clear();
+    _numNodes = (int)std::distance(begin, end);
+
+    // gather every positioned stream, and the largest gain applied ahead of the distance attenuation
+    // (a listener's per-source gain adjustments are not: the sources it boosts are visited by the mix regardless)
+    float maxGain = 1.0f;
+    int index = 0;
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (nodeData) {
+            maxGain = std::max(maxGain, nodeData->getMasterAvatarGain());
+            for (auto& streamPair : nodeData->getAudioStreams()) {
+                auto& stream = streamPair.second;
+                if (stream->getType() == PositionalAudioStream::Injector) {
+                    auto injector = reinterpret_cast<const InjectedAudioStream*>(stream.get());
+                    maxGain = std::max(maxGain, injector->getAttenuationRatio());
+                }
+                if (stream->hasValidPosition()) {
+                    _entries.push_back({ 0, index, stream->getPosition() });
+                }
+            }
+        }
+        ++index;
+    });
+
+    _radius = computeAudibilityRadius(maxGain);
+    _isEnabled = _radius > 0.0f;
+    if (!_isEnabled) {
+        return;
+    }
+
+    // cells are the size of the radius, so a query spanning twice the radius touches at most 3 cells per axis
+    _cellScale = 1.0f / _radius;
+    for (auto& entry : _entries) {
+        entry.key = keyForCell(cellForPosition(entry.position));
+    }
+    std::sort(_entries.begin(), _entries.end());
+}
+
+void AudioMixerSpatialIndex::query(const glm::vec3& position, std::vector<int>& candidates) const {
+    candidates.clear();
+
+    if (!_isEnabled) {
+        candidates.reserve(_numNodes);
+        for (int i = 0; i < _numNodes; ++i) {
+            candidates.push_back(i);
+        }
+        return;
+    }
+
+    const float radiusSquared = _radius * _radius;
+    glm::ivec3 minCell = cellForPosition(position - glm::vec3(_radius));
+    glm::ivec3 maxCell = cellForPosition(position + glm::vec3(_radius));
+
+    glm::ivec3 cell;
+    for (cell.x = minCell.x; cell.x <= maxCell.x; ++cell.x) {
+        for (cell.y = minCell.y; cell.y <= maxCell.y; ++cell.y) {
+            for (cell.z = minCell.z; cell.z <= maxCell.z; ++cell.z) {
+                Entry key { keyForCell(cell), 0, glm::vec3() };
+                auto range = std::equal_range(_entries.cbegin(), _entries.cend(), key);
+                for (auto it = range.first; it != range.second; ++it) {
+                    if (glm::distance2(it->position, position) <= radiusSquared) {
+                        candidates.push_back(it->node);
+                    }
+                }
+            }
+        }
+    }
+
+    // a node with several streams may have been found more than once
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+float AudioMixerSpatialIndex::computeAudibilityRadius(float maxGain) const {
+    // find the weakest distance attenuation, as used by computeGain
+    float attenuation = AudioMixer::getAttenuationPerDoublingInDistance();
+    for (auto& zoneSetting : AudioMixer::getZoneSettings()) {
+        attenuation = std::min(attenuation, zoneSetting.coefficient);
+    }
+    float g = glm::clamp(1.0f - attenuation, EPSILON, 1.0f);
+    if (g >= 1.0f) {
+        // no falloff: everything is audible everywhere
+        return 0.0f;
+    }
+
+    // solve maxGain * g^log2(distance) = INAUDIBLE_GAIN for distance
+    float radius = fastExp2f(fastLog2f(INAUDIBLE_GAIN / maxGain) / fastLog2f(g));
+    return std::max(radius, 1.0f);
+}
+
+AudioMixerSpatialIndex::CellKey AudioMixerSpatialIndex::keyForCell(const glm::ivec3& cell) const {
+    return ((CellKey)(cell.x + CELL_OFFSET) << (2 * CELL_BITS)) |
+        ((CellKey)(cell.y + CELL_OFFSET) << CELL_BITS) |
+        (CellKey)(cell.z + CELL_OFFSET);
+}
+
+glm::ivec3 AudioMixerSpatialIndex::cellForPosition(const glm::vec3& position) const {
+    glm::vec3 cell = glm::clamp(glm::floor(position * _cellScale), glm::vec3(-CELL_MAX), glm::vec3(CELL_MAX));
+    return glm::ivec3(cell);
+}
@@ -0,0 +1,67 @@
+//
+//  AudioMixerSpatialIndex.h
+//  assignment-client/src/audio
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerSpatialIndex_h
+#define hifi_AudioMixerSpatialIndex_h
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <NodeList.h>
+
+// Uniform grid over the positions of all audio streams, rebuilt once per frame before mixing.
+//   Cells are sized to the audibility radius, so a listener only has to visit the (at most 27) cells
+//   around it to find every node with a stream loud enough to reach it.
+//   The index is built on the mixer thread and is read-only (and so thread-safe) while the slaves mix.
+class AudioMixerSpatialIndex {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    // gain under which a full-scale source is considered inaudible (-60dB)
+    static const float INAUDIBLE_GAIN;
+
+    // rebuild the index over the streams of all nodes in [begin, end)
+    void build(ConstIter begin, ConstIter end);
+
+    // fills candidates with the (sorted, unique) offsets from begin of the nodes that may be audible at position
+    // if the index is disabled, every node is a candidate
+    void query(const glm::vec3& position, std::vector<int>& candidates) const;
+
+    // the index is disabled when there is no distance attenuation (every stream is audible everywhere)
+    bool isEnabled() const { return _isEnabled; }
+    float getAudibilityRadius() const { return _radius; }
+    int getNumNodes() const { return _numNodes; }
+
+private:
+    using CellKey = uint64_t;
+
+    struct Entry {
+        CellKey key;
+        int node;
+        glm::vec3 position;
+
+        bool operator<(const Entry& other) const { return key < other.key; }
+    };
+
+    // returns 0 if there is no distance falloff
+    float computeAudibilityRadius(float maxGain) const;
+    CellKey keyForCell(const glm::ivec3& cell) const;
+    glm::ivec3 cellForPosition(const glm::vec3& position) const;
+
+    std::vector<Entry> _entries; // sorted by key, capacity is reused across frames
+    float _radius { 0.0f };
+    float _cellScale { 0.0f };
+    int _numNodes { 0 };
+    bool _isEnabled { false };
+};
+
+#endif // hifi_AudioMixerSpatialIndex_h
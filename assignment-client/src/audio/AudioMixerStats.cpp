@@ -11,6 +11,10 @@
 
 #include "AudioMixerStats.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
 void AudioMixerStats::reset() {
     sumStreams = 0;
     sumListeners = 0;
@@ -21,6 +25,15 @@ void AudioMixerStats::reset() {
     hrtfThrottleRenders = 0;
     manualStereoMixes = 0;
     manualEchoMixes = 0;
+    indexCandidates = 0;
+    indexPruned = 0;
+    encodesSaved = 0;
+    encodeGroups = 0;
+    decodedPackets = 0;
+    decodeDrains = 0;
+    sumDecodeQueueDepth = 0;
+    maxDecodeQueueDepth = 0;
+    std::fill(std::begin(decodeDelays), std::end(decodeDelays), 0);
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime = 0;
 #endif
@@ -36,7 +49,45 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     hrtfThrottleRenders += otherStats.hrtfThrottleRenders;
     manualStereoMixes += otherStats.manualStereoMixes;
     manualEchoMixes += otherStats.manualEchoMixes;
+    indexCandidates += otherStats.indexCandidates;
+    indexPruned += otherStats.indexPruned;
+    encodesSaved += otherStats.encodesSaved;
+    encodeGroups += otherStats.encodeGroups;
+    decodedPackets += otherStats.decodedPackets;
+    decodeDrains += otherStats.decodeDrains;
+    sumDecodeQueueDepth += otherStats.sumDecodeQueueDepth;
+    maxDecodeQueueDepth = std::max(maxDecodeQueueDepth, otherStats.maxDecodeQueueDepth);
+    for (int i = 0; i <= NUM_DECODE_DELAY_BUCKETS; i++) {
+        decodeDelays[i] += otherStats.decodeDelays[i];
+    }
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime += otherStats.mixTime;
 #endif
 }
+
+void AudioMixerStats::addDecodeQueueDepth(int depth) {
+    ++decodeDrains;
+    sumDecodeQueueDepth += depth;
+    maxDecodeQueueDepth = std::max(maxDecodeQueueDepth, depth);
+}
+
+void AudioMixerStats::addDecodeDelay(uint64_t usecs) {
+    ++decodedPackets;
+    ++decodeDelays[std::min(usecs / DECODE_DELAY_BUCKET_USECS, (uint64_t)NUM_DECODE_DELAY_BUCKETS)];
+}
+
+int AudioMixerStats::getDecodeDelayPercentile(float fraction) const {
+    if (decodedPackets == 0) {
+        return 0;
+    }
+
+    int target = (int)std::ceil(fraction * decodedPackets);
+    int count = 0;
+    for (int i = 0; i <= NUM_DECODE_DELAY_BUCKETS; i++) {
+        count += decodeDelays[i];
+        if (count >= target) {
+            return (i + 1) * DECODE_DELAY_BUCKET_USECS;
+        }
+    }
+    return 0;
+}
@@ -12,11 +12,13 @@
 #ifndef hifi_AudioMixerStats_h
 #define hifi_AudioMixerStats_h
 
-#ifdef HIFI_AUDIO_MIXER_DEBUG
 #include <cstdint>
-#endif
 
 struct AudioMixerStats {
+    // arrival-to-decode delays are counted in buckets, up to two frames (and one bucket for anything longer)
+    static const int DECODE_DELAY_BUCKET_USECS = 200;
+    static const int NUM_DECODE_DELAY_BUCKETS = 100;
+
     int sumStreams { 0 };
     int sumListeners { 0 };
     int sumListenersSilent { 0 };
@@ -30,12 +32,33 @@ struct AudioMixerStats {
     int manualStereoMixes { 0 };
     int manualEchoMixes { 0 };
 
+    // listener-node pairs visited / skipped using the audibility index
+    int indexCandidates { 0 };
+    int indexPruned { 0 };
+
+    // listeners that reused the encoded frame of the listener before them, and the encoded frames that were reused
+    int encodesSaved { 0 };
+    int encodeGroups { 0 };
+
+    // stream packets decoded, and the depth of the client queues they were decoded from
+    int decodedPackets { 0 };
+    int decodeDrains { 0 };
+    int sumDecodeQueueDepth { 0 };
+    int maxDecodeQueueDepth { 0 };
+    int decodeDelays[NUM_DECODE_DELAY_BUCKETS + 1] {};
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     uint64_t mixTime { 0 };
 #endif
 
     void reset();
     void accumulate(const AudioMixerStats& otherStats);
+
+    void addDecodeQueueDepth(int depth);
+    void addDecodeDelay(uint64_t usecs);
+
+    // the delay (rounded up to its bucket) that the given fraction of decoded packets were decoded within
+    int getDecodeDelayPercentile(float fraction) const;
 };
 
 #endif // hifi_AudioMixerStats_h
@@ -0,0 +1,85 @@
+//
+//  AvatarEncodeCache.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarEncodeCache.h"
+
+const AvatarEncodeCache::BaselineToken AvatarEncodeCache::UNKNOWN_BASELINE;
+
+AvatarEncodeCache::Key::Key(const QUuid& avatarID, AvatarData::AvatarDataDetail detail, float minRotationDOT,
+                            AvatarDataPacket::HasFlags changedFlags, BaselineToken baseline, int baselineSize) :
+    avatarID(avatarID),
+    detail(detail),
+    minRotationDOT(0.0f),
+    changedFlags(changedFlags),
+    baseline(UNKNOWN_BASELINE),
+    baselineSize(0)
+{
+    // only culling depends on the distance and the joints last sent, leave them out otherwise so more encodes match
+    if (detail == AvatarData::CullSmallData) {
+        this->minRotationDOT = minRotationDOT;
+        this->baseline = baseline;
+        this->baselineSize = baselineSize;
+    }
+}
+
+bool AvatarEncodeCache::Key::operator==(const Key& other) const {
+    return avatarID == other.avatarID && detail == other.detail && minRotationDOT == other.minRotationDOT &&
+        changedFlags == other.changedFlags && baseline == other.baseline && baselineSize == other.baselineSize;
+}
+
+size_t AvatarEncodeCache::KeyHasher::operator()(const Key& key) const {
+    size_t hash = qHash(key.avatarID);
+    hash = hash * 31 + (size_t)key.detail;
+    hash = hash * 31 + (size_t)key.changedFlags;
+    hash = hash * 31 + std::hash<BaselineToken>()(key.baseline);
+    hash = hash * 31 + std::hash<float>()(key.minRotationDOT);
+    return hash;
+}
+
+AvatarEncodeCache::Shard& AvatarEncodeCache::shardFor(const Key& key) {
+    return _shards[qHash(key.avatarID) % NUM_SHARDS];
+}
+
+const AvatarEncodeCache::Shard& AvatarEncodeCache::shardFor(const Key& key) const {
+    return _shards[qHash(key.avatarID) % NUM_SHARDS];
+}
+
+void AvatarEncodeCache::clear() {
+    for (auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.encodes.clear();
+    }
+}
+
+AvatarEncodeCache::EncodePointer AvatarEncodeCache::find(const Key& key) const {
+    if (!isCacheable(key)) {
+        return EncodePointer();
+    }
+
+    auto& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.encodes.find(key);
+    return it != shard.encodes.end() ? it->second : EncodePointer();
+}
+
+AvatarEncodeCache::EncodePointer AvatarEncodeCache::insert(const Key& key, Encode&& encode) {
+    encode.sentBaseline = _nextBaseline++;
+    auto encodePointer = std::make_shared<const Encode>(std::move(encode));
+
+    if (isCacheable(key)) {
+        auto& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // another slave may have encoded the same avatar for the same inputs in the meantime, keep the first
+        auto result = shard.encodes.emplace(key, encodePointer);
+        return result.first->second;
+    }
+    return encodePointer;
+}
@@ -0,0 +1,89 @@
+//
+//  AvatarEncodeCache.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarEncodeCache_h
+#define hifi_AvatarEncodeCache_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <AvatarData.h>
+
+// Encodes of avatar data shared by the slaves during a broadcast frame.
+//   An avatar doesn't change while it is broadcast, so its encode for a receiver only depends on the detail level,
+//   the distance level of the receiver (which sets how small a joint rotation change is culled), which sections of
+//   the avatar changed since the receiver was last sent an update, and the joints the receiver was last sent (its
+//   baseline). Receivers with the same inputs get the same bytes, so the first encode is reused by the others.
+//   Baselines are identified by a token handed out with each encode: receivers sent the same encode share a baseline.
+//   Thread-safe.
+class AvatarEncodeCache {
+public:
+    using BaselineToken = uint64_t;
+    static const BaselineToken UNKNOWN_BASELINE = 0;
+
+    class Key {
+    public:
+        Key(const QUuid& avatarID, AvatarData::AvatarDataDetail detail, float minRotationDOT,
+            AvatarDataPacket::HasFlags changedFlags, BaselineToken baseline, int baselineSize);
+
+        bool operator==(const Key& other) const;
+
+        QUuid avatarID;
+        AvatarData::AvatarDataDetail detail;
+        float minRotationDOT;
+        AvatarDataPacket::HasFlags changedFlags;
+        BaselineToken baseline;
+        int baselineSize;
+    };
+
+    class Encode {
+    public:
+        QByteArray bytes;
+        AvatarDataPacket::HasFlags hasFlags { 0 };
+        bool isIncluded { true }; // false if it didn't fit, even with the minimum data
+        bool updatesBaseline { true };
+        QVector<JointData> sentJoints; // the new baseline of the receiver
+        BaselineToken sentBaseline { UNKNOWN_BASELINE };
+    };
+    using EncodePointer = std::shared_ptr<const Encode>;
+
+    // a key that can't be looked up, its encode depends on a baseline that isn't shared
+    static bool isCacheable(const Key& key) { return key.detail != AvatarData::CullSmallData || key.baseline != UNKNOWN_BASELINE; }
+
+    // drops the encodes of the last frame, called before each broadcast
+    void clear();
+
+    EncodePointer find(const Key& key) const;
+
+    // gives the encode a new baseline token, and shares it if the key is cacheable
+    EncodePointer insert(const Key& key, Encode&& encode);
+
+private:
+    struct KeyHasher {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, EncodePointer, KeyHasher> encodes;
+    };
+
+    static const int NUM_SHARDS = 16;
+
+    Shard& shardFor(const Key& key);
+    const Shard& shardFor(const Key& key) const;
+
+    Shard _shards[NUM_SHARDS];
+    std::atomic<BaselineToken> _nextBaseline { UNKNOWN_BASELINE + 1 };
+};
+
+#endif // hifi_AvatarEncodeCache_h
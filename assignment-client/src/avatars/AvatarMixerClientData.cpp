@@ -33,6 +33,11 @@ uint64_t AvatarMixerClientData::getLastOtherAvatarEncodeTime(QUuid otherAvatar)
     return 0;
 }
 
+AvatarEncodeCache::BaselineToken AvatarMixerClientData::getLastOtherAvatarSentJointsBaseline(const QUuid& otherAvatar) const {
+    auto it = _lastOtherAvatarSentJointsBaseline.find(otherAvatar);
+    return it != _lastOtherAvatarSentJointsBaseline.end() ? it->second : AvatarEncodeCache::UNKNOWN_BASELINE;
+}
+
 void AvatarMixerClientData::setLastOtherAvatarEncodeTime(const QUuid& otherAvatar, uint64_t time) {
     std::unordered_map<QUuid, uint64_t>::iterator itr = _lastOtherAvatarEncodeTime.find(otherAvatar);
     if (itr != _lastOtherAvatarEncodeTime.end()) {
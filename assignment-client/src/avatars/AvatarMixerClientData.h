@@ -30,6 +30,8 @@
 #include <UUIDHasher.h>
 #include <ViewFrustum.h>
 
+#include "AvatarEncodeCache.h"
+
 const QString OUTBOUND_AVATAR_DATA_STATS_KEY = "outbound_av_data_kbps";
 const QString INBOUND_AVATAR_DATA_STATS_KEY = "inbound_av_data_kbps";
 
@@ -121,6 +123,12 @@ public:
         return lastOtherAvatarSentJoints;
     }
 
+    // identifies the joints last sent for the other avatar, so encodes can be shared with the receivers sent the same
+    AvatarEncodeCache::BaselineToken getLastOtherAvatarSentJointsBaseline(const QUuid& otherAvatar) const;
+    void setLastOtherAvatarSentJointsBaseline(const QUuid& otherAvatar, AvatarEncodeCache::BaselineToken baseline) {
+        _lastOtherAvatarSentJointsBaseline[otherAvatar] = baseline;
+    }
+
     void queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
     int processPackets(); // returns number of packets processed
 
@@ -140,6 +148,7 @@ private:
     // sending to "this" node
     std::unordered_map<QUuid, uint64_t> _lastOtherAvatarEncodeTime;
     std::unordered_map<QUuid, QVector<JointData>> _lastOtherAvatarSentJoints;
+    std::unordered_map<QUuid, AvatarEncodeCache::BaselineToken> _lastOtherAvatarSentJointsBaseline;
 
     uint64_t _identityChangeTimestamp;
     bool _avatarSessionDisplayNameMustChange{ true };
@@ -40,12 +40,13 @@ void AvatarMixerSlave::configure(ConstIter begin, ConstIter end) {
 
 void AvatarMixerSlave::configureBroadcast(ConstIter begin, ConstIter end, 
                                 p_high_resolution_clock::time_point lastFrameTimestamp,
-                                float maxKbpsPerNode, float throttlingRatio) {
+                                float maxKbpsPerNode, float throttlingRatio, AvatarEncodeCache* encodeCache) {
     _begin = begin;
     _end = end;
     _lastFrameTimestamp = lastFrameTimestamp;
     _maxKbpsPerNode = maxKbpsPerNode;
     _throttlingRatio = throttlingRatio;
+    _encodeCache = encodeCache;
 }
 
 void AvatarMixerSlave::harvestStats(AvatarMixerSlaveStats& stats) {
@@ -378,39 +379,47 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             nodeData->incrementAvatarInView();
         }
 
-        bool includeThisAvatar = true;
         auto lastEncodeForOther = nodeData->getLastOtherAvatarEncodeTime(otherNode->getUUID());
         QVector<JointData>& lastSentJointsForOther = nodeData->getLastOtherAvatarSentJoints(otherNode->getUUID());
-        bool distanceAdjust = true;
         glm::vec3 viewerPosition = myPosition;
-        AvatarDataPacket::HasFlags hasFlagsOut; // the result of the toByteArray
-        bool dropFaceTracking = false;
 
         quint64 start = usecTimestampNow();
-        QByteArray bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                                                    hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
-        quint64 end = usecTimestampNow();
-        _stats.toByteArrayElapsedTime += (end - start);
-
-        static const int MAX_ALLOWED_AVATAR_DATA = (1400 - NUM_BYTES_RFC4122_UUID);
-        if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
-            qCWarning(avatars) << "otherAvatar.toByteArray() resulted in very large buffer:" << bytes.size() << "... attempt to drop facial data";
-
-            dropFaceTracking = true; // first try dropping the facial data
+        QByteArray bytes;
+        bool includeThisAvatar = true;
+        if (detail == AvatarData::NoData) {
+            // just the flags, all set to nothing
+            AvatarDataPacket::HasFlags hasFlagsOut;
             bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                                             hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
-
-            if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
-                qCWarning(avatars) << "otherAvatar.toByteArray() without facial data resulted in very large buffer:" << bytes.size() << "... reduce to MinimumData";
-                bytes = otherAvatar->toByteArray(AvatarData::MinimumData, lastEncodeForOther, lastSentJointsForOther,
-                                                 hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+                                             hasFlagsOut, false, true, viewerPosition, &lastSentJointsForOther);
+        } else {
+            // receivers with the same inputs get the same bytes, so share the encodes with the other slaves
+            AvatarEncodeCache::Key key(otherNode->getUUID(), detail, otherAvatar->getDistanceBasedMinRotationDOT(viewerPosition),
+                                       otherAvatar->getChangedSinceFlags(lastEncodeForOther),
+                                       nodeData->getLastOtherAvatarSentJointsBaseline(otherNode->getUUID()),
+                                       lastSentJointsForOther.size());
+
+            AvatarEncodeCache::EncodePointer encode;
+            if (_encodeCache) {
+                encode = _encodeCache->find(key);
+            }
+            if (encode) {
+                _stats.numEncodeCacheHits++;
+            } else {
+                _stats.numEncodeCacheMisses++;
+                auto newEncode = encodeAvatarData(otherAvatar, detail, lastEncodeForOther, lastSentJointsForOther, viewerPosition);
+                encode = _encodeCache ? _encodeCache->insert(key, std::move(newEncode))
+                                      : std::make_shared<const AvatarEncodeCache::Encode>(std::move(newEncode));
+            }
 
-                if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
-                    qCWarning(avatars) << "otherAvatar.toByteArray() MinimumData resulted in very large buffer:" << bytes.size() << "... FAIL!!";
-                    includeThisAvatar = false;
-                }
+            bytes = encode->bytes;
+            includeThisAvatar = encode->isIncluded;
+            if (encode->updatesBaseline) {
+                lastSentJointsForOther = encode->sentJoints; // implicitly shared with the other receivers
+                nodeData->setLastOtherAvatarSentJointsBaseline(otherNode->getUUID(), encode->sentBaseline);
             }
         }
+        quint64 end = usecTimestampNow();
+        _stats.toByteArrayElapsedTime += (end - start);
 
         if (includeThisAvatar) {
             numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
@@ -462,6 +471,45 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
 uint64_t REBROADCAST_IDENTITY_TO_DOWNSTREAM_EVERY_US = 5 * 1000 * 1000;
 
+AvatarEncodeCache::Encode AvatarMixerSlave::encodeAvatarData(const AvatarData* otherAvatar, AvatarData::AvatarDataDetail detail,
+                                                             quint64 lastEncodeForOther,
+                                                             const QVector<JointData>& lastSentJointsForOther,
+                                                             glm::vec3 viewerPosition) {
+    AvatarEncodeCache::Encode encode;
+    encode.sentJoints = lastSentJointsForOther;
+
+    // without joint data the joints last sent stay as they are
+    encode.updatesBaseline = (detail != AvatarData::MinimumData && detail != AvatarData::PALMinimum);
+
+    bool distanceAdjust = true;
+    bool dropFaceTracking = false;
+
+    encode.bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, encode.sentJoints,
+                                            encode.hasFlags, dropFaceTracking, distanceAdjust, viewerPosition, &encode.sentJoints);
+
+    static const int MAX_ALLOWED_AVATAR_DATA = (1400 - NUM_BYTES_RFC4122_UUID);
+    if (encode.bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
+        qCWarning(avatars) << "otherAvatar.toByteArray() resulted in very large buffer:" << encode.bytes.size() << "... attempt to drop facial data";
+
+        dropFaceTracking = true; // first try dropping the facial data
+        encode.bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, encode.sentJoints,
+                                                encode.hasFlags, dropFaceTracking, distanceAdjust, viewerPosition, &encode.sentJoints);
+
+        if (encode.bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
+            qCWarning(avatars) << "otherAvatar.toByteArray() without facial data resulted in very large buffer:" << encode.bytes.size() << "... reduce to MinimumData";
+            encode.bytes = otherAvatar->toByteArray(AvatarData::MinimumData, lastEncodeForOther, encode.sentJoints,
+                                                    encode.hasFlags, dropFaceTracking, distanceAdjust, viewerPosition, &encode.sentJoints);
+
+            if (encode.bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
+                qCWarning(avatars) << "otherAvatar.toByteArray() MinimumData resulted in very large buffer:" << encode.bytes.size() << "... FAIL!!";
+                encode.isIncluded = false;
+            }
+        }
+    }
+
+    return encode;
+}
+
 void AvatarMixerSlave::broadcastAvatarDataToDownstreamMixer(const SharedNodePointer& node) {
     _stats.downstreamMixersBroadcastedTo++;
 
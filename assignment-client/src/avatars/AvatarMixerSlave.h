@@ -12,6 +12,8 @@
 #ifndef hifi_AvatarMixerSlave_h
 #define hifi_AvatarMixerSlave_h
 
+#include "AvatarEncodeCache.h"
+
 class AvatarMixerClientData;
 
 class AvatarMixerSlaveStats {
@@ -32,6 +34,8 @@ public:
     quint64 avatarDataPackingElapsedTime { 0 };
     quint64 packetSendingElapsedTime { 0 };
     quint64 toByteArrayElapsedTime { 0 };
+    int numEncodeCacheHits { 0 };
+    int numEncodeCacheMisses { 0 };
     quint64 jobElapsedTime { 0 };
 
     void reset() {
@@ -53,6 +57,8 @@ public:
         avatarDataPackingElapsedTime = 0;
         packetSendingElapsedTime = 0;
         toByteArrayElapsedTime = 0;
+        numEncodeCacheHits = 0;
+        numEncodeCacheMisses = 0;
         jobElapsedTime = 0;
     }
 
@@ -73,6 +79,8 @@ public:
         avatarDataPackingElapsedTime += rhs.avatarDataPackingElapsedTime;
         packetSendingElapsedTime += rhs.packetSendingElapsedTime;
         toByteArrayElapsedTime += rhs.toByteArrayElapsedTime;
+        numEncodeCacheHits += rhs.numEncodeCacheHits;
+        numEncodeCacheMisses += rhs.numEncodeCacheMisses;
         jobElapsedTime += rhs.jobElapsedTime;
         return *this;
     }
@@ -86,7 +94,7 @@ public:
     void configure(ConstIter begin, ConstIter end);
     void configureBroadcast(ConstIter begin, ConstIter end, 
                     p_high_resolution_clock::time_point lastFrameTimestamp, 
-                    float maxKbpsPerNode, float throttlingRatio);
+                    float maxKbpsPerNode, float throttlingRatio, AvatarEncodeCache* encodeCache);
 
     void processIncomingPackets(const SharedNodePointer& node);
     void broadcastAvatarData(const SharedNodePointer& node);
@@ -100,6 +108,11 @@ private:
     void broadcastAvatarDataToAgent(const SharedNodePointer& node);
     void broadcastAvatarDataToDownstreamMixer(const SharedNodePointer& node);
 
+    // encodes otherAvatar for a receiver, dropping data until it fits in a packet
+    AvatarEncodeCache::Encode encodeAvatarData(const AvatarData* otherAvatar, AvatarData::AvatarDataDetail detail,
+                                               quint64 lastEncodeForOther, const QVector<JointData>& lastSentJointsForOther,
+                                               glm::vec3 viewerPosition);
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
@@ -107,6 +120,7 @@ private:
     p_high_resolution_clock::time_point _lastFrameTimestamp;
     float _maxKbpsPerNode { 0.0f };
     float _throttlingRatio { 0.0f };
+    AvatarEncodeCache* _encodeCache { nullptr };
 
     AvatarMixerSlaveStats _stats;
 };
@@ -98,6 +98,8 @@ private:
     Queue _queue;
     ConstIter _begin;
     ConstIter _end;
+
+    AvatarEncodeCache _encodeCache; // shared by the slaves, cleared every broadcast
 };
 
 #endif // hifi_AvatarMixerSlavePool_h
@@ -395,6 +395,19 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    // display how often viewers are sent an entity encoded for another viewer
+    quint64 encodeCacheHits, encodeCacheMisses, encodeCacheBytesReused;
+    EntityItem::getEncodeCacheStats(encodeCacheHits, encodeCacheMisses, encodeCacheBytesReused);
+    quint64 entitiesEncoded = encodeCacheHits + encodeCacheMisses;
+    float encodeCacheHitRate = entitiesEncoded > 0 ? (float)encodeCacheHits / (float)entitiesEncoded : 0.0f;
+
+    statsString += "<b>Entity Server Encode Cache Statistics</b>\r\n";
+    statsString += QString(" Entities encoded... %1\r\n").arg(locale.toString((qulonglong)entitiesEncoded));
+    statsString += QString("Copied from cache... %1 (%2%)\r\n").arg(locale.toString((qulonglong)encodeCacheHits))
+        .arg(locale.toString(encodeCacheHitRate * 100.0f, 'f', 2));
+    statsString += QString("     Bytes reused... %1 bytes\r\n").arg(locale.toString((qulonglong)encodeCacheBytesReused));
+    statsString += "\r\n\r\n";
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
@@ -26,14 +26,16 @@ EntityTreeSendThread::EntityTreeSendThread(OctreeServer* myServer, const SharedN
 
     // connect to connection ID change on EntityNodeData so we can clear state for this receiver
     auto nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
-    connect(nodeData, &EntityNodeData::incomingConnectionIDChanged, this, &EntityTreeSendThread::resetState);
+    connect(nodeData, &EntityNodeData::incomingConnectionIDChanged, this, &EntityTreeSendThread::resetState, Qt::QueuedConnection);
 }
 
 void EntityTreeSendThread::resetState() {
-    qCDebug(entities) << "Clearing known EntityTreeSendThread state for" << _nodeUuid;
+    runBeforeNextPass([this] {
+        qCDebug(entities) << "Clearing known EntityTreeSendThread state for" << _nodeUuid;
 
-    _knownState.clear();
-    _traversal.reset();
+        _knownState.clear();
+        _traversal.reset();
+    });
 }
 
 void EntityTreeSendThread::preDistributionProcessing() {
@@ -497,23 +499,27 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
 
 void EntityTreeSendThread::editingEntityPointer(const EntityItemPointer& entity) {
     if (entity) {
-        if (_entitiesInQueue.find(entity.get()) == _entitiesInQueue.end() && _knownState.find(entity.get()) != _knownState.end()) {
-            bool success = false;
-            AACube cube = entity->getQueryAACube(success);
-            if (success) {
-                // We can force a removal from _knownState if the current view is used and entity is out of view
-                if (_traversal.doesCurrentUseViewFrustum() && !_traversal.getCurrentView().cubeIntersectsKeyhole(cube)) {
-                    _sendQueue.push(PrioritizedEntity(entity, PrioritizedEntity::FORCE_REMOVE, true));
+        runBeforeNextPass([this, entity] {
+            if (_entitiesInQueue.find(entity.get()) == _entitiesInQueue.end() && _knownState.find(entity.get()) != _knownState.end()) {
+                bool success = false;
+                AACube cube = entity->getQueryAACube(success);
+                if (success) {
+                    // We can force a removal from _knownState if the current view is used and entity is out of view
+                    if (_traversal.doesCurrentUseViewFrustum() && !_traversal.getCurrentView().cubeIntersectsKeyhole(cube)) {
+                        _sendQueue.push(PrioritizedEntity(entity, PrioritizedEntity::FORCE_REMOVE, true));
+                        _entitiesInQueue.insert(entity.get());
+                    }
+                } else {
+                    _sendQueue.push(PrioritizedEntity(entity, PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY, true));
                     _entitiesInQueue.insert(entity.get());
                 }
-            } else {
-                _sendQueue.push(PrioritizedEntity(entity, PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY, true));
-                _entitiesInQueue.insert(entity.get());
             }
-        }
+        });
     }
 }
 
 void EntityTreeSendThread::deletingEntityPointer(EntityItem* entity) {
-    _knownState.erase(entity);
+    runBeforeNextPass([this, entity] {
+        _knownState.erase(entity);
+    });
 }
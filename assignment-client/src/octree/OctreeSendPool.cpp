@@ -0,0 +1,157 @@
+//
+//  OctreeSendPool.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeSendPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <SharedUtil.h>
+
+#include "OctreeSendThread.h"
+#include "OctreeServerConsts.h"
+
+void OctreeSendWorker::run() {
+    _pool.run();
+}
+
+OctreeSendPool::OctreeSendPool(int numThreads) {
+    numThreads = std::max(numThreads, 1);
+    _latencySamples.reserve(NUM_LATENCY_SAMPLES);
+
+    for (int i = 0; i < numThreads; ++i) {
+        auto worker = new OctreeSendWorker(*this);
+        worker->setObjectName(QString("Octree Send Pool %1").arg(i));
+        worker->start();
+        _workers.emplace_back(worker);
+    }
+}
+
+OctreeSendPool::~OctreeSendPool() {
+    {
+        Lock lock(_mutex);
+        _stop = true;
+    }
+    _workCondition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker->wait();
+    }
+}
+
+void OctreeSendPool::add(OctreeSendThread* sendThread) {
+    {
+        Lock lock(_mutex);
+        quint64 registration = _nextRegistration++;
+        _registrations[sendThread] = registration;
+        _queue.push({ usecTimestampNow(), sendThread, registration });
+    }
+    _workCondition.notify_one();
+}
+
+void OctreeSendPool::remove(OctreeSendThread* sendThread) {
+    Lock lock(_mutex);
+
+    // any queued task for this thread is dropped when it is popped
+    _registrations.erase(sendThread);
+
+    _idleCondition.wait(lock, [&] {
+        return _running.find(sendThread) == _running.end();
+    });
+}
+
+quint64 OctreeSendPool::getLatencyPercentile(float percentile) {
+    std::vector<quint64> samples;
+    {
+        Lock lock(_mutex);
+        samples = _latencySamples;
+    }
+
+    if (samples.empty()) {
+        return 0;
+    }
+
+    auto nth = samples.begin() + (size_t)(std::min(std::max(percentile, 0.0f), 1.0f) * (samples.size() - 1));
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+bool OctreeSendPool::isRegistered(const Task& task) const {
+    auto it = _registrations.find(task.sendThread);
+    return it != _registrations.end() && it->second == task.registration;
+}
+
+void OctreeSendPool::trackLatency(quint64 latency) {
+    if ((int)_latencySamples.size() < NUM_LATENCY_SAMPLES) {
+        _latencySamples.push_back(latency);
+    } else {
+        _latencySamples[_nextLatencySample] = latency;
+    }
+    _nextLatencySample = (_nextLatencySample + 1) % NUM_LATENCY_SAMPLES;
+}
+
+void OctreeSendPool::run() {
+    Lock lock(_mutex);
+
+    while (!_stop) {
+        if (_queue.empty()) {
+            _workCondition.wait(lock);
+            continue;
+        }
+
+        Task task = _queue.top();
+        if (!isRegistered(task)) {
+            // the send thread was removed since this task was queued
+            _queue.pop();
+            continue;
+        }
+
+        quint64 now = usecTimestampNow();
+        if (task.deadline > now) {
+            // sleep until the earliest client is due, or until an earlier one is added
+            _workCondition.wait_for(lock, std::chrono::microseconds(task.deadline - now));
+            continue;
+        }
+        _queue.pop();
+
+        // let another worker pick up the next client
+        if (!_queue.empty()) {
+            _workCondition.notify_one();
+        }
+
+        OctreeSendThread* sendThread = task.sendThread;
+        _running.insert(sendThread);
+        lock.unlock();
+
+        bool keepRunning = sendThread->processPooled();
+        quint64 end = usecTimestampNow();
+
+        lock.lock();
+        trackLatency(end - task.deadline);
+
+        if (isRegistered(task)) {
+            if (keepRunning) {
+                // the client is due again one interval after this pass started, or now if it overran
+                task.deadline = std::max(now + OCTREE_SEND_INTERVAL_USECS, end);
+                _queue.push(task);
+            } else {
+                // the client is gone, let the server know so it can release the send thread
+                // (it is still marked as running, so it can not be removed and deleted under us)
+                _registrations.erase(sendThread);
+                lock.unlock();
+                emit sendThread->finished();
+                lock.lock();
+            }
+        }
+
+        _running.erase(sendThread);
+        _idleCondition.notify_all();
+    }
+}
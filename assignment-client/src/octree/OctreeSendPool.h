@@ -0,0 +1,95 @@
+//
+//  OctreeSendPool.h
+//  assignment-client/src/octree
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Fixed-size pool of threads that runs the send passes of every pooled OctreeSendThread
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendPool_h
+#define hifi_OctreeSendPool_h
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <QThread>
+
+class OctreeSendPool;
+class OctreeSendThread;
+
+class OctreeSendWorker : public QThread {
+    Q_OBJECT
+public:
+    OctreeSendWorker(OctreeSendPool& pool) : _pool(pool) {}
+
+    void run() override final;
+
+private:
+    OctreeSendPool& _pool;
+};
+
+// Runs OctreeSendThread passes as tasks on a fixed number of threads, instead of one thread per client.
+//   Clients are served earliest-deadline-first: each is due again one send interval after its last pass started,
+//   or when it ended if the pass overran its interval, so an expensive client cannot starve the others.
+//   add/remove must be called from the thread that owns the send threads.
+class OctreeSendPool {
+public:
+    OctreeSendPool(int numThreads = QThread::idealThreadCount());
+    ~OctreeSendPool();
+
+    // sendThread must have been initialized as non-threaded
+    void add(OctreeSendThread* sendThread);
+
+    // blocks until sendThread is no longer being processed, it is safe to delete after this returns
+    void remove(OctreeSendThread* sendThread);
+
+    int numThreads() const { return (int)_workers.size(); }
+
+    // percentile (in [0, 1]) of the latency between a client's pass being due and completing, in usecs
+    quint64 getLatencyPercentile(float percentile);
+
+private:
+    friend class OctreeSendWorker;
+
+    struct Task {
+        quint64 deadline;
+        OctreeSendThread* sendThread;
+        quint64 registration;
+
+        bool operator>(const Task& other) const { return deadline > other.deadline; }
+    };
+
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+    using TaskQueue = std::priority_queue<Task, std::vector<Task>, std::greater<Task>>;
+
+    void run();
+    bool isRegistered(const Task& task) const;
+    void trackLatency(quint64 latency);
+
+    std::vector<std::unique_ptr<OctreeSendWorker>> _workers;
+
+    Mutex _mutex;
+    std::condition_variable _workCondition;
+    std::condition_variable _idleCondition;
+    TaskQueue _queue; // guarded by _mutex
+    std::unordered_map<OctreeSendThread*, quint64> _registrations; // guarded by _mutex
+    std::unordered_set<OctreeSendThread*> _running; // guarded by _mutex
+    quint64 _nextRegistration { 1 }; // guarded by _mutex
+    bool _stop { false }; // guarded by _mutex
+
+    static const int NUM_LATENCY_SAMPLES = 1024;
+    std::vector<quint64> _latencySamples; // guarded by _mutex
+    int _nextLatencySample { 0 }; // guarded by _mutex
+};
+
+#endif // hifi_OctreeSendPool_h
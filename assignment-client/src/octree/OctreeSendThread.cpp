@@ -74,6 +74,15 @@ bool OctreeSendThread::process() {
 
     quint64  start = usecTimestampNow();
 
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        tasks.swap(_tasks);
+    }
+    for (auto& task : tasks) {
+        task();
+    }
+
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
 
@@ -101,7 +110,8 @@ bool OctreeSendThread::process() {
     }
 
     // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
+    // (when pooled, the OctreeSendPool schedules our next pass instead)
+    if (isStillRunning() && isThreaded()) {
         // dynamically sleep until we need to fire off the next set of octree elements
         int elapsed = (usecTimestampNow() - start);
         int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
@@ -121,6 +131,15 @@ bool OctreeSendThread::process() {
     return isStillRunning();  // keep running till they terminate us
 }
 
+bool OctreeSendThread::processPooled() {
+    return process();
+}
+
+void OctreeSendThread::runBeforeNextPass(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(_tasksMutex);
+    _tasks.push_back(std::move(task));
+}
+
 AtomicUIntStat OctreeSendThread::_usleepTime { 0 };
 AtomicUIntStat OctreeSendThread::_usleepCalls { 0 };
 AtomicUIntStat OctreeSendThread::_totalBytes { 0 };
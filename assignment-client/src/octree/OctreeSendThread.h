@@ -15,6 +15,9 @@
 #define hifi_OctreeSendThread_h
 
 #include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
 
 #include <GenericThread.h>
 #include <Node.h>
@@ -38,6 +41,10 @@ public:
 
     QUuid getNodeUuid() const { return _nodeUuid; }
 
+    /// Runs a single send pass when this thread is driven by an OctreeSendPool (initialized non-threaded).
+    /// Returns false once the client is gone.
+    bool processPooled();
+
     static AtomicUIntStat _totalBytes;
     static AtomicUIntStat _totalWastedBytes;
     static AtomicUIntStat _totalPackets;
@@ -52,6 +59,10 @@ protected:
     /// Implements generic processing behavior for this thread.
     virtual bool process() override;
 
+    /// Runs task at the start of the next send pass, on the thread running it. Slots that change the send state
+    /// go through this, as when pooled they are delivered on the server thread, which must not wait for a pass to end.
+    void runBeforeNextPass(std::function<void()> task);
+
     virtual void traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
             bool viewFrustumChanged, bool isFullScene);
     virtual bool traverseTreeAndBuildNextPacketPayload(EncodeBitstreamParams& params, const QJsonObject& jsonFilters);
@@ -76,6 +87,9 @@ private:
     int _trueBytesSent { 0 }; // available for debug stats
     int _packetsSentThisInterval { 0 }; // used for bandwidth throttle condition
     bool _isShuttingDown { false };
+
+    std::mutex _tasksMutex;
+    std::vector<std::function<void()>> _tasks; // guarded by _tasksMutex
 };
 
 #endif // hifi_OctreeSendThread_h
@@ -442,6 +442,18 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("      writeDatagram() last second: %1 clients\r\n\r\n")
             .arg(locale.toString((uint)howManyThreadsDidCallWriteDatagram(oneSecondAgo)).rightJustified(COLUMN_WIDTH, ' '));
 
+        statsString += QString("                     Send threads: %1 threads\r\n")
+            .arg(locale.toString((uint)getSendThreadCount()).rightJustified(COLUMN_WIDTH, ' '));
+        if (_sendPool) {
+            statsString += QString("     Send latency 50th percentile: %1 usecs\r\n")
+                .arg(locale.toString(_sendPool->getLatencyPercentile(0.50f)).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("     Send latency 95th percentile: %1 usecs\r\n")
+                .arg(locale.toString(_sendPool->getLatencyPercentile(0.95f)).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("     Send latency 99th percentile: %1 usecs\r\n")
+                .arg(locale.toString(_sendPool->getLatencyPercentile(0.99f)).rightJustified(COLUMN_WIDTH, ' '));
+        }
+        statsString += "\r\n";
+
         float averageLoopTime = getAverageLoopTime();
         statsString += QString().sprintf("           Average packetLoop() time:      %7.2f msecs"
                                          "                 samples: %12d \r\n",
@@ -885,14 +897,35 @@ OctreeServer::UniqueSendThread OctreeServer::createSendThread(const SharedNodePo
 
     // we want to be notified when the thread finishes
     connect(sendThread.get(), &GenericThread::finished, this, &OctreeServer::removeSendThread);
-    sendThread->initialize(true);
+
+    if (_wantSendPool) {
+        if (!_sendPool) {
+            int numThreads = _sendPoolSize > 0 ? _sendPoolSize : QThread::idealThreadCount();
+            _sendPool.reset(new OctreeSendPool(numThreads));
+            qDebug() << qPrintable(_safeServerName) << "server sending with a pool of" << _sendPool->numThreads() << "threads";
+        }
+
+        // the pool drives the send passes, and emits finished once the client is gone
+        sendThread->initialize(false);
+        _sendPool->add(sendThread.get());
+    } else {
+        sendThread->initialize(true);
+    }
 
     return sendThread;
 }
 
+void OctreeServer::releaseSendThread(OctreeSendThread& sendThread) {
+    if (_sendPool) {
+        _sendPool->remove(&sendThread);
+    }
+}
+
 void OctreeServer::removeSendThread() {
     // If the object has been deleted since the event was queued, sender() will return nullptr
     if (auto sendThread = qobject_cast<OctreeSendThread*>(sender())) {
+        releaseSendThread(*sendThread);
+
         // This deletes the unique_ptr, so sendThread is destructed after that line
         _sendThreads.erase(sendThread->getNodeUuid());
     }
@@ -909,6 +942,7 @@ void OctreeServer::handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> messa
         if (it == _sendThreads.end()) {
             _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
         } else if (it->second->isShuttingDown()) {
+            releaseSendThread(*it->second);
             _sendThreads.erase(it); // Remove right away and wait on thread to be
 
             _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
@@ -1074,6 +1108,9 @@ void OctreeServer::readConfiguration() {
         readOptionBool(QString("persistFileDownload"), settingsSectionObject, _persistFileDownload);
         qDebug() << "persistFileDownload=" << _persistFileDownload;
 
+        readOptionBool(QString("incrementalPersist"), settingsSectionObject, _wantIncrementalPersist);
+        qDebug() << "incrementalPersist=" << _wantIncrementalPersist;
+
     } else {
         qDebug("persistFilename= DISABLED");
     }
@@ -1087,6 +1124,10 @@ void OctreeServer::readConfiguration() {
         qDebug() << "clockSkew=" << clockSkew;
     }
 
+    readOptionBool(QString("sendThreadPool"), settingsSectionObject, _wantSendPool);
+    readOptionInt(QString("sendThreadPoolSize"), settingsSectionObject, _sendPoolSize);
+    qDebug() << "sendThreadPool=" << _wantSendPool << "sendThreadPoolSize=" << _sendPoolSize;
+
     // Check to see if the user passed in a command line option for setting packet send rate
     int packetsPerSecondPerClientMax = -1;
     if (readOptionInt(QString("packetsPerSecondPerClientMax"), settingsSectionObject, packetsPerSecondPerClientMax)) {
@@ -1324,7 +1365,8 @@ void OctreeServer::beginRunning(QByteArray replaceData) {
 
         // now set up PersistThread
         _persistThread = new OctreePersistThread(_tree, _persistAbsoluteFilePath, _backupDirectoryPath, _persistInterval,
-                                                 _wantBackup, _settings, _debugTimestampNow, _persistAsFileType, replaceData);
+                                                 _wantBackup, _settings, _debugTimestampNow, _persistAsFileType, replaceData,
+                                                 _wantIncrementalPersist);
         _persistThread->initialize(true);
     }
 
@@ -1401,11 +1443,13 @@ void OctreeServer::aboutToFinish() {
     for (auto& it : _sendThreads) {
         auto& sendThread = *it.second;
         sendThread.setIsShuttingDown();
+        releaseSendThread(sendThread);
     }
 
     // Clear will destruct all the unique_ptr to OctreeSendThreads which will call the GenericThread's dtor
     // which waits on the thread to be done before returning
     _sendThreads.clear(); // Cleans up all the send threads.
+    _sendPool.reset();
 
     if (_persistThread) {
         _persistThread->aboutToFinish();
@@ -1522,6 +1566,12 @@ void OctreeServer::sendStatsPacket() {
     threadsStats["2. packetDistributor"] = (double)howManyThreadsDidPacketDistributor(oneSecondAgo);
     threadsStats["3. handlePacektSend"] = (double)howManyThreadsDidHandlePacketSend(oneSecondAgo);
     threadsStats["4. writeDatagram"] = (double)howManyThreadsDidCallWriteDatagram(oneSecondAgo);
+    threadsStats["5. sendThreads"] = getSendThreadCount();
+    if (_sendPool) {
+        threadsStats["6. sendLatencyP50"] = (double)_sendPool->getLatencyPercentile(0.50f);
+        threadsStats["7. sendLatencyP95"] = (double)_sendPool->getLatencyPercentile(0.95f);
+        threadsStats["8. sendLatencyP99"] = (double)_sendPool->getLatencyPercentile(0.99f);
+    }
 
     QJsonObject statsArray1;
     statsArray1["1. configuration"] = getConfiguration();
@@ -1531,6 +1581,18 @@ void OctreeServer::sendStatsPacket() {
     statsArray1["5. clients"] = getCurrentClientCount();
     statsArray1["6. threads"] = threadsStats;
 
+    if (_persistThread) {
+        QJsonObject persistStats;
+        persistStats["1. incremental"] = _persistThread->isIncrementalPersist();
+        persistStats["2. lastPersistMsecs"] = (double)_persistThread->getLastPersistElapsedTime() / USECS_PER_MSEC;
+        persistStats["3. maxPersistMsecs"] = (double)_persistThread->getMaxPersistElapsedTime() / USECS_PER_MSEC;
+        persistStats["4. lastLockHoldMsecs"] = (double)_persistThread->getLastLockHoldTime() / USECS_PER_MSEC;
+        persistStats["5. maxLockHoldMsecs"] = (double)_persistThread->getMaxLockHoldTime() / USECS_PER_MSEC;
+        persistStats["6. lastChanges"] = _persistThread->getLastPersistChangeCount();
+        persistStats["7. logSize"] = (double)_persistThread->getPersistLogSize();
+        statsArray1["7. persist"] = persistStats;
+    }
+
     // Octree Stats
     QJsonObject octreeStats;
     octreeStats["1. elementCount"] = (double)OctreeElement::getNodeCount();
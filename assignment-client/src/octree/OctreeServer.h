@@ -23,6 +23,7 @@
 #include <ThreadedAssignment.h>
 
 #include "OctreePersistThread.h"
+#include "OctreeSendPool.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
@@ -65,6 +66,7 @@ public:
     int getPacketsTotalPerSecond() const { return getPacketsTotalPerInterval() * INTERVALS_PER_SECOND; }
 
     static int getCurrentClientCount() { return _clientCount; }
+    int getSendThreadCount() const { return _sendPool ? _sendPool->numThreads() : (int)_sendThreads.size(); }
     static void clientConnected() { _clientCount++; }
     static void clientDisconnected() { _clientCount--; }
 
@@ -175,6 +177,8 @@ protected:
     
     UniqueSendThread createSendThread(const SharedNodePointer& node);
     virtual UniqueSendThread newSendThread(const SharedNodePointer& node);
+    // must be called before a send thread is destroyed, so it is no longer in use by the send pool
+    void releaseSendThread(OctreeSendThread& sendThread);
 
     int _argc;
     const char** _argv;
@@ -205,6 +209,7 @@ protected:
     int _persistInterval;
     bool _wantBackup;
     bool _persistFileDownload;
+    bool _wantIncrementalPersist { false };
     QString _backupExtensionFormat;
     int _backupInterval;
     int _maxBackupVersions;
@@ -212,7 +217,11 @@ protected:
     time_t _started;
     quint64 _startedUSecs;
     QString _safeServerName;
-    
+
+    bool _wantSendPool { false };
+    int _sendPoolSize { 0 }; // 0 sizes the pool to the core count
+    std::unique_ptr<OctreeSendPool> _sendPool; // must outlive _sendThreads
+
     SendThreads _sendThreads;
 
     static int _clientCount;
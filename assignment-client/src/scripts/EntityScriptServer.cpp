@@ -11,8 +11,11 @@
 
 #include "EntityScriptServer.h"
 
+#include <functional>
 #include <mutex>
 
+#include <QtCore/QThread>
+
 #include <AudioConstants.h>
 #include <AudioInjectorManager.h>
 #include <ClientServerUtils.h>
@@ -52,6 +55,39 @@ void messageHandler(QtMsgType type, const QMessageLogContext& context, const QSt
 
 int EntityScriptServer::_entitiesScriptEngineCount = 0;
 
+// when rebalancing is on, a script engine busy for more than this share of the time moves scripts to the others
+static const float OVERLOADED_SCRIPT_ENGINE_RATIO = 0.5f;
+static const int BALANCE_SCRIPT_ENGINES_INTERVAL_MSECS = 10 * MSECS_PER_SECOND;
+static const int DEFAULT_SCRIPT_ENGINES = 1;
+static const int MAX_SCRIPT_ENGINES = 16;
+
+// sends the entity script calls of the EntityScriptingInterface to the engine running the script of that entity
+class EntityScriptEngineRouter : public EntitiesScriptEngineProvider {
+public:
+    using Lookup = std::function<ScriptEnginePointer(const EntityItemID&)>;
+
+    EntityScriptEngineRouter(Lookup lookup) : _lookup(lookup) {}
+
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                const QStringList& params, const QUuid& remoteCallerID) override {
+        auto engine = _lookup(entityID);
+        if (engine) {
+            engine->callEntityScriptMethod(entityID, methodName, params, remoteCallerID);
+        }
+    }
+
+    QFuture<QVariant> getLocalEntityScriptDetails(const EntityItemID& entityID) override {
+        auto engine = _lookup(entityID);
+        if (!engine) {
+            return QFuture<QVariant>();
+        }
+        return engine->getLocalEntityScriptDetails(entityID);
+    }
+
+private:
+    Lookup _lookup;
+};
+
 EntityScriptServer::EntityScriptServer(ReceivedMessage& message) : ThreadedAssignment(message) {
     qInstallMessageHandler(messageHandler);
 
@@ -96,6 +132,11 @@ EntityScriptServer::EntityScriptServer(ReceivedMessage& message) : ThreadedAssig
     timer->setInterval(LOG_INTERVAL);
     connect(timer, &QTimer::timeout, this, &EntityScriptServer::pushLogs);
     timer->start();
+
+    // started by the settings, as moving a script restarts it
+    _balanceTimer = new QTimer(this);
+    _balanceTimer->setInterval(BALANCE_SCRIPT_ENGINES_INTERVAL_MSECS);
+    connect(_balanceTimer, &QTimer::timeout, this, &EntityScriptServer::balanceEntityScripts);
 }
 
 EntityScriptServer::~EntityScriptServer() {
@@ -110,7 +151,7 @@ void EntityScriptServer::handleReloadEntityServerScriptPacket(QSharedPointer<Rec
 
         if (_entityViewer.getTree() && !_shuttingDown) {
             qCDebug(entity_script_server) << "Reloading: " << entityID;
-            _entitiesScriptEngine->unloadEntityScript(entityID);
+            getEntityScriptEngine(entityID)->unloadEntityScript(entityID);
             checkAndCallPreload(entityID, true);
         }
     }
@@ -126,7 +167,8 @@ void EntityScriptServer::handleEntityScriptGetStatusPacket(QSharedPointer<Receiv
         replyPacketList->writePrimitive(messageID);
 
         EntityScriptDetails details;
-        if (_entitiesScriptEngine->getEntityScriptDetails(entityID, details)) {
+        auto engine = getEntityScriptEngine(entityID);
+        if (engine && engine->getEntityScriptDetails(entityID, details)) {
             replyPacketList->writePrimitive(true);
             replyPacketList->writePrimitive(details.status);
             replyPacketList->writeString(details.errorInfo);
@@ -155,6 +197,27 @@ void EntityScriptServer::handleSettings() {
 
     auto entityScriptServerSettings = settingsObject[ENTITY_SCRIPT_SERVER_SETTINGS_KEY].toObject();
 
+    static const QString SCRIPT_ENGINES_OPTION = "script_engines";
+    int numScriptEngines = std::max(0, entityScriptServerSettings[SCRIPT_ENGINES_OPTION].toInt(DEFAULT_SCRIPT_ENGINES));
+    if (numScriptEngines != _numScriptEngines) {
+        _numScriptEngines = numScriptEngines;
+        if (_entityScriptShards.isEmpty() && !_shards.empty() && !_shuttingDown) {
+            stopEntitiesScriptEngines();
+            resetEntitiesScriptEngines();
+        } else {
+            qDebug() << "Entity script server will use" << numScriptEngines << "script engines once it is reset";
+        }
+    }
+
+    static const QString REBALANCE_SCRIPT_ENGINES_OPTION = "rebalance_script_engines";
+    if (entityScriptServerSettings[REBALANCE_SCRIPT_ENGINES_OPTION].toBool()) {
+        if (!_balanceTimer->isActive()) {
+            _balanceTimer->start();
+        }
+    } else {
+        _balanceTimer->stop();
+    }
+
     static const QString MAX_ENTITY_PPS_OPTION = "max_total_entity_pps";
     static const QString ENTITY_PPS_PER_SCRIPT = "entity_pps_per_script";
 
@@ -171,7 +234,10 @@ void EntityScriptServer::handleSettings() {
 }
 
 void EntityScriptServer::updateEntityPPS() {
-    int numRunningScripts = _entitiesScriptEngine->getNumRunningEntityScripts();
+    int numRunningScripts = 0;
+    for (auto& shard : _shards) {
+        numRunningScripts += shard.engine->getNumRunningEntityScripts();
+    }
     int pps;
     if (std::numeric_limits<int>::max() / _entityPPSPerScript < numRunningScripts) {
         qWarning() << QString("Integer multiplication would overflow, clamping to maxint: %1 * %2").arg(numRunningScripts).arg(_entityPPSPerScript);
@@ -233,7 +299,7 @@ void EntityScriptServer::pushLogs() {
 
 void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
 
-    if (_entitiesScriptEngine && _entityViewer.getTree() && !_shuttingDown) {
+    if (!_shards.empty() && _entityViewer.getTree() && !_shuttingDown) {
         auto entityID = QUuid::fromRfc4122(receivedMessage->read(NUM_BYTES_RFC4122_UUID));
 
         auto method = receivedMessage->readString();
@@ -247,7 +313,7 @@ void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<Recei
             params << paramString;
         }
 
-        _entitiesScriptEngine->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
+        getEntityScriptEngine(entityID)->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
     }
 }
 
@@ -274,8 +340,12 @@ void EntityScriptServer::run() {
         NodeType::EntityServer, NodeType::MessagesMixer, NodeType::AssetServer
     });
 
-    // Setup Script Engine
-    resetEntitiesScriptEngine();
+    // Setup Script Engines
+    _entitiesScriptEngineRouter = QSharedPointer<EntityScriptEngineRouter>::create([this](const EntityItemID& entityID) {
+        return getEntityScriptEngine(entityID);
+    });
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(_entitiesScriptEngineRouter);
+    resetEntitiesScriptEngines();
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
     entityScriptingInterface->init();
@@ -431,7 +501,7 @@ void EntityScriptServer::selectAudioFormat(const QString& selectedCodecName) {
     }
 }
 
-void EntityScriptServer::resetEntitiesScriptEngine() {
+ScriptEnginePointer EntityScriptServer::createEntitiesScriptEngine() {
     auto engineName = QString("about:Entities %1").arg(++_entitiesScriptEngineCount);
     auto newEngine = scriptEngineFactory(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName);
 
@@ -447,86 +517,269 @@ void EntityScriptServer::resetEntitiesScriptEngine() {
     connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
     connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
 
-    connect(newEngine.data(), &ScriptEngine::update, this, [this] {
+    connect(newEngine.data(), &ScriptEngine::entityScriptDetailsUpdated, this, &EntityScriptServer::updateEntityPPS);
+
+    newEngine->setTrackRunLoopStats(true);
+    return newEngine;
+}
+
+void EntityScriptServer::resetEntitiesScriptEngines() {
+    int numScriptEngines = _numScriptEngines;
+    if (numScriptEngines == 0) {
+        numScriptEngines = QThread::idealThreadCount() - 1;
+    }
+    numScriptEngines = std::max(1, std::min(numScriptEngines, MAX_SCRIPT_ENGINES));
+
+    std::vector<ScriptEngineShard> newShards(numScriptEngines);
+    for (auto& shard : newShards) {
+        shard.engine = createEntitiesScriptEngine();
+    }
+
+    // the first engine drives the entity tree
+    connect(newShards.front().engine.data(), &ScriptEngine::update, this, [this] {
         _entityViewer.queryOctree();
         _entityViewer.getTree()->update();
     });
 
+    for (auto& shard : newShards) {
+        shard.engine->runInThread();
+    }
 
-    newEngine->runInThread();
-    auto newEngineSP = qSharedPointerCast<EntitiesScriptEngineProvider>(newEngine);
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(newEngineSP);
+    std::vector<ScriptEngineShard> oldShards;
+    {
+        QWriteLocker locker(&_shardsLock);
+        _shards.swap(newShards);
+        oldShards.swap(newShards);
+        _entityScriptShards.clear();
+    }
+    for (auto& shard : oldShards) {
+        disconnect(shard.engine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+                   this, &EntityScriptServer::updateEntityPPS);
+    }
+    _lastBalanceTime = _lastStatsTime; // the stats so far are of the old engines
 
-    disconnect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-               this, &EntityScriptServer::updateEntityPPS);
-    _entitiesScriptEngine.swap(newEngine);
-    connect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-            this, &EntityScriptServer::updateEntityPPS);
+    qCDebug(entity_script_server) << "Running entity scripts on" << numScriptEngines << "script engines";
 }
 
-
-void EntityScriptServer::clear() {
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
+void EntityScriptServer::stopEntitiesScriptEngines() {
+    for (auto& shard : _shards) {
         // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
-        _entitiesScriptEngine->waitTillDoneRunning();
+        shard.engine->unloadAllEntityScripts();
+        shard.engine->stop();
+    }
+    for (auto& shard : _shards) {
+        shard.engine->waitTillDoneRunning();
     }
+}
+
+void EntityScriptServer::clear() {
+    // unload and stop the engines
+    stopEntitiesScriptEngines();
 
     _entityViewer.clear();
 
-    // reset the engine
+    // reset the engines
     if (!_shuttingDown) {
-        resetEntitiesScriptEngine();
+        resetEntitiesScriptEngines();
+    } else {
+        QWriteLocker locker(&_shardsLock);
+        _entityScriptShards.clear();
     }
 }
 
 void EntityScriptServer::shutdownScriptEngine() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+    for (auto& shard : _shards) {
+        shard.engine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
     }
     _shuttingDown = true;
 
     clear(); // always clear() on shutdown
 }
 
+ScriptEnginePointer EntityScriptServer::getEntityScriptEngine(const EntityItemID& entityID) const {
+    QReadLocker locker(&_shardsLock);
+    if (_shards.empty()) {
+        return ScriptEnginePointer();
+    }
+    return _shards[_entityScriptShards.value(entityID, 0)].engine;
+}
+
+ScriptEnginePointer EntityScriptServer::placeEntityScript(const EntityItemID& entityID) {
+    QWriteLocker locker(&_shardsLock);
+    auto it = _entityScriptShards.constFind(entityID);
+    if (it != _entityScriptShards.constEnd()) {
+        return _shards[it.value()].engine;
+    }
+
+    // weigh the scripts that haven't run yet at the average cost of the running ones
+    quint64 totalScriptUsecs = 0;
+    int totalEntityScripts = 0;
+    for (auto& shard : _shards) {
+        totalScriptUsecs += shard.lastStats.scriptUsecs;
+        totalEntityScripts += shard.numEntityScripts;
+    }
+    quint64 averageScriptUsecs = std::max(totalScriptUsecs / std::max(totalEntityScripts, 1), (quint64)1);
+
+    int bestShard = 0;
+    quint64 bestLoad = std::numeric_limits<quint64>::max();
+    for (int i = 0; i < (int)_shards.size(); ++i) {
+        quint64 load = _shards[i].lastStats.scriptUsecs + _shards[i].numEntityScripts * averageScriptUsecs;
+        if (load < bestLoad) {
+            bestLoad = load;
+            bestShard = i;
+        }
+    }
+
+    _entityScriptShards[entityID] = bestShard;
+    ++_shards[bestShard].numEntityScripts;
+    return _shards[bestShard].engine;
+}
+
+void EntityScriptServer::forgetEntityScript(const EntityItemID& entityID) {
+    QWriteLocker locker(&_shardsLock);
+    auto it = _entityScriptShards.find(entityID);
+    if (it != _entityScriptShards.end()) {
+        --_shards[it.value()].numEntityScripts;
+        _entityScriptShards.erase(it);
+    }
+}
+
+void EntityScriptServer::moveEntityScript(const EntityItemID& entityID, int toShard) {
+    getEntityScriptEngine(entityID)->unloadEntityScript(entityID, true);
+    {
+        QWriteLocker locker(&_shardsLock);
+        auto it = _entityScriptShards.find(entityID);
+        if (it == _entityScriptShards.end()) {
+            return;
+        }
+        --_shards[it.value()].numEntityScripts;
+        ++_shards[toShard].numEntityScripts;
+        it.value() = toShard;
+    }
+    checkAndCallPreload(entityID);
+}
+
+void EntityScriptServer::takeRunLoopStats() {
+    quint64 now = usecTimestampNow();
+    _lastStatsInterval = std::max(now - _lastStatsTime, (quint64)1);
+    _lastStatsTime = now;
+
+    QWriteLocker locker(&_shardsLock);
+    for (auto& shard : _shards) {
+        shard.lastStats = shard.engine->takeRunLoopStats();
+    }
+}
+
+void EntityScriptServer::balanceEntityScripts() {
+    // only act once on the stats of each stats interval
+    if (_lastStatsTime == _lastBalanceTime || _shards.size() < 2 || _shuttingDown) {
+        return;
+    }
+    _lastBalanceTime = _lastStatsTime;
+    quint64 interval = _lastStatsInterval;
+
+    int busiest = 0;
+    int idlest = 0;
+    for (int i = 1; i < (int)_shards.size(); ++i) {
+        if (_shards[i].lastStats.scriptUsecs > _shards[busiest].lastStats.scriptUsecs) {
+            busiest = i;
+        }
+        if (_shards[i].lastStats.scriptUsecs < _shards[idlest].lastStats.scriptUsecs) {
+            idlest = i;
+        }
+    }
+
+    quint64 busiestUsecs = _shards[busiest].lastStats.scriptUsecs;
+    quint64 idlestUsecs = _shards[idlest].lastStats.scriptUsecs;
+    if ((float)busiestUsecs / (float)interval < OVERLOADED_SCRIPT_ENGINE_RATIO || busiestUsecs < 2 * idlestUsecs) {
+        return;
+    }
+
+    // move the heaviest script that doesn't just move the overload to the other engine
+    quint64 maxUsecs = (busiestUsecs - idlestUsecs) / 2;
+    EntityItemID entityToMove;
+    quint64 entityToMoveUsecs = 0;
+    auto& entityScriptUsecs = _shards[busiest].lastStats.entityScriptUsecs;
+    for (auto it = entityScriptUsecs.constBegin(); it != entityScriptUsecs.constEnd(); ++it) {
+        if (it.value() <= maxUsecs && it.value() > entityToMoveUsecs) {
+            entityToMove = it.key();
+            entityToMoveUsecs = it.value();
+        }
+    }
+
+    if (!entityToMove.isNull()) {
+        qCDebug(entity_script_server) << "Moving the script of" << entityToMove << "from script engine" << busiest
+            << "to" << idlest << "-" << busiestUsecs << "vs" << idlestUsecs << "usecs of script time";
+        moveEntityScript(entityToMove, idlest);
+    }
+}
+
 void EntityScriptServer::addingEntity(const EntityItemID& entityID) {
     checkAndCallPreload(entityID);
 }
 
 void EntityScriptServer::deletingEntity(const EntityItemID& entityID) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    if (_entityViewer.getTree() && !_shuttingDown && !_shards.empty()) {
+        getEntityScriptEngine(entityID)->unloadEntityScript(entityID, true);
+        forgetEntityScript(entityID);
     }
 }
 
 void EntityScriptServer::entityServerScriptChanging(const EntityItemID& entityID, bool reload) {
     if (_entityViewer.getTree() && !_shuttingDown) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+        getEntityScriptEngine(entityID)->unloadEntityScript(entityID, true);
         checkAndCallPreload(entityID, reload);
     }
 }
 
 void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, bool reload) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
+    if (_entityViewer.getTree() && !_shuttingDown && !_shards.empty()) {
 
         EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
+        if (!entity || entity->getServerScripts().isEmpty()) {
+            forgetEntityScript(entityID);
+            return;
+        }
+
+        auto engine = placeEntityScript(entityID);
         EntityScriptDetails details;
-        bool notRunning = !_entitiesScriptEngine->getEntityScriptDetails(entityID, details);
-        if (entity && (reload || notRunning || details.scriptText != entity->getServerScripts())) {
-            QString scriptUrl = entity->getServerScripts();
-            if (!scriptUrl.isEmpty()) {
-                scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
-                qCDebug(entity_script_server) << "Loading entity server script" << scriptUrl << "for" << entityID;
-                _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, reload);
-            }
+        bool notRunning = !engine->getEntityScriptDetails(entityID, details);
+        if (reload || notRunning || details.scriptText != entity->getServerScripts()) {
+            QString scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(entity->getServerScripts());
+            qCDebug(entity_script_server) << "Loading entity server script" << scriptUrl << "for" << entityID;
+            engine->loadEntityScript(entityID, scriptUrl, reload);
         }
     }
 }
 
 void EntityScriptServer::sendStatsPacket() {
+    takeRunLoopStats();
+
+    QJsonObject statsObject;
+    QJsonObject scriptEnginesObject;
+    int numEntityScripts = 0;
+    {
+        QReadLocker locker(&_shardsLock);
+        for (int i = 0; i < (int)_shards.size(); ++i) {
+            auto& shard = _shards[i];
+            auto& stats = shard.lastStats;
+
+            QJsonObject shardObject;
+            shardObject["1. entity_scripts"] = shard.numEntityScripts;
+            shardObject["2. script_usecs_per_second"] = (double)stats.scriptUsecs;
+            shardObject["3. avg_lag_usecs"] = stats.numFrames > 0 ? (double)(stats.totalLagUsecs / stats.numFrames) : 0.0;
+            shardObject["4. max_lag_usecs"] = (double)stats.maxLagUsecs;
+            scriptEnginesObject[QString("engine_%1").arg(i)] = shardObject;
+
+            numEntityScripts += shard.numEntityScripts;
+        }
+    }
+
+    statsObject["1. entity_scripts"] = numEntityScripts;
+    statsObject["2. script_engines"] = scriptEnginesObject;
+    statsObject["3. entity_pps"] = _entityEditSender.getPacketsPerSecond();
 
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
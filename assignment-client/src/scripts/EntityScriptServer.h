@@ -15,7 +15,10 @@
 #include <set>
 #include <vector>
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QTimer>
 #include <QtCore/QUuid>
 
 #include <EntityEditPacketSender.h>
@@ -60,10 +63,22 @@ private:
     void negotiateAudioFormat();
     void selectAudioFormat(const QString& selectedCodecName);
 
-    void resetEntitiesScriptEngine();
+    void resetEntitiesScriptEngines();
+    ScriptEnginePointer createEntitiesScriptEngine();
+    void stopEntitiesScriptEngines();
     void clear();
     void shutdownScriptEngine();
 
+    // the engine running the server script of an entity, or the first one if it has none
+    ScriptEnginePointer getEntityScriptEngine(const EntityItemID& entityID) const;
+    // like getEntityScriptEngine(), but places the entity on the least loaded engine if it has none yet
+    ScriptEnginePointer placeEntityScript(const EntityItemID& entityID);
+    void forgetEntityScript(const EntityItemID& entityID);
+    void moveEntityScript(const EntityItemID& entityID, int toShard);
+    void takeRunLoopStats();
+    // moves a script off an overloaded engine, which restarts it, so it only runs when the settings turn it on
+    void balanceEntityScripts();
+
     void addingEntity(const EntityItemID& entityID);
     void deletingEntity(const EntityItemID& entityID);
     void entityServerScriptChanging(const EntityItemID& entityID, bool reload);
@@ -73,8 +88,25 @@ private:
 
     bool _shuttingDown { false };
 
+    // server entity scripts are spread over several script engines, each running on its own thread
+    class ScriptEngineShard {
+    public:
+        ScriptEnginePointer engine;
+        int numEntityScripts { 0 };
+        ScriptEngineRunLoopStats lastStats; // over the last stats interval
+    };
+
     static int _entitiesScriptEngineCount;
-    ScriptEnginePointer _entitiesScriptEngine;
+    std::vector<ScriptEngineShard> _shards;
+    QHash<EntityItemID, int> _entityScriptShards; // which shard runs the server script of each entity
+    mutable QReadWriteLock _shardsLock; // the shards are also looked up from the script threads
+    QSharedPointer<EntitiesScriptEngineProvider> _entitiesScriptEngineRouter;
+    int _numScriptEngines { 1 }; // 0 picks one per core, less one for the assignment thread
+    QTimer* _balanceTimer { nullptr };
+    quint64 _lastStatsTime { 0 };
+    quint64 _lastStatsInterval { 1 };
+    quint64 _lastBalanceTime { 0 };
+
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
 
@@ -86,22 +86,30 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
 
     SharedNodePointer node;
 
-    if (pendingAssignment != _pendingAssignedNodes.end()) {
-        node = processAssignmentConnectRequest(nodeConnection, pendingAssignment->second);
-    } else if (!STATICALLY_ASSIGNED_NODES.contains(nodeConnection.nodeType)) {
-        QString username;
-        QByteArray usernameSignature;
+    QString username;
+    QByteArray usernameSignature;
+
+    if (message->getBytesLeftToRead() > 0) {
+        // read username from packet
+        packetStream >> username;
 
         if (message->getBytesLeftToRead() > 0) {
-            // read username from packet
-            packetStream >> username;
+            // read user signature from packet
+            packetStream >> usernameSignature;
 
             if (message->getBytesLeftToRead() > 0) {
-                // read user signature from packet
-                packetStream >> usernameSignature;
+                // read the newest packet verification the node supports, nodes that don't send one only have MD5
+                quint8 verificationVersion;
+                packetStream >> verificationVersion;
+                nodeConnection.verificationVersion = static_cast<PacketVerificationVersion>(
+                    std::min(verificationVersion, static_cast<quint8>(PacketVerificationVersion::Newest)));
             }
         }
+    }
 
+    if (pendingAssignment != _pendingAssignedNodes.end()) {
+        node = processAssignmentConnectRequest(nodeConnection, pendingAssignment->second);
+    } else if (!STATICALLY_ASSIGNED_NODES.contains(nodeConnection.nodeType)) {
         node = processAgentConnectRequest(nodeConnection, username, usernameSignature);
     }
 
@@ -118,6 +126,7 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
 
         nodeData->setNodeInterestSet(safeInterestSet);
         nodeData->setPlaceName(nodeConnection.placeName);
+        nodeData->setVerificationVersion(nodeConnection.verificationVersion);
 
         qDebug() << "Allowed connection from node" << uuidStringWithoutCurlyBraces(node->getUUID())
             << "on" << message->getSenderSockAddr() << "with MAC" << nodeConnection.hardwareAddress
@@ -301,6 +310,7 @@ void DomainGatekeeper::updateNodePermissions() {
         }
 
         node->setPermissions(userPerms);
+        _server->_domainListCache.updateNode(node);
 
         if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
             qDebug() << "node" << node->getUUID() << "no longer has permission to connect.";
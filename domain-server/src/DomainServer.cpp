@@ -1022,6 +1022,7 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     // update this node's sockets in case they have changed
     sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
     sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+    _domainListCache.updateNode(sendingNode);
 
     // update the NodeInterestSet in case there have been any changes
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
@@ -1032,6 +1033,10 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
         safeInterestSet.remove(NodeType::Agent);
     }
 
+    // a node that changed its interests needs a full list
+    nodeData->setDomainListVersion(safeInterestSet == nodeData->getNodeInterestSet() ?
+        nodeRequestData.domainListVersion : 0);
+
     nodeData->setNodeInterestSet(safeInterestSet);
 
     // update the connecting hostname in case it has changed
@@ -1102,7 +1107,8 @@ QUrl DomainServer::oauthAuthorizationURL(const QUuid& stateUUID) {
 void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(newNode->getLinkedData());
 
-    // reply back to the user with a PacketType::DomainList
+    // reply back to the user with a (full) PacketType::DomainList
+    nodeData->setDomainListVersion(0);
     sendDomainListToNode(newNode, nodeData->getSendingSockAddr());
 
     // if this node is a user (unassigned Agent), signal
@@ -1115,6 +1121,9 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
         newNode->setIsReplicated(true);
     }
 
+    // this is a new (or reconnected) node for the domain lists of the other nodes
+    _domainListCache.updateNode(newNode);
+
     // send out this node to our other connected nodes
     broadcastNewNode(newNode);
 }
@@ -1133,37 +1142,56 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     extendedHeaderStream << node->getUUID();
     extendedHeaderStream << node->getPermissions();
 
-    auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
-
-    // always send the node their own UUID back
-    QDataStream domainListStream(domainListPackets.get());
-
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
 
     // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
     auto& nodeInterestSet = nodeData->getNodeInterestSet();
 
-    if (nodeInterestSet.size() > 0) {
+    // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
+    bool includesNodes = nodeInterestSet.size() > 0 && nodeData->isAuthenticated();
+
+    // if the node has a list from us, only send the nodes that changed since
+    // (a list lost on the way is repaired by the next full one)
+    const int MAX_DELTA_DOMAIN_LISTS = 10;
+    quint64 sinceVersion = nodeData->getDomainListVersion();
+    bool isDelta = includesNodes && _domainListCache.hasVersion(sinceVersion) &&
+        nodeData->getNumDeltaDomainLists() < MAX_DELTA_DOMAIN_LISTS;
+    if (isDelta) {
+        nodeData->setNumDeltaDomainLists(nodeData->getNumDeltaDomainLists() + 1);
+    } else {
+        sinceVersion = 0;
+        nodeData->setNumDeltaDomainLists(0);
+    }
+
+    // a list without any nodes has no version, so the next one is full
+    extendedHeaderStream << (includesNodes ? _domainListCache.getVersion() : (quint64)0);
+    extendedHeaderStream << isDelta;
+
+    auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
-        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
-        if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([&](const SharedNodePointer& otherNode) {
-                if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+    // always send the node their own UUID back
+    QDataStream domainListStream(domainListPackets.get());
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+    if (includesNodes) {
+        // if this authenticated node has any interest types, send back those nodes as well
+        _domainListCache.eachRecordSince(nodeInterestSet, sinceVersion, [&](const DomainListCache::Record& record) {
+            if (record.node != node) {
+                // since we're about to add a node to the packet we start a segment
+                domainListPackets->startSegment();
 
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+                // don't send avatar nodes to other avatars, that will come from avatar mixer
+                domainListPackets->write(record.data);
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
+                // pack the secret that these two nodes will use to communicate with each other
+                domainListStream << connectionSecretForNodes(node, record.node);
+                if (nodeData->getVerificationVersion() != PacketVerificationVersion::MD5) {
+                    domainListStream << static_cast<quint8>(verificationVersionForNodes(node, record.node));
                 }
-            });
-        }
+
+                // we've added the node we wanted so end the segment now
+                domainListPackets->endSegment();
+            }
+        });
     }
 
     // send an empty list to the node, in case there were no other nodes
@@ -1194,6 +1222,19 @@ QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, con
     return QUuid();
 }
 
+PacketVerificationVersion DomainServer::verificationVersionForNodes(const SharedNodePointer& nodeA,
+                                                                   const SharedNodePointer& nodeB) {
+    DomainServerNodeData* nodeAData = static_cast<DomainServerNodeData*>(nodeA->getLinkedData());
+    DomainServerNodeData* nodeBData = static_cast<DomainServerNodeData*>(nodeB->getLinkedData());
+
+    if (nodeAData && nodeBData) {
+        // the newest both of them support
+        return std::min(nodeAData->getVerificationVersion(), nodeBData->getVerificationVersion());
+    }
+
+    return PacketVerificationVersion::MD5;
+}
+
 void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
 
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
@@ -1224,6 +1265,13 @@ void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
             // replace the bytes at the end of the packet for the connection secret between these nodes
             addNodePacket->write(rfcConnectionSecret);
 
+            // followed by how they verify their packets, for nodes that know to read it
+            auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+            if (nodeData->getVerificationVersion() != PacketVerificationVersion::MD5) {
+                addNodePacket->writePrimitive(static_cast<quint8>(verificationVersionForNodes(node, addedNode)));
+            }
+            addNodePacket->setPayloadSize(addNodePacket->pos());
+
             // send off this packet to the node
             limitedNodeList->sendUnreliablePacket(*addNodePacket, *node);
         }
@@ -2939,6 +2987,7 @@ void DomainServer::updateReplicatedNodes() {
                     << otherNode->getPermissions().getVerifiedUserName() << otherNode->getUUID();
             }
             otherNode->setIsReplicated(shouldReplicate);
+            _domainListCache.updateNode(otherNode);
         }
     );
 }
@@ -2959,12 +3008,16 @@ bool DomainServer::shouldReplicateNode(const Node& node) {
 void DomainServer::nodeAdded(SharedNodePointer node) {
     // we don't use updateNodeWithData, so add the DomainServerNodeData to the node here
     node->setLinkedData(std::unique_ptr<DomainServerNodeData> { new DomainServerNodeData() });
+
+    _domainListCache.updateNode(node);
 }
 
 void DomainServer::nodeKilled(SharedNodePointer node) {
     // if this peer connected via ICE then remove them from our ICE peers hash
     _gatekeeper.removeICEPeer(node->getUUID());
 
+    _domainListCache.removeNode(node->getUUID());
+
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
 
     if (nodeData) {
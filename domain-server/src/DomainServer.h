@@ -23,6 +23,7 @@
 #include <QAbstractNativeEventFilter>
 
 #include <Assignment.h>
+#include <DomainListCache.h>
 #include <HTTPSConnection.h>
 #include <LimitedNodeList.h>
 
@@ -171,6 +172,7 @@ private:
     bool isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
 
     QUuid connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
+    PacketVerificationVersion verificationVersionForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
     void broadcastNewNode(const SharedNodePointer& node);
 
     void parseAssignmentConfigs(QSet<Assignment::Type>& excludedTypes);
@@ -217,6 +219,7 @@ private:
     std::vector<QString> _replicatedUsernames;
 
     DomainGatekeeper _gatekeeper;
+    DomainListCache _domainListCache;
 
     HTTPManager _httpManager;
     HTTPSManager* _httpsManager;
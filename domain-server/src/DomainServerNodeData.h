@@ -68,6 +68,18 @@ public:
 
     bool wasAssigned() const { return _wasAssigned; };
     void setWasAssigned(bool wasAssigned) { _wasAssigned = wasAssigned; }
+
+    // the version of the last domain list this node told us it has (0 for none),
+    // and the number of delta lists sent to it since its last full list
+    quint64 getDomainListVersion() const { return _domainListVersion; }
+    void setDomainListVersion(quint64 domainListVersion) { _domainListVersion = domainListVersion; }
+    int getNumDeltaDomainLists() const { return _numDeltaDomainLists; }
+    void setNumDeltaDomainLists(int numDeltaDomainLists) { _numDeltaDomainLists = numDeltaDomainLists; }
+
+    // the newest packet verification this node supports; nodes newer than MD5 are sent the one to use with each other node
+    // after their connection secret
+    PacketVerificationVersion getVerificationVersion() const { return _verificationVersion; }
+    void setVerificationVersion(PacketVerificationVersion verificationVersion) { _verificationVersion = verificationVersion; }
     
 private:
     QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
@@ -93,6 +105,11 @@ private:
     QString _placeName;
 
     bool _wasAssigned { false };
+
+    quint64 _domainListVersion { 0 };
+    int _numDeltaDomainLists { 0 };
+
+    PacketVerificationVersion _verificationVersion { PacketVerificationVersion::MD5 };
 };
 
 #endif // hifi_DomainServerNodeData_h
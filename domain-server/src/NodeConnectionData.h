@@ -30,6 +30,8 @@ public:
     QString placeName;
     QString hardwareAddress;
     QUuid machineFingerprint;
+    quint64 domainListVersion { 0 };
+    PacketVerificationVersion verificationVersion { PacketVerificationVersion::MD5 };
 
     QByteArray protocolVersion;
 };
@@ -9,7 +9,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <atomic>
 #include <string>
+#include <vector>
 
 #include <QScriptEngine>
 
@@ -32,6 +34,7 @@
 #include <RegisteredMetaTypes.h>
 #include <Rig.h>
 #include <SettingHandle.h>
+#include <TBBHelpers.h>
 #include <UsersScriptingInterface.h>
 #include <UUID.h>
 #include <avatars-renderer/OtherAvatar.h>
@@ -182,7 +185,17 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     int numAvatarsUpdated = 0;
     int numAVatarsNotUpdated = 0;
 
-    render::Transaction transaction;
+    struct SimulationJob {
+        std::shared_ptr<Avatar> avatar;
+        bool inView;
+        bool hasNewJointData;
+        bool simulated;
+    };
+    std::vector<SimulationJob> jobs;
+    jobs.reserve(sortedAvatars.size());
+
+    // first the work that touches the scene and physics, for ALL avatars, here on the main thread
+    const float OUT_OF_VIEW_THRESHOLD = 0.5f * AvatarData::OUT_OF_VIEW_PENALTY;
     while (!sortedAvatars.empty()) {
         const SortableAvatar& sortData = sortedAvatars.top();
         const auto avatar = std::static_pointer_cast<Avatar>(sortData.getAvatar());
@@ -193,7 +206,6 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             continue;
         }
 
-        // for ALL avatars...
         if (_shouldRender) {
             avatar->ensureInScene(avatar, qApp->getMain3DScene());
         }
@@ -211,44 +223,43 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
         }
         avatar->animateScaleChanges(deltaTime);
 
-        const float OUT_OF_VIEW_THRESHOLD = 0.5f * AvatarData::OUT_OF_VIEW_PENALTY;
-        uint64_t now = usecTimestampNow();
-        if (now < updateExpiry) {
-            // we're within budget
-            bool inView = sortData.getPriority() > OUT_OF_VIEW_THRESHOLD;
-            if (inView && avatar->hasNewJointData()) {
+        SimulationJob job { avatar, sortData.getPriority() > OUT_OF_VIEW_THRESHOLD, avatar->hasNewJointData(), false };
+        if (!avatar->canSimulateSkeletonInParallel()) {
+            // a skeleton that just loaded sets up its joints on its first simulate, which has to happen here
+            avatar->simulateSkeleton(deltaTime, job.inView);
+            job.simulated = true;
+        }
+        jobs.push_back(job);
+        sortedAvatars.pop();
+    }
+
+    // then the skeletons, fanned out across the worker threads. Each iteration claims the next avatar in priority
+    // order, so once we've spent our time budget it is the lowest priority avatars that wait
+    // --> more avatars may freeze until their priority trickles up
+    // --> some avatar velocity measurements may be a little off
+    std::atomic<size_t> nextJob { 0 };
+    tbb::parallel_for((size_t)0, jobs.size(), [&](size_t) {
+        SimulationJob& job = jobs[nextJob++];
+        if (!job.simulated && usecTimestampNow() < updateExpiry) {
+            job.avatar->simulateSkeleton(deltaTime, job.inView);
+            job.simulated = true;
+        }
+    });
+
+    // and last what depends on other objects or feeds the scene, back in priority order on the main thread
+    render::Transaction transaction;
+    for (auto& job : jobs) {
+        if (job.simulated) {
+            if (job.inView && job.hasNewJointData) {
                 numAvatarsUpdated++;
             }
-            avatar->simulate(deltaTime, inView);
-            avatar->updateRenderItem(transaction);
-            avatar->setLastRenderUpdateTime(startTime);
-        } else {
-            // we've spent our full time budget --> bail on the rest of the avatar updates
-            // --> more avatars may freeze until their priority trickles up
-            // --> some scale or fade animations may glitch
-            // --> some avatar velocity measurements may be a little off
-
-            // no time simulate, but we take the time to count how many were tragically missed
-            bool inView = sortData.getPriority() > OUT_OF_VIEW_THRESHOLD;
-            if (!inView) {
-                break;
-            }
-            if (inView && avatar->hasNewJointData()) {
-                numAVatarsNotUpdated++;
-            }
-            sortedAvatars.pop();
-            while (inView && !sortedAvatars.empty()) {
-                const SortableAvatar& newSortData = sortedAvatars.top();
-                const auto newAvatar = std::static_pointer_cast<Avatar>(newSortData.getAvatar());
-                inView = newSortData.getPriority() > OUT_OF_VIEW_THRESHOLD;
-                if (inView && newAvatar->hasNewJointData()) {
-                    numAVatarsNotUpdated++;
-                }
-                sortedAvatars.pop();
-            }
-            break;
+            job.avatar->simulateAttachedObjects(deltaTime, job.inView);
+            job.avatar->updateRenderItem(transaction);
+            job.avatar->setLastRenderUpdateTime(startTime);
+        } else if (job.inView && job.hasNewJointData) {
+            // no time to simulate, but we count how many were tragically missed
+            numAVatarsNotUpdated++;
         }
-        sortedAvatars.pop();
     }
 
     if (_shouldRender) {
@@ -278,7 +278,7 @@ void Rig::reset(const FBXGeometry& geometry) {
     }
 }
 
-bool Rig::jointStatesEmpty() {
+bool Rig::jointStatesEmpty() const {
     return _internalPoseSet._relativePoses.empty();
 }
 
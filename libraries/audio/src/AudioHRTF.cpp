@@ -275,6 +275,73 @@ static void FIR_1x4_SSE(float* src, float* dst0, float* dst1, float* dst2, float
     }
 }
 
+// 2 channel input, 8 channel output
+// the FIR of two sources evaluated in the same pass, for more independent accumulators
+static void FIR_2x8_SSE(float* src0, float* src1, float* dst[8], float coef0[4][HRTF_TAPS], float coef1[4][HRTF_TAPS], int numFrames) {
+
+    float* coef00 = coef0[0] + HRTF_TAPS - 1;   // process backwards
+    float* coef01 = coef0[1] + HRTF_TAPS - 1;
+    float* coef02 = coef0[2] + HRTF_TAPS - 1;
+    float* coef03 = coef0[3] + HRTF_TAPS - 1;
+    float* coef10 = coef1[0] + HRTF_TAPS - 1;
+    float* coef11 = coef1[1] + HRTF_TAPS - 1;
+    float* coef12 = coef1[2] + HRTF_TAPS - 1;
+    float* coef13 = coef1[3] + HRTF_TAPS - 1;
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        __m128 acc2 = _mm_setzero_ps();
+        __m128 acc3 = _mm_setzero_ps();
+        __m128 acc4 = _mm_setzero_ps();
+        __m128 acc5 = _mm_setzero_ps();
+        __m128 acc6 = _mm_setzero_ps();
+        __m128 acc7 = _mm_setzero_ps();
+
+        float* ps0 = &src0[i - HRTF_TAPS + 1];  // process forwards
+        float* ps1 = &src1[i - HRTF_TAPS + 1];
+
+        assert(HRTF_TAPS % 2 == 0);
+
+        for (int k = 0; k < HRTF_TAPS; k += 2) {
+
+            __m128 x0 = _mm_loadu_ps(&ps0[k+0]);
+            __m128 y0 = _mm_loadu_ps(&ps1[k+0]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load1_ps(&coef00[-k-0]), x0));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load1_ps(&coef01[-k-0]), x0));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load1_ps(&coef02[-k-0]), x0));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load1_ps(&coef03[-k-0]), x0));
+            acc4 = _mm_add_ps(acc4, _mm_mul_ps(_mm_load1_ps(&coef10[-k-0]), y0));
+            acc5 = _mm_add_ps(acc5, _mm_mul_ps(_mm_load1_ps(&coef11[-k-0]), y0));
+            acc6 = _mm_add_ps(acc6, _mm_mul_ps(_mm_load1_ps(&coef12[-k-0]), y0));
+            acc7 = _mm_add_ps(acc7, _mm_mul_ps(_mm_load1_ps(&coef13[-k-0]), y0));
+
+            __m128 x1 = _mm_loadu_ps(&ps0[k+1]);
+            __m128 y1 = _mm_loadu_ps(&ps1[k+1]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load1_ps(&coef00[-k-1]), x1));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load1_ps(&coef01[-k-1]), x1));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load1_ps(&coef02[-k-1]), x1));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load1_ps(&coef03[-k-1]), x1));
+            acc4 = _mm_add_ps(acc4, _mm_mul_ps(_mm_load1_ps(&coef10[-k-1]), y1));
+            acc5 = _mm_add_ps(acc5, _mm_mul_ps(_mm_load1_ps(&coef11[-k-1]), y1));
+            acc6 = _mm_add_ps(acc6, _mm_mul_ps(_mm_load1_ps(&coef12[-k-1]), y1));
+            acc7 = _mm_add_ps(acc7, _mm_mul_ps(_mm_load1_ps(&coef13[-k-1]), y1));
+        }
+
+        _mm_storeu_ps(&dst[0][i], acc0);
+        _mm_storeu_ps(&dst[1][i], acc1);
+        _mm_storeu_ps(&dst[2][i], acc2);
+        _mm_storeu_ps(&dst[3][i], acc3);
+        _mm_storeu_ps(&dst[4][i], acc4);
+        _mm_storeu_ps(&dst[5][i], acc5);
+        _mm_storeu_ps(&dst[6][i], acc6);
+        _mm_storeu_ps(&dst[7][i], acc7);
+    }
+}
+
 //
 // Runtime CPU dispatch
 //
@@ -290,6 +357,15 @@ static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* ds
     (*f)(src, dst0, dst1, dst2, dst3, coef, numFrames); // dispatch
 }
 
+void FIR_2x8_AVX2(float* src0, float* src1, float* dst[8], float coef0[4][HRTF_TAPS], float coef1[4][HRTF_TAPS], int numFrames);
+void FIR_2x8_AVX512(float* src0, float* src1, float* dst[8], float coef0[4][HRTF_TAPS], float coef1[4][HRTF_TAPS], int numFrames);
+
+static void FIR_2x8(float* src0, float* src1, float* dst[8], float coef0[4][HRTF_TAPS], float coef1[4][HRTF_TAPS], int numFrames) {
+
+    static auto f = cpuSupportsAVX512() ? FIR_2x8_AVX512 : (cpuSupportsAVX2() ? FIR_2x8_AVX2 : FIR_2x8_SSE);
+    (*f)(src0, src1, dst, coef0, coef1, numFrames); // dispatch
+}
+
 // 4 channel planar to interleaved
 static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
 
@@ -433,6 +509,65 @@ static void crossfade_4x2(float* src, float* dst, const float* win, int numFrame
     }
 }
 
+// crossfade 2x4 inputs into 2 outputs with accumulation (interleaved)
+// two sources are summed before the output is accumulated
+static void crossfade_8x2(float* src0, float* src1, float* dst, const float* win, int numFrames) {
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        __m128 f0 = _mm_loadu_ps(&win[i]);
+
+        __m128 x0 = _mm_loadu_ps(&src0[4*i+0]);
+        __m128 x1 = _mm_loadu_ps(&src0[4*i+4]);
+        __m128 x2 = _mm_loadu_ps(&src0[4*i+8]);
+        __m128 x3 = _mm_loadu_ps(&src0[4*i+12]);
+
+        __m128 z0 = _mm_loadu_ps(&src1[4*i+0]);
+        __m128 z1 = _mm_loadu_ps(&src1[4*i+4]);
+        __m128 z2 = _mm_loadu_ps(&src1[4*i+8]);
+        __m128 z3 = _mm_loadu_ps(&src1[4*i+12]);
+
+        __m128 y0 = _mm_loadu_ps(&dst[2*i+0]);
+        __m128 y1 = _mm_loadu_ps(&dst[2*i+4]);
+
+        // sum the sources (the crossfade is linear)
+        x0 = _mm_add_ps(x0, z0);
+        x1 = _mm_add_ps(x1, z1);
+        x2 = _mm_add_ps(x2, z2);
+        x3 = _mm_add_ps(x3, z3);
+
+        // deinterleave (4x4 matrix transpose)
+        __m128 t0 = _mm_unpacklo_ps(x0, x1);
+        __m128 t2 = _mm_unpacklo_ps(x2, x3);
+        __m128 t1 = _mm_unpackhi_ps(x0, x1);
+        __m128 t3 = _mm_unpackhi_ps(x2, x3);
+
+        x0 = _mm_movelh_ps(t0, t2);
+        x1 = _mm_movehl_ps(t2, t0);
+        x2 = _mm_movelh_ps(t1, t3);
+        x3 = _mm_movehl_ps(t3, t1);
+
+        // crossfade
+        x0 = _mm_sub_ps(x0, x2);
+        x1 = _mm_sub_ps(x1, x3);
+        x2 = _mm_add_ps(x2, _mm_mul_ps(f0, x0));
+        x3 = _mm_add_ps(x3, _mm_mul_ps(f0, x1));
+
+        // interleave
+        x0 = _mm_unpacklo_ps(x2, x3);
+        x1 = _mm_unpackhi_ps(x2, x3);
+
+        // accumulate
+        y0 = _mm_add_ps(y0, x0);
+        y1 = _mm_add_ps(y1, x1);
+
+        _mm_storeu_ps(&dst[2*i+0], y0);
+        _mm_storeu_ps(&dst[2*i+4], y1);
+    }
+}
+
 // linear interpolation with gain
 static void interpolate(float* dst, const float* src0, const float* src1, float frac, float gain) {
 
@@ -519,6 +654,13 @@ static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* ds
     }
 }
 
+// 2 channel input, 8 channel output
+static void FIR_2x8(float* src0, float* src1, float* dst[8], float coef0[4][HRTF_TAPS], float coef1[4][HRTF_TAPS], int numFrames) {
+
+    FIR_1x4(src0, dst[0], dst[1], dst[2], dst[3], coef0, numFrames);
+    FIR_1x4(src1, dst[4], dst[5], dst[6], dst[7], coef1, numFrames);
+}
+
 // 4 channel planar to interleaved
 static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
 
@@ -713,6 +855,23 @@ static void crossfade_4x2(float* src, float* dst, const float* win, int numFrame
     }
 }
 
+// crossfade 2x4 inputs into 2 outputs with accumulation (interleaved)
+static void crossfade_8x2(float* src0, float* src1, float* dst, const float* win, int numFrames) {
+
+    for (int i = 0; i < numFrames; i++) {
+
+        float frac = win[i];
+
+        float x0 = src0[4*i+0] + src1[4*i+0];
+        float x1 = src0[4*i+1] + src1[4*i+1];
+        float x2 = src0[4*i+2] + src1[4*i+2];
+        float x3 = src0[4*i+3] + src1[4*i+3];
+
+        dst[2*i+0] += x2 + frac * (x0 - x2);
+        dst[2*i+1] += x3 + frac * (x1 - x3);
+    }
+}
+
 // linear interpolation with gain
 static void interpolate(float* dst, const float* src0, const float* src1, float frac, float gain) {
 
@@ -1061,18 +1220,11 @@ static void setFilters(float firCoef[4][HRTF_TAPS], float bqCoef[5][8], int dela
     }
 }
 
-void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames) {
+void AudioHRTF::prepareFilters(int16_t* input, float* in, float firCoef[4][HRTF_TAPS], float bqCoef[5][8], int delay[4],
+                               int index, float azimuth, float distance, float gain) {
 
     assert(index >= 0);
     assert(index < HRTF_TABLES);
-    assert(numFrames == HRTF_BLOCK);
-
-    ALIGN32 float in[HRTF_TAPS + HRTF_BLOCK];               // mono
-    ALIGN32 float firCoef[4][HRTF_TAPS];                    // 4-channel
-    ALIGN32 float firBuffer[4][HRTF_DELAY + HRTF_BLOCK];    // 4-channel
-    ALIGN32 float bqCoef[5][8];                             // 4-channel (interleaved)
-    ALIGN32 float bqBuffer[4 * HRTF_BLOCK];                 // 4-channel (interleaved)
-    int delay[4];                                           // 4-channel (interleaved)
 
     // apply global and local gain adjustment
     gain *= _gainAdjust;
@@ -1096,14 +1248,9 @@ void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth,
     // FIR state update
     memcpy(in, _firState, HRTF_TAPS * sizeof(float));
     memcpy(_firState, &in[HRTF_BLOCK], HRTF_TAPS * sizeof(float));
+}
 
-    // process old/new FIR
-    FIR_1x4(&in[HRTF_TAPS], 
-            &firBuffer[L0][HRTF_DELAY], 
-            &firBuffer[R0][HRTF_DELAY], 
-            &firBuffer[L1][HRTF_DELAY], 
-            &firBuffer[R1][HRTF_DELAY], 
-            firCoef, HRTF_BLOCK);
+void AudioHRTF::processFilters(float firBuffer[4][HRTF_DELAY + HRTF_BLOCK], float bqCoef[5][8], int delay[4], float* bqBuffer) {
 
     // delay state update
     memcpy(firBuffer[L0], _delayState[L0], HRTF_DELAY * sizeof(float));
@@ -1143,10 +1290,78 @@ void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth,
     _bqState[1][R2] = _bqState[1][R3];
     _bqState[2][R2] = _bqState[2][R3];
 
+    _silentState = false;
+}
+
+void AudioHRTF::render(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames) {
+
+    assert(numFrames == HRTF_BLOCK);
+
+    ALIGN32 float in[HRTF_TAPS + HRTF_BLOCK];               // mono
+    ALIGN32 float firCoef[4][HRTF_TAPS];                    // 4-channel
+    ALIGN32 float firBuffer[4][HRTF_DELAY + HRTF_BLOCK];    // 4-channel
+    ALIGN32 float bqCoef[5][8];                             // 4-channel (interleaved)
+    ALIGN32 float bqBuffer[4 * HRTF_BLOCK];                 // 4-channel (interleaved)
+    int delay[4];                                           // 4-channel (interleaved)
+
+    prepareFilters(input, in, firCoef, bqCoef, delay, index, azimuth, distance, gain);
+
+    // process old/new FIR
+    FIR_1x4(&in[HRTF_TAPS], 
+            &firBuffer[L0][HRTF_DELAY], 
+            &firBuffer[R0][HRTF_DELAY], 
+            &firBuffer[L1][HRTF_DELAY], 
+            &firBuffer[R1][HRTF_DELAY], 
+            firCoef, HRTF_BLOCK);
+
+    processFilters(firBuffer, bqCoef, delay, bqBuffer);
+
     // crossfade old/new output and accumulate
     crossfade_4x2(bqBuffer, output, crossfadeTable, HRTF_BLOCK);
+}
 
-    _silentState = false;
+void AudioHRTF::renderBatch(Source* sources, int numSources, float* output, int index, int numFrames) {
+
+    assert(numFrames == HRTF_BLOCK);
+
+    ALIGN32 float in[2][HRTF_TAPS + HRTF_BLOCK];            // mono, per source
+    ALIGN32 float firCoef[2][4][HRTF_TAPS];                 // 4-channel, per source
+    ALIGN32 float firBuffer[2][4][HRTF_DELAY + HRTF_BLOCK]; // 4-channel, per source
+    ALIGN32 float bqCoef[2][5][8];                          // 4-channel (interleaved), per source
+    ALIGN32 float bqBuffer[2][4 * HRTF_BLOCK];              // 4-channel (interleaved), per source
+    int delay[2][4];                                        // 4-channel (interleaved), per source
+
+    float* firOutput[8] = {
+        &firBuffer[0][L0][HRTF_DELAY], &firBuffer[0][R0][HRTF_DELAY], &firBuffer[0][L1][HRTF_DELAY], &firBuffer[0][R1][HRTF_DELAY],
+        &firBuffer[1][L0][HRTF_DELAY], &firBuffer[1][R0][HRTF_DELAY], &firBuffer[1][L1][HRTF_DELAY], &firBuffer[1][R1][HRTF_DELAY],
+    };
+
+    int i = 0;
+    for (; i + 1 < numSources; i += 2) {
+
+        Source& source0 = sources[i+0];
+        Source& source1 = sources[i+1];
+
+        source0.hrtf->prepareFilters(source0.input, in[0], firCoef[0], bqCoef[0], delay[0],
+                                     index, source0.azimuth, source0.distance, source0.gain);
+        source1.hrtf->prepareFilters(source1.input, in[1], firCoef[1], bqCoef[1], delay[1],
+                                     index, source1.azimuth, source1.distance, source1.gain);
+
+        // process old/new FIR of both sources
+        FIR_2x8(&in[0][HRTF_TAPS], &in[1][HRTF_TAPS], firOutput, firCoef[0], firCoef[1], HRTF_BLOCK);
+
+        source0.hrtf->processFilters(firBuffer[0], bqCoef[0], delay[0], bqBuffer[0]);
+        source1.hrtf->processFilters(firBuffer[1], bqCoef[1], delay[1], bqBuffer[1]);
+
+        // crossfade old/new output of both sources and accumulate
+        crossfade_8x2(bqBuffer[0], bqBuffer[1], output, crossfadeTable, HRTF_BLOCK);
+    }
+
+    // an odd source out takes the single source path
+    if (i < numSources) {
+        Source& source = sources[i];
+        source.hrtf->render(source.input, output, index, source.azimuth, source.distance, source.gain, numFrames);
+    }
 }
 
 void AudioHRTF::renderSilent(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames) {
@@ -34,6 +34,17 @@ class AudioHRTF {
 public:
     AudioHRTF() {};
 
+    //
+    // One source of a batch render, with its own HRTF filter state
+    //
+    struct Source {
+        AudioHRTF* hrtf;
+        int16_t* input;
+        float azimuth;
+        float distance;
+        float gain;
+    };
+
     //
     // input: mono source
     // output: interleaved stereo mix buffer (accumulates into existing output)
@@ -50,6 +61,13 @@ public:
     //
     void renderSilent(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
 
+    //
+    // Render many sources heard by one listener, equivalent to calling render() for each of them.
+    // Sources are processed in pairs, with the FIR of both evaluated in the same pass
+    // and their crossfaded output accumulated in a single sweep of the output buffer.
+    //
+    static void renderBatch(Source* sources, int numSources, float* output, int index, int numFrames);
+
     //
     // HRTF local gain adjustment in amplitude (1.0 == unity)
     //
@@ -60,6 +78,11 @@ private:
     AudioHRTF(const AudioHRTF&) = delete;
     AudioHRTF& operator=(const AudioHRTF&) = delete;
 
+    // render stages, shared by render() and renderBatch()
+    void prepareFilters(int16_t* input, float* in, float firCoef[4][HRTF_TAPS], float bqCoef[5][8], int delay[4],
+                        int index, float azimuth, float distance, float gain);
+    void processFilters(float firBuffer[4][HRTF_DELAY + HRTF_BLOCK], float bqCoef[5][8], int delay[4], float* bqBuffer);
+
     // SIMD channel assignmentS
     enum Channel {
         L0, R0,
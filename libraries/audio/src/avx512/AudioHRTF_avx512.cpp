@@ -87,4 +87,73 @@ void FIR_1x4_AVX512(float* src, float* dst0, float* dst1, float* dst2, float* ds
     _mm256_zeroupper();
 }
 
+// 2 channel input, 8 channel output
+// the FIR of two sources evaluated in the same pass, for more independent accumulators
+void FIR_2x8_AVX512(float* src0, float* src1, float* dst[8], float coef0[4][HRTF_TAPS], float coef1[4][HRTF_TAPS], int numFrames) {
+
+    float* coef00 = coef0[0] + HRTF_TAPS - 1;   // process backwards
+    float* coef01 = coef0[1] + HRTF_TAPS - 1;
+    float* coef02 = coef0[2] + HRTF_TAPS - 1;
+    float* coef03 = coef0[3] + HRTF_TAPS - 1;
+    float* coef10 = coef1[0] + HRTF_TAPS - 1;
+    float* coef11 = coef1[1] + HRTF_TAPS - 1;
+    float* coef12 = coef1[2] + HRTF_TAPS - 1;
+    float* coef13 = coef1[3] + HRTF_TAPS - 1;
+
+    assert(numFrames % 16 == 0);
+
+    for (int i = 0; i < numFrames; i += 16) {
+
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        __m512 acc2 = _mm512_setzero_ps();
+        __m512 acc3 = _mm512_setzero_ps();
+        __m512 acc4 = _mm512_setzero_ps();
+        __m512 acc5 = _mm512_setzero_ps();
+        __m512 acc6 = _mm512_setzero_ps();
+        __m512 acc7 = _mm512_setzero_ps();
+
+        float* ps0 = &src0[i - HRTF_TAPS + 1];  // process forwards
+        float* ps1 = &src1[i - HRTF_TAPS + 1];
+
+        assert(HRTF_TAPS % 2 == 0);
+
+        for (int k = 0; k < HRTF_TAPS; k += 2) {
+
+            __m512 x0 = _mm512_loadu_ps(&ps0[k+0]);
+            __m512 y0 = _mm512_loadu_ps(&ps1[k+0]);
+            acc0 = _mm512_fmadd_ps(_mm512_set1_ps(coef00[-k-0]), x0, acc0);
+            acc1 = _mm512_fmadd_ps(_mm512_set1_ps(coef01[-k-0]), x0, acc1);
+            acc2 = _mm512_fmadd_ps(_mm512_set1_ps(coef02[-k-0]), x0, acc2);
+            acc3 = _mm512_fmadd_ps(_mm512_set1_ps(coef03[-k-0]), x0, acc3);
+            acc4 = _mm512_fmadd_ps(_mm512_set1_ps(coef10[-k-0]), y0, acc4);
+            acc5 = _mm512_fmadd_ps(_mm512_set1_ps(coef11[-k-0]), y0, acc5);
+            acc6 = _mm512_fmadd_ps(_mm512_set1_ps(coef12[-k-0]), y0, acc6);
+            acc7 = _mm512_fmadd_ps(_mm512_set1_ps(coef13[-k-0]), y0, acc7);
+
+            __m512 x1 = _mm512_loadu_ps(&ps0[k+1]);
+            __m512 y1 = _mm512_loadu_ps(&ps1[k+1]);
+            acc0 = _mm512_fmadd_ps(_mm512_set1_ps(coef00[-k-1]), x1, acc0);
+            acc1 = _mm512_fmadd_ps(_mm512_set1_ps(coef01[-k-1]), x1, acc1);
+            acc2 = _mm512_fmadd_ps(_mm512_set1_ps(coef02[-k-1]), x1, acc2);
+            acc3 = _mm512_fmadd_ps(_mm512_set1_ps(coef03[-k-1]), x1, acc3);
+            acc4 = _mm512_fmadd_ps(_mm512_set1_ps(coef10[-k-1]), y1, acc4);
+            acc5 = _mm512_fmadd_ps(_mm512_set1_ps(coef11[-k-1]), y1, acc5);
+            acc6 = _mm512_fmadd_ps(_mm512_set1_ps(coef12[-k-1]), y1, acc6);
+            acc7 = _mm512_fmadd_ps(_mm512_set1_ps(coef13[-k-1]), y1, acc7);
+        }
+
+        _mm512_storeu_ps(&dst[0][i], acc0);
+        _mm512_storeu_ps(&dst[1][i], acc1);
+        _mm512_storeu_ps(&dst[2][i], acc2);
+        _mm512_storeu_ps(&dst[3][i], acc3);
+        _mm512_storeu_ps(&dst[4][i], acc4);
+        _mm512_storeu_ps(&dst[5][i], acc5);
+        _mm512_storeu_ps(&dst[6][i], acc6);
+        _mm512_storeu_ps(&dst[7][i], acc7);
+    }
+
+    _mm256_zeroupper();
+}
+
 #endif
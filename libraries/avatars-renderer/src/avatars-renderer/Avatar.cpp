@@ -417,7 +417,17 @@ void Avatar::relayJointDataToChildren() {
 }
 
 void Avatar::simulate(float deltaTime, bool inView) {
-    PROFILE_RANGE(simulation, "simulate");
+    simulateSkeleton(deltaTime, inView);
+    simulateAttachedObjects(deltaTime, inView);
+}
+
+bool Avatar::canSimulateSkeletonInParallel() const {
+    // the first simulate after the skeleton loads sets up its joints, which reaches out to the rest of the avatar
+    return !_skeletonModel->isLoaded() || !_skeletonModel->getRig().jointStatesEmpty();
+}
+
+void Avatar::simulateSkeleton(float deltaTime, bool inView) {
+    PROFILE_RANGE(simulation, "simulateSkeleton");
 
     _simulationRate.increment();
     if (inView) {
@@ -437,7 +447,7 @@ void Avatar::simulate(float deltaTime, bool inView) {
 
                 _skeletonModel->simulate(deltaTime, true);
 
-                locationChanged(); // joints changed, so if there are any children, update them.
+                _jointsChanged = true; // children are told in simulateAttachedObjects()
                 _hasNewJointData = false;
 
                 glm::vec3 headPosition = getWorldPosition();
@@ -448,12 +458,14 @@ void Avatar::simulate(float deltaTime, bool inView) {
             }
             head->setScale(getModelScale());
             head->simulate(deltaTime);
-            relayJointDataToChildren();
         } else {
             // a non-full update is still required so that the position, rotation, scale and bounds of the skeletonModel are updated.
             _skeletonModel->simulate(deltaTime, false);
         }
         _skeletonModelSimulationRate.increment();
+
+        // done here rather than lazily when the render items are updated, so that it's spread over the workers too
+        _skeletonModel->updateClusterMatrices();
     }
 
     // update animation for display name fade in/out
@@ -476,9 +488,25 @@ void Avatar::simulate(float deltaTime, bool inView) {
     {
         PROFILE_RANGE(simulation, "misc");
         measureMotionDerivatives(deltaTime);
-        simulateAttachments(deltaTime);
         updatePalms();
     }
+}
+
+void Avatar::simulateAttachedObjects(float deltaTime, bool inView) {
+    PROFILE_RANGE(simulation, "simulateAttachedObjects");
+
+    if (_jointsChanged) {
+        locationChanged(); // joints changed, so if there are any children, update them.
+        _jointsChanged = false;
+    }
+    if (inView) {
+        relayJointDataToChildren();
+    }
+
+    {
+        PROFILE_RANGE(simulation, "attachments");
+        simulateAttachments(deltaTime);
+    }
     {
         PROFILE_RANGE(simulation, "entities");
         updateAvatarEntities();
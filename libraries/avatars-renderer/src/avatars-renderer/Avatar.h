@@ -89,6 +89,12 @@ public:
     void simulate(float deltaTime, bool inView);
     virtual void simulateAttachments(float deltaTime);
 
+    // simulate() in two halves: the skeleton, head and motion of this avatar alone, which can run on a worker thread
+    // alongside other avatars' once canSimulateSkeletonInParallel(), then on the main thread whatever is attached to it
+    bool canSimulateSkeletonInParallel() const;
+    void simulateSkeleton(float deltaTime, bool inView);
+    void simulateAttachedObjects(float deltaTime, bool inView);
+
     virtual void render(RenderArgs* renderArgs);
 
     void addToScene(AvatarSharedPointer self, const render::ScenePointer& scene,
@@ -334,6 +340,7 @@ protected:
 
     glm::vec3 _worldUpDirection { Vectors::UP };
     bool _moving { false }; ///< set when position is changing
+    bool _jointsChanged { false }; ///< set by simulateSkeleton(), cleared once the children are told
 
     // protected methods...
     bool isLookingAtMe(AvatarSharedPointer avatar) const;
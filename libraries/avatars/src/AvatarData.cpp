@@ -216,6 +216,22 @@ float AvatarData::getDistanceBasedMinTranslationDistance(glm::vec3 viewerPositio
     return AVATAR_MIN_TRANSLATION; // Eventually make this distance sensitive as well
 }
 
+AvatarDataPacket::HasFlags AvatarData::getChangedSinceFlags(quint64 lastSentTime) const {
+    lazyInitHeadData();
+
+    // the same tests as toByteArray
+    return (rotationChangedSince(lastSentTime) ? AvatarDataPacket::PACKET_HAS_AVATAR_ORIENTATION : 0)
+        | (avatarBoundingBoxChangedSince(lastSentTime) ? AvatarDataPacket::PACKET_HAS_AVATAR_BOUNDING_BOX : 0)
+        | (avatarScaleChangedSince(lastSentTime) ? AvatarDataPacket::PACKET_HAS_AVATAR_SCALE : 0)
+        | (lookAtPositionChangedSince(lastSentTime) ? AvatarDataPacket::PACKET_HAS_LOOK_AT_POSITION : 0)
+        | (audioLoudnessChangedSince(lastSentTime) ? AvatarDataPacket::PACKET_HAS_AUDIO_LOUDNESS : 0)
+        | (sensorToWorldMatrixChangedSince(lastSentTime) ? AvatarDataPacket::PACKET_HAS_SENSOR_TO_WORLD_MATRIX : 0)
+        | (additionalFlagsChangedSince(lastSentTime) ? AvatarDataPacket::PACKET_HAS_ADDITIONAL_FLAGS : 0)
+        | (parentInfoChangedSince(lastSentTime) ? AvatarDataPacket::PACKET_HAS_PARENT_INFO : 0)
+        | (tranlationChangedSince(lastSentTime) ? AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION : 0)
+        | (faceTrackerInfoChangedSince(lastSentTime) ? AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO : 0);
+}
+
 
 // we want to track outbound data in this case...
 QByteArray AvatarData::toByteArrayStateful(AvatarDataDetail dataDetail, bool dropFaceTracking) {
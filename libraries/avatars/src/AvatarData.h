@@ -423,6 +423,11 @@ public:
         AvatarDataPacket::HasFlags& hasFlagsOut, bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition,
         QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut = nullptr) const;
 
+    // the sections that changed since lastSentTime, as PACKET_HAS_ flags. Encodes of this avatar with the same detail,
+    // changed sections, distance level and last sent joints are the same, so mixers can share them between receivers
+    AvatarDataPacket::HasFlags getChangedSinceFlags(quint64 lastSentTime) const;
+    float getDistanceBasedMinRotationDOT(glm::vec3 viewerPosition) const;
+
     virtual void doneEncoding(bool cullSmallChanges);
 
     /// \return true if an error should be logged
@@ -734,7 +739,6 @@ public slots:
 protected:
     void lazyInitHeadData() const;
 
-    float getDistanceBasedMinRotationDOT(glm::vec3 viewerPosition) const;
     float getDistanceBasedMinTranslationDistance(glm::vec3 viewerPosition) const;
 
     bool avatarBoundingBoxChangedSince(quint64 time) const { return _avatarBoundingBoxChanged >= time; }
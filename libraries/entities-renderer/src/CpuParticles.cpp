@@ -0,0 +1,192 @@
+//
+//  CpuParticles.cpp
+//  libraries/entities-renderer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CpuParticles.h"
+
+#include <algorithm>
+
+using namespace render::entities;
+
+static const size_t MIN_CAPACITY = 64;
+
+//
+// Integration kernels
+//
+// Each integrates one axis of particles [0, count): position += velocity * dt + 0.5 * acceleration * dt^2, then
+// velocity += acceleration * dt, in the same order of operations as the scalar code so the results match it exactly.
+//
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+static void integrateAxis(float* positions, float* velocities, const float* accelerations, size_t count,
+                          float deltaTime) {
+    const float halfDeltaTimeSquared = 0.5f * deltaTime * deltaTime;
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 halfDt2 = _mm_set1_ps(halfDeltaTimeSquared);
+
+    size_t numVectorized = count & ~(size_t)3;
+    for (size_t i = 0; i < numVectorized; i += 4) {
+        __m128 p = _mm_loadu_ps(&positions[i]);
+        __m128 v = _mm_loadu_ps(&velocities[i]);
+        __m128 a = _mm_loadu_ps(&accelerations[i]);
+        p = _mm_add_ps(p, _mm_add_ps(_mm_mul_ps(v, dt), _mm_mul_ps(halfDt2, a)));
+        v = _mm_add_ps(v, _mm_mul_ps(a, dt));
+        _mm_storeu_ps(&positions[i], p);
+        _mm_storeu_ps(&velocities[i], v);
+    }
+
+    for (size_t i = numVectorized; i < count; i++) {
+        positions[i] += velocities[i] * deltaTime + halfDeltaTimeSquared * accelerations[i];
+        velocities[i] += accelerations[i] * deltaTime;
+    }
+}
+
+static void addToAll(float* values, size_t count, float addend) {
+    const __m128 a = _mm_set1_ps(addend);
+
+    size_t numVectorized = count & ~(size_t)3;
+    for (size_t i = 0; i < numVectorized; i += 4) {
+        _mm_storeu_ps(&values[i], _mm_add_ps(_mm_loadu_ps(&values[i]), a));
+    }
+
+    for (size_t i = numVectorized; i < count; i++) {
+        values[i] += addend;
+    }
+}
+
+#else   // portable reference code
+
+static void integrateAxis(float* positions, float* velocities, const float* accelerations, size_t count,
+                          float deltaTime) {
+    const float halfDeltaTimeSquared = 0.5f * deltaTime * deltaTime;
+    for (size_t i = 0; i < count; i++) {
+        positions[i] += velocities[i] * deltaTime + halfDeltaTimeSquared * accelerations[i];
+        velocities[i] += accelerations[i] * deltaTime;
+    }
+}
+
+static void addToAll(float* values, size_t count, float addend) {
+    for (size_t i = 0; i < count; i++) {
+        values[i] += addend;
+    }
+}
+
+#endif
+
+// copies the ring [head, head + size) of values to the start of a new array of newCapacity
+template <typename T>
+static void linearize(std::vector<T>& values, size_t head, size_t size, size_t newCapacity) {
+    std::vector<T> grown(newCapacity);
+    size_t firstSpan = std::min(size, values.size() - head);
+    std::copy(values.begin() + head, values.begin() + head + firstSpan, grown.begin());
+    std::copy(values.begin(), values.begin() + (size - firstSpan), grown.begin() + firstSpan);
+    values.swap(grown);
+}
+
+template <typename F>
+void CpuParticles::forEachSpan(F f) const {
+    size_t end = _head + _size;
+    if (end <= _capacity) {
+        if (_size > 0) {
+            f(_head, end);
+        }
+    } else {
+        f(_head, _capacity);
+        f(0, end - _capacity);
+    }
+}
+
+void CpuParticles::clear() {
+    _head = 0;
+    _size = 0;
+}
+
+void CpuParticles::push(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& acceleration,
+                        float seed, uint64_t expiration) {
+    if (_size == _capacity) {
+        grow();
+    }
+
+    size_t i = (_head + _size) & (_capacity - 1);
+    _seeds[i] = seed;
+    _lifetimes[i] = 0.0f;
+    _expirations[i] = expiration;
+    _positionsX[i] = position.x;
+    _positionsY[i] = position.y;
+    _positionsZ[i] = position.z;
+    _velocitiesX[i] = velocity.x;
+    _velocitiesY[i] = velocity.y;
+    _velocitiesZ[i] = velocity.z;
+    _accelerationsX[i] = acceleration.x;
+    _accelerationsY[i] = acceleration.y;
+    _accelerationsZ[i] = acceleration.z;
+    ++_size;
+}
+
+void CpuParticles::expire(uint64_t now, size_t maxParticles) {
+    if (_size > maxParticles) {
+        _head = (_head + (_size - maxParticles)) & (_capacity - 1);
+        _size = maxParticles;
+    }
+
+    while (_size > 0 && _expirations[_head] <= now) {
+        _head = (_head + 1) & (_capacity - 1);
+        --_size;
+    }
+
+    if (_size == 0) {
+        _head = 0;
+    }
+}
+
+void CpuParticles::integrate(float deltaTime) {
+    forEachSpan([&](size_t begin, size_t end) {
+        size_t count = end - begin;
+        integrateAxis(&_positionsX[begin], &_velocitiesX[begin], &_accelerationsX[begin], count, deltaTime);
+        integrateAxis(&_positionsY[begin], &_velocitiesY[begin], &_accelerationsY[begin], count, deltaTime);
+        integrateAxis(&_positionsZ[begin], &_velocitiesZ[begin], &_accelerationsZ[begin], count, deltaTime);
+        addToAll(&_lifetimes[begin], count, deltaTime);
+    });
+}
+
+void CpuParticles::writeGpuParticles(GpuParticle* gpuParticles) const {
+    GpuParticle* out = gpuParticles;
+    forEachSpan([&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++, out++) {
+            out->xyz = glm::vec3(_positionsX[i], _positionsY[i], _positionsZ[i]);
+            out->uv = glm::vec2(_lifetimes[i], _seeds[i]);
+        }
+    });
+}
+
+void CpuParticles::grow() {
+    size_t newCapacity = std::max(_capacity * 2, MIN_CAPACITY);
+
+    linearize(_seeds, _head, _size, newCapacity);
+    linearize(_lifetimes, _head, _size, newCapacity);
+    linearize(_expirations, _head, _size, newCapacity);
+    linearize(_positionsX, _head, _size, newCapacity);
+    linearize(_positionsY, _head, _size, newCapacity);
+    linearize(_positionsZ, _head, _size, newCapacity);
+    linearize(_velocitiesX, _head, _size, newCapacity);
+    linearize(_velocitiesY, _head, _size, newCapacity);
+    linearize(_velocitiesZ, _head, _size, newCapacity);
+    linearize(_accelerationsX, _head, _size, newCapacity);
+    linearize(_accelerationsY, _head, _size, newCapacity);
+    linearize(_accelerationsZ, _head, _size, newCapacity);
+
+    _capacity = newCapacity;
+    _head = 0;
+}
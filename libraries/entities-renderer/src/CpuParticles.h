@@ -0,0 +1,73 @@
+//
+//  CpuParticles.h
+//  libraries/entities-renderer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CpuParticles_h
+#define hifi_CpuParticles_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace render { namespace entities {
+
+// The live particles of one emitter, oldest first. They're kept as a ring buffer of structure-of-arrays: integrating
+// them runs 4 at a time with SSE, and since they expire in the order they were emitted, expiring them moves the head.
+class CpuParticles {
+public:
+    // the per-instance vertex data of a particle, as the shader reads it
+    struct GpuParticle {
+        glm::vec3 xyz; // Position
+        glm::vec2 uv; // Lifetime + seed
+    };
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    void clear();
+
+    void push(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& acceleration,
+              float seed, uint64_t expiration);
+
+    // drops the oldest particles while there are more than maxParticles or they have expired by now
+    void expire(uint64_t now, size_t maxParticles);
+
+    void integrate(float deltaTime);
+
+    // writes size() particles to gpuParticles, oldest first
+    void writeGpuParticles(GpuParticle* gpuParticles) const;
+
+private:
+    void grow();
+
+    // calls f(begin, end) over the contiguous spans of the ring, oldest first: at most two of them
+    template <typename F>
+    void forEachSpan(F f) const;
+
+    size_t _capacity { 0 }; // always a power of two
+    size_t _head { 0 }; // index of the oldest particle
+    size_t _size { 0 };
+
+    std::vector<float> _seeds;
+    std::vector<float> _lifetimes;
+    std::vector<uint64_t> _expirations;
+    std::vector<float> _positionsX;
+    std::vector<float> _positionsY;
+    std::vector<float> _positionsZ;
+    std::vector<float> _velocitiesX;
+    std::vector<float> _velocitiesY;
+    std::vector<float> _velocitiesZ;
+    std::vector<float> _accelerationsX;
+    std::vector<float> _accelerationsY;
+    std::vector<float> _accelerationsZ;
+};
+
+} } // namespace
+
+#endif // hifi_CpuParticles_h
@@ -35,6 +35,7 @@
 
 #include "EntitiesRendererLogging.h"
 #include "RenderableEntityItem.h"
+#include "RenderableParticleEffectEntityItem.h"
 
 #include "RenderableWebEntityItem.h"
 
@@ -422,6 +423,9 @@ void EntityTreeRenderer::update(bool simulate) {
             }
         }
 
+        // step the particle effects that were rendered last frame
+        ParticleEffectEntityRenderer::stepSimulations();
+
         if (simulate) {
             // Handle enter/leave entity logic
             checkEnterLeaveEntities();
@@ -10,9 +10,15 @@
 
 #include "RenderableParticleEffectEntityItem.h"
 
+#include <mutex>
+#include <unordered_set>
+
+#include <tbb/parallel_for.h>
+
 #include <StencilMaskPass.h>
 
 #include <GeometryCache.h>
+#include <Profile.h>
 
 #include "textured_particle_vert.h"
 #include "textured_particle_frag.h"
@@ -52,13 +58,11 @@ static ShapePipelinePointer shapePipelineFactory(const ShapePlumber& plumber, co
     return std::make_shared<render::ShapePipeline>(texturedPipeline, nullptr, nullptr, nullptr);
 }
 
-struct GpuParticle {
-    GpuParticle(const glm::vec3& xyzIn, const glm::vec2& uvIn) : xyz(xyzIn), uv(uvIn) {}
-    glm::vec3 xyz; // Position
-    glm::vec2 uv; // Lifetime + seed
-};
+using GpuParticle = CpuParticles::GpuParticle;
 
-using GpuParticles = std::vector<GpuParticle>;
+// every live particle renderer, so the main thread can step them all at once
+static std::mutex _renderersMutex;
+static std::unordered_set<ParticleEffectEntityRenderer*> _renderers;
 
 ParticleEffectEntityRenderer::ParticleEffectEntityRenderer(const EntityItemPointer& entity) : Parent(entity) {
     ParticleUniforms uniforms;
@@ -74,6 +78,34 @@ ParticleEffectEntityRenderer::ParticleEffectEntityRenderer(const EntityItemPoint
         _vertexFormat->setAttribute(gpu::Stream::COLOR, 0, gpu::Element::VEC2F_UV,
             offsetof(GpuParticle, uv), gpu::Stream::PER_INSTANCE);
     });
+
+    std::lock_guard<std::mutex> lock(_renderersMutex);
+    _renderers.insert(this);
+}
+
+ParticleEffectEntityRenderer::~ParticleEffectEntityRenderer() {
+    std::lock_guard<std::mutex> lock(_renderersMutex);
+    _renderers.erase(this);
+}
+
+void ParticleEffectEntityRenderer::stepSimulations() {
+    PROFILE_RANGE(simulation_physics, "stepParticles");
+    std::lock_guard<std::mutex> lock(_renderersMutex);
+
+    std::vector<ParticleEffectEntityRenderer*> renderers;
+    renderers.reserve(_renderers.size());
+    for (auto renderer : _renderers) {
+        if (renderer->_wasRendered.exchange(false)) {
+            renderers.push_back(renderer);
+        }
+    }
+
+    // emitters don't share any state, so each is stepped on its own
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, renderers.size()), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            renderers[i]->stepSimulation();
+        }
+    });
 }
 
 bool ParticleEffectEntityRenderer::needsRenderUpdateFromTypedEntity(const TypedEntityPointer& entity) const {
@@ -101,12 +133,14 @@ void ParticleEffectEntityRenderer::doRenderUpdateSynchronousTyped(const ScenePoi
     }
     
     if (resultWithReadLock<bool>([&]{ return _particleProperties != newParticleProperties; })) {
-        _timeUntilNextEmit = 0;
         withWriteLock([&]{
+            _timeUntilNextEmit = 0;
             _particleProperties = newParticleProperties;
         });
     }
-    _emitting = entity->getIsEmitting();
+    withWriteLock([&] {
+        _emitting = entity->getIsEmitting();
+    });
 
     bool hasTexture = resultWithReadLock<bool>([&]{ return _particleProperties.textures.isEmpty(); });
     if (hasTexture) {
@@ -163,8 +197,11 @@ Item::Bound ParticleEffectEntityRenderer::getBound() {
 
 static const size_t VERTEX_PER_PARTICLE = 4;
 
-ParticleEffectEntityRenderer::CpuParticle ParticleEffectEntityRenderer::createParticle(uint64_t now, const Transform& baseTransform, const particle::Properties& particleProperties) {
-    CpuParticle particle;
+void ParticleEffectEntityRenderer::createParticle(uint64_t now, const Transform& baseTransform, const particle::Properties& particleProperties,
+                                                  CpuParticles& particles) {
+    glm::vec3 position;
+    glm::vec3 velocity;
+    glm::vec3 acceleration;
 
     const auto& accelerationSpread = particleProperties.emission.acceleration.spread;
     const auto& azimuthStart = particleProperties.azimuth.start;
@@ -178,10 +215,10 @@ ParticleEffectEntityRenderer::CpuParticle ParticleEffectEntityRenderer::createPa
     const auto& polarStart = particleProperties.polar.start;
     const auto& polarFinish = particleProperties.polar.finish;
 
-    particle.seed = randFloatInRange(-1.0f, 1.0f);
-    particle.expiration = now + (uint64_t)(particleProperties.lifespan * USECS_PER_SECOND);
+    float seed = randFloatInRange(-1.0f, 1.0f);
+    uint64_t expiration = now + (uint64_t)(particleProperties.lifespan * USECS_PER_SECOND);
     if (particleProperties.emission.shouldTrail) {
-        particle.position = baseTransform.getTranslation();
+        position = baseTransform.getTranslation();
         emitOrientation = baseTransform.getRotation() * emitOrientation;
     }
 
@@ -189,8 +226,8 @@ ParticleEffectEntityRenderer::CpuParticle ParticleEffectEntityRenderer::createPa
     if (polarStart == 0.0f && polarFinish == 0.0f && emitDimensions.z == 0.0f) {
         // Emit along z-axis from position
 
-        particle.velocity = (emitSpeed + 0.2f * speedSpread) * (emitOrientation * Vectors::UNIT_Z);
-        particle.acceleration = emitAcceleration + randFloatInRange(-1.0f, 1.0f) * accelerationSpread;
+        velocity = (emitSpeed + 0.2f * speedSpread) * (emitOrientation * Vectors::UNIT_Z);
+        acceleration = emitAcceleration + randFloatInRange(-1.0f, 1.0f) * accelerationSpread;
 
     } else {
         // Emit around point or from ellipsoid
@@ -233,14 +270,14 @@ ParticleEffectEntityRenderer::CpuParticle ParticleEffectEntityRenderer::createPa
                 radii.y > 0.0f ? y / (radii.y * radii.y) : 0.0f,
                 radii.z > 0.0f ? z / (radii.z * radii.z) : 0.0f
             ));
-            particle.position += emitOrientation * emitPosition;
+            position += emitOrientation * emitPosition;
         }
 
-        particle.velocity = (emitSpeed + randFloatInRange(-1.0f, 1.0f) * speedSpread) * (emitOrientation * emitDirection);
-        particle.acceleration = emitAcceleration + randFloatInRange(-1.0f, 1.0f) * accelerationSpread;
+        velocity = (emitSpeed + randFloatInRange(-1.0f, 1.0f) * speedSpread) * (emitOrientation * emitDirection);
+        acceleration = emitAcceleration + randFloatInRange(-1.0f, 1.0f) * accelerationSpread;
     }
 
-    return particle;
+    particles.push(position, velocity, acceleration, seed, expiration);
 }
 
 void ParticleEffectEntityRenderer::stepSimulation() {
@@ -252,56 +289,39 @@ void ParticleEffectEntityRenderer::stepSimulation() {
     const auto now = usecTimestampNow();
     const auto interval = std::min<uint64_t>(USECS_PER_SECOND / 60, now - _lastSimulated);
     _lastSimulated = now;
-    
+
     particle::Properties particleProperties;
+    Transform modelTransform;
     withReadLock([&]{
         particleProperties = _particleProperties;
+        modelTransform = getModelTransform();
     });
 
-    if (_emitting && particleProperties.emitting()) {
-        const auto& modelTransform = getModelTransform();
-        uint64_t emitInterval = particleProperties.emitIntervalUsecs();
-        if (emitInterval > 0 && interval >= _timeUntilNextEmit) {
-            auto timeRemaining = interval;
-            while (timeRemaining > _timeUntilNextEmit) {
-                // emit particle
-                _cpuParticles.push_back(createParticle(now, modelTransform, particleProperties));
-                _timeUntilNextEmit = emitInterval;
-                if (emitInterval < timeRemaining) {
-                    timeRemaining -= emitInterval;
+    withWriteLock([&] {
+        if (_emitting && particleProperties.emitting()) {
+            uint64_t emitInterval = particleProperties.emitIntervalUsecs();
+            if (emitInterval > 0 && interval >= _timeUntilNextEmit) {
+                auto timeRemaining = interval;
+                while (timeRemaining > _timeUntilNextEmit) {
+                    // emit particle
+                    createParticle(now, modelTransform, particleProperties, _cpuParticles);
+                    _timeUntilNextEmit = emitInterval;
+                    if (emitInterval < timeRemaining) {
+                        timeRemaining -= emitInterval;
+                    }
                 }
+            } else {
+                _timeUntilNextEmit -= interval;
             }
-        } else {
-            _timeUntilNextEmit -= interval;
         }
-    }
-
-    // Kill any particles that have expired or are over the max size
-    while (_cpuParticles.size() > particleProperties.maxParticles || (!_cpuParticles.empty() && _cpuParticles.front().expiration <= now)) {
-        _cpuParticles.pop_front();
-    }
 
-    const float deltaTime = (float)interval / (float)USECS_PER_SECOND;
-    // update the particles 
-    for (auto& particle : _cpuParticles) {
-        particle.integrate(deltaTime);
-    }
+        // Kill any particles that have expired or are over the max size
+        _cpuParticles.expire(now, particleProperties.maxParticles);
 
-    // Build particle primitives
-    static GpuParticles gpuParticles;
-    gpuParticles.clear();
-    gpuParticles.reserve(_cpuParticles.size()); // Reserve space
-    std::transform(_cpuParticles.begin(), _cpuParticles.end(), std::back_inserter(gpuParticles), [](const CpuParticle& particle) {
-        return GpuParticle(particle.position, glm::vec2(particle.lifetime, particle.seed));
+        const float deltaTime = (float)interval / (float)USECS_PER_SECOND;
+        // update the particles
+        _cpuParticles.integrate(deltaTime);
     });
-
-    // Update particle buffer
-    auto& particleBuffer = _particleBuffer;
-    size_t numBytes = sizeof(GpuParticle) * gpuParticles.size();
-    particleBuffer->resize(numBytes);
-    if (numBytes != 0) {
-        particleBuffer->setData(numBytes, (const gpu::Byte*)gpuParticles.data());
-    }
 }
 
 void ParticleEffectEntityRenderer::doRender(RenderArgs* args) {
@@ -311,7 +331,16 @@ void ParticleEffectEntityRenderer::doRender(RenderArgs* args) {
 
 
     // FIXME migrate simulation to a compute stage
-    stepSimulation();
+    _wasRendered = true;
+
+    // Update particle buffer, writing the particles straight into it
+    withReadLock([&] {
+        size_t numParticles = _cpuParticles.size();
+        _particleBuffer->resize(sizeof(GpuParticle) * numParticles);
+        if (numParticles != 0) {
+            _cpuParticles.writeGpuParticles(_particleBuffer->editRange<GpuParticle>(0, numParticles));
+        }
+    });
 
     gpu::Batch& batch = *args->_batch;
     if (_networkTexture && _networkTexture->isLoaded()) {
@@ -11,10 +11,14 @@
 #ifndef hifi_RenderableParticleEffectEntityItem_h
 #define hifi_RenderableParticleEffectEntityItem_h
 
+#include <atomic>
+
 #include "RenderableEntityItem.h"
 #include <ParticleEffectEntityItem.h>
 #include <TextureCache.h>
 
+#include "CpuParticles.h"
+
 namespace render { namespace entities {
 
 class ParticleEffectEntityRenderer : public TypedEntityRenderer<ParticleEffectEntityItem> {
@@ -23,6 +27,11 @@ class ParticleEffectEntityRenderer : public TypedEntityRenderer<ParticleEffectEn
 
 public:
     ParticleEffectEntityRenderer(const EntityItemPointer& entity);
+    ~ParticleEffectEntityRenderer();
+
+    // Steps the particles of every emitter that has been rendered since the last step, in parallel.
+    // Called once a frame from the main thread, so that the render thread only has to copy them out
+    static void stepSimulations();
 
 protected:
     virtual bool needsRenderUpdateFromTypedEntity(const TypedEntityPointer& entity) const override;
@@ -43,40 +52,6 @@ private:
     using Buffer = gpu::Buffer;
     using BufferView = gpu::BufferView;
 
-    // CPU particles
-    // FIXME either switch to GPU compute particles or switch to simd updating of the particles
-#if 1
-    struct CpuParticle {
-        float seed{ 0.0f };
-        uint64_t expiration { 0 };
-        float lifetime { 0.0f };
-        glm::vec3 position;
-        glm::vec3 velocity;
-        glm::vec3 acceleration;
-
-        void integrate(float deltaTime) {
-            glm::vec3 atSquared = (0.5f * deltaTime * deltaTime) * acceleration;
-            position += velocity * deltaTime + atSquared;
-            velocity += acceleration * deltaTime;
-            lifetime += deltaTime;
-        }
-    };
-    using CpuParticles = std::deque<CpuParticle>;
-#else
-    struct CpuParticles {
-        std::vector<float> seeds;
-        std::vector<float> lifetimes;
-        std::vector<vec4> positions;
-        std::vector<vec4> velocities;
-        std::vector<vec4> accelerations;
-
-        size_t size() const;
-        void resize(size_t size);
-        void integrate(float deltaTime);
-    };
-#endif
-
-
     template<typename T>
     struct InterpolationData {
         T start;
@@ -93,13 +68,15 @@ private:
     };
 
 
-    static CpuParticle createParticle(uint64_t now, const Transform& baseTransform, const particle::Properties& particleProperties);
+    static void createParticle(uint64_t now, const Transform& baseTransform, const particle::Properties& particleProperties,
+                               CpuParticles& particles);
     void stepSimulation();
 
     particle::Properties _particleProperties;
     CpuParticles _cpuParticles;
     bool _emitting { false };
     uint64_t _timeUntilNextEmit { 0 };
+    std::atomic<bool> _wasRendered { false }; // since the last step, so emitters that aren't in view are paused
     BufferPointer _particleBuffer{ std::make_shared<Buffer>() };
     BufferView _uniformBuffer;
     quint64 _lastSimulated { 0 };
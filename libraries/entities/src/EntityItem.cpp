@@ -43,6 +43,9 @@ int entityItemPointernMetaTypeId = qRegisterMetaType<EntityItemPointer>();
 
 int EntityItem::_maxActionsDataSize = 800;
 quint64 EntityItem::_rememberDeletedActionTime = 20 * USECS_PER_SECOND;
+std::atomic<quint64> EntityItem::_encodeCacheHits { 0 };
+std::atomic<quint64> EntityItem::_encodeCacheMisses { 0 };
+std::atomic<quint64> EntityItem::_encodeCacheBytesReused { 0 };
 QString EntityItem::_marketplacePublicKey;
 
 EntityItem::EntityItem(const EntityItemID& entityItemID) :
@@ -140,6 +143,41 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
 
     OctreeElement::AppendState appendState = OctreeElement::COMPLETED; // assume the best
 
+    EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
+    EntityPropertyFlags requestedProperties = getEntityProperties(params);
+
+    // If we are being called for a subsequent pass at appendEntityData() that failed to completely encode this item,
+    // then our entityTreeElementExtraEncodeData should include data about which properties we need to append.
+    bool isContinuation = entityTreeElementExtraEncodeData && entityTreeElementExtraEncodeData->entities.contains(getEntityItemID());
+    if (isContinuation) {
+        requestedProperties = entityTreeElementExtraEncodeData->entities.value(getEntityItemID());
+    }
+
+    // anything but a continuation is encoded the same for every viewer until the entity changes,
+    // so is copied from the last complete encoding when there is one
+    EncodedData encodeVersion;
+    if (!isContinuation) {
+        encodeVersion = getEncodeVersion();
+        encodeVersion.requestedProperties = requestedProperties;
+
+        QByteArray encodedData;
+        {
+            std::lock_guard<std::mutex> lock(_encodedDataMutex);
+            if (_encodedData.isSameVersion(encodeVersion) && _encodedData.requestedProperties == requestedProperties) {
+                encodedData = _encodedData.data;
+            }
+        }
+
+        // if it doesn't fit whole, encode it again so that what does fit can be sent
+        if (!encodedData.isEmpty() && packetData->appendRawData(encodedData)) {
+            _encodeCacheHits++;
+            _encodeCacheBytesReused += encodedData.size();
+            params.trackSend(getID(), getLastEdited());
+            return OctreeElement::COMPLETED;
+        }
+        _encodeCacheMisses++;
+    }
+
     // encode our ID as a byte count coded byte stream
     QByteArray encodedID = getID().toRfc4122();
 
@@ -158,17 +196,9 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     QByteArray encodedSimulatedDelta = simulatedDeltaCoder;
 
 
-    EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
-    EntityPropertyFlags requestedProperties = getEntityProperties(params);
-
-    // If we are being called for a subsequent pass at appendEntityData() that failed to completely encode this item,
-    // then our entityTreeElementExtraEncodeData should include data about which properties we need to append.
-    if (entityTreeElementExtraEncodeData && entityTreeElementExtraEncodeData->entities.contains(getEntityItemID())) {
-        requestedProperties = entityTreeElementExtraEncodeData->entities.value(getEntityItemID());
-    }
-
     EntityPropertyFlags propertiesDidntFit = requestedProperties;
 
+    int startOfEntity = packetData->getUncompressedByteOffset();
     LevelDetails entityLevel = packetData->startLevel();
 
     quint64 lastEdited = getLastEdited();
@@ -318,6 +348,18 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         }
 
         packetData->endLevel(entityLevel);
+
+        // keep a complete encoding for the next viewer, unless the entity changed while it was being encoded
+        if (!isContinuation && appendState == OctreeElement::COMPLETED) {
+            EncodedData encodedVersion = getEncodeVersion();
+            if (encodedVersion.isSameVersion(encodeVersion)) {
+                int endOfEntity = packetData->getUncompressedByteOffset();
+                encodeVersion.data = QByteArray((const char*)packetData->getUncompressedData(startOfEntity), endOfEntity - startOfEntity);
+
+                std::lock_guard<std::mutex> lock(_encodedDataMutex);
+                _encodedData = std::move(encodeVersion);
+            }
+        }
     } else {
         packetData->discardLevel(entityLevel);
         appendState = OctreeElement::NONE; // if we got here, then we didn't include the item
@@ -337,6 +379,25 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     return appendState;
 }
 
+EntityItem::EncodedData EntityItem::getEncodeVersion() const {
+    EncodedData version;
+    withReadLock([&] {
+        version.lastEdited = _lastEdited;
+        version.lastUpdated = _lastUpdated;
+        version.lastSimulated = _lastSimulated;
+        version.changedOnServer = _changedOnServer;
+        version.queryAACube = _queryAACube;
+    });
+    version.encodeVersion = _encodeVersion;
+    return version;
+}
+
+void EntityItem::getEncodeCacheStats(quint64& hits, quint64& misses, quint64& bytesReused) {
+    hits = _encodeCacheHits;
+    misses = _encodeCacheMisses;
+    bytesReused = _encodeCacheBytesReused;
+}
+
 // TODO: My goal is to get rid of this concept completely. The old code (and some of the current code) used this
 // result to calculate if a packet being sent to it was potentially bad or corrupt. I've adjusted this to now
 // only consider the minimum header bytes as being required. But it would be preferable to completely eliminate
@@ -1973,6 +2034,7 @@ bool EntityItem::addAction(EntitySimulationPointer simulation, EntityDynamicPoin
         if (result) {
             action->setIsMine(true);
             _dynamicDataDirty = true;
+            bumpEncodeVersion();
         } else {
             removeActionInternal(action->getID());
         }
@@ -1999,6 +2061,7 @@ bool EntityItem::addActionInternal(EntitySimulationPointer simulation, EntityDyn
     serializeActions(success, newDataCache);
     if (success) {
         _allActionsDataCache = newDataCache;
+        bumpEncodeVersion();
         _flags |= Simulation::DIRTY_PHYSICS_ACTIVATION;
 
         auto actionType = action->getType();
@@ -2036,6 +2099,7 @@ bool EntityItem::updateAction(EntitySimulationPointer simulation, const QUuid& a
         if (success) {
             action->setIsMine(true);
             serializeActions(success, _allActionsDataCache);
+            bumpEncodeVersion();
             _flags |= Simulation::DIRTY_PHYSICS_ACTIVATION;
         } else {
             qCDebug(entities) << "EntityItem::updateAction failed";
@@ -2115,6 +2179,7 @@ bool EntityItem::removeActionInternal(const QUuid& actionID, EntitySimulationPoi
 
         bool success = true;
         serializeActions(success, _allActionsDataCache);
+        bumpEncodeVersion();
         _flags |= Simulation::DIRTY_PHYSICS_ACTIVATION;
         setDynamicDataNeedsTransmit(true);
         return success;
@@ -2135,6 +2200,7 @@ bool EntityItem::clearActions(EntitySimulationPointer simulation) {
         // empty _serializedActions means no actions for the EntityItem
         _actionsToRemove.clear();
         _allActionsDataCache.clear();
+        bumpEncodeVersion();
         _flags |= Simulation::DIRTY_PHYSICS_ACTIVATION;
         _flags |= Simulation::DIRTY_COLLISION_GROUP; // may need to not collide with own avatar
     });
@@ -2235,6 +2301,7 @@ void EntityItem::deserializeActionsInternal() {
     }
 
     _dynamicDataDirty = true;
+    bumpEncodeVersion();
 
     return;
 }
@@ -2255,6 +2322,7 @@ void EntityItem::setDynamicData(QByteArray dynamicData) {
 void EntityItem::setDynamicDataInternal(QByteArray dynamicData) {
     if (_allActionsDataCache != dynamicData) {
         _allActionsDataCache = dynamicData;
+        bumpEncodeVersion();
         deserializeActionsInternal();
     }
     checkWaitingToRemove();
@@ -12,7 +12,9 @@
 #ifndef hifi_EntityItem_h
 #define hifi_EntityItem_h
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <stdint.h>
 
 #include <glm/glm.hpp>
@@ -123,6 +125,9 @@ public:
     virtual OctreeElement::AppendState appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                                         EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData) const;
 
+    // complete encodings reused from an entity's encode cache, those encoded afresh, and the bytes copied instead of encoded
+    static void getEncodeCacheStats(quint64& hits, quint64& misses, quint64& bytesReused);
+
     virtual void appendSubclassData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                     EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData,
                                     EntityPropertyFlags& requestedProperties,
@@ -519,6 +524,35 @@ protected:
     quint64 _created { 0 };
     quint64 _changedOnServer { 0 };
 
+    // The last complete encoding of this entity by appendEntityData, which every viewer is sent until the entity changes.
+    //   Edits and simulation touch the change stamps; the encode version is bumped by the setters that don't (actions,
+    //   animation), and the query cube, which the octree recomputes as things move, is compared by value
+    struct EncodedData {
+        quint64 lastEdited { 0 };
+        quint64 lastUpdated { 0 };
+        quint64 lastSimulated { 0 };
+        quint64 changedOnServer { 0 };
+        quint64 encodeVersion { 0 };
+        AACube queryAACube;
+        EntityPropertyFlags requestedProperties;
+        QByteArray data;
+
+        bool isSameVersion(const EncodedData& other) const {
+            return lastEdited == other.lastEdited && lastUpdated == other.lastUpdated &&
+                lastSimulated == other.lastSimulated && changedOnServer == other.changedOnServer &&
+                encodeVersion == other.encodeVersion && queryAACube == other.queryAACube;
+        }
+    };
+    EncodedData getEncodeVersion() const;
+    void bumpEncodeVersion() { _encodeVersion++; }
+    std::atomic<quint64> _encodeVersion { 0 };
+    mutable std::mutex _encodedDataMutex;
+    mutable EncodedData _encodedData;
+
+    static std::atomic<quint64> _encodeCacheHits;
+    static std::atomic<quint64> _encodeCacheMisses;
+    static std::atomic<quint64> _encodeCacheBytesReused;
+
     mutable AABox _cachedAABox;
     mutable AACube _maxAACube;
     mutable AACube _minAACube;
@@ -0,0 +1,271 @@
+//
+//  EntitySpatialIndex.cpp
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <OctalCode.h>
+#include <OctreeConstants.h>
+
+void EntitySpatialIndex::insert(const OctreeElementPointer& element) {
+    int level = getElementLevel(element);
+    QWriteLocker locker(&_lock);
+    bool inserted;
+    if (level > MAX_INDEXED_LEVEL) {
+        inserted = _unindexedElements.emplace(element.get(), element).second;
+    } else {
+        inserted = _levels[level].emplace(getElementCell(element), element).second;
+    }
+    if (inserted) {
+        ++_numElements;
+    }
+}
+
+void EntitySpatialIndex::remove(const OctreeElementPointer& element) {
+    int level = getElementLevel(element);
+    QWriteLocker locker(&_lock);
+    size_t numErased;
+    if (level > MAX_INDEXED_LEVEL) {
+        numErased = _unindexedElements.erase(element.get());
+    } else {
+        numErased = _levels[level].erase(getElementCell(element));
+    }
+    _numElements -= numErased;
+}
+
+void EntitySpatialIndex::clear() {
+    QWriteLocker locker(&_lock);
+    for (auto& level : _levels) {
+        level.clear();
+    }
+    _unindexedElements.clear();
+    _numElements = 0;
+}
+
+size_t EntitySpatialIndex::getNumElements() const {
+    QReadLocker locker(&_lock);
+    return _numElements;
+}
+
+int EntitySpatialIndex::getElementLevel(const OctreeElementPointer& element) {
+    return numberOfThreeBitSectionsInCode(element->getOctalCode());
+}
+
+EntitySpatialIndex::Cell EntitySpatialIndex::getElementCell(const OctreeElementPointer& element) {
+    // up to MAX_INDEXED_LEVEL the element corners are exact in float, so this is an exact division
+    const AACube& cube = element->getAACube();
+    glm::vec3 cell = glm::round((cube.getCorner() + (float)HALF_TREE_SCALE) / cube.getScale());
+    return { (int32_t)cell.x, (int32_t)cell.y, (int32_t)cell.z };
+}
+
+void EntitySpatialIndex::findElements(const AABox& bounds, const ElementVisitor& visitor) const {
+    const double halfTreeScale = (double)HALF_TREE_SCALE;
+    const glm::vec3 minimum = bounds.getMinimumPoint();
+    const glm::vec3 maximum = bounds.getMaximumPoint();
+
+    QReadLocker locker(&_lock);
+    for (int level = 0; level <= MAX_INDEXED_LEVEL; level++) {
+        const Level& cells = _levels[level];
+        if (cells.empty()) {
+            continue;
+        }
+
+        const double numCells = (double)((int64_t)1 << level);
+        const double cellScale = (double)TREE_SCALE / numCells;
+
+        // touching counts, so a bound that falls on a cell boundary also takes in the cell before it
+        int32_t low[3];
+        int32_t high[3];
+        double rangeSize = 1.0;
+        bool isOutside = false;
+        for (int axis = 0; axis < 3; axis++) {
+            double lowCell = std::max(std::ceil((minimum[axis] + halfTreeScale) / cellScale) - 1.0, 0.0);
+            double highCell = std::min(std::floor((maximum[axis] + halfTreeScale) / cellScale), numCells - 1.0);
+            if (!(lowCell <= highCell)) {
+                isOutside = true;
+                break;
+            }
+            low[axis] = (int32_t)lowCell;
+            high[axis] = (int32_t)highCell;
+            rangeSize *= highCell - lowCell + 1.0;
+        }
+        if (isOutside) {
+            continue;
+        }
+
+        if (rangeSize <= (double)cells.size()) {
+            Cell cell;
+            for (cell.x = low[0]; cell.x <= high[0]; cell.x++) {
+                for (cell.y = low[1]; cell.y <= high[1]; cell.y++) {
+                    for (cell.z = low[2]; cell.z <= high[2]; cell.z++) {
+                        auto itr = cells.find(cell);
+                        if (itr != cells.end()) {
+                            visitor(itr->second);
+                        }
+                    }
+                }
+            }
+        } else {
+            for (auto& entry : cells) {
+                const Cell& cell = entry.first;
+                if (cell.x >= low[0] && cell.x <= high[0] && cell.y >= low[1] && cell.y <= high[1] &&
+                        cell.z >= low[2] && cell.z <= high[2]) {
+                    visitor(entry.second);
+                }
+            }
+        }
+    }
+
+    for (auto& entry : _unindexedElements) {
+        visitor(entry.second);
+    }
+}
+
+void EntitySpatialIndex::addRayCandidate(const OctreeElementPointer& element, const glm::vec3& origin,
+                                         const glm::vec3& direction, std::vector<RayCandidate>& candidates) const {
+    // same test as EntityTreeElement::findRayIntersection
+    const AACube& cube = element->getAACube();
+    float distance;
+    BoxFace face;
+    glm::vec3 surfaceNormal;
+    if (cube.findRayIntersection(origin, direction, distance, face, surfaceNormal)) {
+        candidates.push_back({ cube.contains(origin) ? 0.0f : distance, element });
+    }
+}
+
+void EntitySpatialIndex::findElements(const glm::vec3& origin, const glm::vec3& direction,
+                                      std::vector<RayCandidate>& candidates) const {
+    const double halfTreeScale = (double)HALF_TREE_SCALE;
+
+    // clip the ray to the world, nothing is indexed outside of it
+    double worldEnter = 0.0;
+    double worldExit = std::numeric_limits<double>::max();
+    bool canWalk = false;
+    for (int axis = 0; axis < 3; axis++) {
+        if (!std::isfinite(direction[axis])) {
+            worldExit = -1.0;
+        } else if (direction[axis] == 0.0f) {
+            if (origin[axis] < -halfTreeScale || origin[axis] > halfTreeScale) {
+                worldExit = -1.0;
+            }
+        } else {
+            double t1 = (-halfTreeScale - origin[axis]) / direction[axis];
+            double t2 = (halfTreeScale - origin[axis]) / direction[axis];
+            worldEnter = std::max(worldEnter, std::min(t1, t2));
+            worldExit = std::min(worldExit, std::max(t1, t2));
+            canWalk = true;
+        }
+    }
+    const bool hitsWorld = canWalk && worldEnter <= worldExit;
+    const double pathLength = hitsWorld ? (worldExit - worldEnter) *
+        ((double)std::abs(direction.x) + (double)std::abs(direction.y) + (double)std::abs(direction.z)) : 0.0;
+
+    QReadLocker locker(&_lock);
+    for (int level = 0; level <= MAX_INDEXED_LEVEL; level++) {
+        const Level& cells = _levels[level];
+        if (cells.empty() || (canWalk && !hitsWorld)) {
+            continue;
+        }
+
+        const int64_t numCells = (int64_t)1 << level;
+        const double cellScale = (double)TREE_SCALE / (double)numCells;
+        if (!canWalk || pathLength / cellScale + 3.0 >= (double)cells.size()) {
+            // the ray would cross more cells than there are elements on this level, test them all
+            for (auto& entry : cells) {
+                addRayCandidate(entry.second, origin, direction, candidates);
+            }
+            continue;
+        }
+
+        // walk the cells the ray crosses (Amanatides & Woo)
+        int64_t startCell[3];
+        int step[3];
+        double firstCrossing[3];
+        double crossingInterval[3];
+        // a ray starting on a cell boundary also touches the cells before it, and runs along them if it doesn't
+        // move on that axis; moving backwards it enters them anyway
+        int boundaryAxes = 0;
+        int walkingBoundaryAxes = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            double start = ((double)origin[axis] + worldEnter * direction[axis] + halfTreeScale) / cellScale;
+            startCell[axis] = std::min(std::max((int64_t)std::floor(start), (int64_t)0), numCells - 1);
+            bool isOnBoundary = start == std::floor(start) && startCell[axis] > 0 && startCell[axis] == (int64_t)start;
+            if (isOnBoundary && direction[axis] >= 0.0f) {
+                boundaryAxes |= 1 << axis;
+            }
+            if (direction[axis] > 0.0f) {
+                step[axis] = 1;
+                firstCrossing[axis] = ((double)(startCell[axis] + 1) * cellScale - halfTreeScale - origin[axis]) / direction[axis];
+                crossingInterval[axis] = cellScale / direction[axis];
+            } else if (direction[axis] < 0.0f) {
+                step[axis] = -1;
+                firstCrossing[axis] = ((double)startCell[axis] * cellScale - halfTreeScale - origin[axis]) / direction[axis];
+                crossingInterval[axis] = -cellScale / direction[axis];
+            } else {
+                step[axis] = 0;
+                firstCrossing[axis] = std::numeric_limits<double>::max();
+                crossingInterval[axis] = 0.0;
+                if (isOnBoundary) {
+                    walkingBoundaryAxes |= 1 << axis;
+                }
+            }
+        }
+
+        for (int offsets = 0; offsets < 8; offsets++) {
+            if ((offsets & ~boundaryAxes) != 0) {
+                continue;
+            }
+            int64_t cell[3];
+            double nextCrossing[3];
+            for (int axis = 0; axis < 3; axis++) {
+                cell[axis] = startCell[axis] - ((offsets >> axis) & 1);
+                nextCrossing[axis] = firstCrossing[axis];
+            }
+
+            if ((offsets & ~walkingBoundaryAxes) != 0) {
+                // only touched at the start
+                auto itr = cells.find({ (int32_t)cell[0], (int32_t)cell[1], (int32_t)cell[2] });
+                if (itr != cells.end()) {
+                    addRayCandidate(itr->second, origin, direction, candidates);
+                }
+                continue;
+            }
+
+            while (true) {
+                auto itr = cells.find({ (int32_t)cell[0], (int32_t)cell[1], (int32_t)cell[2] });
+                if (itr != cells.end()) {
+                    addRayCandidate(itr->second, origin, direction, candidates);
+                }
+
+                int axis = nextCrossing[0] < nextCrossing[1] ?
+                    (nextCrossing[0] < nextCrossing[2] ? 0 : 2) : (nextCrossing[1] < nextCrossing[2] ? 1 : 2);
+                if (nextCrossing[axis] > worldExit) {
+                    break;
+                }
+                cell[axis] += step[axis];
+                if (cell[axis] < 0 || cell[axis] >= numCells) {
+                    break;
+                }
+                nextCrossing[axis] += crossingInterval[axis];
+            }
+        }
+    }
+
+    for (auto& entry : _unindexedElements) {
+        addRayCandidate(entry.second, origin, direction, candidates);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const RayCandidate& a, const RayCandidate& b) {
+        return a.distance < b.distance;
+    });
+}
@@ -0,0 +1,83 @@
+//
+//  EntitySpatialIndex.h
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialIndex_h
+#define hifi_EntitySpatialIndex_h
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QReadWriteLock>
+
+#include <AABox.h>
+#include <OctreeElement.h>
+
+// Hierarchical hash grid over the octree elements that hold entities, kept alongside the octree so the spatial
+//   queries of the EntityTree don't have to walk it from the root. Octree elements are aligned cubes, so every element
+//   is exactly one cell of the grid of its level. A query visits, for every level, either the cells its bounds
+//   overlap or, when those outnumber them, the occupied cells of that level; so its cost follows the number of
+//   elements near the query instead of the depth of the tree. The index only produces candidate elements, the
+//   caller still does the exact element test, so results are the same as recursing the octree.
+class EntitySpatialIndex {
+public:
+    using ElementVisitor = std::function<void(const OctreeElementPointer&)>;
+
+    struct RayCandidate {
+        float distance; // distance along the ray to the element cube, zero if it contains the origin
+        OctreeElementPointer element;
+    };
+
+    // called when an element gains its first entity, or loses its last one
+    void insert(const OctreeElementPointer& element);
+    void remove(const OctreeElementPointer& element);
+    void clear();
+
+    // visits every element whose cube may touch bounds
+    void findElements(const AABox& bounds, const ElementVisitor& visitor) const;
+
+    // the elements whose cube the ray hits, nearest first
+    void findElements(const glm::vec3& origin, const glm::vec3& direction, std::vector<RayCandidate>& candidates) const;
+
+    size_t getNumElements() const;
+
+private:
+    struct Cell {
+        int32_t x;
+        int32_t y;
+        int32_t z;
+        bool operator==(const Cell& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+
+    struct CellHash {
+        size_t operator()(const Cell& cell) const {
+            return (size_t)(((uint64_t)(uint32_t)cell.x * 73856093) ^ ((uint64_t)(uint32_t)cell.y * 19349663) ^
+                ((uint64_t)(uint32_t)cell.z * 83492791));
+        }
+    };
+
+    using Level = std::unordered_map<Cell, OctreeElementPointer, CellHash>;
+
+    // deeper elements may not sit exactly on their grid in float, they are kept in a list that every query checks
+    static const int MAX_INDEXED_LEVEL = 24;
+
+    static int getElementLevel(const OctreeElementPointer& element);
+    static Cell getElementCell(const OctreeElementPointer& element);
+
+    void addRayCandidate(const OctreeElementPointer& element, const glm::vec3& origin, const glm::vec3& direction,
+                         std::vector<RayCandidate>& candidates) const;
+
+    mutable QReadWriteLock _lock;
+    std::vector<Level> _levels { std::vector<Level>(MAX_INDEXED_LEVEL + 1) };
+    std::unordered_map<OctreeElement*, OctreeElementPointer> _unindexedElements;
+    size_t _numElements { 0 };
+};
+
+#endif // hifi_EntitySpatialIndex_h
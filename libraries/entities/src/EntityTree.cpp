@@ -99,6 +99,9 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     }
     QHash<EntityItemID, EntityItemPointer> localMap;
     localMap.swap(_entityMap);
+    foreach(const EntityItemID& entityID, localMap.keys()) {
+        markChangedForPersist(entityID);
+    }
     this->withWriteLock([&] {
         foreach(EntityItemPointer entity, localMap) {
             EntityTreeElementPointer element = entity->getElement();
@@ -108,6 +111,7 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         }
     });
     localMap.clear();
+    _spatialIndex.clear();
     Octree::eraseAllOctreeElements(createNewRoot);
 
     resetClientEditStats();
@@ -270,6 +274,7 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
     }
 
     _isDirty = true;
+    markChangedForPersist(entity->getEntityItemID());
     emit addingEntity(entity->getEntityItemID());
 
     // find and hook up any entities with this entity as a (previously) missing parent
@@ -334,6 +339,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                     emit editingEntityPointer(entity);
                 }
                 _isDirty = true;
+                markChangedForPersist(entity->getEntityItemID());
             }
         }
     } else {
@@ -449,6 +455,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
         }
 
         _isDirty = true;
+        markChangedForPersist(entity->getEntityItemID());
 
         uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
         if (newFlags) {
@@ -660,6 +667,7 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
     const RemovedEntities& entities = theOperator.getEntities();
     foreach(const EntityToDeleteDetails& details, entities) {
         EntityItemPointer theEntity = details.entity;
+        markChangedForPersist(theEntity->getEntityItemID());
 
         if (getIsServer()) {
             QSet<EntityItemID> childrenIDs;
@@ -768,7 +776,19 @@ EntityItemID EntityTree::findRayIntersection(const glm::vec3& origin, const glm:
 
     bool requireLock = lockType == Octree::Lock;
     bool lockResult = withReadLock([&]{
-        recurseTreeWithOperation(findRayIntersectionOp, &args);
+        if (_spatialIndexEnabled) {
+            // nearest elements first, stop once the next one starts beyond the best hit
+            std::vector<EntitySpatialIndex::RayCandidate> candidates;
+            _spatialIndex.findElements(origin, direction, candidates);
+            for (auto& candidate : candidates) {
+                if (candidate.distance > distance) {
+                    break;
+                }
+                findRayIntersectionOp(candidate.element, &args);
+            }
+        } else {
+            recurseTreeWithOperation(findRayIntersectionOp, &args);
+        }
     }, requireLock);
 
     if (accurateResult) {
@@ -815,8 +835,14 @@ bool EntityTree::findInSphereOperation(const OctreeElementPointer& element, void
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities) {
     FindAllNearPointArgs args = { center, radius, QVector<EntityItemPointer>() };
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInSphereOperation, &args);
+    if (_spatialIndexEnabled) {
+        _spatialIndex.findElements(AABox(center - glm::vec3(radius), 2.0f * radius), [&](const OctreeElementPointer& element) {
+            findInSphereOperation(element, &args);
+        });
+    } else {
+        // NOTE: This should use recursion, since this is a spatial operation
+        recurseTreeWithOperation(findInSphereOperation, &args);
+    }
 
     // swap the two lists of entity pointers instead of copy
     foundEntities.swap(args.entities);
@@ -845,8 +871,14 @@ bool EntityTree::findInCubeOperation(const OctreeElementPointer& element, void*
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) {
     FindEntitiesInCubeArgs args(cube);
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInCubeOperation, &args);
+    if (_spatialIndexEnabled) {
+        _spatialIndex.findElements(AABox(cube), [&](const OctreeElementPointer& element) {
+            findInCubeOperation(element, &args);
+        });
+    } else {
+        // NOTE: This should use recursion, since this is a spatial operation
+        recurseTreeWithOperation(findInCubeOperation, &args);
+    }
     // swap the two lists of entity pointers instead of copy
     foundEntities.swap(args._foundEntities);
 }
@@ -874,8 +906,14 @@ bool EntityTree::findInBoxOperation(const OctreeElementPointer& element, void* e
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) {
     FindEntitiesInBoxArgs args(box);
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInBoxOperation, &args);
+    if (_spatialIndexEnabled) {
+        _spatialIndex.findElements(box, [&](const OctreeElementPointer& element) {
+            findInBoxOperation(element, &args);
+        });
+    } else {
+        // NOTE: This should use recursion, since this is a spatial operation
+        recurseTreeWithOperation(findInBoxOperation, &args);
+    }
     // swap the two lists of entity pointers instead of copy
     foundEntities.swap(args._foundEntities);
 }
@@ -899,8 +937,26 @@ bool EntityTree::findInFrustumOperation(const OctreeElementPointer& element, voi
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const ViewFrustum& frustum, QVector<EntityItemPointer>& foundEntities) {
     FindInFrustumArgs args = { frustum, QVector<EntityItemPointer>() };
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInFrustumOperation, &args);
+    if (_spatialIndexEnabled) {
+        // bound the keyhole: the frustum and the sphere around its position
+        const float centerRadius = frustum.getCenterRadius();
+        glm::vec3 minimum = frustum.getPosition() - glm::vec3(centerRadius);
+        glm::vec3 maximum = frustum.getPosition() + glm::vec3(centerRadius);
+        const glm::vec3 corners[] = {
+            frustum.getNearTopLeft(), frustum.getNearTopRight(), frustum.getNearBottomLeft(), frustum.getNearBottomRight(),
+            frustum.getFarTopLeft(), frustum.getFarTopRight(), frustum.getFarBottomLeft(), frustum.getFarBottomRight()
+        };
+        for (auto& corner : corners) {
+            minimum = glm::min(minimum, corner);
+            maximum = glm::max(maximum, corner);
+        }
+        _spatialIndex.findElements(AABox(minimum, maximum - minimum), [&](const OctreeElementPointer& element) {
+            findInFrustumOperation(element, &args);
+        });
+    } else {
+        // NOTE: This should use recursion, since this is a spatial operation
+        recurseTreeWithOperation(findInFrustumOperation, &args);
+    }
     // swap the two lists of entity pointers instead of copy
     foundEntities.swap(args.entities);
 }
@@ -1686,6 +1742,7 @@ void EntityTree::releaseSceneEncodeData(OctreeElementExtraEncodeData* extraEncod
 }
 
 void EntityTree::entityChanged(EntityItemPointer entity) {
+    markChangedForPersist(entity->getEntityItemID());
     if (entity->isSimulated()) {
         _simulation->changeEntity(entity);
     }
@@ -2386,6 +2443,105 @@ bool EntityTree::readFromMap(QVariantMap& map) {
     return success;
 }
 
+void EntityTree::markChangedForPersist(const EntityItemID& entityID) {
+    QWriteLocker locker(&_persistChangesLock);
+    if (_persistChangesTracked) {
+        _persistChanges.insert(entityID);
+    }
+}
+
+void EntityTree::encodePersistChanges(PersistRecords& changes, bool all) {
+    QSet<EntityItemID> changedIDs;
+    {
+        QWriteLocker locker(&_persistChangesLock);
+        _persistChangesTracked = true;
+        changedIDs.swap(_persistChanges);
+    }
+
+    if (all) {
+        QReadLocker locker(&_entityMapLock);
+        changedIDs = _entityMap.keys().toSet();
+    }
+
+    foreach(const EntityItemID& entityID, changedIDs) {
+        EntityItemPointer entity = findEntityByEntityItemID(entityID);
+        if (entity && !entity->getClientOnly()) {
+            changes[entityID] = encodePersistRecord(entity);
+        } else {
+            // it was deleted since
+            changes[entityID] = QByteArray();
+        }
+    }
+}
+
+QByteArray EntityTree::encodePersistRecord(const EntityItemPointer& entity) const {
+    // start with the size of an edit packet and grow it for the entities that don't fit
+    const int INITIAL_RECORD_SIZE = MAX_OCTREE_PACKET_DATA_SIZE;
+    const int MAX_RECORD_SIZE = 64 * 1024 * 1024;
+
+    EntityItemProperties properties = entity->getProperties();
+    properties.markAllChanged();
+
+    // ownership doesn't survive a restart of the server
+    properties.setSimulationOwnerChanged(false);
+
+    for (int size = INITIAL_RECORD_SIZE; size <= MAX_RECORD_SIZE; size *= 2) {
+        QByteArray buffer(size, 0);
+        EntityPropertyFlags didntFitProperties;
+        auto appendState = EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, entity->getEntityItemID(),
+                                                                         properties, buffer, properties.getChangedProperties(),
+                                                                         didntFitProperties);
+        if (appendState == OctreeElement::COMPLETED) {
+            // edit packets leave out the created time
+            quint64 created = entity->getCreated();
+            buffer.prepend(reinterpret_cast<const char*>(&created), sizeof(created));
+            return buffer;
+        }
+    }
+
+    qCWarning(entities) << "Entity" << entity->getEntityItemID() << "is too large to be persisted";
+    return QByteArray();
+}
+
+bool EntityTree::readPersistRecords(const PersistRecords& records) {
+    bool success = true;
+    for (auto it = records.begin(); it != records.end(); ++it) {
+        const QByteArray& record = it.value();
+        if (record.isEmpty()) {
+            // a deleted entity
+            continue;
+        }
+
+        quint64 created;
+        if (record.size() <= (int)sizeof(created)) {
+            qCDebug(entities) << "Skipping truncated persist record for entity" << it.key();
+            success = false;
+            continue;
+        }
+        memcpy(&created, record.constData(), sizeof(created));
+
+        EntityItemID entityItemID;
+        EntityItemProperties properties;
+        int processedBytes = 0;
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(record.constData()) + sizeof(created);
+        if (!EntityItemProperties::decodeEntityEditPacket(data, record.size() - sizeof(created), processedBytes,
+                                                          entityItemID, properties)) {
+            qCDebug(entities) << "Failed to decode persist record for entity" << it.key();
+            success = false;
+            continue;
+        }
+        properties.setCreated(created);
+
+        EntityItemPointer entity = addEntity(entityItemID, properties);
+        if (!entity) {
+            qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+            success = false;
+        }
+    }
+
+    return success;
+}
+
 void EntityTree::resetClientEditStats() {
     _treeResetTime = usecTimestampNow();
     _maxEditDelta = 0;
@@ -24,6 +24,7 @@ using EntityTreePointer = std::shared_ptr<EntityTree>;
 #include "AddEntityOperator.h"
 #include "EntityTreeElement.h"
 #include "DeleteEntityOperator.h"
+#include "EntitySpatialIndex.h"
 #include "MovingEntitiesOperator.h"
 
 class EntityEditFilters;
@@ -169,6 +170,11 @@ public:
     /// \parameter foundEntities[out] vector of EntityItemPointer
     void findEntities(RecurseOctreeOperation& scanOperator, QVector<EntityItemPointer>& foundEntities);
 
+    /// the elements holding entities, which answer the spatial queries above instead of recursing the octree
+    EntitySpatialIndex& getSpatialIndex() { return _spatialIndex; }
+    void setSpatialIndexEnabled(bool enabled) { _spatialIndexEnabled = enabled; }
+    bool isSpatialIndexEnabled() const { return _spatialIndexEnabled; }
+
     void addNewlyCreatedHook(NewlyCreatedEntityHook* hook);
     void removeNewlyCreatedHook(NewlyCreatedEntityHook* hook);
 
@@ -227,6 +233,13 @@ public:
                             bool skipThoseWithBadParents) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
 
+    virtual bool canPersistIncrementally() const override { return true; }
+    virtual void encodePersistChanges(PersistRecords& changes, bool all) override;
+    virtual bool readPersistRecords(const PersistRecords& records) override;
+
+    /// Mark the entity as changed for the next incremental persist, for changes that don't go through updateEntity
+    void markChangedForPersist(const EntityItemID& entityID);
+
     glm::vec3 getContentsDimensions();
     float getContentsLargestDimension();
 
@@ -351,6 +364,15 @@ protected:
     mutable QReadWriteLock _entityMapLock;
     QHash<EntityItemID, EntityItemPointer> _entityMap;
 
+    EntitySpatialIndex _spatialIndex;
+    bool _spatialIndexEnabled { true };
+
+    QByteArray encodePersistRecord(const EntityItemPointer& entity) const;
+
+    mutable QReadWriteLock _persistChangesLock;
+    bool _persistChangesTracked { false }; /// set once incremental persistence starts
+    QSet<EntityItemID> _persistChanges; /// entities added, edited or deleted since the last incremental persist
+
     mutable QReadWriteLock _entityCertificateIDMapLock;
     QHash<QString, EntityItemID> _entityCertificateIDMap;
 
@@ -889,7 +889,9 @@ EntityItemPointer EntityTreeElement::getEntityWithEntityItemID(const EntityItemI
 }
 
 void EntityTreeElement::cleanupEntities() {
+    bool hadEntities = false;
     withWriteLock([&] {
+        hadEntities = !_entityItems.empty();
         foreach(EntityItemPointer entity, _entityItems) {
             entity->preDelete();
             // NOTE: only EntityTreeElement should ever be changing the value of entity->_element
@@ -901,6 +903,9 @@ void EntityTreeElement::cleanupEntities() {
         _entityItems.clear();
     });
     bumpChangedContent();
+    if (hadEntities && _myTree) {
+        _myTree->getSpatialIndex().remove(getThisOctreeElementPointer());
+    }
 }
 
 bool EntityTreeElement::removeEntityItem(EntityItemPointer entity, bool deletion) {
@@ -908,14 +913,19 @@ bool EntityTreeElement::removeEntityItem(EntityItemPointer entity, bool deletion
         entity->preDelete();
     }
     int numEntries = 0;
+    bool isEmpty = false;
     withWriteLock([&] {
         numEntries = _entityItems.removeAll(entity);
+        isEmpty = _entityItems.empty();
     });
     if (numEntries > 0) {
         // NOTE: only EntityTreeElement should ever be changing the value of entity->_element
         assert(entity->_element.get() == this);
         entity->_element = NULL;
         bumpChangedContent();
+        if (isEmpty && _myTree) {
+            _myTree->getSpatialIndex().remove(getThisOctreeElementPointer());
+        }
         return true;
     }
     return false;
@@ -930,11 +940,16 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
 void EntityTreeElement::addEntityItem(EntityItemPointer entity) {
     assert(entity);
     assert(entity->_element == nullptr);
+    bool wasEmpty = false;
     withWriteLock([&] {
+        wasEmpty = _entityItems.empty();
         _entityItems.push_back(entity);
     });
     bumpChangedContent();
     entity->_element = getThisPointer();
+    if (wasEmpty && _myTree) {
+        _myTree->getSpatialIndex().insert(getThisOctreeElementPointer());
+    }
 }
 
 // will average a "common reduced LOD view" from the the child elements...
@@ -358,6 +358,7 @@ void ModelEntityItem::setAnimationURL(const QString& url) {
     _flags |= Simulation::DIRTY_UPDATEABLE;
     withWriteLock([&] {
         _animationProperties.setURL(url);
+        bumpEncodeVersion();
     });
 }
 
@@ -428,11 +429,13 @@ void ModelEntityItem::setAnimationSettings(const QString& value) {
 void ModelEntityItem::setAnimationIsPlaying(bool value) {
     _flags |= Simulation::DIRTY_UPDATEABLE;
     _animationProperties.setRunning(value);
+    bumpEncodeVersion();
 }
 
 void ModelEntityItem::setAnimationFPS(float value) {
     _flags |= Simulation::DIRTY_UPDATEABLE;
     _animationProperties.setFPS(value);
+    bumpEncodeVersion();
 }
 
 // virtual
@@ -644,12 +647,14 @@ QString ModelEntityItem::getAnimationURL() const {
 void ModelEntityItem::setAnimationCurrentFrame(float value) {
     withWriteLock([&] {
         _animationProperties.setCurrentFrame(value);
+        bumpEncodeVersion();
     });
 }
 
 void ModelEntityItem::setAnimationLoop(bool loop) { 
     withWriteLock([&] {
         _animationProperties.setLoop(loop);
+        bumpEncodeVersion();
     });
 }
 
@@ -663,6 +668,7 @@ bool ModelEntityItem::getAnimationLoop() const {
 void ModelEntityItem::setAnimationHold(bool hold) { 
     withWriteLock([&] {
         _animationProperties.setHold(hold);
+        bumpEncodeVersion();
     });
 }
 
@@ -675,6 +681,7 @@ bool ModelEntityItem::getAnimationHold() const {
 void ModelEntityItem::setAnimationFirstFrame(float firstFrame) { 
     withWriteLock([&] {
         _animationProperties.setFirstFrame(firstFrame);
+        bumpEncodeVersion();
     });
 }
 
@@ -687,6 +694,7 @@ float ModelEntityItem::getAnimationFirstFrame() const {
 void ModelEntityItem::setAnimationLastFrame(float lastFrame) { 
     withWriteLock([&] {
         _animationProperties.setLastFrame(lastFrame);
+        bumpEncodeVersion();
     });
 }
 
@@ -90,7 +90,7 @@ public:
     void setAnimationIsPlaying(bool value);
     void setAnimationFPS(float value); 
 
-    void setAnimationAllowTranslation(bool value) { _animationProperties.setAllowTranslation(value); };
+    void setAnimationAllowTranslation(bool value) { _animationProperties.setAllowTranslation(value); bumpEncodeVersion(); };
     bool getAnimationAllowTranslation() const { return _animationProperties.getAllowTranslation(); };
 
     void setAnimationLoop(bool loop);
@@ -42,6 +42,7 @@ void SimpleEntitySimulation::clearOwnership(const QUuid& ownerID) {
             // remove ownership and dirty all the tree elements that contain the it
             entity->clearSimulationOwnership();
             entity->markAsChangedOnServer();
+            getEntityTree()->markChangedForPersist(entity->getEntityItemID());
             DirtyOctreeElementOperator op(entity->getElement());
             getEntityTree()->recurseTreeWithOperator(&op);
         } else {
@@ -71,6 +72,7 @@ void SimpleEntitySimulation::updateEntitiesInternal(uint64_t now) {
 
                     // dirty all the tree elements that contain it
                     entity->markAsChangedOnServer();
+                    getEntityTree()->markChangedForPersist(entity->getEntityItemID());
                     DirtyOctreeElementOperator op(entity->getElement());
                     getEntityTree()->recurseTreeWithOperator(&op);
                 }
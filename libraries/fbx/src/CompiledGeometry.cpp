@@ -0,0 +1,785 @@
+//
+//  CompiledGeometry.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CompiledGeometry.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include <QtCore/QFile>
+
+#include <Finally.h>
+
+static const char COMPILED_GEOMETRY_MAGIC[] = { 'H', 'F', 'C', 'G' };
+// written as it lies in memory, so a file from a machine of the other byte order is rejected rather than misread
+static const quint32 BYTE_ORDER_MARK = 0x01020304;
+
+const quint32 CompiledGeometry::CURRENT_VERSION = 1;
+
+namespace {
+
+// Values that are copied in and out just as they lie in memory
+template <typename T> struct IsPlain : std::is_arithmetic<T> {};
+template <> struct IsPlain<glm::vec2> : std::true_type {};
+template <> struct IsPlain<glm::vec3> : std::true_type {};
+template <> struct IsPlain<glm::vec4> : std::true_type {};
+template <> struct IsPlain<glm::quat> : std::true_type {};
+template <> struct IsPlain<glm::mat4> : std::true_type {};
+template <> struct IsPlain<Extents> : std::true_type {};
+template <> struct IsPlain<graphics::Material::Schema> : std::true_type {};
+
+class Writer {
+public:
+    const QByteArray& getData() const { return _data; }
+
+    void writeRaw(const void* bytes, size_t size) { _data.append(reinterpret_cast<const char*>(bytes), (int)size); }
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(IsPlain<T>::value, "only plain values can be written as they are");
+        writeRaw(&value, sizeof(T));
+    }
+
+    void write(const QByteArray& bytes) {
+        write((qint32)bytes.size());
+        writeRaw(bytes.constData(), bytes.size());
+    }
+    void write(const QString& string) { write(string.toUtf8()); }
+    void write(const std::string& string) {
+        write((qint32)string.size());
+        writeRaw(string.data(), string.size());
+    }
+
+    template <typename T>
+    void write(const QVector<T>& values) {
+        write((qint32)values.size());
+        writeElements(values.constData(), values.size(), IsPlain<T>());
+    }
+    template <typename T>
+    void write(const std::vector<T>& values) {
+        write((qint32)values.size());
+        writeElements(values.data(), values.size(), IsPlain<T>());
+    }
+    template <typename T>
+    void write(const QList<T>& values) {
+        write((qint32)values.size());
+        for (const auto& value : values) {
+            write(value);
+        }
+    }
+    template <typename K, typename V>
+    void write(const QHash<K, V>& hash) {
+        write((qint32)hash.size());
+        for (auto it = hash.constBegin(); it != hash.constEnd(); ++it) {
+            write(it.key());
+            write(it.value());
+        }
+    }
+
+    void write(const Transform& transform);
+    void write(const FBXJointShapeInfo& shapeInfo);
+    void write(const FBXJoint& joint);
+    void write(const FBXCluster& cluster);
+    void write(const FBXTexture& texture);
+    void write(const FBXMeshPart& part);
+    void write(const graphics::MaterialPointer& material);
+    void write(const FBXMaterial& material);
+    void write(const FBXBlendshape& blendshape);
+    void write(const graphics::MeshPointer& mesh);
+    void write(const FBXMesh& mesh);
+    void write(const FBXAnimationFrame& frame);
+    void write(const FBXGeometry& geometry);
+
+private:
+    template <typename T>
+    void writeElements(const T* values, size_t count, std::true_type) { writeRaw(values, count * sizeof(T)); }
+    template <typename T>
+    void writeElements(const T* values, size_t count, std::false_type) {
+        for (size_t i = 0; i < count; i++) {
+            write(values[i]);
+        }
+    }
+
+    QByteArray _data;
+};
+
+class Reader {
+public:
+    Reader(const char* data, size_t length) : _cursor(data), _end(data + length) {}
+
+    bool atEnd() const { return _cursor == _end; }
+
+    const char* take(quint64 size) {
+        if (size > (quint64)(_end - _cursor)) {
+            throw QString("compiled geometry is truncated");
+        }
+        const char* bytes = _cursor;
+        _cursor += size;
+        return bytes;
+    }
+
+    // the number of elements that follow, each of which takes at least elementSize bytes
+    int readCount(size_t elementSize) {
+        qint32 count;
+        read(count);
+        if (count < 0 || (size_t)count > (size_t)(_end - _cursor) / elementSize) {
+            throw QString("corrupt compiled geometry");
+        }
+        return count;
+    }
+
+    template <typename T>
+    void read(T& value) {
+        static_assert(IsPlain<T>::value, "only plain values can be read as they are");
+        memcpy(&value, take(sizeof(T)), sizeof(T));
+    }
+
+    void read(QByteArray& bytes) {
+        int size = readCount(1);
+        bytes = QByteArray(take(size), size);
+    }
+    void read(QString& string) {
+        QByteArray utf8;
+        read(utf8);
+        string = QString::fromUtf8(utf8);
+    }
+    void read(std::string& string) {
+        int size = readCount(1);
+        string.assign(take(size), size);
+    }
+
+    template <typename T>
+    void read(QVector<T>& values) {
+        int count = readCount(IsPlain<T>::value ? sizeof(T) : 1);
+        values.resize(count);
+        readElements(values.data(), count, IsPlain<T>());
+    }
+    template <typename T>
+    void read(std::vector<T>& values) {
+        int count = readCount(IsPlain<T>::value ? sizeof(T) : 1);
+        values.resize(count);
+        readElements(values.data(), count, IsPlain<T>());
+    }
+    template <typename T>
+    void read(QList<T>& values) {
+        int count = readCount(1);
+        values.clear();
+        values.reserve(count);
+        for (int i = 0; i < count; i++) {
+            T value;
+            read(value);
+            values.append(value);
+        }
+    }
+    template <typename K, typename V>
+    void read(QHash<K, V>& hash) {
+        int count = readCount(1);
+        hash.clear();
+        hash.reserve(count);
+        for (int i = 0; i < count; i++) {
+            K key;
+            read(key);
+            read(hash[key]);
+        }
+    }
+
+    void read(Transform& transform);
+    void read(FBXJointShapeInfo& shapeInfo);
+    void read(FBXJoint& joint);
+    void read(FBXCluster& cluster);
+    void read(FBXTexture& texture);
+    void read(FBXMeshPart& part);
+    void read(graphics::MaterialPointer& material);
+    void read(FBXMaterial& material);
+    void read(FBXBlendshape& blendshape);
+    void read(graphics::MeshPointer& mesh);
+    void read(FBXMesh& mesh);
+    void read(FBXAnimationFrame& frame);
+    void read(FBXGeometry& geometry);
+
+private:
+    template <typename T>
+    void readElements(T* values, size_t count, std::true_type) {
+        if (count > 0) {
+            memcpy(values, take(count * sizeof(T)), count * sizeof(T));
+        }
+    }
+    template <typename T>
+    void readElements(T* values, size_t count, std::false_type) {
+        for (size_t i = 0; i < count; i++) {
+            read(values[i]);
+        }
+    }
+
+    const char* _cursor;
+    const char* const _end;
+};
+
+//
+// Each structure is written and read back field by field, in the same order
+//
+
+void Writer::write(const Transform& transform) {
+    write(transform.getRotation());
+    write(transform.getScale());
+    write(transform.getTranslation());
+}
+
+void Reader::read(Transform& transform) {
+    glm::quat rotation;
+    glm::vec3 scale;
+    glm::vec3 translation;
+    read(rotation);
+    read(scale);
+    read(translation);
+    transform.setIdentity();
+    transform.setRotation(rotation);
+    transform.setScale(scale);
+    transform.setTranslation(translation);
+}
+
+void Writer::write(const FBXJointShapeInfo& shapeInfo) {
+    write(shapeInfo.avgPoint);
+    write(shapeInfo.dots);
+    write(shapeInfo.points);
+    write(shapeInfo.debugLines);
+}
+
+void Reader::read(FBXJointShapeInfo& shapeInfo) {
+    read(shapeInfo.avgPoint);
+    read(shapeInfo.dots);
+    read(shapeInfo.points);
+    read(shapeInfo.debugLines);
+}
+
+void Writer::write(const FBXJoint& joint) {
+    write(joint.shapeInfo);
+    write(joint.freeLineage);
+    write(joint.isFree);
+    write(joint.parentIndex);
+    write(joint.distanceToParent);
+    write(joint.translation);
+    write(joint.preTransform);
+    write(joint.preRotation);
+    write(joint.rotation);
+    write(joint.postRotation);
+    write(joint.postTransform);
+    write(joint.transform);
+    write(joint.rotationMin);
+    write(joint.rotationMax);
+    write(joint.inverseDefaultRotation);
+    write(joint.inverseBindRotation);
+    write(joint.bindTransform);
+    write(joint.name);
+    write(joint.isSkeletonJoint);
+    write(joint.bindTransformFoundInCluster);
+    write(joint.hasGeometricOffset);
+    write(joint.geometricTranslation);
+    write(joint.geometricRotation);
+    write(joint.geometricScaling);
+}
+
+void Reader::read(FBXJoint& joint) {
+    read(joint.shapeInfo);
+    read(joint.freeLineage);
+    read(joint.isFree);
+    read(joint.parentIndex);
+    read(joint.distanceToParent);
+    read(joint.translation);
+    read(joint.preTransform);
+    read(joint.preRotation);
+    read(joint.rotation);
+    read(joint.postRotation);
+    read(joint.postTransform);
+    read(joint.transform);
+    read(joint.rotationMin);
+    read(joint.rotationMax);
+    read(joint.inverseDefaultRotation);
+    read(joint.inverseBindRotation);
+    read(joint.bindTransform);
+    read(joint.name);
+    read(joint.isSkeletonJoint);
+    read(joint.bindTransformFoundInCluster);
+    read(joint.hasGeometricOffset);
+    read(joint.geometricTranslation);
+    read(joint.geometricRotation);
+    read(joint.geometricScaling);
+}
+
+void Writer::write(const FBXCluster& cluster) {
+    write(cluster.jointIndex);
+    write(cluster.inverseBindMatrix);
+    write(cluster.inverseBindTransform);
+}
+
+void Reader::read(FBXCluster& cluster) {
+    read(cluster.jointIndex);
+    read(cluster.inverseBindMatrix);
+    read(cluster.inverseBindTransform);
+}
+
+void Writer::write(const FBXTexture& texture) {
+    write(texture.id);
+    write(texture.name);
+    write(texture.filename);
+    write(texture.content);
+    write(texture.transform);
+    write(texture.maxNumPixels);
+    write(texture.texcoordSet);
+    write(texture.texcoordSetName);
+    write(texture.isBumpmap);
+}
+
+void Reader::read(FBXTexture& texture) {
+    read(texture.id);
+    read(texture.name);
+    read(texture.filename);
+    read(texture.content);
+    read(texture.transform);
+    read(texture.maxNumPixels);
+    read(texture.texcoordSet);
+    read(texture.texcoordSetName);
+    read(texture.isBumpmap);
+}
+
+void Writer::write(const FBXMeshPart& part) {
+    write(part.quadIndices);
+    write(part.quadTrianglesIndices);
+    write(part.triangleIndices);
+    write(part.materialID);
+}
+
+void Reader::read(FBXMeshPart& part) {
+    read(part.quadIndices);
+    read(part.quadTrianglesIndices);
+    read(part.triangleIndices);
+    read(part.materialID);
+}
+
+// The readers only ever set the material's attributes, never its texture maps, so its schema is all there is to keep
+void Writer::write(const graphics::MaterialPointer& material) {
+    write(material != nullptr);
+    if (material) {
+        write(material->getSchemaBuffer().get<graphics::Material::Schema>());
+    }
+}
+
+void Reader::read(graphics::MaterialPointer& material) {
+    bool hasMaterial;
+    read(hasMaterial);
+    if (hasMaterial) {
+        graphics::Material::Schema schema;
+        read(schema);
+        material = std::make_shared<graphics::Material>();
+        material->setSchema(schema);
+    } else {
+        material.reset();
+    }
+}
+
+void Writer::write(const FBXMaterial& material) {
+    write(material.diffuseColor);
+    write(material.diffuseFactor);
+    write(material.specularColor);
+    write(material.specularFactor);
+    write(material.emissiveColor);
+    write(material.emissiveFactor);
+    write(material.shininess);
+    write(material.opacity);
+    write(material.metallic);
+    write(material.roughness);
+    write(material.emissiveIntensity);
+    write(material.ambientFactor);
+    write(material.bumpMultiplier);
+    write(material.materialID);
+    write(material.name);
+    write(material.shadingModel);
+    write(material._material);
+    write(material.normalTexture);
+    write(material.albedoTexture);
+    write(material.opacityTexture);
+    write(material.glossTexture);
+    write(material.roughnessTexture);
+    write(material.specularTexture);
+    write(material.metallicTexture);
+    write(material.emissiveTexture);
+    write(material.occlusionTexture);
+    write(material.scatteringTexture);
+    write(material.lightmapTexture);
+    write(material.lightmapParams);
+    write(material.isPBSMaterial);
+    write(material.useNormalMap);
+    write(material.useAlbedoMap);
+    write(material.useOpacityMap);
+    write(material.useRoughnessMap);
+    write(material.useSpecularMap);
+    write(material.useMetallicMap);
+    write(material.useEmissiveMap);
+    write(material.useOcclusionMap);
+}
+
+void Reader::read(FBXMaterial& material) {
+    read(material.diffuseColor);
+    read(material.diffuseFactor);
+    read(material.specularColor);
+    read(material.specularFactor);
+    read(material.emissiveColor);
+    read(material.emissiveFactor);
+    read(material.shininess);
+    read(material.opacity);
+    read(material.metallic);
+    read(material.roughness);
+    read(material.emissiveIntensity);
+    read(material.ambientFactor);
+    read(material.bumpMultiplier);
+    read(material.materialID);
+    read(material.name);
+    read(material.shadingModel);
+    read(material._material);
+    read(material.normalTexture);
+    read(material.albedoTexture);
+    read(material.opacityTexture);
+    read(material.glossTexture);
+    read(material.roughnessTexture);
+    read(material.specularTexture);
+    read(material.metallicTexture);
+    read(material.emissiveTexture);
+    read(material.occlusionTexture);
+    read(material.scatteringTexture);
+    read(material.lightmapTexture);
+    read(material.lightmapParams);
+    read(material.isPBSMaterial);
+    read(material.useNormalMap);
+    read(material.useAlbedoMap);
+    read(material.useOpacityMap);
+    read(material.useRoughnessMap);
+    read(material.useSpecularMap);
+    read(material.useMetallicMap);
+    read(material.useEmissiveMap);
+    read(material.useOcclusionMap);
+}
+
+void Writer::write(const FBXBlendshape& blendshape) {
+    write(blendshape.indices);
+    write(blendshape.vertices);
+    write(blendshape.normals);
+    write(blendshape.tangents);
+}
+
+void Reader::read(FBXBlendshape& blendshape) {
+    read(blendshape.indices);
+    read(blendshape.vertices);
+    read(blendshape.normals);
+    read(blendshape.tangents);
+}
+
+// The views of a mesh mostly share one attribute buffer between them, so its buffers are written first, once each,
+// and the views refer to them by index.
+void Writer::write(const graphics::MeshPointer& mesh) {
+    write(mesh != nullptr);
+    if (!mesh) {
+        return;
+    }
+
+    std::vector<std::pair<gpu::Stream::Slot, graphics::Mesh::BufferView>> attributes;
+    for (int slot = 0; slot < gpu::Stream::NUM_INPUT_SLOTS; slot++) {
+        auto attribute = mesh->getAttributeBuffer(slot);
+        if (attribute._buffer) {
+            attributes.emplace_back((gpu::Stream::Slot)slot, attribute);
+        }
+    }
+
+    std::vector<gpu::BufferPointer> buffers;
+    auto addBuffer = [&](const graphics::Mesh::BufferView& view) {
+        if (view._buffer && std::find(buffers.begin(), buffers.end(), view._buffer) == buffers.end()) {
+            buffers.push_back(view._buffer);
+        }
+    };
+    addBuffer(mesh->getVertexBuffer());
+    addBuffer(mesh->getIndexBuffer());
+    addBuffer(mesh->getPartBuffer());
+    for (const auto& attribute : attributes) {
+        addBuffer(attribute.second);
+    }
+
+    write((qint32)buffers.size());
+    for (const auto& buffer : buffers) {
+        write((quint64)buffer->getSize());
+        writeRaw(buffer->getData(), buffer->getSize());
+    }
+
+    auto writeView = [&](const graphics::Mesh::BufferView& view) {
+        qint32 bufferIndex = -1;
+        if (view._buffer) {
+            bufferIndex = (qint32)(std::find(buffers.begin(), buffers.end(), view._buffer) - buffers.begin());
+        }
+        write(bufferIndex);
+        write((quint64)view._offset);
+        write((quint64)view._size);
+        write(view._stride);
+        write((quint8)view._element.getDimension());
+        write((quint8)view._element.getType());
+        write((quint8)view._element.getSemantic());
+    };
+    writeView(mesh->getVertexBuffer());
+    writeView(mesh->getIndexBuffer());
+    writeView(mesh->getPartBuffer());
+    write((qint32)attributes.size());
+    for (const auto& attribute : attributes) {
+        write(attribute.first);
+        writeView(attribute.second);
+    }
+
+    write(mesh->modelName);
+    write(mesh->displayName);
+}
+
+void Reader::read(graphics::MeshPointer& mesh) {
+    bool hasMesh;
+    read(hasMesh);
+    if (!hasMesh) {
+        mesh.reset();
+        return;
+    }
+    mesh = std::make_shared<graphics::Mesh>();
+
+    // this is the one copy of the vertex data on its way to the GPU: straight from the file into the buffer's sysmem
+    int numBuffers = readCount(sizeof(quint64));
+    std::vector<gpu::BufferPointer> buffers;
+    buffers.reserve(numBuffers);
+    for (int i = 0; i < numBuffers; i++) {
+        quint64 size;
+        read(size);
+        const char* bytes = take(size);
+        buffers.push_back(std::make_shared<gpu::Buffer>((gpu::Size)size, reinterpret_cast<const gpu::Byte*>(bytes)));
+    }
+
+    auto readView = [&]() -> graphics::Mesh::BufferView {
+        qint32 bufferIndex;
+        quint64 offset;
+        quint64 size;
+        quint16 stride;
+        quint8 dimension;
+        quint8 type;
+        quint8 semantic;
+        read(bufferIndex);
+        read(offset);
+        read(size);
+        read(stride);
+        read(dimension);
+        read(type);
+        read(semantic);
+        if (bufferIndex < 0) {
+            return graphics::Mesh::BufferView();
+        }
+        if (bufferIndex >= (qint32)buffers.size() || dimension >= gpu::NUM_DIMENSIONS || type >= gpu::NUM_TYPES ||
+                semantic >= gpu::NUM_SEMANTICS) {
+            throw QString("corrupt compiled geometry");
+        }
+        const auto& buffer = buffers[bufferIndex];
+        if (offset > buffer->getSize() || size > buffer->getSize() - offset) {
+            throw QString("corrupt compiled geometry");
+        }
+        return graphics::Mesh::BufferView(buffer, offset, size, stride,
+            gpu::Element((gpu::Dimension)dimension, (gpu::Type)type, (gpu::Semantic)semantic));
+    };
+
+    auto vertexBuffer = readView();
+    auto indexBuffer = readView();
+    auto partBuffer = readView();
+    if (vertexBuffer._buffer) {
+        mesh->setVertexBuffer(vertexBuffer);
+    }
+    if (indexBuffer._buffer) {
+        mesh->setIndexBuffer(indexBuffer);
+    }
+    if (partBuffer._buffer) {
+        mesh->setPartBuffer(partBuffer);
+    }
+
+    int numAttributes = readCount(1);
+    for (int i = 0; i < numAttributes; i++) {
+        gpu::Stream::Slot slot;
+        read(slot);
+        auto attribute = readView();
+        if (slot >= gpu::Stream::NUM_INPUT_SLOTS || !attribute._buffer) {
+            throw QString("corrupt compiled geometry");
+        }
+        mesh->addAttribute(slot, attribute);
+    }
+
+    read(mesh->modelName);
+    read(mesh->displayName);
+}
+
+void Writer::write(const FBXMesh& mesh) {
+    write(mesh.parts);
+    write(mesh.vertices);
+    write(mesh.normals);
+    write(mesh.tangents);
+    write(mesh.colors);
+    write(mesh.texCoords);
+    write(mesh.texCoords1);
+    write(mesh.clusterIndices);
+    write(mesh.clusterWeights);
+    write(mesh.originalIndices);
+    write(mesh.clusters);
+    write(mesh.meshExtents);
+    write(mesh.modelTransform);
+    write(mesh.blendshapes);
+    write(mesh.meshIndex);
+    write(mesh._mesh);
+    write(mesh.wasCompressed);
+}
+
+void Reader::read(FBXMesh& mesh) {
+    read(mesh.parts);
+    read(mesh.vertices);
+    read(mesh.normals);
+    read(mesh.tangents);
+    read(mesh.colors);
+    read(mesh.texCoords);
+    read(mesh.texCoords1);
+    read(mesh.clusterIndices);
+    read(mesh.clusterWeights);
+    read(mesh.originalIndices);
+    read(mesh.clusters);
+    read(mesh.meshExtents);
+    read(mesh.modelTransform);
+    read(mesh.blendshapes);
+    read(mesh.meshIndex);
+    read(mesh._mesh);
+    read(mesh.wasCompressed);
+}
+
+void Writer::write(const FBXAnimationFrame& frame) {
+    write(frame.rotations);
+    write(frame.translations);
+}
+
+void Reader::read(FBXAnimationFrame& frame) {
+    read(frame.rotations);
+    read(frame.translations);
+}
+
+void Writer::write(const FBXGeometry& geometry) {
+    write(geometry.originalURL);
+    write(geometry.author);
+    write(geometry.applicationName);
+    write(geometry.joints);
+    write(geometry.jointIndices);
+    write(geometry.hasSkeletonJoints);
+    write(geometry.meshes);
+    write(geometry.materials);
+    write(geometry.offset);
+    write(geometry.leftEyeJointIndex);
+    write(geometry.rightEyeJointIndex);
+    write(geometry.neckJointIndex);
+    write(geometry.rootJointIndex);
+    write(geometry.leanJointIndex);
+    write(geometry.headJointIndex);
+    write(geometry.leftHandJointIndex);
+    write(geometry.rightHandJointIndex);
+    write(geometry.leftToeJointIndex);
+    write(geometry.rightToeJointIndex);
+    write(geometry.leftEyeSize);
+    write(geometry.rightEyeSize);
+    write(geometry.humanIKJointIndices);
+    write(geometry.palmDirection);
+    write(geometry.neckPivot);
+    write(geometry.bindExtents);
+    write(geometry.meshExtents);
+    write(geometry.animationFrames);
+    write(geometry.meshIndicesToModelNames);
+    write(geometry.blendshapeChannelNames);
+}
+
+void Reader::read(FBXGeometry& geometry) {
+    read(geometry.originalURL);
+    read(geometry.author);
+    read(geometry.applicationName);
+    read(geometry.joints);
+    read(geometry.jointIndices);
+    read(geometry.hasSkeletonJoints);
+    read(geometry.meshes);
+    read(geometry.materials);
+    read(geometry.offset);
+    read(geometry.leftEyeJointIndex);
+    read(geometry.rightEyeJointIndex);
+    read(geometry.neckJointIndex);
+    read(geometry.rootJointIndex);
+    read(geometry.leanJointIndex);
+    read(geometry.headJointIndex);
+    read(geometry.leftHandJointIndex);
+    read(geometry.rightHandJointIndex);
+    read(geometry.leftToeJointIndex);
+    read(geometry.rightToeJointIndex);
+    read(geometry.leftEyeSize);
+    read(geometry.rightEyeSize);
+    read(geometry.humanIKJointIndices);
+    read(geometry.palmDirection);
+    read(geometry.neckPivot);
+    read(geometry.bindExtents);
+    read(geometry.meshExtents);
+    read(geometry.animationFrames);
+    read(geometry.meshIndicesToModelNames);
+    read(geometry.blendshapeChannelNames);
+}
+
+} // anonymous namespace
+
+QByteArray CompiledGeometry::serialize(const FBXGeometry& geometry) {
+    Writer writer;
+    writer.writeRaw(COMPILED_GEOMETRY_MAGIC, sizeof(COMPILED_GEOMETRY_MAGIC));
+    writer.write(BYTE_ORDER_MARK);
+    writer.write(CURRENT_VERSION);
+    writer.write(geometry);
+    return writer.getData();
+}
+
+FBXGeometry::Pointer CompiledGeometry::unserialize(const char* data, size_t length) {
+    Reader reader(data, length);
+    if (memcmp(reader.take(sizeof(COMPILED_GEOMETRY_MAGIC)), COMPILED_GEOMETRY_MAGIC, sizeof(COMPILED_GEOMETRY_MAGIC)) != 0) {
+        throw QString("not a compiled geometry");
+    }
+    quint32 byteOrderMark;
+    quint32 version;
+    reader.read(byteOrderMark);
+    reader.read(version);
+    if (byteOrderMark != BYTE_ORDER_MARK || version != CURRENT_VERSION) {
+        throw QString("compiled geometry is from another version");
+    }
+
+    auto geometry = std::make_shared<FBXGeometry>();
+    reader.read(*geometry);
+    if (!reader.atEnd()) {
+        throw QString("corrupt compiled geometry");
+    }
+    return geometry;
+}
+
+FBXGeometry::Pointer CompiledGeometry::unserialize(const QString& filepath) {
+    QFile file(filepath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw QString("could not open compiled geometry ") + filepath;
+    }
+
+    // the mapping is only needed until everything has been copied out of it
+    uchar* mapped = file.map(0, file.size());
+    if (!mapped) {
+        QByteArray data = file.readAll();
+        return unserialize(data.constData(), (size_t)data.size());
+    }
+    Finally unmap([&] {
+        file.unmap(mapped);
+    });
+    return unserialize(reinterpret_cast<const char*>(mapped), (size_t)file.size());
+}
@@ -0,0 +1,34 @@
+//
+//  CompiledGeometry.h
+//  libraries/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CompiledGeometry_h
+#define hifi_CompiledGeometry_h
+
+#include <QByteArray>
+#include <QString>
+
+#include "FBX.h"
+
+// A geometry as the readers leave it -- joints, materials, meshes with their final vertex, index and part buffers, and
+// bounds -- flattened into one block of native-endian data, so that loading it again is a series of copies rather than a
+// parse.  It is only meant to be read back on the machine that wrote it.
+class CompiledGeometry {
+public:
+    // Whenever a change is made to the layout, or to what the readers produce, this value should be incremented
+    static const quint32 CURRENT_VERSION;
+
+    static QByteArray serialize(const FBXGeometry& geometry);
+
+    // Throw a QString if the data is truncated, corrupt, or from another version
+    static FBXGeometry::Pointer unserialize(const char* data, size_t length);
+    static FBXGeometry::Pointer unserialize(const QString& filepath);
+};
+
+#endif // hifi_CompiledGeometry_h
@@ -51,6 +51,12 @@ public:
     QByteArray name;
     QVariantList properties;
     FBXNodeList children;
+
+    // The vertices, normals, UVs and polygon indices of a geometry, when read from a binary file straight into the types
+    //   extractMesh uses, in place of properties (see FBXReader::parseFBX)
+    QVector<glm::vec3> vec3Values;
+    QVector<glm::vec2> texCoordValues;
+    QVector<int> intValues;
 };
 
 
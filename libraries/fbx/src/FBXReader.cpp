@@ -352,10 +352,10 @@ FBXBlendshape extractBlendshape(const FBXNode& object) {
             blendshape.indices = FBXReader::getIntVector(data);
 
         } else if (data.name == "Vertices") {
-            blendshape.vertices = FBXReader::createVec3Vector(FBXReader::getDoubleVector(data));
+            blendshape.vertices = FBXReader::getVec3Vector(data);
 
         } else if (data.name == "Normals") {
-            blendshape.normals = FBXReader::createVec3Vector(FBXReader::getDoubleVector(data));
+            blendshape.normals = FBXReader::getVec3Vector(data);
         }
     }
     return blendshape;
@@ -2006,7 +2006,7 @@ FBXGeometry* readFBX(const QByteArray& model, const QVariantHash& mapping, const
 
 FBXGeometry* readFBX(QIODevice* device, const QVariantHash& mapping, const QString& url, bool loadLightmaps, float lightmapLevel) {
     FBXReader reader;
-    reader._rootNode = FBXReader::parseFBX(device);
+    reader._rootNode = FBXReader::parseFBX(device, true);
     reader._loadLightmaps = loadLightmaps;
     reader._lightmapLevel = lightmapLevel;
 
@@ -120,7 +120,9 @@ public:
     FBXGeometry* _fbxGeometry;
 
     FBXNode _rootNode;
-    static FBXNode parseFBX(QIODevice* device);
+    // readGeometryArrays reads the geometry arrays of a binary file into the typed values of their nodes, rather than
+    //   their properties, which is only for trees that are read and not written back out
+    static FBXNode parseFBX(QIODevice* device, bool readGeometryArrays = false);
 
     FBXGeometry* extractFBXGeometry(const QVariantHash& mapping, const QString& url);
 
@@ -172,6 +174,8 @@ public:
     static QVector<glm::vec4> createVec4VectorRGBA(const QVector<double>& doubleVector, glm::vec4& average);
     static QVector<glm::vec3> createVec3Vector(const QVector<double>& doubleVector);
     static QVector<glm::vec2> createVec2Vector(const QVector<double>& doubleVector);
+    static QVector<glm::vec3> getVec3Vector(const FBXNode& node);
+    static QVector<glm::vec2> getTexCoordVector(const FBXNode& node);
     static glm::mat4 createMat4(const QVector<double>& doubleVector);
 
     static QVector<int> getIntVector(const FBXNode& node);
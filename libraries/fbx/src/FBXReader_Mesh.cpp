@@ -207,7 +207,7 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
 
     foreach (const FBXNode& child, object.children) {
         if (child.name == "Vertices") {
-            data.vertices = createVec3Vector(getDoubleVector(child));
+            data.vertices = getVec3Vector(child);
 
         } else if (child.name == "PolygonVertexIndex") {
             data.polygonIndices = getIntVector(child);
@@ -217,7 +217,7 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
             bool indexToDirect = false;
             foreach (const FBXNode& subdata, child.children) {
                 if (subdata.name == "Normals") {
-                    data.normals = createVec3Vector(getDoubleVector(subdata));
+                    data.normals = getVec3Vector(subdata);
 
                 } else if (subdata.name == "NormalsIndex") {
                     data.normalIndices = getIntVector(subdata);
@@ -273,8 +273,8 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
                 attrib.index = child.properties.at(0).toInt();
                 foreach (const FBXNode& subdata, child.children) {
                     if (subdata.name == "UV") {
-                        data.texCoords = createVec2Vector(getDoubleVector(subdata));
-                        attrib.texCoords = createVec2Vector(getDoubleVector(subdata));
+                        data.texCoords = getTexCoordVector(subdata);
+                        attrib.texCoords = data.texCoords;
                     } else if (subdata.name == "UVIndex") {
                         data.texCoordIndices = getIntVector(subdata);
                         attrib.texCoordIndices = getIntVector(subdata);
@@ -301,7 +301,7 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
                 attrib.index = child.properties.at(0).toInt();
                 foreach (const FBXNode& subdata, child.children) {
                     if (subdata.name == "UV") {
-                        attrib.texCoords = createVec2Vector(getDoubleVector(subdata));
+                        attrib.texCoords = getTexCoordVector(subdata);
                     } else if (subdata.name == "UVIndex") {
                         attrib.texCoordIndices = getIntVector(subdata);
                     } else if  (subdata.name == "Name") {
@@ -11,165 +11,279 @@
 
 #include "FBXReader.h"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+
+#include <zlib.h>
+
 #include <QtCore/QBuffer>
-#include <QtCore/QDataStream>
+#include <QtCore/QFileDevice>
 #include <QtCore/QIODevice>
 #include <QtCore/QStringList>
 #include <QtCore/QTextStream>
 #include <QtCore/QDebug>
-#include <QtCore/QtEndian>
 #include <QtCore/QFileInfo>
 
+#include <Finally.h>
 #include <shared/NsightHelpers.h>
 #include "ModelFormatLogging.h"
 
-template<class T>
-int streamSize() {
-    return sizeof(T);
+// Reads the binary format in place, straight out of the bytes of the file rather than through a stream
+class BinaryReader {
+public:
+    BinaryReader(const char* data, qint64 size) : _begin(data), _current(data), _end(data + size) { }
+
+    qint64 position() const { return _current - _begin; }
+    bool atEnd() const { return _current == _end; }
+
+    char peek() const {
+        if (_current == _end) {
+            throw QString("corrupt fbx file");
+        }
+        return *_current;
+    }
+
+    const char* readRaw(qint64 length) {
+        if (length < 0 || length > _end - _current) {
+            throw QString("corrupt fbx file");
+        }
+        const char* data = _current;
+        _current += length;
+        return data;
+    }
+
+    template<class T>
+    T read() {
+        T value;
+        memcpy(&value, readRaw(sizeof(T)), sizeof(T));
+        return fromLittleEndian(value);
+    }
+
+    template<class T>
+    static T fromLittleEndian(T value) {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        char* bytes = reinterpret_cast<char*>(&value);
+        std::reverse(bytes, bytes + sizeof(T));
+#endif
+        return value;
+    }
+
+private:
+    const char* _begin;
+    const char* _current;
+    const char* _end;
+};
+
+// deflate can't do better than this, so a larger array is a corrupt length rather than something to allocate
+static const quint64 MAX_DEFLATE_RATIO = 1032;
+
+static void checkBinaryArrayLength(quint32 arrayLength, quint64 numBytes, quint32 encoding, quint32 compressedLength) {
+    if (arrayLength > (quint32)std::numeric_limits<int>::max() ||
+        (encoding == FBX_PROPERTY_COMPRESSED_FLAG && numBytes > MAX_DEFLATE_RATIO * ((quint64)compressedLength + 1))) {
+        throw QString("corrupt fbx file");
+    }
 }
 
-template<bool>
-int streamSize() {
-    return 1;
+template<class T>
+QVector<T> readBinaryArrayValues(BinaryReader& in) {
+    quint32 arrayLength = in.read<quint32>();
+    quint32 encoding = in.read<quint32>();
+    quint32 compressedLength = in.read<quint32>();
+
+    quint64 numBytes = (quint64)sizeof(T) * arrayLength;
+    checkBinaryArrayLength(arrayLength, numBytes, encoding, compressedLength);
+
+    // decode straight into the array, without copying the compressed or uncompressed bytes on the way
+    QVector<T> values(arrayLength);
+    if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+        const char* compressed = in.readRaw(compressedLength);
+        uLongf uncompressedLength = (uLongf)numBytes;
+        if (numBytes > 0 && (uncompress(reinterpret_cast<Bytef*>(values.data()), &uncompressedLength,
+                reinterpret_cast<const Bytef*>(compressed), compressedLength) != Z_OK || uncompressedLength != numBytes)) {
+            throw QString("corrupt fbx file");
+        }
+    } else if (numBytes > 0) {
+        memcpy(values.data(), in.readRaw(numBytes), numBytes);
+    }
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    for (auto& value : values) {
+        value = BinaryReader::fromLittleEndian(value);
+    }
+#endif
+    return values;
 }
 
 template<class T>
-QVariant readBinaryArray(QDataStream& in, int& position) {
-    quint32 arrayLength;
-    quint32 encoding;
-    quint32 compressedLength;
-
-    in >> arrayLength;
-    in >> encoding;
-    in >> compressedLength;
-    position += sizeof(quint32) * 3;
-
-    QVector<T> values;
-    if ((int)QSysInfo::ByteOrder == (int)in.byteOrder()) {
-        values.resize(arrayLength);
-        QByteArray arrayData;
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            arrayData = qUncompress(compressed);
-            if (arrayData.isEmpty() ||
-                (unsigned int)arrayData.size() != (sizeof(T) * arrayLength)) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-        } else {
-            arrayData.resize(sizeof(T) * arrayLength);
-            position += sizeof(T) * arrayLength;
-            in.readRawData(arrayData.data(), arrayData.size());
+QVariant readBinaryArray(BinaryReader& in) {
+    return QVariant::fromValue(readBinaryArrayValues<T>(in));
+}
+
+// Converts numElements elements of N little-endian T components, appending them to values
+template<class T, int N, class V, class Convert>
+void appendBinaryVectors(const char* data, qint64 numElements, QVector<V>& values, Convert convert) {
+    for (qint64 i = 0; i < numElements; i++) {
+        float components[N];
+        for (int j = 0; j < N; j++) {
+            T component;
+            memcpy(&component, data, sizeof(T));
+            data += sizeof(T);
+            components[j] = (float)BinaryReader::fromLittleEndian(component);
+        }
+        values.append(convert(components));
+    }
+}
+
+// Reads a double or float array straight into vectors of N floats, one chunk of inflated bytes at a time if it's
+//   compressed, so there is neither a QVariant nor an array of doubles to convert from afterwards.  As with
+//   createVec3Vector, a trailing partial vector is dropped
+template<class T, int N, class V, class Convert>
+QVector<V> readBinaryVectorArray(BinaryReader& in, Convert convert) {
+    quint32 arrayLength = in.read<quint32>();
+    quint32 encoding = in.read<quint32>();
+    quint32 compressedLength = in.read<quint32>();
+
+    quint64 numBytes = (quint64)sizeof(T) * arrayLength;
+    checkBinaryArrayLength(arrayLength, numBytes, encoding, compressedLength);
+
+    QVector<V> values;
+    values.reserve(arrayLength / N);
+    if (encoding != FBX_PROPERTY_COMPRESSED_FLAG) {
+        appendBinaryVectors<T, N>(in.readRaw(numBytes), arrayLength / N, values, convert);
+        return values;
+    }
+
+    const char* compressed = in.readRaw(compressedLength);
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit(&stream) != Z_OK) {
+        throw QString("corrupt fbx file");
+    }
+    Finally endInflate([&] {
+        inflateEnd(&stream);
+    });
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed));
+    stream.avail_in = compressedLength;
+
+    const int ELEMENT_SIZE = sizeof(T) * N;
+    const int CHUNK_ELEMENTS = 1024;
+    char chunk[CHUNK_ELEMENTS * ELEMENT_SIZE];
+    int filled = 0;
+    int result = Z_OK;
+    while (result != Z_STREAM_END) {
+        stream.next_out = reinterpret_cast<Bytef*>(chunk + filled);
+        stream.avail_out = sizeof(chunk) - filled;
+        result = inflate(&stream, Z_NO_FLUSH);
+        if ((result != Z_OK && result != Z_STREAM_END) || stream.total_out > numBytes) {
+            throw QString("corrupt fbx file");
         }
+        filled = sizeof(chunk) - stream.avail_out;
+
+        // convert the whole elements, and keep any partial one for the next chunk
+        int numElements = filled / ELEMENT_SIZE;
+        appendBinaryVectors<T, N>(chunk, numElements, values, convert);
+        int converted = numElements * ELEMENT_SIZE;
+        memmove(chunk, chunk + converted, filled - converted);
+        filled -= converted;
+    }
+    if (stream.total_out != numBytes) {
+        throw QString("corrupt fbx file");
+    }
+    return values;
+}
+
+static glm::vec3 toVec3(const float* components) {
+    return glm::vec3(components[0], components[1], components[2]);
+}
 
-        if (arrayData.size() > 0) {
-            memcpy(&values[0], arrayData.constData(), arrayData.size());
+static glm::vec2 toTexCoord(const float* components) {
+    // flipped, as createVec2Vector does
+    return glm::vec2(components[0], -components[1]);
+}
+
+// Reads the single array property of one of the geometry arrays extractMesh uses into the node's typed values,
+//   returning false, with nothing read, if it isn't one or isn't of the expected type
+bool readBinaryGeometryArray(BinaryReader& in, FBXNode& node) {
+    char type = in.peek();
+    bool isDouble = (type == 'd');
+    if (node.name == "PolygonVertexIndex") {
+        if (type != 'i') {
+            return false;
         }
-    } else {
-        values.reserve(arrayLength);
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            QByteArray uncompressed = qUncompress(compressed);
-            if (uncompressed.isEmpty()) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-            QDataStream uncompressedIn(uncompressed);
-            uncompressedIn.setByteOrder(QDataStream::LittleEndian);
-            uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                uncompressedIn >> value;
-                values.append(value);
-            }
-        } else {
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                in >> value;
-                position += streamSize<T>();
-                values.append(value);
-            }
+        in.read<char>();
+        node.intValues = readBinaryArrayValues<qint32>(in);
+
+    } else if (node.name == "Vertices" || node.name == "Normals") {
+        if (type != 'd' && type != 'f') {
+            return false;
         }
+        in.read<char>();
+        node.vec3Values = isDouble ? readBinaryVectorArray<double, 3, glm::vec3>(in, toVec3) :
+            readBinaryVectorArray<float, 3, glm::vec3>(in, toVec3);
+
+    } else if (node.name == "UV") {
+        if (type != 'd' && type != 'f') {
+            return false;
+        }
+        in.read<char>();
+        node.texCoordValues = isDouble ? readBinaryVectorArray<double, 2, glm::vec2>(in, toTexCoord) :
+            readBinaryVectorArray<float, 2, glm::vec2>(in, toTexCoord);
+
+    } else {
+        return false;
     }
-    return QVariant::fromValue(values);
+    return true;
 }
 
-QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
-    char ch;
-    in.device()->getChar(&ch);
-    position++;
+QVariant parseBinaryFBXProperty(BinaryReader& in) {
+    char ch = in.read<char>();
     switch (ch) {
         case 'Y': {
-            qint16 value;
-            in >> value;
-            position += sizeof(qint16);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<qint16>());
         }
         case 'C': {
-            bool value;
-            in >> value;
-            position++;
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<qint8>() != 0);
         }
         case 'I': {
-            qint32 value;
-            in >> value;
-            position += sizeof(qint32);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<qint32>());
         }
         case 'F': {
-            float value;
-            in >> value;
-            position += sizeof(float);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<float>());
         }
         case 'D': {
-            double value;
-            in >> value;
-            position += sizeof(double);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<double>());
         }
         case 'L': {
-            qint64 value;
-            in >> value;
-            position += sizeof(qint64);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<qint64>());
         }
         case 'f': {
-            return readBinaryArray<float>(in, position);
+            return readBinaryArray<float>(in);
         }
         case 'd': {
-            return readBinaryArray<double>(in, position);
+            return readBinaryArray<double>(in);
         }
         case 'l': {
-            return readBinaryArray<qint64>(in, position);
+            return readBinaryArray<qint64>(in);
         }
         case 'i': {
-            return readBinaryArray<qint32>(in, position);
+            return readBinaryArray<qint32>(in);
         }
         case 'b': {
-            return readBinaryArray<bool>(in, position);
+            return readBinaryArray<bool>(in);
         }
         case 'S':
         case 'R': {
-            quint32 length;
-            in >> length;
-            position += sizeof(quint32) + length;
-            return QVariant::fromValue(in.device()->read(length));
+            quint32 length = in.read<quint32>();
+            return QVariant::fromValue(QByteArray(in.readRaw(length), length));
         }
         default:
             throw QString("Unknown property type: ") + ch;
     }
 }
 
-FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions = false) {
+FBXNode parseBinaryFBXNode(BinaryReader& in, bool has64BitPositions = false, bool readGeometryArrays = false,
+        bool inGeometry = false) {
     qint64 endOffset;
     quint64 propertyCount;
     quint64 propertyListLength;
@@ -177,27 +291,17 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
 
     // FBX 2016 and beyond uses 64bit positions in the node headers, pre-2016 used 32bit values
     // our code generally doesn't care about the size that much, so we will use 64bit values
-    // from here on out, but if the file is an older format we read the stream into temp 32bit 
-    // values and then assign to our actual 64bit values.
+    // from here on out, but if the file is an older format we read the 32bit values and widen them.
     if (has64BitPositions) {
-        in >> endOffset;
-        in >> propertyCount;
-        in >> propertyListLength;
-        position += sizeof(quint64) * 3;
+        endOffset = in.read<qint64>();
+        propertyCount = in.read<quint64>();
+        propertyListLength = in.read<quint64>();
     } else {
-        qint32 tempEndOffset;
-        quint32 tempPropertyCount;
-        quint32 tempPropertyListLength;
-        in >> tempEndOffset;
-        in >> tempPropertyCount;
-        in >> tempPropertyListLength;
-        position += sizeof(quint32) * 3;
-        endOffset = tempEndOffset;
-        propertyCount = tempPropertyCount;
-        propertyListLength = tempPropertyListLength;
-    }
-    in >> nameLength;
-    position += sizeof(quint8);
+        endOffset = in.read<qint32>();
+        propertyCount = in.read<quint32>();
+        propertyListLength = in.read<quint32>();
+    }
+    nameLength = in.read<quint8>();
 
     FBXNode node;
     const int MIN_VALID_OFFSET = 40;
@@ -205,15 +309,19 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
         // use a null name to indicate a null node
         return node;
     }
-    node.name = in.device()->read(nameLength);
-    position += nameLength;
+    node.name = QByteArray(in.readRaw(nameLength), nameLength);
 
-    for (quint32 i = 0; i < propertyCount; i++) {
-        node.properties.append(parseBinaryFBXProperty(in, position));
+    if (!(inGeometry && propertyCount == 1 && readBinaryGeometryArray(in, node))) {
+        // every property takes at least two bytes, so don't trust a larger count with the reservation
+        node.properties.reserve((int)std::min(propertyCount, propertyListLength / 2));
+        for (quint64 i = 0; i < propertyCount; i++) {
+            node.properties.append(parseBinaryFBXProperty(in));
+        }
     }
 
-    while (endOffset > position) {
-        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
+    bool childrenInGeometry = readGeometryArrays && (inGeometry || node.name == "Geometry");
+    while (endOffset > in.position()) {
+        FBXNode child = parseBinaryFBXNode(in, has64BitPositions, readGeometryArrays, childrenInGeometry);
         if (child.name.isNull()) {
             return node;
 
@@ -348,7 +456,7 @@ FBXNode parseTextFBXNode(Tokenizer& tokenizer) {
     return node;
 }
 
-FBXNode FBXReader::parseFBX(QIODevice* device) {
+FBXNode FBXReader::parseFBX(QIODevice* device, bool readGeometryArrays) {
     PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xff0000ff, device);
     // verify the prolog
     if (device->peek(FBX_BINARY_PROLOG.size()) != FBX_BINARY_PROLOG) {
@@ -366,9 +474,31 @@ FBXNode FBXReader::parseFBX(QIODevice* device) {
         }
         return top;
     }
-    QDataStream in(device);
-    in.setByteOrder(QDataStream::LittleEndian);
-    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
+
+    // parse the binary format in place: out of the bytes of a buffer, or of a file mapped into memory,
+    // and only read a copy of the rest of the device if it's neither
+    const char* data = nullptr;
+    qint64 size = 0;
+    QByteArray contents;
+    uchar* mapped = nullptr;
+    auto buffer = qobject_cast<QBuffer*>(device);
+    auto file = qobject_cast<QFileDevice*>(device);
+    if (buffer) {
+        data = buffer->data().constData() + buffer->pos();
+        size = buffer->size() - buffer->pos();
+    } else if (file && (mapped = file->map(file->pos(), file->size() - file->pos()))) {
+        data = reinterpret_cast<const char*>(mapped);
+        size = file->size() - file->pos();
+    } else {
+        contents = device->readAll();
+        data = contents.constData();
+        size = contents.size();
+    }
+    Finally unmap([&] {
+        if (mapped) {
+            file->unmap(mapped);
+        }
+    });
 
     // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
     // of the FBX binary format
@@ -377,18 +507,16 @@ FBXNode FBXReader::parseFBX(QIODevice* device) {
     //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
     //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
     //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
-    in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
-    int position = FBX_HEADER_BYTES_BEFORE_VERSION;
-    quint32 fileVersion;
-    in >> fileVersion;
-    position += sizeof(fileVersion);
+    BinaryReader in(data, size);
+    in.readRaw(FBX_HEADER_BYTES_BEFORE_VERSION);
+    quint32 fileVersion = in.read<quint32>();
     qCDebug(modelformat) << "fileVersion:" << fileVersion;
     bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
 
     // parse the top-level node
     FBXNode top;
-    while (device->bytesAvailable()) {
-        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (!in.atEnd()) {
+        FBXNode next = parseBinaryFBXNode(in, has64BitPositions, readGeometryArrays);
         if (next.name.isNull()) {
             return top;
 
@@ -408,6 +536,7 @@ glm::vec3 FBXReader::getVec3(const QVariantList& properties, int index) {
 
 QVector<glm::vec4> FBXReader::createVec4Vector(const QVector<double>& doubleVector) {
     QVector<glm::vec4> values;
+    values.reserve(doubleVector.size() / 4);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 4) * 4); it != end; ) {
         float x = *it++;
         float y = *it++;
@@ -421,6 +550,7 @@ QVector<glm::vec4> FBXReader::createVec4Vector(const QVector<double>& doubleVect
 
 QVector<glm::vec4> FBXReader::createVec4VectorRGBA(const QVector<double>& doubleVector, glm::vec4& average) {
     QVector<glm::vec4> values;
+    values.reserve(doubleVector.size() / 4);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 4) * 4); it != end; ) {
         float x = *it++;
         float y = *it++;
@@ -438,6 +568,7 @@ QVector<glm::vec4> FBXReader::createVec4VectorRGBA(const QVector<double>& double
 
 QVector<glm::vec3> FBXReader::createVec3Vector(const QVector<double>& doubleVector) {
     QVector<glm::vec3> values;
+    values.reserve(doubleVector.size() / 3);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 3) * 3); it != end; ) {
         float x = *it++;
         float y = *it++;
@@ -449,6 +580,7 @@ QVector<glm::vec3> FBXReader::createVec3Vector(const QVector<double>& doubleVect
 
 QVector<glm::vec2> FBXReader::createVec2Vector(const QVector<double>& doubleVector) {
     QVector<glm::vec2> values;
+    values.reserve(doubleVector.size() / 2);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 2) * 2); it != end; ) {
         float s = *it++;
         float t = *it++;
@@ -457,6 +589,20 @@ QVector<glm::vec2> FBXReader::createVec2Vector(const QVector<double>& doubleVect
     return values;
 }
 
+QVector<glm::vec3> FBXReader::getVec3Vector(const FBXNode& node) {
+    if (!node.vec3Values.isEmpty()) {
+        return node.vec3Values;
+    }
+    return createVec3Vector(getDoubleVector(node));
+}
+
+QVector<glm::vec2> FBXReader::getTexCoordVector(const FBXNode& node) {
+    if (!node.texCoordValues.isEmpty()) {
+        return node.texCoordValues;
+    }
+    return createVec2Vector(getDoubleVector(node));
+}
+
 glm::mat4 FBXReader::createMat4(const QVector<double>& doubleVector) {
     return glm::mat4(doubleVector.at(0), doubleVector.at(1), doubleVector.at(2), doubleVector.at(3),
         doubleVector.at(4), doubleVector.at(5), doubleVector.at(6), doubleVector.at(7),
@@ -465,6 +611,9 @@ glm::mat4 FBXReader::createMat4(const QVector<double>& doubleVector) {
 }
 
 QVector<int> FBXReader::getIntVector(const FBXNode& node) {
+    if (!node.intValues.isEmpty()) {
+        return node.intValues;
+    }
     foreach (const FBXNode& child, node.children) {
         if (child.name == "a") {
             return getIntVector(child);
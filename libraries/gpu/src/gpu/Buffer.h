@@ -108,6 +108,15 @@ public:
         return append(sizeof(T) * t.size(), reinterpret_cast<const Byte*>(&t[0]));
     }
 
+    // Mark count elements from index dirty and return them to be written in place, rather than
+    // filling a temporary and copying it in with setSubData.  The range must be within getSize()
+    template <typename T>
+    T* editRange(Size index, Size count) {
+        Q_ASSERT(sizeof(T) * (index + count) <= _end);
+        markDirty<T>(index, count);
+        return reinterpret_cast<T*>(editData()) + index;
+    }
+
 
     const GPUObjectPointer gpuObject {};
     
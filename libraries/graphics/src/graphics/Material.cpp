@@ -119,6 +119,11 @@ void Material::setScattering(float scattering) {
     _schemaBuffer.edit<Schema>()._scattering = scattering;
 }
 
+void Material::setSchema(const Schema& schema) {
+    _key = MaterialKey(MaterialKey::Flags(schema._key));
+    _schemaBuffer.edit<Schema>() = schema;
+}
+
 void Material::setTextureMap(MapChannel channel, const TextureMapPointer& textureMap) {
     QMutexLocker locker(&_textureMapsMutex);
 
@@ -328,6 +328,9 @@ public:
 
     const UniformBufferView& getSchemaBuffer() const { return _schemaBuffer; }
 
+    // Restore all the attribute values and the key they imply at once, from a schema saved off another material
+    void setSchema(const Schema& schema);
+
     // The texture map to channel association
     void setTextureMap(MapChannel channel, const TextureMapPointer& textureMap);
     const TextureMaps& getTextureMaps() const { return _textureMaps; } // FIXME - not thread safe... 
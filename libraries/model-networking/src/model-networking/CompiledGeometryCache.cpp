@@ -0,0 +1,126 @@
+//
+//  CompiledGeometryCache.cpp
+//  libraries/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CompiledGeometryCache.h"
+
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+
+#include <Gzip.h>
+#include <SettingHandle.h>
+
+using File = cache::File;
+
+// Whenever a change is made to the CompiledGeometry format that isn't backward compatible,
+// this value should be incremented.  This will force the compiled geometry cache to be wiped
+// 0x02 wipes the geometries cached from models that depend on other files
+const int CompiledGeometryCache::CURRENT_VERSION = 0x02;
+const int CompiledGeometryCache::INVALID_VERSION = 0x00;
+const char* CompiledGeometryCache::SETTING_VERSION_NAME = "hifi.geometry.cache_version";
+
+CompiledGeometryCache::CompiledGeometryCache(const std::string& dir, const std::string& ext) :
+    FileCache(dir, ext) { }
+
+void CompiledGeometryCache::initialize() {
+    FileCache::initialize();
+    Setting::Handle<int> cacheVersionHandle(SETTING_VERSION_NAME, INVALID_VERSION);
+    auto cacheVersion = cacheVersionHandle.get();
+    if (cacheVersion != CURRENT_VERSION) {
+        wipe();
+        cacheVersionHandle.set(CURRENT_VERSION);
+    }
+}
+
+static bool objHasExternalDependencies(const QByteArray& data) {
+    // a material library is read along with the model, and a model with texture coordinates but no material goes
+    //   looking for a texture named after itself
+    return data.contains("mtllib") || data.startsWith("vt") || data.contains("\nvt");
+}
+
+bool CompiledGeometryCache::canCache(const QUrl& url, const QByteArray& data) {
+    QString path = url.path().toLower();
+    if (path.endsWith(".obj")) {
+        return !objHasExternalDependencies(data);
+    }
+    if (path.endsWith(".obj.gz")) {
+        QByteArray uncompressedData;
+        return gunzip(data, uncompressedData) && !objHasExternalDependencies(uncompressedData);
+    }
+    if (path.endsWith(".gltf")) {
+        // any buffer with a uri is requested, even one whose uri holds its data
+        QJsonArray buffers = QJsonDocument::fromJson(data).object().value("buffers").toArray();
+        for (const QJsonValue& buffer : buffers) {
+            if (buffer.toObject().contains("uri")) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void addString(QCryptographicHash& hash, const QString& string) {
+    QByteArray utf8 = string.toUtf8();
+    quint32 length = utf8.size();
+    hash.addData(reinterpret_cast<const char*>(&length), sizeof(length));
+    hash.addData(utf8);
+}
+
+static void addVariant(QCryptographicHash& hash, const QVariant& value);
+
+// Adds a mapping with its keys sorted, as a hash has no stable order to go by.  A key the FST gives more than once, as it
+//   does each blendshape, has every one of its values, in the order the mapping gives them
+template <class Mapping>
+static void addMapping(QCryptographicHash& hash, const Mapping& mapping) {
+    QStringList keys = mapping.uniqueKeys();
+    keys.sort();
+    hash.addData("{");
+    for (const QString& key : keys) {
+        addString(hash, key);
+        for (const QVariant& value : mapping.values(key)) {
+            hash.addData("=");
+            addVariant(hash, value);
+        }
+    }
+    hash.addData("}");
+}
+
+static void addVariant(QCryptographicHash& hash, const QVariant& value) {
+    if (value.type() == QVariant::Hash) {
+        addMapping(hash, value.toHash());
+    } else if (value.type() == QVariant::Map) {
+        addMapping(hash, value.toMap());
+    } else if (value.type() == QVariant::List) {
+        hash.addData("[");
+        for (const QVariant& item : value.toList()) {
+            addVariant(hash, item);
+        }
+        hash.addData("]");
+    } else {
+        addString(hash, value.toString());
+    }
+}
+
+CompiledGeometryCache::Key CompiledGeometryCache::getKey(const QUrl& url, const QVariantHash& mapping,
+                                                         const QByteArray& data, bool combineParts) {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(data);
+    addString(hash, url.toString());
+    addMapping(hash, mapping);
+    hash.addData(combineParts ? "1" : "0");
+    return hash.result().toHex().toStdString();
+}
+
+std::unique_ptr<File> CompiledGeometryCache::createFile(Metadata&& metadata, const std::string& filepath) {
+    qCInfo(file_cache) << "Wrote compiled geometry" << metadata.key.c_str();
+    return FileCache::createFile(std::move(metadata), filepath);
+}
@@ -0,0 +1,47 @@
+//
+//  CompiledGeometryCache.h
+//  libraries/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CompiledGeometryCache_h
+#define hifi_CompiledGeometryCache_h
+
+#include <QByteArray>
+#include <QUrl>
+#include <QVariantHash>
+
+#include <shared/FileCache.h>
+
+// Holds the geometries that ModelCache has already read, as CompiledGeometry files, so that a model seen before
+// loads without being parsed again
+class CompiledGeometryCache : public cache::FileCache {
+    Q_OBJECT
+
+public:
+    // Whenever a change is made to the CompiledGeometry format that isn't backward compatible,
+    // this value should be incremented.  This will force the compiled geometry cache to be wiped
+    static const int CURRENT_VERSION;
+    static const int INVALID_VERSION;
+    static const char* SETTING_VERSION_NAME;
+
+    CompiledGeometryCache(const std::string& dir, const std::string& ext);
+
+    void initialize() override;
+
+    // Whether the readers' output depends only on the model's own contents; those that load other files too (an OBJ's
+    //   material library or default texture, a glTF's buffers) are read every time, as those files can change under it
+    static bool canCache(const QUrl& url, const QByteArray& data);
+
+    // Everything the readers' output depends on: the model's contents, where it came from, and how it was asked for
+    static Key getKey(const QUrl& url, const QVariantHash& mapping, const QByteArray& data, bool combineParts);
+
+protected:
+    std::unique_ptr<cache::File> createFile(Metadata&& metadata, const std::string& filepath) override final;
+};
+
+#endif // hifi_CompiledGeometryCache_h
@@ -12,6 +12,7 @@
 #include "ModelCache.h"
 #include <Finally.h>
 #include <FSTReader.h>
+#include "CompiledGeometry.h"
 #include "FBXReader.h"
 #include "OBJReader.h"
 #include "GLTFReader.h"
@@ -184,29 +185,55 @@ void GeometryReader::run() {
 
             FBXGeometry::Pointer fbxGeometry;
 
-            if (_url.path().toLower().endsWith(".fbx")) {
-                fbxGeometry.reset(readFBX(_data, _mapping, _url.path()));
-                if (fbxGeometry->meshes.size() == 0 && fbxGeometry->joints.size() == 0) {
-                    throw QString("empty geometry, possibly due to an unsupported FBX version");
+            // A model that has been read before is loaded back from the geometry that was compiled from it then
+            auto modelCache = DependencyManager::get<ModelCache>();
+            auto& compiledGeometryCache = modelCache->_compiledGeometryCache;
+            bool canCache = CompiledGeometryCache::canCache(_url, _data);
+            auto compiledGeometryKey = canCache ?
+                CompiledGeometryCache::getKey(_url, _mapping, _data, _combineParts) : CompiledGeometryCache::Key();
+            auto compiledGeometryFile = canCache ? compiledGeometryCache->getFile(compiledGeometryKey) : nullptr;
+            if (compiledGeometryFile) {
+                try {
+                    fbxGeometry = CompiledGeometry::unserialize(QString::fromStdString(compiledGeometryFile->getFilepath()));
+                } catch (const QString& error) {
+                    qCWarning(modelnetworking) << "Discarding compiled geometry for" << _url << ":" << error;
                 }
-            } else if (_url.path().toLower().endsWith(".obj")) {
-                fbxGeometry = OBJReader().readOBJ(_data, _mapping, _combineParts, _url);
-            } else if (_url.path().toLower().endsWith(".obj.gz")) {
-                QByteArray uncompressedData;
-                if (gunzip(_data, uncompressedData)){
-                    fbxGeometry = OBJReader().readOBJ(uncompressedData, _mapping, _combineParts, _url);
+                compiledGeometryFile.reset();
+            }
+
+            if (!fbxGeometry) {
+                if (_url.path().toLower().endsWith(".fbx")) {
+                    fbxGeometry.reset(readFBX(_data, _mapping, _url.path()));
+                    if (fbxGeometry->meshes.size() == 0 && fbxGeometry->joints.size() == 0) {
+                        throw QString("empty geometry, possibly due to an unsupported FBX version");
+                    }
+                } else if (_url.path().toLower().endsWith(".obj")) {
+                    fbxGeometry = OBJReader().readOBJ(_data, _mapping, _combineParts, _url);
+                } else if (_url.path().toLower().endsWith(".obj.gz")) {
+                    QByteArray uncompressedData;
+                    if (gunzip(_data, uncompressedData)){
+                        fbxGeometry = OBJReader().readOBJ(uncompressedData, _mapping, _combineParts, _url);
+                    } else {
+                        throw QString("failed to decompress .obj.gz");
+                    }
+
+                } else if (_url.path().toLower().endsWith(".gltf")) {
+                    std::shared_ptr<GLTFReader> glreader = std::make_shared<GLTFReader>();
+                    fbxGeometry.reset(glreader->readGLTF(_data, _mapping, _url));
+                    if (fbxGeometry->meshes.size() == 0 && fbxGeometry->joints.size() == 0) {
+                        throw QString("empty geometry, possibly due to an unsupported GLTF version");
+                    }
                 } else {
-                    throw QString("failed to decompress .obj.gz");
+                    throw QString("unsupported format");
                 }
 
-            } else if (_url.path().toLower().endsWith(".gltf")) {
-                std::shared_ptr<GLTFReader> glreader = std::make_shared<GLTFReader>();
-                fbxGeometry.reset(glreader->readGLTF(_data, _mapping, _url));
-                if (fbxGeometry->meshes.size() == 0 && fbxGeometry->joints.size() == 0) {
-                    throw QString("empty geometry, possibly due to an unsupported GLTF version");
+                if (canCache) {
+                    QByteArray compiledGeometry = CompiledGeometry::serialize(*fbxGeometry);
+                    if (!compiledGeometryCache->writeFile(compiledGeometry.constData(),
+                            CompiledGeometryCache::Metadata(compiledGeometryKey, compiledGeometry.size()), true)) {
+                        qCWarning(modelnetworking) << _url << "failed to write compiled geometry";
+                    }
                 }
-            } else {
-                throw QString("unsupported format");
             }
 
             // Ensure the resource has not been deleted
@@ -289,7 +316,11 @@ void GeometryDefinitionResource::setGeometryDefinition(FBXGeometry::Pointer fbxG
     finishedLoading(true);
 }
 
+const std::string ModelCache::COMPILED_GEOMETRY_DIRNAME { "geometry_cache" };
+const std::string ModelCache::COMPILED_GEOMETRY_EXT { "hfcg" };
+
 ModelCache::ModelCache() {
+    _compiledGeometryCache->initialize();
     const qint64 GEOMETRY_DEFAULT_UNUSED_MAX_SIZE = DEFAULT_UNUSED_MAX_SIZE;
     setUnusedResourceCacheSize(GEOMETRY_DEFAULT_UNUSED_MAX_SIZE);
     setObjectName("ModelCache");
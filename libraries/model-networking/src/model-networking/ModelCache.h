@@ -19,6 +19,7 @@
 #include <graphics/Asset.h>
 
 #include "FBXReader.h"
+#include "CompiledGeometryCache.h"
 #include "TextureCache.h"
 
 // Alias instead of derive to avoid copying
@@ -152,8 +153,16 @@ protected:
                                                     const void* extra) override;
 
 private:
+    friend class GeometryReader;
+
     ModelCache();
     virtual ~ModelCache() = default;
+
+    static const std::string COMPILED_GEOMETRY_DIRNAME;
+    static const std::string COMPILED_GEOMETRY_EXT;
+
+    std::shared_ptr<cache::FileCache> _compiledGeometryCache {
+        std::make_shared<CompiledGeometryCache>(COMPILED_GEOMETRY_DIRNAME, COMPILED_GEOMETRY_EXT) };
 };
 
 class NetworkMaterial : public graphics::Material {
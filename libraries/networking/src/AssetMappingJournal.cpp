@@ -0,0 +1,205 @@
+//
+//  AssetMappingJournal.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetMappingJournal.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
+#include "NetworkLogging.h"
+
+static const QString JOURNAL_SUFFIX = ".journal";
+
+// number of logged operations after which the journal is folded back into the map file
+static const int COMPACTION_OPERATION_THRESHOLD = 10000;
+
+AssetMappingJournal::AssetMappingJournal(const QString& mapFilePath) :
+    _mapFilePath(mapFilePath),
+    _journal(mapFilePath + JOURNAL_SUFFIX)
+{
+}
+
+AssetMappingJournal::~AssetMappingJournal() {
+    waitForCompaction();
+}
+
+bool AssetMappingJournal::replay(AssetUtils::Mappings& mappings) {
+    waitForCompaction();
+    _journal.close();
+
+    // a compacting journal is left over if the last compaction did not finish, it is read before the current journal
+    int numOperations = 0;
+    qint64 journalSize = _journal.read([&](const QByteArray& payload) {
+        return readRecord(payload, mappings, numOperations);
+    });
+    if (journalSize < 0) {
+        qCCritical(networking) << "Failed to read mapping journal at" << _journal.getPath();
+        return false;
+    }
+
+    if (QFile::exists(_journal.getRotatedPath()) || journalSize > 0) {
+        qCInfo(networking) << "Replayed" << numOperations << "mapping operations from the journal for" << _mapFilePath;
+
+        // fold the journals into the map file now, so the new journal starts from a clean slate
+        if (writeMapFile(_mapFilePath, mappings)) {
+            _journal.remove();
+            journalSize = 0;
+        } else {
+            // keep the journals around, they will be replayed again next time
+            _numOperations = numOperations;
+        }
+    }
+
+    if (!_journal.open(journalSize)) {
+        qCCritical(networking) << "Failed to open mapping journal at" << _journal.getPath();
+        return false;
+    }
+    return true;
+}
+
+void AssetMappingJournal::set(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash) {
+    _pendingOperations.push_back({ OperationType::Set, path, hash });
+}
+
+void AssetMappingJournal::remove(const AssetUtils::AssetPath& path) {
+    _pendingOperations.push_back({ OperationType::Remove, path, AssetUtils::AssetHash() });
+}
+
+bool AssetMappingJournal::commit() {
+    if (_pendingOperations.empty()) {
+        return true;
+    }
+
+    QByteArray payload;
+    {
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream << (quint32)_pendingOperations.size();
+        for (auto& operation : _pendingOperations) {
+            stream << (quint8)operation.type << operation.path << operation.hash;
+        }
+    }
+    int numOperations = (int)_pendingOperations.size();
+    _pendingOperations.clear();
+
+    if (!_journal.isOpen()) {
+        qCWarning(networking) << "Cannot commit mapping operations, the journal at" << _journal.getPath() << "is not open";
+        return false;
+    }
+
+    if (!_journal.append(payload)) {
+        qCWarning(networking) << "Failed to write mapping operations to the journal at" << _journal.getPath();
+        return false;
+    }
+
+    _numOperations += numOperations;
+    return true;
+}
+
+bool AssetMappingJournal::needsCompaction() const {
+    return _numOperations >= COMPACTION_OPERATION_THRESHOLD && !_isCompacting;
+}
+
+void AssetMappingJournal::compact(const AssetUtils::Mappings& mappings) {
+    if (_isCompacting) {
+        return;
+    }
+    waitForCompaction();
+
+    if (!_journal.rotate()) {
+        qCWarning(networking) << "Failed to rotate the mapping journal at" << _journal.getPath() << "- will not compact";
+        return;
+    }
+
+    _numOperations = 0;
+
+    // the mappings are copied here, on the calling thread, and written out in the background
+    _isCompacting = true;
+    _compactionThread = std::thread([this, mappings] {
+        if (writeMapFile(_mapFilePath, mappings)) {
+            _journal.removeRotated();
+        } else {
+            qCWarning(networking) << "Failed to compact the mapping journal into" << _mapFilePath
+                << "- it will be retried with the next compaction";
+        }
+        _isCompacting = false;
+    });
+}
+
+void AssetMappingJournal::waitForCompaction() {
+    if (_compactionThread.joinable()) {
+        _compactionThread.join();
+    }
+}
+
+bool AssetMappingJournal::writeMapFile(const QString& mapFilePath, const AssetUtils::Mappings& mappings) {
+    QSaveFile mapFile { mapFilePath };
+    if (mapFile.open(QIODevice::WriteOnly)) {
+        QJsonObject root;
+
+        for (auto& it : mappings) {
+            root[it.first] = it.second;
+        }
+
+        QJsonDocument jsonDocument { root };
+
+        if (mapFile.write(jsonDocument.toJson()) != -1 && mapFile.commit()) {
+            qCDebug(networking) << "Wrote JSON mappings to file at" << mapFilePath;
+            return true;
+        } else {
+            qCWarning(networking) << "Failed to write JSON mappings to file at" << mapFilePath;
+        }
+    } else {
+        qCWarning(networking) << "Failed to open map file at" << mapFilePath;
+    }
+
+    return false;
+}
+
+void AssetMappingJournal::apply(AssetUtils::Mappings& mappings, const Operation& operation) {
+    if (operation.type == OperationType::Set) {
+        mappings[operation.path] = operation.hash;
+    } else if (operation.path.endsWith('/')) {
+        // the mappings are sorted, so everything in the folder is in one range
+        auto it = mappings.lower_bound(operation.path);
+        while (it != mappings.end() && it->first.startsWith(operation.path)) {
+            it = mappings.erase(it);
+        }
+    } else {
+        mappings.erase(operation.path);
+    }
+}
+
+bool AssetMappingJournal::readRecord(const QByteArray& payload, AssetUtils::Mappings& mappings, int& numOperations) {
+    QDataStream stream(payload);
+    quint32 numRecordOperations;
+    stream >> numRecordOperations;
+
+    std::vector<Operation> operations;
+    for (quint32 i = 0; i < numRecordOperations && stream.status() == QDataStream::Ok; ++i) {
+        quint8 type;
+        Operation operation;
+        stream >> type >> operation.path >> operation.hash;
+        operation.type = (OperationType)type;
+        operations.push_back(operation);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // a record is all or nothing
+    for (auto& operation : operations) {
+        apply(mappings, operation);
+    }
+    numOperations += (int)operations.size();
+    return true;
+}
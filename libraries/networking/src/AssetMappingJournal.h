@@ -0,0 +1,83 @@
+//
+//  AssetMappingJournal.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetMappingJournal_h
+#define hifi_AssetMappingJournal_h
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <RecordLog.h>
+
+#include "AssetUtils.h"
+
+// Append-only log of the changes made to the asset server mappings, next to the JSON map file.
+//   Each commit appends a single checksummed record, instead of rewriting the whole map file. Once enough operations
+//   have been logged the journal is compacted: the current mappings are written to the map file on a background thread
+//   and the journal starts over. On startup the journal is replayed on top of the mappings read from the map file.
+//   Operations are absolute (set a path, remove a path or folder), so replaying a journal more than once is harmless.
+//   Not thread-safe, except for the background compaction itself.
+class AssetMappingJournal {
+public:
+    AssetMappingJournal(const QString& mapFilePath);
+    ~AssetMappingJournal();
+
+    // applies what is left in the journal from the last run to mappings (read from the map file),
+    // folds it into the map file, and opens the journal for new operations
+    bool replay(AssetUtils::Mappings& mappings);
+
+    // queue operations for the next commit
+    void set(const AssetUtils::AssetPath& path, const AssetUtils::AssetHash& hash);
+    void remove(const AssetUtils::AssetPath& path); // a path ending with a slash removes the whole folder
+
+    // atomically appends the queued operations to the journal, returns false if they could not be persisted
+    bool commit();
+    void rollback() { _pendingOperations.clear(); }
+
+    bool needsCompaction() const;
+
+    // writes mappings to the map file in the background, and starts a new journal
+    void compact(const AssetUtils::Mappings& mappings);
+    void waitForCompaction();
+
+    int getNumOperations() const { return _numOperations; }
+    bool isCompacting() const { return _isCompacting; }
+
+    // the map file format: a JSON object of path to hash
+    static bool writeMapFile(const QString& mapFilePath, const AssetUtils::Mappings& mappings);
+
+private:
+    enum class OperationType : quint8 {
+        Set = 0,
+        Remove
+    };
+
+    struct Operation {
+        OperationType type;
+        AssetUtils::AssetPath path;
+        AssetUtils::AssetHash hash;
+    };
+
+    static void apply(AssetUtils::Mappings& mappings, const Operation& operation);
+
+    // applies the operations of a journal record, returns false if it can't be parsed
+    static bool readRecord(const QByteArray& payload, AssetUtils::Mappings& mappings, int& numOperations);
+
+    QString _mapFilePath;
+    RecordLog _journal; // rotated aside while it is being folded into the map file
+    std::vector<Operation> _pendingOperations;
+    int _numOperations { 0 }; // operations since the last compaction
+
+    std::thread _compactionThread;
+    std::atomic<bool> _isCompacting { false };
+};
+
+#endif // hifi_AssetMappingJournal_h
@@ -0,0 +1,69 @@
+//
+//  DomainListCache.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DomainListCache.h"
+
+#include <QtCore/QDataStream>
+
+#include <SharedUtil.h>
+
+DomainListCache::DomainListCache() :
+    _firstVersion(usecTimestampNow()),
+    _version(_firstVersion)
+{
+}
+
+bool DomainListCache::updateNode(const SharedNodePointer& node) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << *node;
+
+    NodeType_t nodeType = node->getType();
+    auto it = _index.find(node->getUUID());
+    if (it != _index.end()) {
+        if (it->first == nodeType) {
+            Record& record = _records[nodeType][it->second];
+            if (record.data == data) {
+                return false;
+            }
+            record.data = data;
+            record.version = ++_version;
+            return true;
+        }
+
+        // the node changed type, move it to its new group
+        removeNode(node->getUUID());
+    }
+
+    auto& records = _records[nodeType];
+    _index.insert(node->getUUID(), { nodeType, records.size() });
+    records.push_back({ node, data, ++_version });
+    return true;
+}
+
+void DomainListCache::removeNode(const QUuid& nodeID) {
+    auto it = _index.find(nodeID);
+    if (it == _index.end()) {
+        return;
+    }
+
+    // swap the last record of the group into the removed one
+    auto& records = _records[it->first];
+    size_t index = it->second;
+    _index.erase(it);
+
+    if (index != records.size() - 1) {
+        records[index] = std::move(records.back());
+        _index[records[index].node->getUUID()].second = index;
+    }
+    records.pop_back();
+
+    // nodes are only removed from lists by the packets that kill them, so a removal doesn't need a new version
+}
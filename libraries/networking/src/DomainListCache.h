@@ -0,0 +1,80 @@
+//
+//  DomainListCache.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DomainListCache_h
+#define hifi_DomainListCache_h
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
+
+#include "Node.h"
+#include "NodeType.h"
+
+// The nodes of a domain list, as the domain-server streams them, serialized once per change instead of once per list.
+//   Records are grouped by node type, so a list only looks at the types its node is interested in, and each is stamped
+//   with the version of the cache it last changed in, so a node that tells us the version of the last list it has only
+//   needs the records changed since.
+//   Versions start at the time the cache is created, so a version from a previous run of the domain-server is never
+//   mistaken for one of ours. Not thread-safe.
+class DomainListCache {
+public:
+    struct Record {
+        SharedNodePointer node;
+        QByteArray data;
+        quint64 version;
+    };
+
+    DomainListCache();
+
+    quint64 getVersion() const { return _version; }
+
+    // whether the records changed since the given version can be told apart from the others
+    bool hasVersion(quint64 version) const { return version >= _firstVersion && version <= _version; }
+
+    // re-serializes the node, and bumps the version if that changed its record (or it is new)
+    // returns whether it did
+    bool updateNode(const SharedNodePointer& node);
+    void removeNode(const QUuid& nodeID);
+
+    int getNumRecords() const { return _index.size(); }
+
+    // calls functor(const Record&) for each record of the given types changed after the given version
+    template <typename F>
+    void eachRecordSince(const NodeSet& nodeTypes, quint64 version, F functor) const;
+
+private:
+    quint64 _firstVersion;
+    quint64 _version;
+
+    std::unordered_map<NodeType_t, std::vector<Record>> _records;
+    QHash<QUuid, std::pair<NodeType_t, size_t>> _index;
+};
+
+template <typename F>
+void DomainListCache::eachRecordSince(const NodeSet& nodeTypes, quint64 version, F functor) const {
+    for (NodeType_t nodeType : nodeTypes) {
+        auto it = _records.find(nodeType);
+        if (it == _records.end()) {
+            continue;
+        }
+        for (const Record& record : it->second) {
+            if (record.version > version) {
+                functor(record);
+            }
+        }
+    }
+}
+
+#endif // hifi_DomainListCache_h
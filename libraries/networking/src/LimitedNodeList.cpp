@@ -36,6 +36,7 @@
 #include "HifiSockAddr.h"
 #include "NetworkLogging.h"
 #include "udt/Packet.h"
+#include "udt/PacketBufferPool.h"
 
 static Setting::Handle<quint16> LIMITED_NODELIST_LOCAL_PORT("LimitedNodeList.LocalPort", 0);
 
@@ -318,15 +319,13 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
 
             if (verifiedPacket && !ignoreVerification) {
 
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash = NLPacket::hashForPacketAndSecret(packet, sourceNode->getConnectionSecret());
-
-                // check if the md5 hash in the header matches the hash we would expect
-                if (packetHeaderHash != expectedHash) {
+                // check if the hash in the header matches the hash we would expect
+                if (!NLPacket::isVerificationHashValid(packet, sourceNode->getVerificationKey())) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
-                        qCDebug(networking) << packetHeaderHash << expectedHash;
+                        qCDebug(networking) << NLPacket::verificationHashInHeader(packet)
+                            << NLPacket::hashForPacket(packet, sourceNode->getVerificationKey());
                         qCDebug(networking) << "Packet hash mismatch on" << headerType << "- Sender" << sourceID;
 
                         hashDebugSuppressMap.insert(sourceID, headerType);
@@ -363,15 +362,15 @@ void LimitedNodeList::collectPacketStats(const NLPacket& packet) {
     _numCollectedBytes += packet.getDataSize();
 }
 
-void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret) {
+void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const NLPacket::VerificationKey& verificationKey) {
     if (!PacketTypeEnum::getNonSourcedPackets().contains(packet.getType())) {
         packet.writeSourceID(getSessionUUID());
     }
 
-    if (!connectionSecret.isNull()
+    if (!verificationKey.isNull()
         && !PacketTypeEnum::getNonSourcedPackets().contains(packet.getType())
         && !PacketTypeEnum::getNonVerifiedPackets().contains(packet.getType())) {
-        packet.writeVerificationHashGivenSecret(connectionSecret);
+        packet.writeVerificationHash(verificationKey);
     }
 }
 
@@ -387,17 +386,17 @@ qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const Node&
     emit dataSent(destinationNode.getType(), packet.getDataSize());
     destinationNode.recordBytesSent(packet.getDataSize());
 
-    return sendUnreliablePacket(packet, *destinationNode.getActiveSocket(), destinationNode.getConnectionSecret());
+    return sendUnreliablePacket(packet, *destinationNode.getActiveSocket(), destinationNode.getVerificationKey());
 }
 
 qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr,
-                                             const QUuid& connectionSecret) {
+                                             const NLPacket::VerificationKey& verificationKey) {
     Q_ASSERT(!packet.isPartOfMessage());
     Q_ASSERT_X(!packet.isReliable(), "LimitedNodeList::sendUnreliablePacket",
                "Trying to send a reliable packet unreliably.");
 
     collectPacketStats(packet);
-    fillPacketHeader(packet, connectionSecret);
+    fillPacketHeader(packet, verificationKey);
 
     return _nodeSocket.writePacket(packet, sockAddr);
 }
@@ -410,7 +409,7 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
         emit dataSent(destinationNode.getType(), packet->getDataSize());
         destinationNode.recordBytesSent(packet->getDataSize());
 
-        return sendPacket(std::move(packet), *activeSocket, destinationNode.getConnectionSecret());
+        return sendPacket(std::move(packet), *activeSocket, destinationNode.getVerificationKey());
     } else {
         qCDebug(networking) << "LimitedNodeList::sendPacket called without active socket for node" << destinationNode << "- not sending";
         return ERROR_SENDING_PACKET_BYTES;
@@ -418,18 +417,18 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
 }
 
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr,
-                                   const QUuid& connectionSecret) {
+                                   const NLPacket::VerificationKey& verificationKey) {
     Q_ASSERT(!packet->isPartOfMessage());
     if (packet->isReliable()) {
         collectPacketStats(*packet);
-        fillPacketHeader(*packet, connectionSecret);
+        fillPacketHeader(*packet, verificationKey);
 
         auto size = packet->getDataSize();
         _nodeSocket.writePacket(std::move(packet), sockAddr);
 
         return size;
     } else {
-        return sendUnreliablePacket(*packet, sockAddr, connectionSecret);
+        return sendUnreliablePacket(*packet, sockAddr, verificationKey);
     }
 }
 
@@ -438,13 +437,13 @@ qint64 LimitedNodeList::sendUnreliableUnorderedPacketList(NLPacketList& packetLi
 
     if (activeSocket) {
         qint64 bytesSent = 0;
-        auto connectionSecret = destinationNode.getConnectionSecret();
+        auto verificationKey = destinationNode.getVerificationKey();
 
         // close the last packet in the list
         packetList.closeCurrentPacket();
 
         while (!packetList._packets.empty()) {
-            bytesSent += sendPacket(packetList.takeFront<NLPacket>(), *activeSocket, connectionSecret);
+            bytesSent += sendPacket(packetList.takeFront<NLPacket>(), *activeSocket, verificationKey);
         }
 
         emit dataSent(destinationNode.getType(), bytesSent);
@@ -457,14 +456,14 @@ qint64 LimitedNodeList::sendUnreliableUnorderedPacketList(NLPacketList& packetLi
 }
 
 qint64 LimitedNodeList::sendUnreliableUnorderedPacketList(NLPacketList& packetList, const HifiSockAddr& sockAddr,
-                                                          const QUuid& connectionSecret) {
+                                                          const NLPacket::VerificationKey& verificationKey) {
     qint64 bytesSent = 0;
 
     // close the last packet in the list
     packetList.closeCurrentPacket();
 
     while (!packetList._packets.empty()) {
-        bytesSent += sendPacket(packetList.takeFront<NLPacket>(), sockAddr, connectionSecret);
+        bytesSent += sendPacket(packetList.takeFront<NLPacket>(), sockAddr, verificationKey);
     }
 
     return bytesSent;
@@ -492,7 +491,7 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
         for (std::unique_ptr<udt::Packet>& packet : packetList->_packets) {
             NLPacket* nlPacket = static_cast<NLPacket*>(packet.get());
             collectPacketStats(*nlPacket);
-            fillPacketHeader(*nlPacket, destinationNode.getConnectionSecret());
+            fillPacketHeader(*nlPacket, destinationNode.getVerificationKey());
         }
 
         return _nodeSocket.writePacketList(std::move(packetList), *activeSocket);
@@ -515,7 +514,7 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
     auto& destinationSockAddr = (overridenSockAddr.isNull()) ? *destinationNode.getActiveSocket()
                                                              : overridenSockAddr;
 
-    return sendPacket(std::move(packet), destinationSockAddr, destinationNode.getConnectionSecret());
+    return sendPacket(std::move(packet), destinationSockAddr, destinationNode.getVerificationKey());
 }
 
 int LimitedNodeList::updateNodeWithDataFromPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
@@ -542,11 +541,30 @@ NodeData* LimitedNodeList::getOrCreateLinkedData(SharedNodePointer node) {
 }
 
 SharedNodePointer LimitedNodeList::nodeWithUUID(const QUuid& nodeUUID) {
-    QReadLocker readLocker(&_nodeMutex);
+    auto snapshot = getNodeSnapshot();
+
+    auto it = snapshot->indices.find(nodeUUID);
+    return it == snapshot->indices.cend() ? SharedNodePointer() : snapshot->nodes[it->second];
+}
+
+void LimitedNodeList::updateNodeSnapshot() {
+    // serialize the rebuilds, so a snapshot of fewer changes can't be published over one of more
+    std::lock_guard<std::mutex> snapshotLock(_nodeSnapshotMutex);
 
-    NodeHash::const_iterator it = _nodeHash.find(nodeUUID);
-    return it == _nodeHash.cend() ? SharedNodePointer() : it->second;
- }
+    auto snapshot = std::make_shared<NodeSnapshot>();
+    {
+        QReadLocker readLocker(&_nodeMutex);
+
+        snapshot->nodes.reserve(_nodeHash.size());
+        snapshot->indices.reserve(_nodeHash.size());
+        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
+            snapshot->indices[it->first] = snapshot->nodes.size();
+            snapshot->nodes.push_back(it->second);
+        }
+    }
+
+    _nodeSnapshot.set(std::move(snapshot));
+}
 
 void LimitedNodeList::eraseAllNodes() {
     QSet<SharedNodePointer> killedNodes;
@@ -568,6 +586,8 @@ void LimitedNodeList::eraseAllNodes() {
         }
     }
 
+    updateNodeSnapshot();
+
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
@@ -593,6 +613,7 @@ bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
             QWriteLocker writeLocker(&_nodeMutex);
             _nodeHash.unsafe_erase(it);
         }
+        updateNodeSnapshot();
 
         handleNodeKill(matchingNode);
         return true;
@@ -622,7 +643,8 @@ void LimitedNodeList::handleNodeKill(const SharedNodePointer& node) {
 SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    bool isReplicated, bool isUpstream,
-                                                   const QUuid& connectionSecret, const NodePermissions& permissions) {
+                                                   const QUuid& connectionSecret, const NodePermissions& permissions,
+                                                   PacketVerificationVersion verificationVersion) {
     QReadLocker readLocker(&_nodeMutex);
     NodeHash::const_iterator it = _nodeHash.find(uuid);
 
@@ -632,7 +654,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         matchingNode->setPublicSocket(publicSocket);
         matchingNode->setLocalSocket(localSocket);
         matchingNode->setPermissions(permissions);
-        matchingNode->setConnectionSecret(connectionSecret);
+        matchingNode->setConnectionSecret(connectionSecret, verificationVersion);
         matchingNode->setIsReplicated(isReplicated);
         matchingNode->setIsUpstream(isUpstream || NodeType::isUpstream(nodeType));
 
@@ -642,7 +664,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         Node* newNode = new Node(uuid, nodeType, publicSocket, localSocket);
         newNode->setIsReplicated(isReplicated);
         newNode->setIsUpstream(isUpstream || NodeType::isUpstream(nodeType));
-        newNode->setConnectionSecret(connectionSecret);
+        newNode->setConnectionSecret(connectionSecret, verificationVersion);
         newNode->setPermissions(permissions);
 
         // move the newly constructed node to the LNL thread
@@ -686,6 +708,8 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
 #endif
         readLocker.unlock();
 
+        updateNodeSnapshot();
+
         qCDebug(networking) << "Added" << *newNode;
 
         auto weakPtr = newNodePointer.toWeakRef(); // We don't want the lambdas to hold a strong ref
@@ -791,8 +815,17 @@ void LimitedNodeList::getPacketStats(float& packetsInPerSecond, float& bytesInPe
     bytesOutPerSecond = (float) _numCollectedBytes / ((float) _packetStatTimer.elapsed() / 1000.0f);
 }
 
+void LimitedNodeList::getPacketBufferStats(float& bufferHitRate, qint64& outstandingBuffers, qint64& pooledBuffers) {
+    auto stats = udt::PacketBufferPool::getStats();
+    quint64 numAcquired = stats.hits + stats.misses;
+    bufferHitRate = numAcquired > 0 ? (float)stats.hits / (float)numAcquired : 0.0f;
+    outstandingBuffers = stats.outstanding;
+    pooledBuffers = stats.pooled;
+}
+
 void LimitedNodeList::resetPacketStats() {
     getPacketReceiver().resetCounters();
+    udt::PacketBufferPool::resetCounters();
 
     _numCollectedPackets = 0;
     _numCollectedBytes = 0;
@@ -822,6 +855,10 @@ void LimitedNodeList::removeSilentNodes() {
         node->getMutex().unlock();
     });
 
+    if (!killedNodes.isEmpty()) {
+        updateNodeSnapshot();
+    }
+
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
@@ -1126,11 +1163,9 @@ void LimitedNodeList::sendPeerQueryToIceServer(const HifiSockAddr& iceServerSock
 }
 
 SharedNodePointer LimitedNodeList::findNodeWithAddr(const HifiSockAddr& addr) {
-    QReadLocker locker(&_nodeMutex);
-    auto it = std::find_if(std::begin(_nodeHash), std::end(_nodeHash), [&](const UUIDNodePair& pair) {
-        return pair.second->getActiveSocket() ? (*pair.second->getActiveSocket() == addr) : false;
+    return nodeMatchingPredicate([&](const SharedNodePointer& node) {
+        return node->getActiveSocket() ? (*node->getActiveSocket() == addr) : false;
     });
-    return (it != std::end(_nodeHash)) ? it->second : SharedNodePointer();
 }
 
 void LimitedNodeList::sendPacketToIceServer(PacketType packetType, const HifiSockAddr& iceServerSockAddr,
@@ -16,8 +16,10 @@
 #include <stdint.h>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
@@ -35,6 +37,7 @@
 
 #include <DependencyManager.h>
 #include <SharedUtil.h>
+#include <SnapshotPointer.h>
 
 #include "DomainHandler.h"
 #include "Node.h"
@@ -69,6 +72,12 @@ const QString USERNAME_UUID_REPLACEMENT_STATS_KEY = "$username";
 typedef std::pair<QUuid, SharedNodePointer> UUIDNodePair;
 typedef tbb::concurrent_unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
 
+// an immutable copy of the node hash, published each time a node is added or removed, for lock-free reads
+struct NodeSnapshot {
+    std::vector<SharedNodePointer> nodes;
+    std::unordered_map<QUuid, size_t, UUIDHasher> indices;  // of nodes, by UUID
+};
+
 typedef quint8 PingType_t;
 namespace PingType {
     const PingType_t Agnostic = 0;
@@ -132,18 +141,18 @@ public:
     // either to a node (via its active socket) or to a manual sockaddr
     qint64 sendUnreliablePacket(const NLPacket& packet, const Node& destinationNode);
     qint64 sendUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr,
-                                const QUuid& connectionSecret = QUuid());
+                                const NLPacket::VerificationKey& verificationKey = NLPacket::VerificationKey());
 
     // use sendPacket to send a moved unreliable or reliable NL packet to a node's active socket or manual sockaddr
     qint64 sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode);
     qint64 sendPacket(std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr,
-                      const QUuid& connectionSecret = QUuid());
+                      const NLPacket::VerificationKey& verificationKey = NLPacket::VerificationKey());
 
     // use sendUnreliableUnorderedPacketList to unreliably send separate packets from the packet list
     // either to a node's active socket or to a manual sockaddr
     qint64 sendUnreliableUnorderedPacketList(NLPacketList& packetList, const Node& destinationNode);
     qint64 sendUnreliableUnorderedPacketList(NLPacketList& packetList, const HifiSockAddr& sockAddr,
-                          const QUuid& connectionSecret = QUuid());
+                          const NLPacket::VerificationKey& verificationKey = NLPacket::VerificationKey());
 
     // use sendPacketList to send reliable packet lists (ordered or unordered) to a node's active socket
     // or to a manual sock addr
@@ -152,7 +161,7 @@ public:
 
     std::function<void(Node*)> linkedDataCreateCallback;
 
-    size_t size() const { QReadLocker readLock(&_nodeMutex); return _nodeHash.size(); }
+    size_t size() const { return _nodeSnapshot.get()->nodes.size(); }
 
     SharedNodePointer nodeWithUUID(const QUuid& nodeUUID);
 
@@ -160,7 +169,8 @@ public:
                                       const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                       bool isReplicated = false, bool isUpstream = false,
                                       const QUuid& connectionSecret = QUuid(),
-                                      const NodePermissions& permissions = DEFAULT_AGENT_PERMISSIONS);
+                                      const NodePermissions& permissions = DEFAULT_AGENT_PERMISSIONS,
+                                      PacketVerificationVersion verificationVersion = PacketVerificationVersion::MD5);
 
     static bool parseSTUNResponse(udt::BasePacket* packet, QHostAddress& newPublicAddress, uint16_t& newPublicPort);
     bool hasCompletedInitialSTUN() const { return _hasCompletedInitialSTUN; }
@@ -178,6 +188,8 @@ public:
     SharedNodePointer soloNodeOfType(NodeType_t nodeType);
 
     void getPacketStats(float& packetsInPerSecond, float& bytesInPerSecond, float& packetsOutPerSecond, float& bytesOutPerSecond);
+    // the share of packet buffers reused from the pool since the last reset, and the buffers held by packets and free in the pool
+    void getPacketBufferStats(float& bufferHitRate, qint64& outstandingBuffers, qint64& pooledBuffers);
     void resetPacketStats();
 
     std::unique_ptr<NLPacket> constructPingPacket(PingType_t pingType = PingType::Agnostic);
@@ -193,10 +205,12 @@ public:
     using value_type = SharedNodePointer;
     using const_iterator = std::vector<value_type>::const_iterator;
 
-    // Cede control of iteration under a single read lock (e.g. for use by thread pools)
-    // Use this for nested loops instead of taking nested read locks!
-    //   This allows multiple threads (i.e. a thread pool) to share a lock
-    //   without deadlocking when a dying node attempts to acquire a write lock
+    // The current nodes, which stay alive and unchanged for as long as the snapshot is held
+    //   Iterating nodes takes no locks - nodes added or killed meanwhile are only seen by the next snapshot
+    std::shared_ptr<const NodeSnapshot> getNodeSnapshot() const { return _nodeSnapshot.get(); }
+
+    // Cede control of iteration over a single snapshot (e.g. for use by thread pools)
+    // Use this for nested loops, so every loop sees the same nodes
     template<typename NestedNodeLambda>
     void nestedEach(NestedNodeLambda functor, 
                     int* lockWaitOut = nullptr, 
@@ -204,59 +218,51 @@ public:
                     int* functorOut = nullptr) {
         auto start = usecTimestampNow();
         {
-            QReadLocker readLock(&_nodeMutex);
+            auto snapshot = getNodeSnapshot();
             auto endLock = usecTimestampNow();
             if (lockWaitOut) {
                 *lockWaitOut = (endLock - start);
             }
 
-            // Size of _nodeHash could change at any time,
-            // so reserve enough memory for the current size
-            // and then back insert all the nodes found
-            std::vector<SharedNodePointer> nodes;
-            nodes.reserve(_nodeHash.size());
-            std::transform(_nodeHash.cbegin(), _nodeHash.cend(), std::back_inserter(nodes), [&](const NodeHash::value_type& it) {
-                return it.second;
-            });
-            auto endTransform = usecTimestampNow();
+            // the snapshot is already a vector of nodes, so there is nothing left to transform
             if (nodeTransformOut) {
-                *nodeTransformOut = (endTransform - endLock);
+                *nodeTransformOut = 0;
             }
 
-            functor(nodes.cbegin(), nodes.cend());
+            functor(snapshot->nodes.cbegin(), snapshot->nodes.cend());
             auto endFunctor = usecTimestampNow();
             if (functorOut) {
-                *functorOut = (endFunctor - endTransform);
+                *functorOut = (endFunctor - endLock);
             }
         }
     }
 
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (const auto& node : snapshot->nodes) {
+            functor(node);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (const auto& node : snapshot->nodes) {
+            if (predicate(node)) {
+                functor(node);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (const auto& node : snapshot->nodes) {
+            if (!functor(node)) {
                 break;
             }
         }
@@ -264,25 +270,21 @@ public:
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (const auto& node : snapshot->nodes) {
+            if (predicate(node)) {
+                return node;
             }
         }
 
         return SharedNodePointer();
     }
 
-    // This is unsafe because it does not take a lock
-    // Must only be called when you know that a read lock on the node mutex is held
-    // and will be held for the duration of your iteration
+    // Now the same as eachNode, since iteration no longer needs a lock to be held
     template<typename NodeLambda>
     void unsafeEachNode(NodeLambda functor) {
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
-        }
+        eachNode(functor);
     }
 
     void putLocalPortIntoSharedMemory(const QString key, QObject* parent, quint16 localPort);
@@ -362,9 +364,10 @@ protected:
     qint64 sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode,
                       const HifiSockAddr& overridenSockAddr);
     qint64 writePacket(const NLPacket& packet, const HifiSockAddr& destinationSockAddr,
-                       const QUuid& connectionSecret = QUuid());
+                       const NLPacket::VerificationKey& verificationKey = NLPacket::VerificationKey());
     void collectPacketStats(const NLPacket& packet);
-    void fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret = QUuid());
+    void fillPacketHeader(const NLPacket& packet,
+                          const NLPacket::VerificationKey& verificationKey = NLPacket::VerificationKey());
 
     void setLocalSocket(const HifiSockAddr& sockAddr);
 
@@ -380,8 +383,14 @@ protected:
 
     bool sockAddrBelongsToNode(const HifiSockAddr& sockAddr) { return findNodeWithAddr(sockAddr) != SharedNodePointer(); }
 
+    // rebuilds the node snapshot from the node hash - call after adding or erasing nodes, without holding _nodeMutex
+    void updateNodeSnapshot();
+
+    // writers still lock the hash, readers only ever see the snapshot
     NodeHash _nodeHash;
     mutable QReadWriteLock _nodeMutex { QReadWriteLock::Recursive };
+    std::mutex _nodeSnapshotMutex;
+    SnapshotPointer<NodeSnapshot> _nodeSnapshot;
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket { nullptr };
     HifiSockAddr _localSockAddr;
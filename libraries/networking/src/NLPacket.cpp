@@ -11,10 +11,13 @@
 
 #include "NLPacket.h"
 
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QtEndian>
+
 int NLPacket::localHeaderSize(PacketType type) {
     bool nonSourced = PacketTypeEnum::getNonSourcedPackets().contains(type);
     bool nonVerified = PacketTypeEnum::getNonVerifiedPackets().contains(type);
-    qint64 optionalSize = (nonSourced ? 0 : NUM_BYTES_RFC4122_UUID) + ((nonSourced || nonVerified) ? 0 : NUM_BYTES_MD5_HASH);
+    qint64 optionalSize = (nonSourced ? 0 : NUM_BYTES_RFC4122_UUID) + ((nonSourced || nonVerified) ? 0 : NUM_BYTES_VERIFICATION_HASH);
     return sizeof(PacketType) + sizeof(PacketVersion) + optionalSize;
 }
 int NLPacket::totalHeaderSize(PacketType type, bool isPartOfMessage) {
@@ -144,23 +147,63 @@ QUuid NLPacket::sourceIDInHeader(const udt::Packet& packet) {
     return QUuid::fromRfc4122(QByteArray::fromRawData(packet.getData() + offset, NUM_BYTES_RFC4122_UUID));
 }
 
+NLPacket::VerificationKey::VerificationKey(const QUuid& connectionSecret, PacketVerificationVersion version) :
+    _connectionSecret(connectionSecret),
+    _version(version)
+{
+    if (version == PacketVerificationVersion::SipHash128) {
+        // the key is the secret in its RFC 4122 layout, without the allocation of QUuid::toRfc4122
+        uint8_t key[SipHash128::KEY_SIZE];
+        qToBigEndian(connectionSecret.data1, key);
+        qToBigEndian(connectionSecret.data2, key + 4);
+        qToBigEndian(connectionSecret.data3, key + 6);
+        memcpy(key + 8, connectionSecret.data4, sizeof(connectionSecret.data4));
+        _sipHash = SipHash128(key);
+    }
+}
+
+void NLPacket::VerificationKey::hash(const char* data, int size, uint8_t* hash) const {
+    if (_version == PacketVerificationVersion::SipHash128) {
+        _sipHash.hash(reinterpret_cast<const uint8_t*>(data), size, hash);
+    } else {
+        // the payload followed by the connection secret
+        QCryptographicHash md5(QCryptographicHash::Md5);
+        md5.addData(data, size);
+        md5.addData(_connectionSecret.toRfc4122());
+        memcpy(hash, md5.result().constData(), NUM_BYTES_VERIFICATION_HASH);
+    }
+}
+
+NLPacket::VerificationKey NLPacket::verificationKeyForSecret(const QUuid& connectionSecret,
+                                                             PacketVerificationVersion version) {
+    return VerificationKey(connectionSecret, version);
+}
+
 QByteArray NLPacket::verificationHashInHeader(const udt::Packet& packet) {
     int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
-    return QByteArray(packet.getData() + offset, NUM_BYTES_MD5_HASH);
+    return QByteArray(packet.getData() + offset, NUM_BYTES_VERIFICATION_HASH);
 }
 
-QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret) {
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    
-    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
-        + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
-    
-    // add the packet payload and the connection UUID
-    hash.addData(packet.getData() + offset, packet.getDataSize() - offset);
-    hash.addData(connectionSecret.toRfc4122());
-    
-    // return the hash
-    return hash.result();
+static void computeHashForPacket(const udt::Packet& packet, const NLPacket::VerificationKey& key, uint8_t* hash) {
+    int offset = udt::Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+        + NUM_BYTES_RFC4122_UUID + NUM_BYTES_VERIFICATION_HASH;
+
+    // hash the packet payload
+    key.hash(packet.getData() + offset, packet.getDataSize() - offset, hash);
+}
+
+QByteArray NLPacket::hashForPacket(const udt::Packet& packet, const VerificationKey& key) {
+    QByteArray hash(NUM_BYTES_VERIFICATION_HASH, 0);
+    computeHashForPacket(packet, key, reinterpret_cast<uint8_t*>(hash.data()));
+    return hash;
+}
+
+bool NLPacket::isVerificationHashValid(const udt::Packet& packet, const VerificationKey& key) {
+    uint8_t hash[NUM_BYTES_VERIFICATION_HASH];
+    computeHashForPacket(packet, key, hash);
+
+    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
+    return memcmp(packet.getData() + offset, hash, NUM_BYTES_VERIFICATION_HASH) == 0;
 }
 
 void NLPacket::writeTypeAndVersion() {
@@ -212,13 +255,11 @@ void NLPacket::writeSourceID(const QUuid& sourceID) const {
     _sourceID = sourceID;
 }
 
-void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret) const {
+void NLPacket::writeVerificationHash(const VerificationKey& key) const {
     Q_ASSERT(!PacketTypeEnum::getNonSourcedPackets().contains(_type) &&
              !PacketTypeEnum::getNonVerifiedPackets().contains(_type));
     
     auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
                 + NUM_BYTES_RFC4122_UUID;
-    QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret);
-    
-    memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
+    computeHashForPacket(*this, key, reinterpret_cast<uint8_t*>(_packet.get() + offset));
 }
@@ -14,6 +14,7 @@
 
 #include <QtCore/QSharedPointer>
 
+#include <SipHash.h>
 #include <UUID.h>
 
 #include "udt/Packet.h"
@@ -36,7 +37,7 @@ public:
     //    |                               |                               |
     //    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+                               |
     //    |                                                               |
-    //    |                   MD5 Verification - 16 bytes                 |
+    //    |                Verification Hash - 16 bytes                   |
     //    |                   (ONLY FOR VERIFIED PACKETS)                 |
     //    |                               +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
     //    |                               |                               |
@@ -46,7 +47,7 @@ public:
     // this is used by the Octree classes - must be known at compile time
     static const int MAX_PACKET_HEADER_SIZE =
         sizeof(udt::Packet::SequenceNumberAndBitField) + sizeof(udt::Packet::MessageNumberAndBitField) +
-        sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
+        sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID + NUM_BYTES_VERIFICATION_HASH;
     
     static std::unique_ptr<NLPacket> create(PacketType type, qint64 size = -1,
                     bool isReliable = false, bool isPartOfMessage = false, PacketVersion version = 0);
@@ -70,8 +71,30 @@ public:
     static PacketVersion versionInHeader(const udt::Packet& packet);
     
     static QUuid sourceIDInHeader(const udt::Packet& packet);
+    // the verification hash is keyed with the connection secret, and computed the way the two nodes agreed on when
+    // they were given it; the key is set up once per secret
+    class VerificationKey {
+    public:
+        VerificationKey() {}
+        VerificationKey(const QUuid& connectionSecret, PacketVerificationVersion version);
+
+        bool isNull() const { return _connectionSecret.isNull(); }
+        PacketVerificationVersion getVersion() const { return _version; }
+
+        // writes NUM_BYTES_VERIFICATION_HASH bytes to hash
+        void hash(const char* data, int size, uint8_t* hash) const;
+
+    private:
+        QUuid _connectionSecret;
+        PacketVerificationVersion _version { PacketVerificationVersion::MD5 };
+        SipHash128 _sipHash;
+    };
+    static VerificationKey verificationKeyForSecret(const QUuid& connectionSecret,
+                                                    PacketVerificationVersion version = PacketVerificationVersion::Newest);
+
     static QByteArray verificationHashInHeader(const udt::Packet& packet);
-    static QByteArray hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret);
+    static QByteArray hashForPacket(const udt::Packet& packet, const VerificationKey& key);
+    static bool isVerificationHashValid(const udt::Packet& packet, const VerificationKey& key);
     
     PacketType getType() const { return _type; }
     void setType(PacketType type);
@@ -82,7 +105,7 @@ public:
     const QUuid& getSourceID() const { return _sourceID; }
     
     void writeSourceID(const QUuid& sourceID) const;
-    void writeVerificationHashGivenSecret(const QUuid& connectionSecret) const;
+    void writeVerificationHash(const VerificationKey& key) const;
 
 protected:
     
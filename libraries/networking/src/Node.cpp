@@ -99,6 +99,11 @@ Node::Node(const QUuid& uuid, NodeType_t type, const HifiSockAddr& publicSocket,
     _ignoreRadiusEnabled = false;
 }
 
+void Node::setConnectionSecret(const QUuid& connectionSecret, PacketVerificationVersion verificationVersion) {
+    _connectionSecret = connectionSecret;
+    _verificationKey = NLPacket::verificationKeyForSecret(connectionSecret, verificationVersion);
+}
+
 void Node::setType(char type) {
     _type = type;
     
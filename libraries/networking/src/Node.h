@@ -28,6 +28,7 @@
 
 #include "HifiSockAddr.h"
 #include "NetworkPeer.h"
+#include "NLPacket.h"
 #include "NodeData.h"
 #include "NodeType.h"
 #include "SimpleMovingAverage.h"
@@ -55,7 +56,10 @@ public:
     void setIsUpstream(bool isUpstream) { _isUpstream = isUpstream; }
 
     const QUuid& getConnectionSecret() const { return _connectionSecret; }
-    void setConnectionSecret(const QUuid& connectionSecret) { _connectionSecret = connectionSecret; }
+    // the verification version is the one the domain server picked for us and this node along with the secret
+    void setConnectionSecret(const QUuid& connectionSecret,
+                             PacketVerificationVersion verificationVersion = PacketVerificationVersion::MD5);
+    const NLPacket::VerificationKey& getVerificationKey() const { return _verificationKey; }
 
     NodeData* getLinkedData() const { return _linkedData.get(); }
     void setLinkedData(std::unique_ptr<NodeData> linkedData) { _linkedData = std::move(linkedData); }
@@ -97,6 +101,7 @@ private:
     NodeType_t _type;
 
     QUuid _connectionSecret;
+    NLPacket::VerificationKey _verificationKey;
     std::unique_ptr<NodeData> _linkedData;
     bool _isReplicated { false };
     int _pingMs;
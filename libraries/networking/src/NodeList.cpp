@@ -238,6 +238,8 @@ void NodeList::reset(bool skipDomainHandlerReset) {
 
     LimitedNodeList::reset();
 
+    _domainListVersion = 0;
+
     // lock and clear our set of ignored IDs
     _ignoredSetLock.lockForWrite();
     _ignoredNodeIDs.clear();
@@ -397,10 +399,17 @@ void NodeList::sendDomainServerCheckIn() {
             packetStream << accountInfo.getUsername();
 
             // if this is a connect request, and we can present a username signature, send it along
+            QByteArray usernameSignature;
             if (requiresUsernameSignature && accountManager->getAccountInfo().hasPrivateKey()) {
-                const QByteArray& usernameSignature = accountManager->getAccountInfo().getUsernameSignature(connectionToken);
-                packetStream << usernameSignature;
+                usernameSignature = accountManager->getAccountInfo().getUsernameSignature(connectionToken);
             }
+            packetStream << usernameSignature;
+
+            // and the newest packet verification we support, so the domain-server can send the one to use with each node
+            packetStream << static_cast<quint8>(PacketVerificationVersion::Newest);
+        } else {
+            // the version of the last domain list we have, so that we're only sent what changed since
+            packetStream << _domainListVersion;
         }
 
         flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::SendDSCheckIn);
@@ -614,10 +623,28 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     packetStream >> newPermissions;
     setPermissions(newPermissions);
 
+    // the version of this list, to tell the domain-server in our next check in,
+    // and whether it only has the nodes that changed since the version we told it in our last one
+    quint64 domainListVersion;
+    bool isDelta;
+    packetStream >> domainListVersion >> isDelta;
+    _domainListVersion = domainListVersion;
+
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
         parseNodeFromPacketStream(packetStream);
     }
+
+    if (isDelta) {
+        // the nodes left out are unchanged, keep the ones we only hear about from the domain server alive
+        auto now = usecTimestampNow();
+        eachMatchingNode([&](const SharedNodePointer& node) {
+            return node->getType() == NodeType::downstreamType(_ownerType) ||
+                node->getType() == NodeType::upstreamType(_ownerType);
+        }, [&](const SharedNodePointer& node) {
+            node->setLastHeardMicrostamp(now);
+        });
+    }
 }
 
 void NodeList::processDomainServerAddedNode(QSharedPointer<ReceivedMessage> message) {
@@ -651,10 +678,15 @@ void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
         nodePublicSocket.setAddress(_domainHandler.getIP());
     }
 
-    packetStream >> connectionUUID;
+    // the domain-server follows the secret with the packet verification to use with this node, as we sent it ours
+    quint8 verificationVersion;
+    packetStream >> connectionUUID >> verificationVersion;
 
-    SharedNodePointer node = addOrUpdateNode(nodeUUID, nodeType, nodePublicSocket,
-                                             nodeLocalSocket, isReplicated, false, connectionUUID, permissions);
+    SharedNodePointer node = addOrUpdateNode(nodeUUID, nodeType, nodePublicSocket, nodeLocalSocket, isReplicated, false,
+                                             connectionUUID, permissions,
+                                             static_cast<PacketVerificationVersion>(
+                                                 std::min(verificationVersion,
+                                                          static_cast<quint8>(PacketVerificationVersion::Newest))));
 
     // nodes that are downstream or upstream of our own type are kept alive when we hear about them from the domain server
     // and always have their public socket as their active socket
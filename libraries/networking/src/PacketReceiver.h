@@ -97,6 +97,7 @@ private:
     
     friend class EntityEditPacketSender;
     friend class OctreePacketProcessor;
+    friend class AudioMixer;
 };
 
 #endif // hifi_PacketReceiver_h
@@ -26,7 +26,8 @@ ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
       _sourceID(packetList.getSourceID()),
       _packetType(packetList.getType()),
       _packetVersion(packetList.getVersion()),
-      _senderSockAddr(packetList.getSenderSockAddr())
+      _senderSockAddr(packetList.getSenderSockAddr()),
+      _firstPacketReceiveTime(p_high_resolution_clock::now())
 {
 }
 
@@ -38,7 +39,8 @@ ReceivedMessage::ReceivedMessage(NLPacket& packet)
       _packetType(packet.getType()),
       _packetVersion(packet.getVersion()),
       _senderSockAddr(packet.getSenderSockAddr()),
-      _isComplete(packet.getPacketPosition() == NLPacket::ONLY)
+      _isComplete(packet.getPacketPosition() == NLPacket::ONLY),
+      _firstPacketReceiveTime(packet.getReceiveTime())
 {
 }
 
@@ -51,7 +53,8 @@ ReceivedMessage::ReceivedMessage(QByteArray byteArray, PacketType packetType, Pa
     _packetType(packetType),
     _packetVersion(packetVersion),
     _senderSockAddr(senderSockAddr),
-    _isComplete(true)
+    _isComplete(true),
+    _firstPacketReceiveTime(p_high_resolution_clock::now())
 {
 }
 
@@ -50,6 +50,9 @@ public:
 
     qint64 getSize() const { return _data.size(); }
 
+    // the time the (first) packet of this message was read off the socket
+    p_high_resolution_clock::time_point getFirstPacketReceiveTime() const { return _firstPacketReceiveTime; }
+
     qint64 getBytesLeftToRead() const { return _data.size() -  _position; }
 
     void seek(qint64 position) { _position = position; }
@@ -100,6 +103,8 @@ private:
 
     std::atomic<bool> _isComplete { true };  
     std::atomic<bool> _failed { false };
+
+    p_high_resolution_clock::time_point _firstPacketReceiveTime;
 };
 
 Q_DECLARE_METATYPE(ReceivedMessage*)
@@ -95,6 +95,10 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
 
     float packetsInPerSecond, bytesInPerSecond, packetsOutPerSecond, bytesOutPerSecond;
     nodeList->getPacketStats(packetsInPerSecond, bytesInPerSecond, packetsOutPerSecond, bytesOutPerSecond);
+
+    float bufferHitRate;
+    qint64 outstandingBuffers, pooledBuffers;
+    nodeList->getPacketBufferStats(bufferHitRate, outstandingBuffers, pooledBuffers);
     nodeList->resetPacketStats();
 
     QJsonObject ioStats;
@@ -102,6 +106,9 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
     ioStats["inbound_packets_per_s"] = packetsInPerSecond;
     ioStats["outbound_bytes_per_s"] = bytesOutPerSecond;
     ioStats["outbound_packets_per_s"] = packetsOutPerSecond;
+    ioStats["packet_buffer_hit_rate"] = bufferHitRate;
+    ioStats["packet_buffers_outstanding"] = outstandingBuffers;
+    ioStats["packet_buffers_pooled"] = pooledBuffers;
 
     statsObject["io_stats"] = ioStats;
 
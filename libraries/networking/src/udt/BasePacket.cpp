@@ -12,6 +12,7 @@
 #include "BasePacket.h"
 
 #include "../NetworkLogging.h"
+#include "PacketBufferPool.h"
 
 using namespace udt;
 
@@ -59,8 +60,7 @@ BasePacket::BasePacket(qint64 size) {
     // Sanity check
     Q_ASSERT(size >= 0 || size < maxPayload);
     
-    _packetSize = size;
-    _packet.reset(new char[_packetSize]());
+    allocatePacket(size, true);
     _payloadCapacity = _packetSize;
     _payloadSize = 0;
     _payloadStart = _packet.get();
@@ -77,6 +77,10 @@ BasePacket::BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSock
     
 }
 
+BasePacket::~BasePacket() {
+    releasePacket();
+}
+
 BasePacket::BasePacket(const BasePacket& other) :
     QIODevice()
 {
@@ -84,8 +88,7 @@ BasePacket::BasePacket(const BasePacket& other) :
 }
 
 BasePacket& BasePacket::operator=(const BasePacket& other) {
-    _packetSize = other._packetSize;
-    _packet = std::unique_ptr<char[]>(new char[_packetSize]);
+    allocatePacket(other._packetSize, false);
     memcpy(_packet.get(), other._packet.get(), _packetSize);
     
     _payloadStart = _packet.get() + (other._payloadStart - other._packet.get());
@@ -109,8 +112,11 @@ BasePacket::BasePacket(BasePacket&& other) {
 }
 
 BasePacket& BasePacket::operator=(BasePacket&& other) {
+    releasePacket();
     _packetSize = other._packetSize;
     _packet = std::move(other._packet);
+    _isPacketPooled = other._isPacketPooled;
+    other._isPacketPooled = false;
     
     _payloadStart = other._payloadStart;
     _payloadCapacity = other._payloadCapacity;
@@ -219,3 +225,26 @@ void BasePacket::adjustPayloadStartAndCapacity(qint64 headerSize, bool shouldDec
         _payloadSize -= headerSize;
     }
 }
+
+void BasePacket::allocatePacket(qint64 size, bool shouldClear) {
+    releasePacket();
+    _packetSize = size;
+
+    // anything that fits in an MTU comes from the pool, which is every packet sent but the odd oversized one
+    if (size <= PacketBufferPool::BUFFER_SIZE) {
+        _packet = PacketBufferPool::acquire(shouldClear ? size : 0);
+        _isPacketPooled = true;
+    } else if (shouldClear) {
+        _packet.reset(new char[size]());
+    } else {
+        _packet.reset(new char[size]);
+    }
+}
+
+void BasePacket::releasePacket() {
+    if (_isPacketPooled) {
+        PacketBufferPool::release(std::move(_packet));
+        _isPacketPooled = false;
+    }
+    _packet.reset();
+}
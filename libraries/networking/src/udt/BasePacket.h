@@ -34,6 +34,12 @@ public:
     static std::unique_ptr<BasePacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
                                                           const HifiSockAddr& senderSockAddr);
     
+    ~BasePacket();
+    
+    // Hands the buffer back to the PacketBufferPool when the packet is done with it, for received packets
+    // that were read into a buffer acquired from the pool
+    void setIsPacketPooled(bool isPacketPooled) { _isPacketPooled = isPacketPooled; }
+    
     // Current level's header size
     static int localHeaderSize();
     // Cumulated size of all the headers
@@ -104,8 +110,12 @@ protected:
     
     void adjustPayloadStartAndCapacity(qint64 headerSize, bool shouldDecreasePayloadSize = false);
     
+    void allocatePacket(qint64 size, bool shouldClear);
+    void releasePacket();
+    
     qint64 _packetSize = 0;        // Total size of the allocated memory
     std::unique_ptr<char[]> _packet; // Allocated memory
+    bool _isPacketPooled = false;  // whether _packet was drawn from the PacketBufferPool
     
     char* _payloadStart = nullptr; // Start of the payload
     qint64 _payloadCapacity = 0;          // Total capacity of the payload
@@ -83,21 +83,13 @@ Connection::~Connection() {
 }
 
 void Connection::stopSendQueue() {
-    if (auto sendQueue = _sendQueue.release()) {
-        // grab the send queue thread so we can wait on it
-        QThread* sendQueueThread = sendQueue->thread();
-        
+    if (auto sendQueue = std::move(_sendQueue)) {
         // tell the send queue to stop and be deleted
+        // (its destructor waits for the send scheduler to be done with it)
         
         sendQueue->stop();
 
         _lastMessageNumber = sendQueue->getCurrentMessageNumber();
-
-        sendQueue->deleteLater();
-        
-        // wait on the send queue thread so we know the send queue is gone
-        sendQueueThread->quit();
-        sendQueueThread->wait();
     }
 }
 
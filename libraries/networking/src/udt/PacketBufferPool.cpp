@@ -0,0 +1,142 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+using namespace udt;
+
+namespace {
+
+const size_t THREAD_CACHE_SIZE = 64;
+const size_t THREAD_CACHE_BATCH = THREAD_CACHE_SIZE / 2;
+
+// past this (about 6MB of buffers) released buffers are freed, so a burst doesn't pin memory forever
+const size_t MAX_DEPOT_SIZE = 4096;
+
+std::atomic<quint64> hits { 0 };
+std::atomic<quint64> misses { 0 };
+std::atomic<qint64> outstanding { 0 };
+
+class Depot {
+public:
+    ~Depot() {
+        for (auto buffer : _buffers) {
+            delete[] buffer;
+        }
+    }
+
+    // moves up to THREAD_CACHE_BATCH buffers to the cache
+    void take(std::vector<char*>& cache) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        size_t count = std::min(THREAD_CACHE_BATCH, _buffers.size());
+        cache.insert(cache.end(), _buffers.end() - count, _buffers.end());
+        _buffers.resize(_buffers.size() - count);
+    }
+
+    // moves the buffers past the cache's first keep to the depot, freeing any the depot has no room for
+    void give(std::vector<char*>& cache, size_t keep) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto it = cache.begin() + keep;
+        while (it != cache.end() && _buffers.size() < MAX_DEPOT_SIZE) {
+            _buffers.push_back(*it++);
+        }
+        lock.unlock();
+
+        for (; it != cache.end(); ++it) {
+            delete[] *it;
+        }
+        cache.resize(keep);
+    }
+
+    qint64 size() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return (qint64)_buffers.size();
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<char*> _buffers;
+};
+
+Depot& depot() {
+    static Depot depot;
+    return depot;
+}
+
+struct ThreadCache {
+    ThreadCache() {
+        // make sure the depot outlives the caches of threads still running at exit
+        depot();
+        buffers.reserve(THREAD_CACHE_SIZE);
+    }
+    ~ThreadCache() { depot().give(buffers, 0); }
+
+    std::vector<char*> buffers;
+};
+
+thread_local ThreadCache threadCache;
+
+}
+
+std::unique_ptr<char[]> PacketBufferPool::acquire(int sizeToClear) {
+    Q_ASSERT(sizeToClear >= 0 && sizeToClear <= BUFFER_SIZE);
+
+    auto& buffers = threadCache.buffers;
+    if (buffers.empty()) {
+        depot().take(buffers);
+    }
+
+    char* buffer;
+    if (!buffers.empty()) {
+        buffer = buffers.back();
+        buffers.pop_back();
+        memset(buffer, 0, sizeToClear);
+        hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        buffer = new char[BUFFER_SIZE]();
+        misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    outstanding.fetch_add(1, std::memory_order_relaxed);
+
+    return std::unique_ptr<char[]>(buffer);
+}
+
+void PacketBufferPool::release(std::unique_ptr<char[]> buffer) {
+    if (!buffer) {
+        return;
+    }
+    outstanding.fetch_sub(1, std::memory_order_relaxed);
+
+    auto& buffers = threadCache.buffers;
+    if (buffers.size() == THREAD_CACHE_SIZE) {
+        depot().give(buffers, THREAD_CACHE_SIZE - THREAD_CACHE_BATCH);
+    }
+    buffers.push_back(buffer.release());
+}
+
+PacketBufferPool::Stats PacketBufferPool::getStats() {
+    Stats stats;
+    stats.hits = hits.load(std::memory_order_relaxed);
+    stats.misses = misses.load(std::memory_order_relaxed);
+    stats.outstanding = outstanding.load(std::memory_order_relaxed);
+    stats.pooled = depot().size();
+    return stats;
+}
+
+void PacketBufferPool::resetCounters() {
+    hits.store(0, std::memory_order_relaxed);
+    misses.store(0, std::memory_order_relaxed);
+}
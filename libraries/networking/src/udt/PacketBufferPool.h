@@ -0,0 +1,51 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_udt_PacketBufferPool_h
+#define hifi_udt_PacketBufferPool_h
+
+#include <memory>
+
+#include <QtCore/QtGlobal>
+
+#include "Constants.h"
+
+namespace udt {
+
+// Recycles MTU sized packet buffers, so creating and destroying packets doesn't go through the allocator.
+//   Each thread keeps a small cache of free buffers, and trades half of it at a time with a shared depot
+//   when it runs dry or overflows. Packets are usually created on one thread and destroyed on another
+//   (the send queue, the packet receiver), so buffers flow back through the depot in batches.
+class PacketBufferPool {
+public:
+    static const int BUFFER_SIZE = MAX_PACKET_SIZE;
+
+    struct Stats {
+        quint64 hits { 0 };         // buffers reused since the last reset
+        quint64 misses { 0 };       // buffers allocated since the last reset
+        qint64 outstanding { 0 };   // buffers currently held by packets, or waiting in the socket for a datagram
+        qint64 pooled { 0 };        // buffers free in the depot (thread caches are not counted)
+    };
+
+    // returns a buffer of BUFFER_SIZE bytes, with the first sizeToClear bytes zeroed
+    static std::unique_ptr<char[]> acquire(int sizeToClear = BUFFER_SIZE);
+
+    // takes back a buffer from acquire, from any thread
+    static void release(std::unique_ptr<char[]> buffer);
+
+    static Stats getStats();
+    static void resetCounters();
+};
+
+} // namespace udt
+
+#endif // hifi_udt_PacketBufferPool_h
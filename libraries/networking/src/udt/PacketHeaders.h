@@ -204,7 +204,15 @@ public:
 
 using PacketType = PacketTypeEnum::Value;
 
-const int NUM_BYTES_MD5_HASH = 16;
+const int NUM_BYTES_VERIFICATION_HASH = 16;
+
+// the keyed hash verified packets carry in their header - nodes send the newest they support with their connect request,
+// and the domain server hands each pair of nodes the one they both support along with their connection secret
+enum class PacketVerificationVersion : uint8_t {
+    MD5 = 0, // MD5 of the payload followed by the connection secret, for nodes that don't send one
+    SipHash128, // SipHash-2-4-128 of the payload, keyed with the connection secret
+    Newest = SipHash128
+};
 
 typedef char PacketVersion;
 
@@ -301,7 +309,13 @@ enum class DomainListVersion : PacketVersion {
     PrePermissionsGrid = 18,
     PermissionsGrid,
     GetUsernameFromUUIDSupport,
-    GetMachineFingerprintFromUUIDSupport
+    GetMachineFingerprintFromUUIDSupport,
+    DeltaLists
+};
+
+enum class DomainListRequestVersion : PacketVersion {
+    PreDeltaLists = 17,
+    HasListVersion
 };
 
 enum class AudioVersion : PacketVersion {
@@ -13,7 +13,6 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -31,6 +30,7 @@
 #include "PacketQueue.h"
 #include "SequenceNumber.h"
 #include "LossList.h"
+#include "SendScheduler.h"
 
 namespace udt {
     
@@ -90,16 +90,24 @@ signals:
     void shortCircuitLoss(quint32 sequenceNumber);
     void timeout();
     
-private slots:
-    void run();
-    
 private:
+    friend class SendScheduler;
+
+    using TimePoint = SendScheduler::TimePoint;
+
     SendQueue(Socket* socket, HifiSockAddr dest, SequenceNumber currentSequenceNumber,
               MessageNumber currentMessageNumber, bool hasReceivedHandshakeACK);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
     
-    void sendHandshake();
+    // called by the SendScheduler - sends what can be sent right now and sets when it should be called again
+    // returns false once the queue has stopped
+    bool process(TimePoint& nextProcessTime);
+
+    // wakes the queue up on the scheduler because there may be something new to send
+    void notify();
+
+    void sendHandshake(TimePoint now);
     
     int sendPacket(const Packet& packet);
     bool sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket, SequenceNumber sequenceNumber);
@@ -107,9 +115,13 @@ private:
     int maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool attemptedToSendPacket);
+    // called when there was nothing to send - returns false if the queue has become inactive,
+    // otherwise sets when it should be processed again if it is not woken up before then
+    bool checkInactivity(TimePoint now, TimePoint& nextProcessTime);
     void deactivate(); // makes the queue inactive and cleans it up
 
+    TimePoint getNextPacketTime(TimePoint now, int newPacketCount);
+
     bool isFlowWindowFull() const;
     
     // Increments current sequence number and return it
@@ -140,14 +152,19 @@ private:
     using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
     std::unordered_map<SequenceNumber, PacketResendPair> _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
-    
-    std::condition_variable_any _emptyCondition;
-
 
     std::atomic<bool> _shouldSendProbes { true };
+
+    std::shared_ptr<SendScheduler> _scheduler;
+    std::atomic<uint32_t> _numNotifications { 0 }; // bumped on every event that may give the queue something to send
+
+    // only touched from process (one scheduler thread at a time)
+    TimePoint _lastHandshakeTime;
+    TimePoint _nextPacketTimestamp; // when the next packet should go out, according to the packet send period
+    bool _isWaiting { false }; // true while there has been nothing to send
+    TimePoint _waitStartTime;
+    uint32_t _waitNotifications { 0 }; // _numNotifications when the wait started
 };
     
 }
@@ -0,0 +1,219 @@
+//
+//  SendScheduler.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendScheduler.h"
+
+#include <algorithm>
+
+#include "SendQueue.h"
+
+using namespace udt;
+
+void SendSchedulerWorker::run() {
+    _scheduler.run();
+}
+
+std::shared_ptr<SendScheduler> SendScheduler::getInstance() {
+    static std::mutex instanceMutex;
+    static std::weak_ptr<SendScheduler> weakInstance;
+
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    auto instance = weakInstance.lock();
+    if (!instance) {
+        instance = std::make_shared<SendScheduler>();
+        weakInstance = instance;
+    }
+    return instance;
+}
+
+SendScheduler::SendScheduler(int numThreads) :
+    _wheel(NUM_SLOTS)
+{
+    numThreads = std::max(numThreads, 1);
+
+    for (int i = 0; i < numThreads; ++i) {
+        auto worker = new SendSchedulerWorker(*this);
+        worker->setObjectName(QString("Networking: SendScheduler %1").arg(i));
+        worker->start();
+        _workers.emplace_back(worker);
+    }
+}
+
+SendScheduler::~SendScheduler() {
+    {
+        Lock lock(_mutex);
+        _stop = true;
+    }
+    _workCondition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker->wait();
+    }
+}
+
+void SendScheduler::add(SendQueue* queue) {
+    Lock lock(_mutex);
+    schedule(queue, _queues[queue], p_high_resolution_clock::now());
+}
+
+void SendScheduler::wake(SendQueue* queue) {
+    Lock lock(_mutex);
+
+    auto it = _queues.find(queue);
+    if (it == _queues.end()) {
+        return;
+    }
+
+    if (it->second.isRunning) {
+        // it will be re-scheduled right away once the current pass is done
+        it->second.isWakePending = true;
+    } else {
+        schedule(queue, it->second, p_high_resolution_clock::now());
+    }
+}
+
+void SendScheduler::remove(SendQueue* queue) {
+    Lock lock(_mutex);
+
+    _idleCondition.wait(lock, [&] {
+        auto it = _queues.find(queue);
+        return it == _queues.end() || !it->second.isRunning;
+    });
+
+    // any timer or ready entry left for this queue is dropped when it comes up
+    _queues.erase(queue);
+}
+
+void SendScheduler::schedule(SendQueue* queue, QueueState& state, TimePoint deadline) {
+    ++state.generation;
+
+    Tick tick = tickForTime(deadline);
+    if (tick <= _currentTick) {
+        _ready.emplace_back(queue, state.generation);
+        _workCondition.notify_one();
+    } else {
+        _wheel[tick % NUM_SLOTS].push_back({ queue, state.generation, tick });
+        ++_numTimers;
+
+        // a sleeping worker may need to wake up earlier for this one
+        _workCondition.notify_one();
+    }
+}
+
+void SendScheduler::advance(Tick tick) {
+    if (tick <= _currentTick) {
+        return;
+    }
+
+    // every slot has to be visited once if we fell behind by a whole turn of the wheel
+    Tick numTicks = std::min<Tick>(tick - _currentTick, NUM_SLOTS);
+    for (Tick i = 1; i <= numTicks; ++i) {
+        auto& slot = _wheel[(_currentTick + i) % NUM_SLOTS];
+
+        auto end = std::remove_if(slot.begin(), slot.end(), [&](const Timer& timer) {
+            auto it = _queues.find(timer.queue);
+            if (it == _queues.end() || it->second.generation != timer.generation) {
+                // the queue was removed or re-scheduled since
+                return true;
+            }
+            if (timer.tick <= tick) {
+                _ready.emplace_back(timer.queue, timer.generation);
+                return true;
+            }
+            // due in a later turn of the wheel
+            return false;
+        });
+        _numTimers -= (int)std::distance(end, slot.end());
+        slot.erase(end, slot.end());
+    }
+
+    _currentTick = tick;
+}
+
+SendScheduler::Tick SendScheduler::findNextTick() const {
+    for (Tick i = 1; i <= (Tick)NUM_SLOTS; ++i) {
+        Tick tick = _currentTick + i;
+        for (auto& timer : _wheel[tick % NUM_SLOTS]) {
+            if (timer.tick == tick) {
+                return tick;
+            }
+        }
+    }
+    return _currentTick + NUM_SLOTS;
+}
+
+SendScheduler::Tick SendScheduler::tickForTime(TimePoint time) const {
+    if (time <= _epoch) {
+        return 0;
+    }
+
+    // round up, so that a queue is never processed before its deadline
+    auto usecs = std::chrono::duration_cast<std::chrono::microseconds>(time - _epoch).count();
+    return (Tick)((usecs + TICK_USECS - 1) / TICK_USECS);
+}
+
+SendScheduler::TimePoint SendScheduler::timeForTick(Tick tick) const {
+    return _epoch + std::chrono::microseconds(tick * TICK_USECS);
+}
+
+void SendScheduler::run() {
+    Lock lock(_mutex);
+
+    while (!_stop) {
+        advance(tickForTime(p_high_resolution_clock::now()));
+
+        if (_ready.empty()) {
+            if (_numTimers == 0) {
+                _workCondition.wait(lock);
+            } else {
+                _workCondition.wait_until(lock, timeForTick(findNextTick()));
+            }
+            continue;
+        }
+
+        SendQueue* queue = _ready.front().first;
+        uint64_t generation = _ready.front().second;
+        _ready.pop_front();
+
+        auto it = _queues.find(queue);
+        if (it == _queues.end() || it->second.generation != generation || it->second.isRunning) {
+            // the queue was removed or re-scheduled since this entry was queued
+            continue;
+        }
+        it->second.isRunning = true;
+
+        // let another worker pick up the next queue
+        if (!_ready.empty()) {
+            _workCondition.notify_one();
+        }
+
+        lock.unlock();
+
+        TimePoint nextProcessTime;
+        bool keepRunning = queue->process(nextProcessTime);
+
+        lock.lock();
+
+        it = _queues.find(queue);
+        if (it != _queues.end()) {
+            auto& state = it->second;
+            state.isRunning = false;
+
+            if (state.isWakePending) {
+                state.isWakePending = false;
+                schedule(queue, state, p_high_resolution_clock::now());
+            } else if (keepRunning) {
+                schedule(queue, state, nextProcessTime);
+            }
+        }
+
+        _idleCondition.notify_all();
+    }
+}
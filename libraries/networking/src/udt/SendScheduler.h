@@ -0,0 +1,116 @@
+//
+//  SendScheduler.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendScheduler_h
+#define hifi_SendScheduler_h
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QThread>
+
+#include <PortableHighResolutionClock.h>
+
+namespace udt {
+
+class SendQueue;
+class SendScheduler;
+
+class SendSchedulerWorker : public QThread {
+    Q_OBJECT
+public:
+    SendSchedulerWorker(SendScheduler& scheduler) : _scheduler(scheduler) {}
+
+    void run() override final;
+
+private:
+    SendScheduler& _scheduler;
+};
+
+// Drives every SendQueue from a small, shared set of threads, instead of one thread per connection.
+//   The next time each queue wants to send (its pacing deadline, handshake re-send or timeout) is held in a hashed
+//   timer wheel. Queues that are due, or that were woken by an ACK, NAK or new packet, are processed in FIFO order,
+//   and a queue is only ever processed by one thread at a time.
+class SendScheduler {
+public:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    // the scheduler shared by all sockets in this process - it goes away with the last SendQueue or Socket holding it
+    static std::shared_ptr<SendScheduler> getInstance();
+
+    SendScheduler(int numThreads = QThread::idealThreadCount());
+    ~SendScheduler();
+
+    // starts processing queue right away
+    void add(SendQueue* queue);
+
+    // processes queue as soon as possible, regardless of its current deadline
+    void wake(SendQueue* queue);
+
+    // blocks until queue is no longer being processed, it is safe to delete after this returns
+    void remove(SendQueue* queue);
+
+    int numThreads() const { return (int)_workers.size(); }
+
+private:
+    friend class SendSchedulerWorker;
+
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+    using Tick = uint64_t;
+
+    struct QueueState {
+        uint64_t generation { 0 }; // bumped every time the queue is scheduled, so older timers are ignored
+        bool isRunning { false };
+        bool isWakePending { false };
+    };
+
+    struct Timer {
+        SendQueue* queue;
+        uint64_t generation;
+        Tick tick;
+    };
+
+    void run();
+
+    void schedule(SendQueue* queue, QueueState& state, TimePoint deadline);
+    void advance(Tick tick); // moves the timers due by tick to the ready list
+    Tick findNextTick() const; // the earliest tick with a timer, or the end of the wheel if there is none before it
+
+    Tick tickForTime(TimePoint time) const;
+    TimePoint timeForTick(Tick tick) const;
+
+    static const int TICK_USECS = 100;
+    static const int NUM_SLOTS = 1024;
+
+    std::vector<std::unique_ptr<SendSchedulerWorker>> _workers;
+
+    Mutex _mutex;
+    std::condition_variable _workCondition;
+    std::condition_variable _idleCondition;
+
+    const TimePoint _epoch { p_high_resolution_clock::now() };
+    std::vector<std::vector<Timer>> _wheel; // guarded by _mutex
+    Tick _currentTick { 0 }; // guarded by _mutex
+    int _numTimers { 0 }; // guarded by _mutex
+
+    std::deque<std::pair<SendQueue*, uint64_t>> _ready; // guarded by _mutex
+    std::unordered_map<SendQueue*, QueueState> _queues; // guarded by _mutex
+    bool _stop { false }; // guarded by _mutex
+};
+
+}
+
+#endif // hifi_SendScheduler_h
@@ -15,6 +15,12 @@
 #include <sys/socket.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#endif
+
 #include <QtCore/QThread>
 
 #include <shared/QtHelpers.h>
@@ -26,6 +32,7 @@
 #include "Packet.h"
 #include "../NLPacket.h"
 #include "../NLPacketList.h"
+#include "PacketBufferPool.h"
 #include "PacketList.h"
 #include <Trace.h>
 
@@ -74,6 +81,14 @@ void Socket::bind(const QHostAddress& address, quint16 port) {
     }
 }
 
+void Socket::setBatchedDatagramsEnabled(bool enabled) {
+#if defined(Q_OS_LINUX)
+    _batchedDatagramsEnabled = enabled;
+#else
+    Q_UNUSED(enabled);
+#endif
+}
+
 void Socket::rebind() {
     rebind(_udpSocket.localPort());
 }
@@ -186,6 +201,13 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
     }
 
     // Unerliable and Unordered
+#if defined(Q_OS_LINUX)
+    if (_batchedDatagramsEnabled && packetList->_packets.size() > 1
+        && sockAddr.getAddress().protocol() == QAbstractSocket::IPv4Protocol) {
+        return writeBatchedPackets(packetList->_packets, sockAddr);
+    }
+#endif
+
     qint64 totalBytesSent = 0;
     while (!packetList->_packets.empty()) {
         totalBytesSent += writePacket(packetList->takeFront<Packet>(), sockAddr);
@@ -239,6 +261,88 @@ qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& soc
     return bytesWritten;
 }
 
+#if defined(Q_OS_LINUX)
+
+qint64 Socket::writeBatchedPackets(const std::list<std::unique_ptr<Packet>>& packets, const HifiSockAddr& sockAddr) {
+    sockaddr_in destination;
+    memset(&destination, 0, sizeof(destination));
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(sockAddr.getPort());
+    destination.sin_addr.s_addr = htonl(sockAddr.getAddress().toIPv4Address());
+
+    std::array<iovec, DATAGRAM_BATCH_SIZE> iovecs;
+    std::array<mmsghdr, DATAGRAM_BATCH_SIZE> headers;
+
+    qint64 totalBytesSent = 0;
+    auto it = packets.begin();
+
+    while (it != packets.end()) {
+        // grab the sequence numbers for this batch of packets at once
+        int numPackets = 0;
+        {
+            Lock lock(_unreliableSequenceNumbersMutex);
+            auto& sequenceNumber = _unreliableSequenceNumbers[sockAddr];
+
+            for (; it != packets.end() && numPackets < DATAGRAM_BATCH_SIZE; ++it, ++numPackets) {
+                const Packet& packet = **it;
+                Q_ASSERT_X(!packet.isReliable(), "Socket::writeBatchedPackets", "Cannot send a reliable packet unreliably");
+
+                packet.writeSequenceNumber(++sequenceNumber);
+
+                iovecs[numPackets].iov_base = const_cast<char*>(packet.getData());
+                iovecs[numPackets].iov_len = packet.getDataSize();
+
+                memset(&headers[numPackets], 0, sizeof(mmsghdr));
+                headers[numPackets].msg_hdr.msg_name = &destination;
+                headers[numPackets].msg_hdr.msg_namelen = sizeof(destination);
+                headers[numPackets].msg_hdr.msg_iov = &iovecs[numPackets];
+                headers[numPackets].msg_hdr.msg_iovlen = 1;
+            }
+        }
+
+        int numSent = 0;
+        while (numSent < numPackets) {
+            int result = sendmmsg(_udpSocket.socketDescriptor(), &headers[numSent], numPackets - numSent, 0);
+
+            if (result < 0) {
+                if (errno == ENOSYS) {
+                    // sendmmsg is not available, send what's left one at a time from here on
+                    qCWarning(networking) << "Socket::writeBatchedPackets sendmmsg is not supported, disabling batched datagrams";
+                    _batchedDatagramsEnabled = false;
+
+                    for (int i = numSent; i < numPackets; ++i) {
+                        totalBytesSent += writeDatagram(static_cast<const char*>(iovecs[i].iov_base), iovecs[i].iov_len,
+                                                        sockAddr);
+                    }
+                    for (; it != packets.end(); ++it) {
+                        totalBytesSent += writePacket(**it, sockAddr);
+                    }
+                    return totalBytesSent;
+                }
+
+                // when saturating a link this isn't an uncommon message - suppress it so it doesn't bomb the debug
+                static const QString WRITE_ERROR_REGEX = "Socket::writeBatchedPackets sendmmsg failed - .*";
+                static QString repeatedMessage
+                    = LogHandler::getInstance().addRepeatedMessageRegex(WRITE_ERROR_REGEX);
+
+                qCDebug(networking) << "Socket::writeBatchedPackets sendmmsg failed -" << strerror(errno);
+
+                // drop the datagram that could not be sent, like writeDatagram would, and carry on with the rest
+                ++numSent;
+            } else {
+                for (int i = numSent; i < numSent + result; ++i) {
+                    totalBytesSent += headers[i].msg_len;
+                }
+                numSent += result;
+            }
+        }
+    }
+
+    return totalBytesSent;
+}
+
+#endif
+
 Connection* Socket::findOrCreateConnection(const HifiSockAddr& sockAddr) {
     auto it = _connectionsHash.find(sockAddr);
 
@@ -326,99 +430,218 @@ void Socket::checkForReadyReadBackup() {
 }
 
 void Socket::readPendingDatagrams() {
+#if defined(Q_OS_LINUX)
+    if (_batchedDatagramsEnabled) {
+        // Qt disables its read notifier while it has an unread datagram and only re-enables it from readDatagram,
+        // so pull the first datagram through the Qt socket and drain the rest with recvmmsg
+        if (readPendingDatagram()) {
+            int numRead = 0;
+            while ((numRead = readBatchedDatagrams()) == DATAGRAM_BATCH_SIZE) {}
+
+            if (numRead >= 0) {
+                return;
+            }
+        }
+    }
+#endif
+
+    while (readPendingDatagram()) {}
+}
+
+bool Socket::readPendingDatagram() {
     int packetSizeWithHeader = -1;
 
-    while (_udpSocket.hasPendingDatagrams() && (packetSizeWithHeader = _udpSocket.pendingDatagramSize()) != -1) {
+    if (!_udpSocket.hasPendingDatagrams() || (packetSizeWithHeader = _udpSocket.pendingDatagramSize()) == -1) {
+        return false;
+    }
 
-        // we're reading a packet so re-start the readyRead backup timer
-        _readyReadBackupTimer->start();
+    // we're reading a packet so re-start the readyRead backup timer
+    _readyReadBackupTimer->start();
+
+    // grab a time point we can mark as the receive time of this packet
+    auto receiveTime = p_high_resolution_clock::now();
+
+    // setup a HifiSockAddr to read into
+    HifiSockAddr senderSockAddr;
+
+    // setup a buffer to read the packet into, from the pool if it will fit in one
+    bool isBufferPooled = packetSizeWithHeader <= PacketBufferPool::BUFFER_SIZE;
+    auto buffer = isBufferPooled ? PacketBufferPool::acquire(0)
+                                 : std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+
+    // pull the datagram
+    auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
+                                            senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+
+    // save information for this packet, in case it is the one that sticks readyRead
+    _lastPacketSizeRead = sizeRead;
+    _lastPacketSockAddr = senderSockAddr;
+
+    if (sizeRead <= 0) {
+        // we either didn't pull anything for this packet or there was an error reading (this seems to trigger
+        // on windows even if there's not a packet available)
+        if (isBufferPooled) {
+            PacketBufferPool::release(std::move(buffer));
+        }
+        return true;
+    }
+
+    processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr, receiveTime, isBufferPooled);
+    return true;
+}
+
+#if defined(Q_OS_LINUX)
+
+Socket::DatagramBatch::~DatagramBatch() {
+    for (auto& buffer : buffers) {
+        PacketBufferPool::release(std::move(buffer));
+    }
+}
+
+int Socket::readBatchedDatagrams() {
+    if (!_receiveBatch) {
+        _receiveBatch.reset(new DatagramBatch);
+    }
+    auto& batch = *_receiveBatch;
+
+    for (int i = 0; i < DATAGRAM_BATCH_SIZE; ++i) {
+        // replace the buffers that were handed off to packets during the last batch
+        if (!batch.buffers[i]) {
+            batch.buffers[i] = PacketBufferPool::acquire(0);
+        }
+
+        batch.iovecs[i].iov_base = batch.buffers[i].get();
+        batch.iovecs[i].iov_len = MAX_PACKET_SIZE;
+
+        memset(&batch.headers[i], 0, sizeof(mmsghdr));
+        batch.headers[i].msg_hdr.msg_name = &batch.addresses[i];
+        batch.headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        batch.headers[i].msg_hdr.msg_iov = &batch.iovecs[i];
+        batch.headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int numRead = recvmmsg(_udpSocket.socketDescriptor(), batch.headers.data(), DATAGRAM_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+
+    if (numRead < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            // nothing left to read
+            return 0;
+        }
 
-        // grab a time point we can mark as the receive time of this packet
-        auto receiveTime = p_high_resolution_clock::now();
+        qCWarning(networking) << "Socket::readBatchedDatagrams recvmmsg failed -" << strerror(errno)
+            << "- disabling batched datagrams";
+        _batchedDatagramsEnabled = false;
+        return -1;
+    }
 
-        // setup a HifiSockAddr to read into
-        HifiSockAddr senderSockAddr;
+    if (numRead > 0) {
+        // we're reading packets so re-start the readyRead backup timer
+        _readyReadBackupTimer->start();
+    }
 
-        // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+    // the whole batch was pulled at once, so it shares a receive time
+    auto receiveTime = p_high_resolution_clock::now();
 
-        // pull the datagram
-        auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
-                                                senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+    for (int i = 0; i < numRead; ++i) {
+        auto& header = batch.headers[i];
+        int sizeRead = header.msg_len;
+        HifiSockAddr senderSockAddr(reinterpret_cast<const sockaddr*>(&batch.addresses[i]));
 
         // save information for this packet, in case it is the one that sticks readyRead
         _lastPacketSizeRead = sizeRead;
         _lastPacketSockAddr = senderSockAddr;
 
+        if (header.msg_hdr.msg_flags & MSG_TRUNC) {
+            static const QString TRUNCATED_REGEX = "Socket::readBatchedDatagrams dropping datagram larger than .*";
+            static QString repeatedMessage
+                = LogHandler::getInstance().addRepeatedMessageRegex(TRUNCATED_REGEX);
+
+            qCDebug(networking) << "Socket::readBatchedDatagrams dropping datagram larger than" << MAX_PACKET_SIZE
+                << "bytes from" << senderSockAddr;
+            continue;
+        }
+
         if (sizeRead <= 0) {
-            // we either didn't pull anything for this packet or there was an error reading (this seems to trigger
-            // on windows even if there's not a packet available)
             continue;
         }
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        processDatagram(std::move(batch.buffers[i]), sizeRead, senderSockAddr, receiveTime, true);
+    }
 
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
-            }
+    return numRead;
+}
 
-            continue;
+#endif
+
+void Socket::processDatagram(std::unique_ptr<char[]> buffer, int size, const HifiSockAddr& senderSockAddr,
+                             p_high_resolution_clock::time_point receiveTime, bool isBufferPooled) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+            basePacket->setIsPacketPooled(isBufferPooled);
+            basePacket->setReceiveTime(receiveTime);
+            it->second(std::move(basePacket));
+        } else if (isBufferPooled) {
+            PacketBufferPool::release(std::move(buffer));
         }
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        return;
+    }
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr);
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        controlPacket->setIsPacketPooled(isBufferPooled);
+        controlPacket->setReceiveTime(receiveTime);
 
-            if (connection) {
-                connection->processControl(move(controlPacket));
-            }
+        // move this control packet to the matching connection, if there is one
+        auto connection = findOrCreateConnection(senderSockAddr);
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
-
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
-
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto connection = findOrCreateConnection(senderSockAddr);
-
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
+        if (connection) {
+            connection->processControl(move(controlPacket));
+        }
+
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        packet->setIsPacketPooled(isBufferPooled);
+        packet->setReceiveTime(receiveTime);
+
+        // save the sequence number in case this is the packet that sticks readyRead
+        _lastReceivedSequenceNumber = packet->getSequenceNumber();
+
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto connection = findOrCreateConnection(senderSockAddr);
+
+                if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                              packet->getDataSize(),
+                                                                              packet->getPayloadSize())) {
+                    // the connection could not be created or indicated that we should not continue processing this packet
 #ifdef UDT_CONNECTION_DEBUG
-                        qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
-                            << ", type" << NLPacket::typeInHeader(*packet);
+                    qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
+                        << ", type" << NLPacket::typeInHeader(*packet);
 #endif
-                        continue;
-                    }
+                    return;
                 }
+            }
 
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+            if (packet->isPartOfMessage()) {
+                auto connection = findOrCreateConnection(senderSockAddr);
+                if (connection) {
+                    connection->queueReceivedMessagePacket(std::move(packet));
                 }
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
             }
         }
     }
@@ -14,7 +14,10 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <array>
+#include <atomic>
 #include <functional>
+#include <list>
 #include <unordered_map>
 #include <mutex>
 
@@ -22,6 +25,10 @@
 #include <QtCore/QTimer>
 #include <QtNetwork/QUdpSocket>
 
+#if defined(Q_OS_LINUX)
+#include <sys/socket.h>
+#endif
+
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
@@ -80,6 +87,11 @@ public:
     void addUnfilteredHandler(const HifiSockAddr& senderSockAddr, BasePacketHandler handler)
         { _unfilteredHandlers[senderSockAddr] = handler; }
     
+    // use recvmmsg/sendmmsg to read and write datagrams in batches, where available (Linux only)
+    //   the Qt socket path is used when disabled or unavailable
+    void setBatchedDatagramsEnabled(bool enabled);
+    bool isBatchedDatagramsEnabled() const { return _batchedDatagramsEnabled; }
+
     void setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory);
     void setConnectionMaxBandwidth(int maxBandwidth);
 
@@ -111,6 +123,19 @@ private:
     void setSystemBufferSizes();
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr);
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
+
+    // reads a single datagram through the Qt socket, returns false if there was none pending
+    bool readPendingDatagram();
+    // isBufferPooled says whether buffer was acquired from the PacketBufferPool and should be released back to it
+    void processDatagram(std::unique_ptr<char[]> buffer, int size, const HifiSockAddr& senderSockAddr,
+                         p_high_resolution_clock::time_point receiveTime, bool isBufferPooled = false);
+
+#if defined(Q_OS_LINUX)
+    // reads up to DATAGRAM_BATCH_SIZE datagrams with a single recvmmsg call
+    // returns the number of datagrams read, or -1 if batched reads are not supported
+    int readBatchedDatagrams();
+    qint64 writeBatchedPackets(const std::list<std::unique_ptr<Packet>>& packets, const HifiSockAddr& sockAddr);
+#endif
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
     ConnectionStats::Stats sampleStatsForConnection(const HifiSockAddr& destination);
@@ -143,8 +168,30 @@ private:
 
     std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<TCPVegasCC>() };
 
+    // keeps the send scheduler threads around between connections, instead of only while there is a SendQueue
+    std::shared_ptr<SendScheduler> _sendScheduler { SendScheduler::getInstance() };
+
     bool _shouldChangeSocketOptions { true };
 
+#if defined(Q_OS_LINUX)
+    static const int DATAGRAM_BATCH_SIZE = 64;
+
+    // MTU-sized buffers from the PacketBufferPool for recvmmsg - a buffer is only replaced once its datagram has been
+    // handed off to a packet, which releases it back to the pool
+    struct DatagramBatch {
+        ~DatagramBatch();
+
+        std::array<std::unique_ptr<char[]>, DATAGRAM_BATCH_SIZE> buffers;
+        std::array<sockaddr_storage, DATAGRAM_BATCH_SIZE> addresses;
+        std::array<iovec, DATAGRAM_BATCH_SIZE> iovecs;
+        std::array<mmsghdr, DATAGRAM_BATCH_SIZE> headers;
+    };
+    std::unique_ptr<DatagramBatch> _receiveBatch;
+    std::atomic<bool> _batchedDatagramsEnabled { true };
+#else
+    std::atomic<bool> _batchedDatagramsEnabled { false };
+#endif
+
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
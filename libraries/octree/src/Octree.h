@@ -300,6 +300,16 @@ public:
     bool readJSONFromGzippedFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // Incremental persistence, see OctreePersistThread
+    //   The persisted state of each item is an opaque record keyed by its ID, an empty record marks a deleted item.
+    using PersistRecords = QHash<QUuid, QByteArray>;
+    virtual bool canPersistIncrementally() const { return false; }
+    /// Encodes the items changed since the last call, or every item if all is true. Tracking changes starts with the
+    /// first call. Expects the tree to be locked for reading.
+    virtual void encodePersistChanges(PersistRecords&, bool) { }
+    /// Adds the items encoded in records to the tree. Expects the tree to be locked for writing.
+    virtual bool readPersistRecords(const PersistRecords&) { return false; }
+
     uint64_t getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -333,6 +343,8 @@ public:
         _persistID = id;
         _persistDataVersion = dataVersion;
     }
+    QUuid getPersistID() const { return _persistID; }
+    int getPersistDataVersion() const { return _persistDataVersion; }
 
     virtual void resetEditStats() { }
     virtual quint64 getAverageDecodeTime() const { return 0; }
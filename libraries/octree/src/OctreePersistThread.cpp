@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -16,11 +17,13 @@
 #include <fstream>
 #include <time.h>
 
+#include <QDataStream>
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QSaveFile>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -36,9 +39,16 @@
 
 const int OctreePersistThread::DEFAULT_PERSIST_INTERVAL = 1000 * 30; // every 30 seconds
 
+static const QString SNAPSHOT_EXTENSION = ".snapshot";
+static const QString LOG_EXTENSION = ".log";
+
+// the log is folded into a new snapshot once it is larger than the last one, and at least this large
+static const qint64 MIN_COMPACTION_LOG_SIZE = 1024 * 1024;
+
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, const QString& backupDirectory, int persistInterval,
                                          bool wantBackup, const QJsonObject& settings, bool debugTimestampNow,
-                                         QString persistAsFileType, const QByteArray& replacementData) :
+                                         QString persistAsFileType, const QByteArray& replacementData,
+                                         bool incrementalPersist) :
     _tree(tree),
     _filename(filename),
     _backupDirectory(backupDirectory),
@@ -50,7 +60,8 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _wantBackup(wantBackup),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _incrementalPersist(incrementalPersist)
 {
     parseSettings(settings);
 
@@ -58,6 +69,101 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     // in case the persist filename has an extension that doesn't match the file type
     QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
     _filename = sansExt + "." + _persistAsFileType;
+
+    _snapshotFilename = _filename + SNAPSHOT_EXTENSION;
+    _log.setPath(_filename + LOG_EXTENSION);
+}
+
+OctreePersistThread::~OctreePersistThread() {
+    waitForSnapshot();
+}
+
+qint64 OctreePersistThread::writePersistSnapshot(const QString& filename, quint32 version, QUuid persistID, qint32 dataVersion,
+                                                 const Octree::PersistRecords& records) {
+    QByteArray payload;
+    {
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream << version << persistID << dataVersion << records;
+    }
+    auto record = RecordLog::frameRecord(payload);
+
+    QSaveFile file { filename };
+    if (!file.open(QIODevice::WriteOnly) || file.write(record) != record.size() || !file.commit()) {
+        qCWarning(octree) << "Failed to write entities snapshot to" << filename;
+        return -1;
+    }
+    return record.size();
+}
+
+bool OctreePersistThread::appendPersistLog(RecordLog& log, quint32 version, qint32 dataVersion,
+                                           const Octree::PersistRecords& changes) {
+    QByteArray payload;
+    {
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream << version << dataVersion << changes;
+    }
+    return log.append(payload);
+}
+
+bool OctreePersistThread::readPersistSnapshot(const QString& snapshotFilename, const QStringList& logFilenames,
+                                              quint32 expectedVersion, Octree::PersistRecords& records,
+                                              QUuid& persistID, qint32& dataVersion) {
+    if (!QFile::exists(snapshotFilename)) {
+        return false;
+    }
+
+    QVector<QByteArray> snapshotPayloads;
+    RecordLog::readFile(snapshotFilename, [&](const QByteArray& payload) {
+        // the payload only points into the data read, keep a copy
+        snapshotPayloads.push_back(QByteArray(payload.constData(), payload.size()));
+        return true;
+    });
+
+    quint32 version = 0;
+    if (snapshotPayloads.size() == 1) {
+        QDataStream stream(snapshotPayloads[0]);
+        stream >> version >> persistID >> dataVersion >> records;
+        if (stream.status() != QDataStream::Ok) {
+            version = 0;
+        }
+    }
+
+    if (version != expectedVersion) {
+        // the encoding of the entities changed since, or the snapshot is corrupt
+        qCWarning(octree) << "Can't read entities snapshot" << snapshotFilename;
+        records.clear();
+        return false;
+    }
+
+    // then replay the changes logged since
+    int numChanges = 0;
+    for (auto& logFilename : logFilenames) {
+        RecordLog::readFile(logFilename, [&](const QByteArray& payload) {
+            quint32 logVersion = 0;
+            qint32 logDataVersion = 0;
+            Octree::PersistRecords changes;
+            QDataStream stream(payload);
+            stream >> logVersion >> logDataVersion >> changes;
+            if (stream.status() != QDataStream::Ok || logVersion != version) {
+                return false;
+            }
+
+            for (auto it = changes.begin(); it != changes.end(); ++it) {
+                if (it.value().isEmpty()) {
+                    records.remove(it.key());
+                } else {
+                    records.insert(it.key(), it.value());
+                }
+            }
+            dataVersion = std::max(dataVersion, logDataVersion);
+            numChanges += changes.size();
+            return true;
+        });
+    }
+
+    qCDebug(octree) << "Read" << records.size() << "entities from snapshot" << snapshotFilename
+        << "after replaying" << numChanges << "logged changes";
+    return true;
 }
 
 QString OctreePersistThread::getPersistFileMimeType() const {
@@ -174,10 +280,25 @@ bool OctreePersistThread::process() {
 
         if (!_replacementData.isNull()) {
             replaceData(_replacementData);
+
+            // the snapshot and log describe the content that was just replaced
+            removeIncrementalPersistFiles();
         }
 
         OctreeUtils::RawOctreeData data;
-        if (data.readOctreeDataInfoFromFile(_filename)) {
+        bool dataRead = data.readOctreeDataInfoFromFile(_filename);
+
+        // the snapshot and log are more recent than the JSON file, unless the last shutdown was clean
+        Octree::PersistRecords incrementalRecords;
+        bool incrementalPersistRead = false;
+        if (_incrementalPersist) {
+            incrementalPersistRead = readIncrementalPersist(incrementalRecords, data, dataRead);
+        } else {
+            // left over from when incremental persist was on, they would be behind the JSON file from now on
+            removeIncrementalPersistFiles();
+        }
+
+        if (!incrementalPersistRead && dataRead) {
             qDebug() << "Setting entity version info to: " << data.id << data.version;
             _tree->setOctreeVersionInfo(data.id, data.version);
         }
@@ -200,14 +321,21 @@ bool OctreePersistThread::process() {
                 qCDebug(octree) << "Lock file removed:" << lockFileName;
             }
 
-            persistentFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+            if (incrementalPersistRead) {
+                persistentFileRead = _tree->readPersistRecords(incrementalRecords);
+            } else {
+                persistentFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+            }
             _tree->pruneTree();
         });
+        incrementalRecords.clear();
 
         quint64 loadDone = usecTimestampNow();
         _loadTimeUSecs = loadDone - loadStarted;
 
-        _tree->clearDirtyBit(); // the tree is clean since we just loaded it
+        if (!incrementalPersistRead) {
+            _tree->clearDirtyBit(); // the tree is clean since we just loaded it
+        } // otherwise the JSON file is behind, and is written again with the next backup
         qCDebug(octree, "DONE loading Octrees from file... fileRead=%s", debug::valueOf(persistentFileRead));
 
         unsigned long nodeCount = OctreeElement::getNodeCount();
@@ -228,6 +356,10 @@ bool OctreePersistThread::process() {
                     << " setChildAtIndexTime=" << OctreeElement::getSetChildAtIndexTime() << " perSet=" << usecPerSet;
         }
 
+        if (_incrementalPersist) {
+            startIncrementalPersist();
+        }
+
         _initialLoadComplete = true;
 
         // Since we just loaded the persistent file, we can consider ourselves as having "just checked" for persistance.
@@ -260,7 +392,18 @@ bool OctreePersistThread::process() {
 
         if (sinceLastSave > intervalToCheck) {
             _lastCheck = now;
-            persist();
+            if (_incrementalPersist) {
+                bool persistedChanges = persistIncrementally();
+
+                // keep the JSON file current for the backups, and the domain server's copy current either way
+                if (isBackupDue()) {
+                    persist();
+                } else if (persistedChanges) {
+                    sendLatestEntityDataToDS();
+                }
+            } else {
+                persist();
+            }
         }
     }
     
@@ -280,6 +423,12 @@ bool OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
+    if (_incrementalPersist) {
+        persistIncrementally();
+
+        std::lock_guard<std::mutex> lock(_incrementalPersistMutex);
+        waitForSnapshot();
+    }
     persist();
     qCDebug(octree) << "Persist thread done with about to finish...";
     _stopThread = true;
@@ -296,16 +445,22 @@ QByteArray OctreePersistThread::getPersistFileContents() const {
 
 void OctreePersistThread::persist() {
     if (_tree->isDirty() && _initialLoadComplete) {
+        quint64 persistStart = usecTimestampNow();
+        quint64 lockHoldUsecs = 0;
 
         _tree->withWriteLock([&] {
+            quint64 lockStart = usecTimestampNow();
             qCDebug(octree) << "pruning Octree before saving...";
             _tree->pruneTree();
             qCDebug(octree) << "DONE pruning Octree before saving...";
+            lockHoldUsecs = usecTimestampNow() - lockStart;
         });
 
-        qCDebug(octree) << "persist operation calling backup...";
-        backup(); // handle backup if requested        
-        qCDebug(octree) << "persist operation DONE with backup...";
+        if (!_incrementalPersist) {
+            qCDebug(octree) << "persist operation calling backup...";
+            backup(); // handle backup if requested
+            qCDebug(octree) << "persist operation DONE with backup...";
+        }
 
         _tree->incrementPersistDataVersion();
 
@@ -326,8 +481,195 @@ void OctreePersistThread::persist() {
             qCDebug(octree) << "saving Octree lock file removed:" << lockFileName;
         }
 
+        if (_incrementalPersist) {
+            // the JSON file is only written for the backups, so back up what was just written
+            qCDebug(octree) << "persist operation calling backup...";
+            backup();
+            qCDebug(octree) << "persist operation DONE with backup...";
+        }
+
         sendLatestEntityDataToDS();
+
+        recordPersistStats(usecTimestampNow() - persistStart, lockHoldUsecs);
+    }
+}
+
+bool OctreePersistThread::isBackupDue() const {
+    if (!_wantBackup) {
+        return false;
     }
+
+    quint64 now = usecTimestampNow();
+    for (const BackupRule& rule : _backupRules) {
+        quint64 intervalToBackup = (quint64)rule.interval * USECS_PER_SECOND;
+        if (rule.maxBackupVersions > 0 && now - rule.lastBackup > intervalToBackup) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void OctreePersistThread::recordPersistStats(quint64 elapsedUsecs, quint64 lockHoldUsecs) {
+    _lastPersistUsecs = elapsedUsecs;
+    _lastLockHoldUsecs = lockHoldUsecs;
+    if (elapsedUsecs > _maxPersistUsecs) {
+        _maxPersistUsecs = elapsedUsecs;
+    }
+    if (lockHoldUsecs > _maxLockHoldUsecs) {
+        _maxLockHoldUsecs = lockHoldUsecs;
+    }
+}
+
+bool OctreePersistThread::readIncrementalPersist(Octree::PersistRecords& records, const OctreeUtils::RawOctreeData& data,
+                                                 bool dataRead) {
+    QUuid persistID;
+    qint32 dataVersion = 0;
+    if (!readPersistSnapshot(_snapshotFilename, { _log.getRotatedPath(), _log.getPath() }, _tree->expectedVersion(),
+                             records, persistID, dataVersion)) {
+        if (QFile::exists(_snapshotFilename)) {
+            qCWarning(octree) << "Loading" << _filename << "instead of entities snapshot" << _snapshotFilename;
+        }
+        return false;
+    }
+
+    // the JSON file is written at shutdown and for backups, or replaced with other content
+    if (dataRead && (persistID != data.id || dataVersion < data.version)) {
+        qCDebug(octree) << "Entities file" << _filename << "is newer than snapshot" << _snapshotFilename << "- loading it instead:"
+            << data.id << data.version << "vs" << persistID << dataVersion;
+        records.clear();
+        return false;
+    }
+
+    _tree->setOctreeVersionInfo(persistID, dataVersion);
+    return true;
+}
+
+void OctreePersistThread::startIncrementalPersist() {
+    if (!_tree->canPersistIncrementally()) {
+        qCWarning(octree) << "This tree can't be persisted incrementally, persisting to" << _filename << "instead";
+        _incrementalPersist = false;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_incrementalPersistMutex);
+
+    quint64 persistStart = usecTimestampNow();
+    quint64 lockHoldUsecs = 0;
+    _tree->withReadLock([&] {
+        quint64 lockStart = usecTimestampNow();
+        _tree->encodePersistChanges(_persistRecords, true);
+        lockHoldUsecs = usecTimestampNow() - lockStart;
+    });
+
+    // start over from a snapshot of what was just loaded, the log only ever applies on top of a snapshot
+    _snapshotSize = writePersistSnapshot(_snapshotFilename, _tree->expectedVersion(), _tree->getPersistID(),
+                                  _tree->getPersistDataVersion(), _persistRecords);
+    if (_snapshotSize < 0 || !openPersistLog()) {
+        qCWarning(octree) << "Failed to start incremental persist, persisting to" << _filename << "instead";
+        removeIncrementalPersistFiles();
+        _persistRecords.clear();
+        _incrementalPersist = false;
+        return;
+    }
+    _log.removeRotated();
+
+    _lastPersistChangeCount = _persistRecords.size();
+    recordPersistStats(usecTimestampNow() - persistStart, lockHoldUsecs);
+}
+
+bool OctreePersistThread::persistIncrementally() {
+    std::lock_guard<std::mutex> lock(_incrementalPersistMutex);
+    if (!_initialLoadComplete || !_incrementalPersist) {
+        return false;
+    }
+
+    quint64 persistStart = usecTimestampNow();
+    quint64 lockHoldUsecs = 0;
+    Octree::PersistRecords changes;
+    _tree->withReadLock([&] {
+        quint64 lockStart = usecTimestampNow();
+        _tree->encodePersistChanges(changes, false);
+        lockHoldUsecs = usecTimestampNow() - lockStart;
+    });
+
+    if (!changes.isEmpty()) {
+        for (auto it = changes.begin(); it != changes.end(); ++it) {
+            if (it.value().isEmpty()) {
+                _persistRecords.remove(it.key());
+            } else {
+                _persistRecords.insert(it.key(), it.value());
+            }
+        }
+
+        // every change is a new version of the data, so that loading can tell which of this and the JSON file is newer
+        _tree->incrementPersistDataVersion();
+
+        if (!appendPersistLog(_log, _tree->expectedVersion(), _tree->getPersistDataVersion(), changes)) {
+            qCWarning(octree) << "Failed to write" << changes.size() << "entity changes to" << _log.getPath()
+                << "- writing a snapshot instead";
+            startSnapshot();
+        } else if (_log.size() > std::max((qint64)_snapshotSize, MIN_COMPACTION_LOG_SIZE)) {
+            startSnapshot();
+        }
+        _persistLogSize = _log.size();
+    }
+
+    _lastPersistChangeCount = changes.size();
+    recordPersistStats(usecTimestampNow() - persistStart, lockHoldUsecs);
+    return !changes.isEmpty();
+}
+
+void OctreePersistThread::startSnapshot() {
+    if (_isWritingSnapshot) {
+        return;
+    }
+    waitForSnapshot();
+
+    bool rotated = _log.rotate();
+    _persistLogSize = _log.size();
+    if (!rotated) {
+        qCWarning(octree) << "Failed to rotate entities log" << _log.getPath() << "- will not write a snapshot";
+        return;
+    }
+
+    // the records are implicitly shared, the copy is only made as the next changes come in
+    _isWritingSnapshot = true;
+    Octree::PersistRecords records = _persistRecords;
+    quint32 version = _tree->expectedVersion();
+    QUuid persistID = _tree->getPersistID();
+    qint32 dataVersion = _tree->getPersistDataVersion();
+    _snapshotThread = std::thread([this, records, version, persistID, dataVersion] {
+        quint64 start = usecTimestampNow();
+        qint64 size = writePersistSnapshot(_snapshotFilename, version, persistID, dataVersion, records);
+        if (size >= 0) {
+            _snapshotSize = size;
+            _log.removeRotated();
+            qCDebug(octree) << "Wrote" << records.size() << "entities to snapshot" << _snapshotFilename << "in"
+                << (usecTimestampNow() - start) / USECS_PER_MSEC << "ms";
+        } else {
+            qCWarning(octree) << "Failed to write entities snapshot, it will be retried with the next one";
+        }
+        _isWritingSnapshot = false;
+    });
+}
+
+void OctreePersistThread::waitForSnapshot() {
+    if (_snapshotThread.joinable()) {
+        _snapshotThread.join();
+    }
+}
+
+bool OctreePersistThread::openPersistLog() {
+    if (!_log.open()) {
+        return false;
+    }
+    _persistLogSize = _log.size();
+    return true;
+}
+
+void OctreePersistThread::removeIncrementalPersistFiles() {
+    QFile::remove(_snapshotFilename);
+    _log.remove();
 }
 
 void OctreePersistThread::sendLatestEntityDataToDS() {
@@ -14,9 +14,16 @@
 #ifndef hifi_OctreePersistThread_h
 #define hifi_OctreePersistThread_h
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <QFile>
 #include <QString>
 #include <GenericThread.h>
+#include <RecordLog.h>
 #include "Octree.h"
+#include "OctreeDataUtils.h"
 
 class OctreePersistThread : public GenericThread {
     Q_OBJECT
@@ -35,7 +42,9 @@ public:
     OctreePersistThread(OctreePointer tree, const QString& filename, const QString& backupDirectory,
                         int persistInterval = DEFAULT_PERSIST_INTERVAL, bool wantBackup = false,
                         const QJsonObject& settings = QJsonObject(), bool debugTimestampNow = false,
-                        QString persistAsFileType = "json.gz", const QByteArray& replacementData = QByteArray());
+                        QString persistAsFileType = "json.gz", const QByteArray& replacementData = QByteArray(),
+                        bool incrementalPersist = false);
+    ~OctreePersistThread();
 
     bool isInitialLoadComplete() const { return _initialLoadComplete; }
     quint64 getLoadElapsedTime() const { return _loadTimeUSecs; }
@@ -46,6 +55,27 @@ public:
     QString getPersistFileMimeType() const;
     QByteArray getPersistFileContents() const;
 
+    bool isIncrementalPersist() const { return _incrementalPersist; }
+
+    // how long the last and longest persist took, and held the tree locked for
+    quint64 getLastPersistElapsedTime() const { return _lastPersistUsecs; }
+    quint64 getMaxPersistElapsedTime() const { return _maxPersistUsecs; }
+    quint64 getLastLockHoldTime() const { return _lastLockHoldUsecs; }
+    quint64 getMaxLockHoldTime() const { return _maxLockHoldUsecs; }
+    int getLastPersistChangeCount() const { return _lastPersistChangeCount; }
+    qint64 getPersistLogSize() const { return _persistLogSize; }
+
+    // The snapshot holds every entity, with the id and data version of the tree it was taken of. Each record of a log
+    // holds the entities changed since the last one (an empty record for a deleted entity), with the data version they
+    // bring the tree to. Returns the size of the snapshot written, or -1 if it couldn't be.
+    static qint64 writePersistSnapshot(const QString& filename, quint32 version, QUuid persistID, qint32 dataVersion,
+                                       const Octree::PersistRecords& records);
+    static bool appendPersistLog(RecordLog& log, quint32 version, qint32 dataVersion, const Octree::PersistRecords& changes);
+    // Reads the snapshot and replays the logs, in order, on top of it. A torn or corrupt tail of a log is ignored.
+    // Returns false if there is no snapshot, or it can't be read with the expected version.
+    static bool readPersistSnapshot(const QString& snapshotFilename, const QStringList& logFilenames, quint32 expectedVersion,
+                                    Octree::PersistRecords& records, QUuid& persistID, qint32& dataVersion);
+
 signals:
     void loadCompleted();
 
@@ -65,6 +95,20 @@ protected:
     void replaceData(QByteArray data);
     void sendLatestEntityDataToDS();
 
+    // Incremental persistence: every persist interval, the entities changed since the last one are appended to a
+    // binary log. Once the log outgrows the last snapshot, a new snapshot of every entity is written in the background
+    // and the log starts over. Loading reads the snapshot and replays the log on top of it, unless the JSON file is
+    // newer. The JSON file is still written at shutdown, and before each backup.
+    bool readIncrementalPersist(Octree::PersistRecords& records, const OctreeUtils::RawOctreeData& data, bool dataRead);
+    void startIncrementalPersist();
+    bool persistIncrementally(); // returns true if there were changes to persist
+    void startSnapshot();
+    void waitForSnapshot();
+    bool openPersistLog();
+    void removeIncrementalPersistFiles();
+    bool isBackupDue() const;
+    void recordPersistStats(quint64 elapsedUsecs, quint64 lockHoldUsecs);
+
 private:
     OctreePointer _tree;
     QString _filename;
@@ -84,6 +128,22 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    bool _incrementalPersist;
+    QString _snapshotFilename;
+    std::mutex _incrementalPersistMutex; // aboutToFinish is called from another thread
+    RecordLog _log; // rotated aside while it is being folded into the snapshot
+    Octree::PersistRecords _persistRecords; // the persisted entities, as of the last incremental persist
+    std::atomic<qint64> _snapshotSize { 0 };
+    std::thread _snapshotThread;
+    std::atomic<bool> _isWritingSnapshot { false };
+
+    std::atomic<quint64> _lastPersistUsecs { 0 };
+    std::atomic<quint64> _maxPersistUsecs { 0 };
+    std::atomic<quint64> _lastLockHoldUsecs { 0 };
+    std::atomic<quint64> _maxLockHoldUsecs { 0 };
+    std::atomic<int> _lastPersistChangeCount { 0 };
+    std::atomic<qint64> _persistLogSize { 0 };
 };
 
 #endif // hifi_OctreePersistThread_h
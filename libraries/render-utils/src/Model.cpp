@@ -1746,8 +1746,7 @@ void Model::setCollisionMesh(graphics::MeshPointer mesh) {
     _needsFixupInScene = true;
 }
 
-ModelBlender::ModelBlender() :
-    _pendingBlenders(0) {
+ModelBlender::ModelBlender() {
 }
 
 ModelBlender::~ModelBlender() {
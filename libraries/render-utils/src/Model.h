@@ -17,6 +17,7 @@
 #include <QUrl>
 #include <QMutex>
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
@@ -511,7 +512,7 @@ private:
     virtual ~ModelBlender();
 
     std::set<ModelWeakPointer, std::owner_less<ModelWeakPointer>> _modelsRequiringBlends;
-    int _pendingBlenders;
+    std::atomic<int> _pendingBlenders { 0 }; // blends are noted from the avatar simulation workers as well
     Mutex _mutex;
 };
 
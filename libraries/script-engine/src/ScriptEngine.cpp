@@ -102,6 +102,42 @@ int scriptEnginePointerMetaID = qRegisterMetaType<ScriptEnginePointer>();
 
 Q_LOGGING_CATEGORY(scriptengineScript, "hifi.scriptengine.script")
 
+// Script.update.connect() and disconnect(), which hand entity script handlers to the ScriptEngine and everything else
+// to the signal's own connect() and disconnect(), kept as the data of these functions
+static bool getUpdateHandlerArguments(QScriptContext* context, QScriptValue& thisObject, QScriptValue& function) {
+    function = context->argument(0);
+    if (context->argumentCount() > 1) {
+        thisObject = context->argument(0);
+        function = context->argument(1);
+        if (function.isString()) {
+            function = thisObject.property(function.toString());
+        }
+    }
+    return function.isFunction();
+}
+
+static QScriptValue connectScriptUpdate(QScriptContext* context, QScriptEngine* engine) {
+    auto scriptEngine = qobject_cast<ScriptEngine*>(engine);
+    QScriptValue thisObject;
+    QScriptValue function;
+    if (scriptEngine && getUpdateHandlerArguments(context, thisObject, function) &&
+        scriptEngine->connectEntityUpdateHandler(thisObject, function)) {
+        return engine->undefinedValue();
+    }
+    return context->callee().data().call(context->thisObject(), context->argumentsObject());
+}
+
+static QScriptValue disconnectScriptUpdate(QScriptContext* context, QScriptEngine* engine) {
+    auto scriptEngine = qobject_cast<ScriptEngine*>(engine);
+    QScriptValue thisObject;
+    QScriptValue function;
+    if (scriptEngine && getUpdateHandlerArguments(context, thisObject, function) &&
+        scriptEngine->disconnectEntityUpdateHandler(thisObject, function)) {
+        return engine->undefinedValue();
+    }
+    return context->callee().data().call(context->thisObject(), context->argumentsObject());
+}
+
 static QScriptValue debugPrint(QScriptContext* context, QScriptEngine* engine) {
     QString message = "";
     for (int i = 0; i < context->argumentCount(); i++) {
@@ -173,7 +209,6 @@ ScriptEngine::ScriptEngine(Context context, const QString& scriptContents, const
     BaseScriptEngine(),
     _context(context),
     _scriptContents(scriptContents),
-    _timerFunctionMap(),
     _fileNameString(fileNameString),
     _arrayBufferClass(new ArrayBufferClass(this)),
     _assetScriptingInterface(new AssetScriptingInterface(this)),
@@ -307,12 +342,15 @@ void ScriptEngine::runDebuggable() {
             return;
         }
 
+        fireTimers();
+
         qint64 now = usecTimestampNow();
         // we check for 'now' in the past in case people set their clock back
         if (_lastUpdate < now) {
             float deltaTime = (float)(now - _lastUpdate) / (float)USECS_PER_SECOND;
             if (!_isFinished) {
                 emit update(deltaTime);
+                callEntityUpdateHandlers(deltaTime);
             }
         }
         _lastUpdate = now;
@@ -669,6 +707,18 @@ void ScriptEngine::init() {
         auto resolve = Script.property("_requireResolve");
         require.setProperty("resolve", resolve, READONLY_PROP_FLAGS);
         resetModuleCache();
+
+        // set up Script.update.connect and Script.update.disconnect, see connectEntityUpdateHandler, but only for
+        // engines that time their entity scripts, which turn that on before they run
+        if (_trackRunLoopStats) {
+            auto update = Script.property("update");
+            auto connect = newFunction(connectScriptUpdate);
+            connect.setData(update.property("connect"));
+            update.setProperty("connect", connect, READONLY_HIDDEN_PROP_FLAGS);
+            auto disconnect = newFunction(disconnectScriptUpdate);
+            disconnect.setData(update.property("disconnect"));
+            update.setProperty("disconnect", disconnect, READONLY_HIDDEN_PROP_FLAGS);
+        }
     }
 
     registerGlobalObject("Audio", DependencyManager::get<AudioScriptingInterface>().data());
@@ -1075,15 +1125,31 @@ void ScriptEngine::run() {
         // We don't want to actually sleep for too long, because it causes our scripts to hang
         // on shutdown and stop... so we want to loop and sleep until we've spent our time in
         // purgatory, constantly checking to see if our script was asked to end
+        // Script timers are fired from here too, waking up for them on the way
         bool processedEvents = false;
-        if (!_isFinished) {
+        while (!_isFinished) {
             PROFILE_RANGE(script, "processEvents-sleep");
+            fireTimers();
+            if (_isFinished) {
+                break;
+            }
+
             std::chrono::milliseconds sleepFor =
                 std::chrono::duration_cast<std::chrono::milliseconds>(sleepUntil - clock::now());
+            if (sleepFor <= std::chrono::milliseconds(0)) {
+                if (!processedEvents) {
+                    QCoreApplication::processEvents();
+                    processedEvents = true;
+                }
+                break;
+            }
+
+            sleepFor = std::min(sleepFor, getTimeUntilNextTimer());
             if (sleepFor > std::chrono::milliseconds(0)) {
                 QEventLoop loop;
                 QTimer timer;
                 timer.setSingleShot(true);
+                timer.setTimerType(Qt::PreciseTimer);
                 connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
                 timer.start(sleepFor.count());
                 loop.exec();
@@ -1093,6 +1159,11 @@ void ScriptEngine::run() {
             processedEvents = true;
         }
 
+        if (_trackRunLoopStats) {
+            auto lag = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - sleepUntil);
+            addRunLoopLag(std::max(lag, std::chrono::microseconds(0)));
+        }
+
         PROFILE_RANGE(script, "ScriptMainLoop");
 
 #ifdef SCRIPT_DELAY_DEBUG
@@ -1147,6 +1218,14 @@ void ScriptEngine::run() {
                     PROFILE_RANGE(script, "ScriptUpdate");
                     emit update(deltaTime);
                 }
+                if (_trackRunLoopStats) {
+                    addScriptTime(EntityItemID(), std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - preUpdate));
+                }
+                {
+                    // timed per entity script by doWithEnvironment()
+                    PROFILE_RANGE(script, "EntityScriptUpdate");
+                    callEntityUpdateHandlers(deltaTime);
+                }
                 auto postUpdate = clock::now();
                 auto elapsed = (postUpdate - preUpdate);
                 totalUpdates += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
@@ -1193,32 +1272,15 @@ void ScriptEngine::run() {
 // NOTE: This is private because it must be called on the same thread that created the timers, which is why
 // we want to only call it in our own run "shutdown" processing.
 void ScriptEngine::stopAllTimers() {
-    QMutableHashIterator<QTimer*, CallbackData> i(_timerFunctionMap);
-    int j {0};
-    while (i.hasNext()) {
-        i.next();
-        QTimer* timer = i.key();
-        qCDebug(scriptengine) << getFilename() << "stopAllTimers[" << j++ << "]";
-        stopTimer(timer);
+    if (!_timers.isEmpty()) {
+        qCDebug(scriptengine) << getFilename() << "stopAllTimers" << _timers.size();
+        _timers.clear();
     }
 }
 
 void ScriptEngine::stopAllTimersForEntityScript(const EntityItemID& entityID) {
-     // We could maintain a separate map of entityID => QTimer, but someone will have to prove to me that it's worth the complexity. -HRS
-    QVector<QTimer*> toDelete;
-    QMutableHashIterator<QTimer*, CallbackData> i(_timerFunctionMap);
-    while (i.hasNext()) {
-        i.next();
-        if (i.value().definingEntityIdentifier != entityID) {
-            continue;
-        }
-        QTimer* timer = i.key();
-        toDelete << timer; // don't delete while we're iterating. save it.
-    }
-    for (auto timer:toDelete) { // now reap 'em
-        stopTimer(timer);
-    }
-
+    // the timers are also filed by entity, so this only touches the timers of that entity
+    _timers.removeOwner(entityID);
 }
 
 void ScriptEngine::stop(bool marshal) {
@@ -1268,7 +1330,25 @@ void ScriptEngine::updateMemoryCost(const qint64& deltaSize) {
     }
 }
 
-void ScriptEngine::timerFired() {
+quint64 ScriptEngine::getTimerTicks() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(p_high_resolution_clock::now() - _timersStartTime).count();
+}
+
+std::chrono::milliseconds ScriptEngine::getTimeUntilNextTimer() const {
+    ScriptTimers::Ticks nextExpiry = _timers.getNextExpiry();
+    if (nextExpiry == ScriptTimers::NO_EXPIRY) {
+        return std::chrono::milliseconds::max();
+    }
+    ScriptTimers::Ticks now = getTimerTicks();
+    return std::chrono::milliseconds(nextExpiry > now ? nextExpiry - now : 0);
+}
+
+void ScriptEngine::fireTimers() {
+    ScriptTimers::Ticks now = getTimerTicks();
+    if (_timers.getNextExpiry() > now) {
+        return;
+    }
+
     {
         auto engine = DependencyManager::get<ScriptEngines>();
         if (!engine || engine->isStopped()) {
@@ -1277,77 +1357,53 @@ void ScriptEngine::timerFired() {
         }
     }
 
-    QTimer* callingTimer = reinterpret_cast<QTimer*>(sender());
-    CallbackData timerData = _timerFunctionMap.value(callingTimer);
-
-    if (!callingTimer->isActive()) {
-        // this timer is done, we can kill it
-        _timerFunctionMap.remove(callingTimer);
-        delete callingTimer;
-    }
-
-    // call the associated JS function, if it exists
-    if (timerData.function.isValid()) {
-        PROFILE_RANGE(script, __FUNCTION__);
-        auto preTimer = p_high_resolution_clock::now();
-        callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
-        auto postTimer = p_high_resolution_clock::now();
-        auto elapsed = (postTimer - preTimer);
-        _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
-    } else {
-        qCWarning(scriptengine) << "timerFired -- invalid function" << timerData.function.toVariant().toString();
-    }
+    PROFILE_RANGE(script, __FUNCTION__);
+    _timers.fireDue(now, [this](const CallbackData& timerData) {
+        // call the associated JS function, if it exists
+        if (timerData.function.isValid()) {
+            auto preTimer = p_high_resolution_clock::now();
+            callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
+            auto postTimer = p_high_resolution_clock::now();
+            auto elapsed = (postTimer - preTimer);
+            _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+        } else {
+            qCWarning(scriptengine) << "timerFired -- invalid function" << timerData.function.toVariant().toString();
+        }
+    });
 }
 
-QObject* ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
-    // create the timer, add it to the map, and start it
-    QTimer* newTimer = new QTimer(this);
-    newTimer->setSingleShot(isSingleShot);
-
-    // The default timer type is not very accurate below about 200ms http://doc.qt.io/qt-5/qt.html#TimerType-enum
-    static const int MIN_TIMEOUT_FOR_COARSE_TIMER = 200;
-    if (intervalMS < MIN_TIMEOUT_FOR_COARSE_TIMER) {
-        newTimer->setTimerType(Qt::PreciseTimer);
-    }
-
-    connect(newTimer, &QTimer::timeout, this, &ScriptEngine::timerFired);
-
-    // make sure the timer stops when the script does
-    connect(this, &ScriptEngine::scriptEnding, newTimer, &QTimer::stop);
-
-
+QScriptValue ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
     CallbackData timerData = { function, currentEntityIdentifier, currentSandboxURL };
-    _timerFunctionMap.insert(newTimer, timerData);
-
-    newTimer->start(intervalMS);
-    return newTimer;
+    ScriptTimers::TimerID timer = _timers.add(currentEntityIdentifier, timerData, getTimerTicks(),
+                                              (quint32)std::max(intervalMS, 0), isSingleShot);
+    if (!timer) {
+        scriptWarningMessage("Script timer could not be created, too many timers... parent script:" + getFilename());
+        return QScriptValue(QScriptValue::NullValue);
+    }
+    return QScriptValue((double)timer);
 }
 
-QObject* ScriptEngine::setInterval(const QScriptValue& function, int intervalMS) {
+QScriptValue ScriptEngine::setInterval(const QScriptValue& function, int intervalMS) {
     if (DependencyManager::get<ScriptEngines>()->isStopped()) {
         scriptWarningMessage("Script.setInterval() while shutting down is ignored... parent script:" + getFilename());
-        return NULL; // bail early
+        return QScriptValue(QScriptValue::NullValue); // bail early
     }
 
     return setupTimerWithInterval(function, intervalMS, false);
 }
 
-QObject* ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
+QScriptValue ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
     if (DependencyManager::get<ScriptEngines>()->isStopped()) {
         scriptWarningMessage("Script.setTimeout() while shutting down is ignored... parent script:" + getFilename());
-        return NULL; // bail early
+        return QScriptValue(QScriptValue::NullValue); // bail early
     }
 
     return setupTimerWithInterval(function, timeoutMS, true);
 }
 
-void ScriptEngine::stopTimer(QTimer *timer) {
-    if (_timerFunctionMap.contains(timer)) {
-        timer->stop();
-        _timerFunctionMap.remove(timer);
-        delete timer;
-    } else {
-        qCDebug(scriptengine) << "stopTimer -- not in _timerFunctionMap" << timer;
+void ScriptEngine::stopTimer(const QScriptValue& timer) {
+    if (!timer.isNumber() || !_timers.remove((ScriptTimers::TimerID)timer.toNumber())) {
+        qCDebug(scriptengine) << "stopTimer -- not a running timer" << timer.toString();
     }
 }
 
@@ -1932,6 +1988,70 @@ int ScriptEngine::getNumRunningEntityScripts() const {
     return sum;
 }
 
+ScriptEngineRunLoopStats ScriptEngine::takeRunLoopStats() {
+    ScriptEngineRunLoopStats stats;
+    std::lock_guard<std::mutex> lock(_runLoopStatsMutex);
+    std::swap(stats, _runLoopStats);
+    return stats;
+}
+
+bool ScriptEngine::connectEntityUpdateHandler(const QScriptValue& thisObject, const QScriptValue& function) {
+    if (currentEntityIdentifier.isInvalidID()) {
+        return false;
+    }
+    EntityUpdateHandler handler = { { function, currentEntityIdentifier, currentSandboxURL }, thisObject };
+    _entityUpdateHandlers.push_back(handler);
+    return true;
+}
+
+bool ScriptEngine::disconnectEntityUpdateHandler(const QScriptValue& thisObject, const QScriptValue& function) {
+    for (auto it = _entityUpdateHandlers.begin(); it != _entityUpdateHandlers.end(); ++it) {
+        if (it->callback.function.strictlyEquals(function) && (thisObject.isValid() ?
+                it->thisObject.strictlyEquals(thisObject) : !it->thisObject.isValid())) {
+            _entityUpdateHandlers.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ScriptEngine::callEntityUpdateHandlers(float deltaTime) {
+    // a copy, since handlers may connect or disconnect others
+    auto handlers = _entityUpdateHandlers;
+    for (auto& handler : handlers) {
+        if (_isFinished) {
+            break;
+        }
+        callWithEnvironment(handler.callback.definingEntityIdentifier, handler.callback.definingSandboxURL,
+                            handler.callback.function, handler.thisObject, { QScriptValue((qsreal)deltaTime) });
+    }
+}
+
+void ScriptEngine::removeEntityUpdateHandlers(const EntityItemID& entityID) {
+    for (auto it = _entityUpdateHandlers.begin(); it != _entityUpdateHandlers.end();) {
+        if (it->callback.definingEntityIdentifier == entityID) {
+            it = _entityUpdateHandlers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ScriptEngine::addScriptTime(const EntityItemID& entityID, std::chrono::microseconds elapsed) {
+    std::lock_guard<std::mutex> lock(_runLoopStatsMutex);
+    _runLoopStats.scriptUsecs += elapsed.count();
+    if (!entityID.isNull()) {
+        _runLoopStats.entityScriptUsecs[entityID] += elapsed.count();
+    }
+}
+
+void ScriptEngine::addRunLoopLag(std::chrono::microseconds lag) {
+    std::lock_guard<std::mutex> lock(_runLoopStatsMutex);
+    _runLoopStats.totalLagUsecs += lag.count();
+    _runLoopStats.maxLagUsecs = std::max(_runLoopStats.maxLagUsecs, (quint64)lag.count());
+    ++_runLoopStats.numFrames;
+}
+
 void ScriptEngine::setEntityScriptDetails(const EntityItemID& entityID, const EntityScriptDetails& details) {
     _entityScripts[entityID] = details;
     emit entityScriptDetailsUpdated();
@@ -2388,6 +2508,7 @@ void ScriptEngine::unloadEntityScript(const EntityItemID& entityID, bool shouldR
         }
 
         stopAllTimersForEntityScript(entityID);
+        removeEntityUpdateHandlers(entityID);
         {
             // FIXME: shouldn't have to do this here, but currently something seems to be firing unloads moments after firing initial load requests
             processDeferredEntityLoads(scriptText, entityID);
@@ -2457,6 +2578,10 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
     currentEntityIdentifier = entityID;
     currentSandboxURL = sandboxURL;
 
+    bool isTimed = _trackRunLoopStats && _environmentDepth == 0;
+    auto startTime = p_high_resolution_clock::now();
+    ++_environmentDepth;
+
 #if DEBUG_CURRENT_ENTITY
     QScriptValue oldData = this->globalObject().property("debugEntityID");
     this->globalObject().setProperty("debugEntityID", entityID.toScriptValue(this)); // Make the entityID available to javascript as a global.
@@ -2468,6 +2593,12 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
     maybeEmitUncaughtException(!entityID.isNull() ? entityID.toString() : __FUNCTION__);
     currentEntityIdentifier = oldIdentifier;
     currentSandboxURL = oldSandboxURL;
+
+    --_environmentDepth;
+    if (isTimed) {
+        addScriptTime(entityID,
+            std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now() - startTime));
+    }
 }
 
 void ScriptEngine::callWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, QScriptValue function, QScriptValue thisObject, QScriptValueList args) {
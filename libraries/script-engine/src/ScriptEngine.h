@@ -12,6 +12,7 @@
 #ifndef hifi_ScriptEngine_h
 #define hifi_ScriptEngine_h
 
+#include <mutex>
 #include <vector>
 
 #include <QtCore/QObject>
@@ -27,6 +28,8 @@
 #include <AvatarData.h>
 #include <AvatarHashMap.h>
 #include <LimitedNodeList.h>
+#include <PortableHighResolutionClock.h>
+#include <TimerWheel.h>
 #include <EntityItemID.h>
 #include <EntitiesScriptEngineProvider.h>
 #include <EntityScriptUtils.h>
@@ -71,6 +74,16 @@ public:
     //bool forceRedownload;
 };
 
+// what the run loop of a ScriptEngine spent its time on, see ScriptEngine::takeRunLoopStats()
+class ScriptEngineRunLoopStats {
+public:
+    quint64 scriptUsecs { 0 }; // running script code: updates, timers and entity script calls
+    quint64 totalLagUsecs { 0 }; // how late the run loop got back to its frames
+    quint64 maxLagUsecs { 0 };
+    int numFrames { 0 };
+    QHash<EntityItemID, quint64> entityScriptUsecs; // the part of scriptUsecs spent in each entity script
+};
+
 typedef QList<CallbackData> CallbackList;
 typedef QHash<QString, CallbackList> RegisteredEventHandlers;
 
@@ -179,10 +192,11 @@ public:
     QVariantMap fetchModuleSource(const QString& modulePath, const bool forceDownload = false);
     QScriptValue instantiateModule(const QScriptValue& module, const QString& sourceCode);
 
-    Q_INVOKABLE QObject* setInterval(const QScriptValue& function, int intervalMS);
-    Q_INVOKABLE QObject* setTimeout(const QScriptValue& function, int timeoutMS);
-    Q_INVOKABLE void clearInterval(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
-    Q_INVOKABLE void clearTimeout(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
+    // timers are numbers, like in browsers
+    Q_INVOKABLE QScriptValue setInterval(const QScriptValue& function, int intervalMS);
+    Q_INVOKABLE QScriptValue setTimeout(const QScriptValue& function, int timeoutMS);
+    Q_INVOKABLE void clearInterval(const QScriptValue& timer) { stopTimer(timer); }
+    Q_INVOKABLE void clearTimeout(const QScriptValue& timer) { stopTimer(timer); }
 
     Q_INVOKABLE void print(const QString& message);
     Q_INVOKABLE QUrl resolvePath(const QString& path) const;
@@ -238,6 +252,16 @@ public:
     int getNumRunningEntityScripts() const;
     bool getEntityScriptDetails(const EntityItemID& entityID, EntityScriptDetails &details) const;
 
+    // run loop stats are off by default, once on they accumulate until taken (from any thread)
+    void setTrackRunLoopStats(bool trackRunLoopStats) { _trackRunLoopStats = trackRunLoopStats; }
+    ScriptEngineRunLoopStats takeRunLoopStats();
+
+    // Script.update handlers connected from an entity script are kept here rather than connected to the signal, and
+    // called with the environment of that entity script, so their time is counted against it. These return false
+    // for connections that should go to the signal.
+    bool connectEntityUpdateHandler(const QScriptValue& thisObject, const QScriptValue& function);
+    bool disconnectEntityUpdateHandler(const QScriptValue& thisObject, const QScriptValue& function);
+
 public slots:
     void callAnimationStateHandler(QScriptValue callback, AnimVariantMap parameters, QStringList names, bool useNames, AnimVariantResultHandler resultHandler);
     void updateMemoryCost(const qint64&);
@@ -271,19 +295,30 @@ protected:
     Q_INVOKABLE QString _requireResolve(const QString& moduleId, const QString& relativeTo = QString());
 
     QString logException(const QScriptValue& exception);
-    void timerFired();
+    void fireTimers();
+    quint64 getTimerTicks() const;
+    std::chrono::milliseconds getTimeUntilNextTimer() const;
     void stopAllTimers();
     void stopAllTimersForEntityScript(const EntityItemID& entityID);
+    void callEntityUpdateHandlers(float deltaTime);
+    void removeEntityUpdateHandlers(const EntityItemID& entityID);
     void refreshFileScript(const EntityItemID& entityID);
     void updateEntityScriptStatus(const EntityItemID& entityID, const EntityScriptStatus& status, const QString& errorInfo = QString());
     void setEntityScriptDetails(const EntityItemID& entityID, const EntityScriptDetails& details);
     void setParentURL(const QString& parentURL) { _parentURL = parentURL; }
     void processDeferredEntityLoads(const QString& entityScript, const EntityItemID& leaderID);
 
-    QObject* setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
-    void stopTimer(QTimer* timer);
+    QScriptValue setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
+    void stopTimer(const QScriptValue& timer);
 
     QHash<EntityItemID, RegisteredEventHandlers> _registeredHandlers;
+
+    class EntityUpdateHandler {
+    public:
+        CallbackData callback;
+        QScriptValue thisObject;
+    };
+    QList<EntityUpdateHandler> _entityUpdateHandlers;
     void forwardHandlerCall(const EntityItemID& entityID, const QString& eventName, QScriptValueList eventHanderArgs);
     Q_INVOKABLE void entityScriptContentAvailable(const EntityItemID& entityID, const QString& scriptOrURL, const QString& contents, bool isURL, bool success, const QString& status);
 
@@ -299,7 +334,10 @@ protected:
     std::atomic<bool> _isRunning { false };
     std::atomic<bool> _isStopping { false };
     bool _isInitialized { false };
-    QHash<QTimer*, CallbackData> _timerFunctionMap;
+    // script timers, in msecs since _timersStartTime, fired from the run loop
+    using ScriptTimers = TimerWheel<EntityItemID, CallbackData>;
+    ScriptTimers _timers;
+    p_high_resolution_clock::time_point _timersStartTime { p_high_resolution_clock::now() };
     QSet<QUrl> _includedURLs;
     QHash<EntityItemID, EntityScriptDetails> _entityScripts;
     QHash<QString, EntityItemID> _occupiedScriptURLs;
@@ -329,6 +367,14 @@ protected:
 
     std::chrono::microseconds _totalTimerExecution { 0 };
 
+    void addScriptTime(const EntityItemID& entityID, std::chrono::microseconds elapsed);
+    void addRunLoopLag(std::chrono::microseconds lag);
+
+    std::atomic<bool> _trackRunLoopStats { false };
+    int _environmentDepth { 0 }; // nested doWithEnvironment() calls, only the outermost is timed
+    std::mutex _runLoopStatsMutex;
+    ScriptEngineRunLoopStats _runLoopStats;
+
     static const QString _SETTINGS_ENABLE_EXTENDED_MODULE_COMPAT;
     static const QString _SETTINGS_ENABLE_EXTENDED_EXCEPTIONS;
 
@@ -0,0 +1,158 @@
+//
+//  RecordLog.cpp
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RecordLog.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFileInfo>
+
+#include "SharedLogging.h"
+
+static const QString ROTATED_SUFFIX = ".compacting";
+
+// every record starts with the size (quint32) and checksum (quint16) of its payload
+static const int RECORD_HEADER_SIZE = sizeof(quint32) + sizeof(quint16);
+
+void RecordLog::setPath(const QString& path) {
+    _file.close();
+    _path = path;
+    _rotatedPath = path + ROTATED_SUFFIX;
+}
+
+qint64 RecordLog::read(const ReadPayload& readPayload) const {
+    if (readFile(_rotatedPath, readPayload) < 0) {
+        return -1;
+    }
+    return readFile(_path, readPayload);
+}
+
+bool RecordLog::open(qint64 size) {
+    _file.setFileName(_path);
+    if (!_file.open(QIODevice::ReadWrite | QIODevice::Append)) {
+        qCWarning(shared) << "Failed to open log" << _path;
+        return false;
+    }
+
+    if (_file.size() > size) {
+        _file.resize(size);
+    }
+    return true;
+}
+
+bool RecordLog::append(const QByteArray& payload) {
+    if (!_file.isOpen()) {
+        return false;
+    }
+
+    auto record = frameRecord(payload);
+    qint64 size = _file.size();
+    if (_file.write(record) != record.size() || !_file.flush()) {
+        _file.resize(size);
+        return false;
+    }
+    return true;
+}
+
+bool RecordLog::rotate() {
+    _file.close();
+
+    bool rotated = false;
+    if (QFile::exists(_rotatedPath)) {
+        // the last rotated log wasn't folded in, carry its records over along with ours
+        QFile rotatedFile { _rotatedPath };
+        QFile file { _path };
+        if (rotatedFile.open(QIODevice::Append) && file.open(QIODevice::ReadOnly)) {
+            qint64 rotatedSize = rotatedFile.size();
+            auto data = file.readAll();
+            file.close();
+
+            rotated = rotatedFile.write(data) == data.size() && rotatedFile.flush() && file.remove();
+            if (!rotated) {
+                // don't leave a partial copy behind, it would be read twice
+                rotatedFile.resize(rotatedSize);
+            }
+        }
+    } else {
+        rotated = QFile::rename(_path, _rotatedPath);
+    }
+
+    if (!rotated) {
+        qCWarning(shared) << "Failed to rotate log" << _path;
+        open(QFileInfo(_path).size());
+        return false;
+    }
+
+    return open();
+}
+
+void RecordLog::remove() {
+    _file.close();
+    QFile::remove(_path);
+    QFile::remove(_rotatedPath);
+}
+
+QByteArray RecordLog::frameRecord(const QByteArray& payload) {
+    QByteArray record;
+    record.reserve(RECORD_HEADER_SIZE + payload.size());
+    {
+        QDataStream stream(&record, QIODevice::WriteOnly);
+        stream << (quint32)payload.size() << qChecksum(payload.constData(), payload.size());
+    }
+    record.append(payload);
+    return record;
+}
+
+qint64 RecordLog::readRecords(const QByteArray& data, const ReadPayload& readPayload) {
+    qint64 validSize = 0;
+
+    while (data.size() - validSize >= RECORD_HEADER_SIZE) {
+        quint32 payloadSize;
+        quint16 checksum;
+        {
+            QDataStream stream(data.mid(validSize, RECORD_HEADER_SIZE));
+            stream >> payloadSize >> checksum;
+        }
+
+        if ((quint64)(data.size() - validSize - RECORD_HEADER_SIZE) < payloadSize) {
+            // incomplete record, the write was interrupted
+            break;
+        }
+
+        const char* payload = data.constData() + validSize + RECORD_HEADER_SIZE;
+        if (qChecksum(payload, payloadSize) != checksum ||
+            !readPayload(QByteArray::fromRawData(payload, payloadSize))) {
+            break;
+        }
+
+        validSize += RECORD_HEADER_SIZE + payloadSize;
+    }
+
+    return validSize;
+}
+
+qint64 RecordLog::readFile(const QString& path, const ReadPayload& readPayload) {
+    QFile file { path };
+    if (!file.exists()) {
+        return 0;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(shared) << "Failed to open log" << path;
+        return -1;
+    }
+
+    auto data = file.readAll();
+    qint64 validSize = readRecords(data, readPayload);
+    if (validSize < data.size()) {
+        qCWarning(shared) << "Ignoring" << data.size() - validSize << "bytes of incomplete or corrupt records at the end of"
+            << "log" << path;
+    }
+    return validSize;
+}
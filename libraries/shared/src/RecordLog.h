@@ -0,0 +1,67 @@
+//
+//  RecordLog.h
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RecordLog_h
+#define hifi_RecordLog_h
+
+#include <functional>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+// Append-only file of records, each framed with the size and checksum of its payload, so that a record whose write was
+//   cut off is found and dropped when the file is read back. What the log holds is folded into some other file (a map
+//   file, a snapshot) by rotating the log aside, writing that file in the background and then removing the rotated log.
+//   If that fails, the next rotation appends to the rotated log that is left, so no record is lost or replayed twice.
+//   Not thread-safe.
+class RecordLog {
+public:
+    using ReadPayload = std::function<bool(const QByteArray& payload)>;
+
+    RecordLog() {}
+    RecordLog(const QString& path) { setPath(path); }
+
+    void setPath(const QString& path);
+    const QString& getPath() const { return _path; }
+    const QString& getRotatedPath() const { return _rotatedPath; }
+
+    // calls readPayload with the payload of each complete record of the rotated log, then of the log, stopping at a torn
+    // or corrupt record or when readPayload returns false. Returns the size of the records of the log that were read,
+    // or -1 if a log can't be opened.
+    qint64 read(const ReadPayload& readPayload) const;
+
+    // opens the log for appending, dropping anything past size (a torn record left by the last run)
+    bool open(qint64 size = 0);
+    void close() { _file.close(); }
+    bool isOpen() const { return _file.isOpen(); }
+    qint64 size() const { return _file.size(); }
+
+    // appends payload as a single record, a partial write is cut off so the next record still lines up
+    bool append(const QByteArray& payload);
+
+    // moves the records of the log to the rotated log and opens a new, empty log
+    bool rotate();
+    void removeRotated() { QFile::remove(_rotatedPath); }
+    void remove();
+
+    static QByteArray frameRecord(const QByteArray& payload);
+    // calls readPayload with the payloads of the records in data as read() does, and returns the size of those read
+    static qint64 readRecords(const QByteArray& data, const ReadPayload& readPayload);
+    // like read(), for a single file, returns 0 if it doesn't exist
+    static qint64 readFile(const QString& path, const ReadPayload& readPayload);
+
+private:
+    QString _path;
+    QString _rotatedPath;
+    QFile _file;
+};
+
+#endif // hifi_RecordLog_h
@@ -0,0 +1,102 @@
+//
+//  SPSCQueue.h
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SPSCQueue_h
+#define hifi_SPSCQueue_h
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free FIFO for exactly one producer thread and one consumer thread.
+//   push() may only be called by the producer and pop() by the consumer. The consumer may change threads, as long as
+//   whatever hands it over also synchronizes (a mutex, a thread pool handoff). size() is exact on either side and an
+//   estimate anywhere else.
+template <typename T>
+class SPSCQueue {
+public:
+    // capacity is rounded up to a power of two
+    SPSCQueue(size_t capacity);
+
+    // returns false, leaving value untouched, if the queue is full
+    bool push(T&& value);
+    bool push(const T& value) { return push(T(value)); }
+
+    // returns false if the queue is empty
+    bool pop(T& value);
+
+    size_t size() const {
+        size_t head = _head.load(std::memory_order_acquire); // before the tail, so the tail is never behind it
+        return _tail.load(std::memory_order_acquire) - head;
+    }
+    bool isEmpty() const { return size() == 0; }
+    size_t capacity() const { return _slots.size(); }
+
+private:
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    std::vector<T> _slots;
+    size_t _mask;
+
+    // the indices grow without wrapping (a size_t will not overflow) and are masked into the slots;
+    // each side keeps its own line, with a cached copy of the other side's index to touch it less often
+    std::atomic<size_t> _head { 0 };    // written by the consumer
+    size_t _cachedTail { 0 };
+    char _consumerPadding[CACHE_LINE_SIZE];
+
+    std::atomic<size_t> _tail { 0 };    // written by the producer
+    size_t _cachedHead { 0 };
+    char _producerPadding[CACHE_LINE_SIZE];
+};
+
+template <typename T>
+SPSCQueue<T>::SPSCQueue(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    _slots.resize(size);
+    _mask = size - 1;
+}
+
+template <typename T>
+bool SPSCQueue<T>::push(T&& value) {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _cachedHead == _slots.size()) {
+        _cachedHead = _head.load(std::memory_order_acquire);
+        if (tail - _cachedHead == _slots.size()) {
+            return false;
+        }
+    }
+    _slots[tail & _mask] = std::move(value);
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SPSCQueue<T>::pop(T& value) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _cachedTail) {
+        _cachedTail = _tail.load(std::memory_order_acquire);
+        if (head == _cachedTail) {
+            return false;
+        }
+    }
+    // move out and reset the slot, so it doesn't hold on to resources until it is reused
+    value = std::move(_slots[head & _mask]);
+    _slots[head & _mask] = T();
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+const size_t SPSCQueue<T>::CACHE_LINE_SIZE;
+
+#endif // hifi_SPSCQueue_h
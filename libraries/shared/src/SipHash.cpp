@@ -0,0 +1,94 @@
+//
+//  SipHash.cpp
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+// SipHash is defined on little-endian words; these are single loads/stores on little-endian machines
+static inline uint64_t readLittleEndian(const uint8_t* bytes) {
+    return (uint64_t)bytes[0] | ((uint64_t)bytes[1] << 8) | ((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24) |
+        ((uint64_t)bytes[4] << 32) | ((uint64_t)bytes[5] << 40) | ((uint64_t)bytes[6] << 48) | ((uint64_t)bytes[7] << 56);
+}
+
+static inline void writeLittleEndian(uint64_t value, uint8_t* bytes) {
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+    v0 += v1;
+    v1 = rotateLeft(v1, 13);
+    v1 ^= v0;
+    v0 = rotateLeft(v0, 32);
+    v2 += v3;
+    v3 = rotateLeft(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotateLeft(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotateLeft(v1, 17);
+    v1 ^= v2;
+    v2 = rotateLeft(v2, 32);
+}
+
+SipHash128::SipHash128(const uint8_t* key) {
+    uint64_t k0 = key ? readLittleEndian(key) : 0;
+    uint64_t k1 = key ? readLittleEndian(key + 8) : 0;
+
+    _v0 = k0 ^ 0x736f6d6570736575ULL;
+    _v1 = k1 ^ 0x646f72616e646f6dULL ^ 0xee; // the 128-bit output variant
+    _v2 = k0 ^ 0x6c7967656e657261ULL;
+    _v3 = k1 ^ 0x7465646279746573ULL;
+}
+
+void SipHash128::hash(const uint8_t* data, size_t size, uint8_t* result) const {
+    uint64_t v0 = _v0;
+    uint64_t v1 = _v1;
+    uint64_t v2 = _v2;
+    uint64_t v3 = _v3;
+
+    // compression: two rounds per 8 byte word
+    const uint8_t* end = data + (size & ~(size_t)7);
+    for (; data != end; data += 8) {
+        uint64_t m = readLittleEndian(data);
+        v3 ^= m;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    // the last word holds the remaining bytes, and the length
+    uint64_t last = (uint64_t)size << 56;
+    for (size_t i = 0; i < (size & 7); i++) {
+        last |= (uint64_t)data[i] << (8 * i);
+    }
+    v3 ^= last;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= last;
+
+    // finalization: four rounds per 64 bits of output
+    v2 ^= 0xee;
+    for (int i = 0; i < 4; i++) {
+        sipRound(v0, v1, v2, v3);
+    }
+    writeLittleEndian(v0 ^ v1 ^ v2 ^ v3, result);
+
+    v1 ^= 0xdd;
+    for (int i = 0; i < 4; i++) {
+        sipRound(v0, v1, v2, v3);
+    }
+    writeLittleEndian(v0 ^ v1 ^ v2 ^ v3, result + 8);
+}
@@ -0,0 +1,34 @@
+//
+//  SipHash.h
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <cstddef>
+#include <cstdint>
+
+// SipHash-2-4 with a 128-bit output (Aumasson & Bernstein), a keyed hash that is fast on short inputs.
+//   The key is set up once, when the object is constructed, so it can be kept per key and reused for every message.
+class SipHash128 {
+public:
+    static const int KEY_SIZE = 16;
+    static const int HASH_SIZE = 16;
+
+    SipHash128() : SipHash128(nullptr) {}
+    SipHash128(const uint8_t* key); // KEY_SIZE bytes, or null for a zero key
+
+    // writes HASH_SIZE bytes to result
+    void hash(const uint8_t* data, size_t size, uint8_t* result) const;
+
+private:
+    uint64_t _v0, _v1, _v2, _v3;
+};
+
+#endif // hifi_SipHash_h
@@ -0,0 +1,78 @@
+//
+//  SnapshotPointer.h
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SnapshotPointer_h
+#define hifi_SnapshotPointer_h
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Publishes immutable snapshots of read-mostly state (RCU style): writers build a new snapshot and swap it in,
+//   readers take a reference to whichever snapshot is current and keep it alive for as long as they use it.
+//   Each thread remembers the last snapshot it read, so while nothing is published readers only load a version
+//   and bump a reference count, and never take a lock. Publishing from several threads must be serialized by the caller.
+template <typename T>
+class SnapshotPointer {
+public:
+    using Pointer = std::shared_ptr<const T>;
+
+    SnapshotPointer() { set(std::make_shared<const T>()); }
+    SnapshotPointer(const SnapshotPointer& other) = delete;
+    SnapshotPointer& operator=(const SnapshotPointer& other) = delete;
+
+    Pointer get() const;
+    void set(Pointer snapshot);
+
+    // changes each time a snapshot is published
+    uint64_t getVersion() const { return _version.load(std::memory_order_acquire); }
+
+private:
+    // versions are unique across instances, so a thread's cache can't mistake one for another
+    static std::atomic<uint64_t> _nextVersion;
+
+    Pointer _snapshot;
+    std::atomic<uint64_t> _version { 0 };
+};
+
+template <typename T>
+std::atomic<uint64_t> SnapshotPointer<T>::_nextVersion { 1 };
+
+template <typename T>
+typename SnapshotPointer<T>::Pointer SnapshotPointer<T>::get() const {
+    // the cache is weak, so a thread that stops reading doesn't keep an old snapshot alive
+    struct Cache {
+        uint64_t version { 0 };
+        std::weak_ptr<const T> snapshot;
+    };
+    static thread_local Cache cache;
+
+    uint64_t version = getVersion();
+    if (cache.version == version) {
+        auto snapshot = cache.snapshot.lock();
+        if (snapshot) {
+            return snapshot;
+        }
+    }
+
+    // read the version first: the snapshot loaded is at least that recent, so it is safe to cache under it
+    auto snapshot = std::atomic_load(&_snapshot);
+    cache.version = version;
+    cache.snapshot = snapshot;
+    return snapshot;
+}
+
+template <typename T>
+void SnapshotPointer<T>::set(Pointer snapshot) {
+    std::atomic_store(&_snapshot, std::move(snapshot));
+    _version.store(_nextVersion.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+}
+
+#endif // hifi_SnapshotPointer_h
@@ -0,0 +1,365 @@
+//
+//  TimerWheel.h
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheel_h
+#define hifi_TimerWheel_h
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <QtCore/QHash>
+
+// Hierarchical timing wheel: many timers for the cost of one, fired in batches by whoever owns the wheel.
+//   Time is counted in ticks (the caller picks the unit, usually msecs) and passed in by the caller. The first level
+//   has a slot per tick, each next level a slot per turn of the level below it; timers are filed on the level their
+//   delay falls on and move down a level as the wheel turns to them. So adding, removing and firing a timer are O(1)
+//   however many timers there are. Every timer also has an owner, and all the timers of an owner can be removed in
+//   O(number of its timers).
+template <typename Owner, typename Payload>
+class TimerWheel {
+public:
+    using TimerID = quint64; // 0 is never a valid id, ids fit in the 53 bits of a double
+    using Ticks = quint64;
+
+    static const Ticks NO_EXPIRY = std::numeric_limits<Ticks>::max();
+
+    TimerWheel(Ticks now = 0) : _currentTick(now) { _slotHeads.assign(NUM_SLOTS, NONE); }
+
+    // fires once after delay ticks, or every interval ticks
+    TimerID add(const Owner& owner, const Payload& payload, Ticks now, quint32 delay, bool isSingleShot);
+    bool remove(TimerID id);
+    int removeOwner(const Owner& owner);
+    void clear();
+
+    bool contains(TimerID id) const { return findTimer(id) != NONE; }
+    size_t size() const { return _numTimers; }
+    bool isEmpty() const { return _numTimers == 0; }
+
+    // the earliest tick at which fireDue() may have something to fire, NO_EXPIRY when the wheel is empty
+    Ticks getNextExpiry() const;
+
+    // calls fire(const Payload&) for every timer due at now, in expiry order. A repeating timer that fell more than an
+    //   interval behind fires once and picks up its schedule from now. fire may add and remove timers.
+    template <typename F>
+    int fireDue(Ticks now, F fire);
+
+private:
+    static const quint32 NONE = std::numeric_limits<quint32>::max();
+
+    static const int FIRST_LEVEL_BITS = 8;
+    static const int LEVEL_BITS = 6;
+    static const int NUM_LEVELS = 4;
+    static const int FIRST_LEVEL_SLOTS = 1 << FIRST_LEVEL_BITS;
+    static const int LEVEL_SLOTS = 1 << LEVEL_BITS;
+    static const int NUM_SLOTS = FIRST_LEVEL_SLOTS + (NUM_LEVELS - 1) * LEVEL_SLOTS;
+    static const Ticks MAX_DELAY = ((Ticks)1 << (FIRST_LEVEL_BITS + (NUM_LEVELS - 1) * LEVEL_BITS)) - 1;
+
+    static const int INDEX_BITS = 24;
+    static const quint32 INDEX_MASK = (1 << INDEX_BITS) - 1;
+    static const quint32 GENERATION_MASK = (1 << 29) - 1;
+
+    struct Timer {
+        Payload payload;
+        Owner owner;
+        Ticks expiry { 0 };
+        quint32 interval { 0 };
+        quint32 generation { 0 };
+        int slot { -1 }; // -1 while due or free
+        quint32 previous { NONE };
+        quint32 next { NONE };
+        quint32 previousOfOwner { NONE };
+        quint32 nextOfOwner { NONE };
+        bool isSingleShot { true };
+        bool isUsed { false };
+    };
+
+    static TimerID makeID(quint32 index, quint32 generation) {
+        return ((TimerID)generation << INDEX_BITS) | index;
+    }
+    quint32 findTimer(TimerID id) const;
+
+    void schedule(quint32 index);
+    void unschedule(quint32 index);
+    void release(quint32 index);
+    void cascade(int level);
+
+    std::vector<Timer> _timers;
+    std::vector<quint32> _freeTimers;
+    std::vector<quint32> _slotHeads;
+    QHash<Owner, quint32> _ownerHeads;
+    std::vector<TimerID> _dueTimers;
+    Ticks _currentTick; // the first tick that hasn't been fired yet
+    size_t _numTimers { 0 };
+    quint32 _nextGeneration { 1 };
+};
+
+template <typename Owner, typename Payload>
+const typename TimerWheel<Owner, Payload>::Ticks TimerWheel<Owner, Payload>::NO_EXPIRY;
+template <typename Owner, typename Payload>
+const quint32 TimerWheel<Owner, Payload>::NONE;
+template <typename Owner, typename Payload>
+const typename TimerWheel<Owner, Payload>::Ticks TimerWheel<Owner, Payload>::MAX_DELAY;
+
+template <typename Owner, typename Payload>
+typename TimerWheel<Owner, Payload>::TimerID TimerWheel<Owner, Payload>::add(const Owner& owner, const Payload& payload,
+                                                                              Ticks now, quint32 delay, bool isSingleShot) {
+    quint32 index;
+    if (!_freeTimers.empty()) {
+        index = _freeTimers.back();
+        _freeTimers.pop_back();
+    } else if (_timers.size() < INDEX_MASK) {
+        index = (quint32)_timers.size();
+        _timers.emplace_back();
+    } else {
+        return 0;
+    }
+
+    Timer& timer = _timers[index];
+    timer.payload = payload;
+    timer.owner = owner;
+    timer.expiry = now + delay;
+    timer.interval = delay;
+    timer.isSingleShot = isSingleShot;
+    timer.isUsed = true;
+    timer.generation = _nextGeneration;
+    _nextGeneration = (_nextGeneration & GENERATION_MASK) + 1;
+
+    auto ownerHead = _ownerHeads.find(owner);
+    timer.previousOfOwner = NONE;
+    if (ownerHead != _ownerHeads.end()) {
+        timer.nextOfOwner = ownerHead.value();
+        _timers[ownerHead.value()].previousOfOwner = index;
+        ownerHead.value() = index;
+    } else {
+        timer.nextOfOwner = NONE;
+        _ownerHeads.insert(owner, index);
+    }
+
+    schedule(index);
+    ++_numTimers;
+    return makeID(index, timer.generation);
+}
+
+template <typename Owner, typename Payload>
+bool TimerWheel<Owner, Payload>::remove(TimerID id) {
+    quint32 index = findTimer(id);
+    if (index == NONE) {
+        return false;
+    }
+    release(index);
+    return true;
+}
+
+template <typename Owner, typename Payload>
+int TimerWheel<Owner, Payload>::removeOwner(const Owner& owner) {
+    auto ownerHead = _ownerHeads.find(owner);
+    if (ownerHead == _ownerHeads.end()) {
+        return 0;
+    }
+    int numRemoved = 0;
+    quint32 index = ownerHead.value();
+    while (index != NONE) {
+        quint32 next = _timers[index].nextOfOwner;
+        release(index);
+        index = next;
+        ++numRemoved;
+    }
+    return numRemoved;
+}
+
+template <typename Owner, typename Payload>
+void TimerWheel<Owner, Payload>::clear() {
+    _timers.clear();
+    _freeTimers.clear();
+    _slotHeads.assign(NUM_SLOTS, NONE);
+    _ownerHeads.clear();
+    _numTimers = 0;
+}
+
+template <typename Owner, typename Payload>
+typename TimerWheel<Owner, Payload>::Ticks TimerWheel<Owner, Payload>::getNextExpiry() const {
+    if (_numTimers == 0) {
+        return NO_EXPIRY;
+    }
+    // the timers of the other levels can't be due before the first level turns to its next slot 0
+    Ticks nextTurn = (_currentTick + FIRST_LEVEL_SLOTS - 1) & ~(Ticks)(FIRST_LEVEL_SLOTS - 1);
+    for (Ticks tick = _currentTick; tick < nextTurn; tick++) {
+        if (_slotHeads[tick & (FIRST_LEVEL_SLOTS - 1)] != NONE) {
+            return tick;
+        }
+    }
+    return nextTurn;
+}
+
+template <typename Owner, typename Payload>
+template <typename F>
+int TimerWheel<Owner, Payload>::fireDue(Ticks now, F fire) {
+    // fire() may come back here, so work on our own list
+    std::vector<TimerID> dueTimers;
+    dueTimers.swap(_dueTimers);
+
+    while (_currentTick <= now) {
+        if (_numTimers == 0) {
+            _currentTick = now + 1;
+            break;
+        }
+        int firstLevelSlot = (int)(_currentTick & (FIRST_LEVEL_SLOTS - 1));
+        if (firstLevelSlot == 0) {
+            for (int level = 1; level < NUM_LEVELS; level++) {
+                int shift = FIRST_LEVEL_BITS + (level - 1) * LEVEL_BITS;
+                int slot = (int)((_currentTick >> shift) & (LEVEL_SLOTS - 1));
+                cascade(level);
+                if (slot != 0) {
+                    break;
+                }
+            }
+        }
+
+        // slots are filed newest first, fire them oldest first
+        size_t firstDue = dueTimers.size();
+        quint32 index = _slotHeads[firstLevelSlot];
+        _slotHeads[firstLevelSlot] = NONE;
+        while (index != NONE) {
+            Timer& timer = _timers[index];
+            timer.slot = -1;
+            dueTimers.push_back(makeID(index, timer.generation));
+            index = timer.next;
+        }
+        std::reverse(dueTimers.begin() + firstDue, dueTimers.end());
+        ++_currentTick;
+    }
+
+    int numFired = 0;
+    for (auto id = dueTimers.begin(); id != dueTimers.end(); ++id) {
+        quint32 index = findTimer(*id);
+        if (index == NONE || _timers[index].slot != -1) {
+            continue; // removed, or removed and added again, by an earlier timer
+        }
+        Timer& timer = _timers[index];
+        if (timer.isSingleShot) {
+            Payload payload = timer.payload;
+            release(index);
+            fire(payload);
+        } else {
+            timer.expiry += std::max(timer.interval, (quint32)1);
+            if (timer.expiry <= now) {
+                timer.expiry = now + timer.interval;
+            }
+            schedule(index);
+            Payload payload = timer.payload;
+            fire(payload);
+        }
+        ++numFired;
+    }
+
+    dueTimers.clear();
+    if (_dueTimers.empty()) {
+        _dueTimers.swap(dueTimers);
+    }
+    return numFired;
+}
+
+template <typename Owner, typename Payload>
+quint32 TimerWheel<Owner, Payload>::findTimer(TimerID id) const {
+    quint32 index = (quint32)(id & INDEX_MASK);
+    if (index >= _timers.size()) {
+        return NONE;
+    }
+    const Timer& timer = _timers[index];
+    if (!timer.isUsed || makeID(index, timer.generation) != id) {
+        return NONE;
+    }
+    return index;
+}
+
+template <typename Owner, typename Payload>
+void TimerWheel<Owner, Payload>::schedule(quint32 index) {
+    Timer& timer = _timers[index];
+    Ticks expiry = std::max(timer.expiry, _currentTick);
+    Ticks delay = std::min(expiry - _currentTick, MAX_DELAY);
+    expiry = _currentTick + delay;
+
+    int slot;
+    if (delay < FIRST_LEVEL_SLOTS) {
+        slot = (int)(expiry & (FIRST_LEVEL_SLOTS - 1));
+    } else {
+        int level = 1;
+        while (delay >= ((Ticks)1 << (FIRST_LEVEL_BITS + level * LEVEL_BITS))) {
+            ++level;
+        }
+        int shift = FIRST_LEVEL_BITS + (level - 1) * LEVEL_BITS;
+        slot = FIRST_LEVEL_SLOTS + (level - 1) * LEVEL_SLOTS + (int)((expiry >> shift) & (LEVEL_SLOTS - 1));
+    }
+
+    timer.slot = slot;
+    timer.previous = NONE;
+    timer.next = _slotHeads[slot];
+    if (timer.next != NONE) {
+        _timers[timer.next].previous = index;
+    }
+    _slotHeads[slot] = index;
+}
+
+template <typename Owner, typename Payload>
+void TimerWheel<Owner, Payload>::unschedule(quint32 index) {
+    Timer& timer = _timers[index];
+    if (timer.slot == -1) {
+        return;
+    }
+    if (timer.previous != NONE) {
+        _timers[timer.previous].next = timer.next;
+    } else {
+        _slotHeads[timer.slot] = timer.next;
+    }
+    if (timer.next != NONE) {
+        _timers[timer.next].previous = timer.previous;
+    }
+    timer.slot = -1;
+}
+
+template <typename Owner, typename Payload>
+void TimerWheel<Owner, Payload>::release(quint32 index) {
+    unschedule(index);
+
+    Timer& timer = _timers[index];
+    if (timer.previousOfOwner != NONE) {
+        _timers[timer.previousOfOwner].nextOfOwner = timer.nextOfOwner;
+    } else if (timer.nextOfOwner != NONE) {
+        _ownerHeads[timer.owner] = timer.nextOfOwner;
+    } else {
+        _ownerHeads.remove(timer.owner);
+    }
+    if (timer.nextOfOwner != NONE) {
+        _timers[timer.nextOfOwner].previousOfOwner = timer.previousOfOwner;
+    }
+
+    timer.payload = Payload();
+    timer.owner = Owner();
+    timer.isUsed = false;
+    _freeTimers.push_back(index);
+    --_numTimers;
+}
+
+template <typename Owner, typename Payload>
+void TimerWheel<Owner, Payload>::cascade(int level) {
+    // file the timers of the slot the wheel just turned to on the levels below
+    int shift = FIRST_LEVEL_BITS + (level - 1) * LEVEL_BITS;
+    int slot = FIRST_LEVEL_SLOTS + (level - 1) * LEVEL_SLOTS + (int)((_currentTick >> shift) & (LEVEL_SLOTS - 1));
+    quint32 index = _slotHeads[slot];
+    _slotHeads[slot] = NONE;
+    while (index != NONE) {
+        quint32 next = _timers[index].next;
+        schedule(index);
+        index = next;
+    }
+}
+
+#endif // hifi_TimerWheel_h
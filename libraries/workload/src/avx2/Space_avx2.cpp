@@ -0,0 +1,58 @@
+//
+//  Space_avx2.cpp
+//  libraries/workload/src/avx2
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+#include "../workload/Space.h"
+
+using namespace workload;
+
+// 8 proxies at a time, see classifyRegions_SSE
+uint32_t classifyRegions_AVX2(const float* centersX, const float* centersY, const float* centersZ,
+                              const float* radiuses, uint32_t numProxies,
+                              const Space::View* views, uint32_t numViews, uint8_t* newRegions) {
+    const __m256 unknown = _mm256_set1_ps((float)Space::REGION_UNKNOWN);
+
+    uint32_t numVectorized = numProxies & ~7u;
+    for (uint32_t i = 0; i < numVectorized; i += 8) {
+        __m256 x = _mm256_loadu_ps(&centersX[i]);
+        __m256 y = _mm256_loadu_ps(&centersY[i]);
+        __m256 z = _mm256_loadu_ps(&centersZ[i]);
+        __m256 r = _mm256_loadu_ps(&radiuses[i]);
+
+        __m256 region = unknown;
+        for (uint32_t j = 0; j < numViews; ++j) {
+            __m256 dx = _mm256_sub_ps(_mm256_set1_ps(views[j].center.x), x);
+            __m256 dy = _mm256_sub_ps(_mm256_set1_ps(views[j].center.y), y);
+            __m256 dz = _mm256_sub_ps(_mm256_set1_ps(views[j].center.z), z);
+            __m256 distance2 = _mm256_fmadd_ps(dz, dz, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx)));
+
+            for (int c = 0; c < Space::REGION_UNKNOWN; ++c) {
+                __m256 touchDistance = _mm256_add_ps(_mm256_set1_ps(views[j].radiuses[c]), r);
+                __m256 touches = _mm256_cmp_ps(distance2, _mm256_mul_ps(touchDistance, touchDistance), _CMP_LT_OQ);
+                region = _mm256_min_ps(region, _mm256_blendv_ps(unknown, _mm256_set1_ps((float)c), touches));
+            }
+        }
+
+        // 8 x int32 to 8 x uint8
+        __m256i regions = _mm256_cvttps_epi32(region);
+        __m128i lo = _mm256_castsi256_si128(regions);
+        __m128i hi = _mm256_extracti128_si256(regions, 1);
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+        _mm_storel_epi64((__m128i*)&newRegions[i], packed);
+    }
+
+    _mm256_zeroupper();
+    return numVectorized;
+}
+
+#endif
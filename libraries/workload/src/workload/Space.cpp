@@ -15,80 +15,232 @@
 #include "Space.h"
 
 #include <algorithm>
+#include <string.h>
 
 #include <glm/gtx/quaternion.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <CPUDetect.h>
+
 using namespace workload;
 
+// below this many proxies the classification runs on the calling thread
+static const uint32_t MIN_PROXIES_FOR_PARALLEL_CATEGORIZE = 16384;
+// proxies per parallel chunk, a multiple of the widest kernel
+static const uint32_t PROXIES_PER_CHUNK = 8192;
+
+//
+// Region classification kernels
+//
+// Each kernel writes the region of proxies [0, numProxies) against all the views to newRegions, and returns how many
+// it did: the rest (fewer than its width) are left to the scalar code. The region is the smallest c for which the
+// proxy touches radiuses[c] of any view, or REGION_UNKNOWN.
+//
+
+static void classifyRegion(const float* centersX, const float* centersY, const float* centersZ, const float* radiuses,
+                           uint32_t i, const Space::View* views, uint32_t numViews, uint8_t* newRegions) {
+    uint8_t region = Space::REGION_UNKNOWN;
+    for (uint32_t j = 0; j < numViews; ++j) {
+        float dx = views[j].center.x - centersX[i];
+        float dy = views[j].center.y - centersY[i];
+        float dz = views[j].center.z - centersZ[i];
+        float distance2 = dx * dx + dy * dy + dz * dz;
+        for (uint8_t c = 0; c < region; ++c) {
+            float touchDistance = views[j].radiuses[c] + radiuses[i];
+            if (distance2 < touchDistance * touchDistance) {
+                region = c;
+                break;
+            }
+        }
+    }
+    newRegions[i] = region;
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+static uint32_t classifyRegions_SSE(const float* centersX, const float* centersY, const float* centersZ,
+                                    const float* radiuses, uint32_t numProxies,
+                                    const Space::View* views, uint32_t numViews, uint8_t* newRegions) {
+    const __m128 unknown = _mm_set1_ps((float)Space::REGION_UNKNOWN);
+
+    uint32_t numVectorized = numProxies & ~3u;
+    for (uint32_t i = 0; i < numVectorized; i += 4) {
+        __m128 x = _mm_loadu_ps(&centersX[i]);
+        __m128 y = _mm_loadu_ps(&centersY[i]);
+        __m128 z = _mm_loadu_ps(&centersZ[i]);
+        __m128 r = _mm_loadu_ps(&radiuses[i]);
+
+        __m128 region = unknown;
+        for (uint32_t j = 0; j < numViews; ++j) {
+            __m128 dx = _mm_sub_ps(_mm_set1_ps(views[j].center.x), x);
+            __m128 dy = _mm_sub_ps(_mm_set1_ps(views[j].center.y), y);
+            __m128 dz = _mm_sub_ps(_mm_set1_ps(views[j].center.z), z);
+            __m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+            // the smallest touching region wins, so it is enough to take the min over every (view, region) pair
+            for (int c = 0; c < Space::REGION_UNKNOWN; ++c) {
+                __m128 touchDistance = _mm_add_ps(_mm_set1_ps(views[j].radiuses[c]), r);
+                __m128 touches = _mm_cmplt_ps(distance2, _mm_mul_ps(touchDistance, touchDistance));
+                __m128 candidate = _mm_or_ps(_mm_and_ps(touches, _mm_set1_ps((float)c)), _mm_andnot_ps(touches, unknown));
+                region = _mm_min_ps(region, candidate);
+            }
+        }
+
+        __m128i regions = _mm_cvttps_epi32(region);
+        regions = _mm_packs_epi32(regions, regions);
+        regions = _mm_packus_epi16(regions, regions);
+        int32_t packed = _mm_cvtsi128_si32(regions);
+        memcpy(&newRegions[i], &packed, sizeof(packed));
+    }
+    return numVectorized;
+}
+
+//
+// Runtime CPU dispatch
+//
+
+uint32_t classifyRegions_AVX2(const float* centersX, const float* centersY, const float* centersZ,
+                              const float* radiuses, uint32_t numProxies,
+                              const Space::View* views, uint32_t numViews, uint8_t* newRegions);
+
+static uint32_t classifyRegions(const float* centersX, const float* centersY, const float* centersZ,
+                                const float* radiuses, uint32_t numProxies,
+                                const Space::View* views, uint32_t numViews, uint8_t* newRegions) {
+
+    static auto f = cpuSupportsAVX2() ? classifyRegions_AVX2 : classifyRegions_SSE;
+    return (*f)(centersX, centersY, centersZ, radiuses, numProxies, views, numViews, newRegions); // dispatch
+}
+
+#else   // portable reference code
+
+static uint32_t classifyRegions(const float* centersX, const float* centersY, const float* centersZ,
+                                const float* radiuses, uint32_t numProxies,
+                                const Space::View* views, uint32_t numViews, uint8_t* newRegions) {
+    return 0;
+}
+
+#endif
+
 int32_t Space::createProxy(const Space::Sphere& newSphere) {
+    int32_t index;
     if (_freeIndices.empty()) {
-        _proxies.emplace_back(Space::Proxy(newSphere));
-        return (int32_t)_proxies.size() - 1;
+        index = (int32_t)_regions.size();
+        resizeProxies((uint32_t)index + 1);
     } else {
-        int32_t index = _freeIndices.back();
+        index = _freeIndices.back();
         _freeIndices.pop_back();
-        _proxies[index].sphere = newSphere;
-        _proxies[index].region = Space::REGION_UNKNOWN;
-        _proxies[index].prevRegion = Space::REGION_UNKNOWN;
-        return index;
     }
+    _centersX[index] = newSphere.x;
+    _centersY[index] = newSphere.y;
+    _centersZ[index] = newSphere.z;
+    _radiuses[index] = newSphere.w;
+    _regions[index] = Space::REGION_UNKNOWN;
+    _prevRegions[index] = Space::REGION_UNKNOWN;
+    return index;
 }
 
 void Space::deleteProxy(int32_t proxyId) {
-    if (proxyId >= (int32_t)_proxies.size() || _proxies.empty()) {
+    if (proxyId >= (int32_t)_regions.size() || _regions.empty()) {
         return;
     }
-    if (proxyId == (int32_t)_proxies.size() - 1) {
+    if (proxyId == (int32_t)_regions.size() - 1) {
         // remove proxy on back
-        _proxies.pop_back();
+        uint32_t numProxies = (uint32_t)_regions.size() - 1;
         if (!_freeIndices.empty()) {
             // remove any freeIndices on back
             std::sort(_freeIndices.begin(), _freeIndices.end());
-            while(!_freeIndices.empty() && _freeIndices.back() == (int32_t)_proxies.size() - 1) {
+            while(!_freeIndices.empty() && _freeIndices.back() == (int32_t)numProxies - 1) {
                 _freeIndices.pop_back();
-                _proxies.pop_back();
+                --numProxies;
             }
         }
+        resizeProxies(numProxies);
     } else {
-        _proxies[proxyId].region = Space::REGION_INVALID;
+        _regions[proxyId] = Space::REGION_INVALID;
         _freeIndices.push_back(proxyId);
     }
 }
 
 void Space::updateProxy(int32_t proxyId, const Space::Sphere& newSphere) {
-    if (proxyId >= (int32_t)_proxies.size()) {
+    if (proxyId >= (int32_t)_regions.size()) {
         return;
     }
-    _proxies[proxyId].sphere = newSphere;
+    _centersX[proxyId] = newSphere.x;
+    _centersY[proxyId] = newSphere.y;
+    _centersZ[proxyId] = newSphere.z;
+    _radiuses[proxyId] = newSphere.w;
 }
 
 void Space::setViews(const std::vector<Space::View>& views) {
     _views = views;
 }
 
-void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
-    uint32_t numProxies = (uint32_t)_proxies.size();
+void Space::resizeProxies(uint32_t numProxies) {
+    _centersX.resize(numProxies);
+    _centersY.resize(numProxies);
+    _centersZ.resize(numProxies);
+    _radiuses.resize(numProxies);
+    _regions.resize(numProxies);
+    _prevRegions.resize(numProxies);
+}
+
+void Space::categorizeRange(uint32_t begin, uint32_t end, std::vector<Space::Change>& changes) {
     uint32_t numViews = (uint32_t)_views.size();
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        Proxy& proxy = _proxies[i];
-        if (proxy.region < Space::REGION_INVALID) {
-            uint8_t region = Space::REGION_UNKNOWN;
-            for (uint32_t j = 0; j < numViews; ++j) {
-                float distance2 = glm::distance2(_views[j].center, glm::vec3(_proxies[i].sphere));
-                for (uint8_t c = 0; c < region; ++c) {
-                    float touchDistance = _views[j].radiuses[c] + _proxies[i].sphere.w;
-                    if (distance2 < touchDistance * touchDistance) {
-                        region = c;
-                        break;
-                    }
-                }
-            }
-            proxy.prevRegion = proxy.region;
-            proxy.region = region;
-            if (proxy.region != proxy.prevRegion) {
-                changes.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
+    uint8_t* newRegions = _newRegions.data();
+
+    // the kernels classify the range as if it started at 0, then the scalar code takes the remainder
+    uint32_t numClassified = classifyRegions(&_centersX[begin], &_centersY[begin], &_centersZ[begin], &_radiuses[begin],
+                                             end - begin, _views.data(), numViews, &newRegions[begin]);
+    for (uint32_t i = begin + numClassified; i < end; ++i) {
+        classifyRegion(_centersX.data(), _centersY.data(), _centersZ.data(), _radiuses.data(), i,
+                       _views.data(), numViews, newRegions);
+    }
+
+    for (uint32_t i = begin; i < end; ++i) {
+        if (_regions[i] < Space::REGION_INVALID) {
+            _prevRegions[i] = _regions[i];
+            _regions[i] = newRegions[i];
+            if (_regions[i] != _prevRegions[i]) {
+                changes.emplace_back(Space::Change((int32_t)i, _regions[i], _prevRegions[i]));
             }
         }
     }
 }
 
+void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
+    uint32_t numProxies = (uint32_t)_regions.size();
+    _newRegions.resize(numProxies);
+
+    if (numProxies < MIN_PROXIES_FOR_PARALLEL_CATEGORIZE) {
+        categorizeRange(0, numProxies, changes);
+        return;
+    }
+
+    // classify the chunks in parallel, each into its own changes, then merge them in order
+    uint32_t numChunks = (numProxies + PROXIES_PER_CHUNK - 1) / PROXIES_PER_CHUNK;
+    _chunkChanges.resize(numChunks);
+    tbb::parallel_for(tbb::blocked_range<uint32_t>(0, numChunks), [&](const tbb::blocked_range<uint32_t>& range) {
+        for (uint32_t chunk = range.begin(); chunk != range.end(); ++chunk) {
+            uint32_t begin = chunk * PROXIES_PER_CHUNK;
+            uint32_t end = std::min(begin + PROXIES_PER_CHUNK, numProxies);
+            _chunkChanges[chunk].clear();
+            categorizeRange(begin, end, _chunkChanges[chunk]);
+        }
+    });
+
+    size_t numChanges = changes.size();
+    for (uint32_t chunk = 0; chunk < numChunks; ++chunk) {
+        numChanges += _chunkChanges[chunk].size();
+    }
+    changes.reserve(numChanges);
+    for (uint32_t chunk = 0; chunk < numChunks; ++chunk) {
+        changes.insert(changes.end(), _chunkChanges[chunk].begin(), _chunkChanges[chunk].end());
+    }
+}
@@ -64,14 +64,27 @@ public:
     void updateProxy(int32_t proxyId, const Sphere& sphere);
     void setViews(const std::vector<View>& views);
 
-    uint32_t getNumObjects() const { return (uint32_t)(_proxies.size() - _freeIndices.size()); }
+    uint32_t getNumObjects() const { return (uint32_t)(_regions.size() - _freeIndices.size()); }
 
     void categorizeAndGetChanges(std::vector<Change>& changes);
 
 private:
-    std::vector<Proxy> _proxies;
+    void resizeProxies(uint32_t numProxies);
+    void categorizeRange(uint32_t begin, uint32_t end, std::vector<Change>& changes);
+
+    // proxies are stored as a structure of arrays, so the region classification can be vectorized
+    std::vector<float> _centersX;
+    std::vector<float> _centersY;
+    std::vector<float> _centersZ;
+    std::vector<float> _radiuses;
+    std::vector<uint8_t> _regions;
+    std::vector<uint8_t> _prevRegions;
+
     std::vector<View> _views;
     std::vector<int32_t> _freeIndices;
+
+    std::vector<uint8_t> _newRegions; // scratch for the classification kernels
+    std::vector<std::vector<Change>> _chunkChanges; // scratch for the parallel classification
 };
 
 } // namespace workload
@@ -0,0 +1,112 @@
+//
+//  AudioHRTFTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioHRTFTests.h"
+
+#include <math.h>
+#include <vector>
+
+#include <AudioHRTF.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioHRTFTests)
+
+const int HRTF_INDEX = 1;
+const int STEREO_BLOCK = 2 * HRTF_BLOCK;
+
+float randomFloat() {
+    return (float)rand() / (float)RAND_MAX;
+}
+
+void randomSources(std::vector<AudioHRTF>& hrtfs, std::vector<int16_t>& inputs, std::vector<AudioHRTF::Source>& sources) {
+    int numSources = (int)hrtfs.size();
+    inputs.resize(numSources * HRTF_BLOCK);
+    for (auto& sample : inputs) {
+        sample = (int16_t)(rand() % 20000 - 10000);
+    }
+
+    sources.resize(numSources);
+    for (int i = 0; i < numSources; i++) {
+        sources[i].hrtf = &hrtfs[i];
+        sources[i].input = &inputs[i * HRTF_BLOCK];
+        sources[i].azimuth = TWO_PI * randomFloat() - PI;
+        sources[i].distance = 0.2f + 10.0f * randomFloat();   // near and far field
+        sources[i].gain = randomFloat();
+    }
+}
+
+void AudioHRTFTests::testRenderBatch() {
+    const int NUM_BLOCKS = 16;
+    const float EPSILON = 1.0e-4f;
+
+    srand(1);
+    for (int numSources : { 1, 2, 5, 32 }) {
+        std::vector<AudioHRTF> singleHRTFs(numSources);
+        std::vector<AudioHRTF> batchHRTFs(numSources);
+
+        for (int block = 0; block < NUM_BLOCKS; block++) {
+            std::vector<int16_t> inputs;
+            std::vector<AudioHRTF::Source> sources;
+            randomSources(batchHRTFs, inputs, sources);
+
+            float singleOutput[STEREO_BLOCK] = {};
+            float batchOutput[STEREO_BLOCK] = {};
+
+            for (auto& source : sources) {
+                auto& hrtf = singleHRTFs[source.hrtf - batchHRTFs.data()];
+                hrtf.render(source.input, singleOutput, HRTF_INDEX, source.azimuth, source.distance, source.gain, HRTF_BLOCK);
+            }
+            AudioHRTF::renderBatch(sources.data(), numSources, batchOutput, HRTF_INDEX, HRTF_BLOCK);
+
+            // the same mix, up to the order of accumulation
+            for (int i = 0; i < STEREO_BLOCK; i++) {
+                QVERIFY(fabsf(singleOutput[i] - batchOutput[i]) < EPSILON * numSources);
+            }
+        }
+    }
+}
+
+#ifdef MANUAL_TEST
+
+void AudioHRTFTests::benchmarkRenderBatch() {
+    const int NUM_SOURCE_BLOCKS = 100000;
+
+    srand(1);
+    for (int numSources : { 1, 8, 32, 128 }) {
+        std::vector<AudioHRTF> hrtfs(numSources);
+        std::vector<int16_t> inputs;
+        std::vector<AudioHRTF::Source> sources;
+        randomSources(hrtfs, inputs, sources);
+
+        float output[STEREO_BLOCK] = {};
+        int numBlocks = NUM_SOURCE_BLOCKS / numSources;
+
+        uint64_t startTime = usecTimestampNow();
+        for (int block = 0; block < numBlocks; block++) {
+            for (auto& source : sources) {
+                source.hrtf->render(source.input, output, HRTF_INDEX, source.azimuth, source.distance, source.gain, HRTF_BLOCK);
+            }
+        }
+        uint64_t singleTime = usecTimestampNow() - startTime;
+
+        startTime = usecTimestampNow();
+        for (int block = 0; block < numBlocks; block++) {
+            AudioHRTF::renderBatch(sources.data(), numSources, output, HRTF_INDEX, HRTF_BLOCK);
+        }
+        uint64_t batchTime = usecTimestampNow() - startTime;
+
+        qDebug() << "numSources =" << numSources
+            << "render:" << (float)singleTime / (float)(numBlocks * numSources) << "usec/source"
+            << "renderBatch:" << (float)batchTime / (float)(numBlocks * numSources) << "usec/source";
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,28 @@
+//
+//  AudioHRTFTests.h
+//  tests/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioHRTFTests_h
+#define hifi_AudioHRTFTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class AudioHRTFTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRenderBatch();
+#ifdef MANUAL_TEST
+    void benchmarkRenderBatch();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_AudioHRTFTests_h
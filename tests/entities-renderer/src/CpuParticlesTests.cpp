@@ -0,0 +1,214 @@
+//
+//  CpuParticlesTests.cpp
+//  tests/entities-renderer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CpuParticlesTests.h"
+
+#include <deque>
+#include <random>
+
+#include <CpuParticles.h>
+#include <PortableHighResolutionClock.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(CpuParticlesTests)
+
+using namespace render::entities;
+using GpuParticle = CpuParticles::GpuParticle;
+
+// the array-of-structures particle the renderer used to step one at a time, to check against
+struct ReferenceParticle {
+    float seed { 0.0f };
+    uint64_t expiration { 0 };
+    float lifetime { 0.0f };
+    glm::vec3 position;
+    glm::vec3 velocity;
+    glm::vec3 acceleration;
+
+    void integrate(float deltaTime) {
+        glm::vec3 atSquared = (0.5f * deltaTime * deltaTime) * acceleration;
+        position += velocity * deltaTime + atSquared;
+        velocity += acceleration * deltaTime;
+        lifetime += deltaTime;
+    }
+};
+
+using ReferenceParticles = std::deque<ReferenceParticle>;
+
+const float DELTA_TIME = 1.0f / 60.0f;
+const float TOLERANCE = 1.0e-5f;
+
+static ReferenceParticle randomParticle(std::mt19937& random, uint64_t expiration) {
+    std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+    ReferenceParticle particle;
+    particle.seed = distribution(random) / 10.0f;
+    particle.expiration = expiration;
+    particle.position = glm::vec3(distribution(random), distribution(random), distribution(random));
+    particle.velocity = glm::vec3(distribution(random), distribution(random), distribution(random));
+    particle.acceleration = glm::vec3(distribution(random), distribution(random), distribution(random));
+    return particle;
+}
+
+static void push(CpuParticles& particles, ReferenceParticles& reference, const ReferenceParticle& particle) {
+    particles.push(particle.position, particle.velocity, particle.acceleration, particle.seed, particle.expiration);
+    reference.push_back(particle);
+}
+
+static void step(CpuParticles& particles, ReferenceParticles& reference) {
+    particles.integrate(DELTA_TIME);
+    for (auto& particle : reference) {
+        particle.integrate(DELTA_TIME);
+    }
+}
+
+static std::vector<GpuParticle> gpuParticles(const CpuParticles& particles) {
+    std::vector<GpuParticle> result(particles.size());
+    if (!result.empty()) {
+        particles.writeGpuParticles(result.data());
+    }
+    return result;
+}
+
+#define COMPARE_PARTICLES(particles, reference) \
+do { \
+    QCOMPARE((particles).size(), (reference).size()); \
+    auto written = gpuParticles(particles); \
+    for (size_t i = 0; i < written.size(); i++) { \
+        QCOMPARE_WITH_ABS_ERROR(written[i].xyz, (reference)[i].position, TOLERANCE); \
+        QCOMPARE_WITH_ABS_ERROR(written[i].uv.x, (reference)[i].lifetime, TOLERANCE); \
+        QCOMPARE(written[i].uv.y, (reference)[i].seed); \
+    } \
+} while (0)
+
+void CpuParticlesTests::testIntegrate() {
+    // not a multiple of the SIMD width, so the scalar tail is covered too
+    const int NUM_PARTICLES = 1003;
+    const int NUM_STEPS = 30;
+    std::mt19937 random(1);
+
+    CpuParticles particles;
+    ReferenceParticles reference;
+    QVERIFY(particles.empty());
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        push(particles, reference, randomParticle(random, i));
+    }
+
+    for (int i = 0; i < NUM_STEPS; i++) {
+        step(particles, reference);
+    }
+    COMPARE_PARTICLES(particles, reference);
+}
+
+void CpuParticlesTests::testExpireAcrossWrap() {
+    std::mt19937 random(2);
+    CpuParticles particles;
+    ReferenceParticles reference;
+    uint64_t nextExpiration = 0;
+
+    auto expire = [&](uint64_t now) {
+        particles.expire(now, (size_t)-1);
+        while (!reference.empty() && reference.front().expiration <= now) {
+            reference.pop_front();
+        }
+    };
+
+    // fill the initial capacity, then expire the older ones so the head moves along
+    for (int i = 0; i < 64; i++) {
+        push(particles, reference, randomParticle(random, nextExpiration++));
+    }
+    step(particles, reference);
+    expire(39);
+    QCOMPARE(particles.size(), (size_t)24);
+
+    // these wrap around to the start of the ring
+    for (int i = 0; i < 30; i++) {
+        push(particles, reference, randomParticle(random, nextExpiration++));
+    }
+    step(particles, reference);
+    COMPARE_PARTICLES(particles, reference);
+
+    // and these make it grow while it's wrapped, which must keep them in order
+    for (int i = 0; i < 50; i++) {
+        push(particles, reference, randomParticle(random, nextExpiration++));
+    }
+    step(particles, reference);
+    COMPARE_PARTICLES(particles, reference);
+
+    expire(100);
+    step(particles, reference);
+    COMPARE_PARTICLES(particles, reference);
+
+    expire(nextExpiration);
+    QVERIFY(particles.empty());
+}
+
+void CpuParticlesTests::testMaxParticles() {
+    std::mt19937 random(3);
+    CpuParticles particles;
+    ReferenceParticles reference;
+    for (int i = 0; i < 100; i++) {
+        push(particles, reference, randomParticle(random, 1000 + i));
+    }
+
+    // the oldest go first
+    particles.expire(0, 10);
+    reference.erase(reference.begin(), reference.begin() + 90);
+    COMPARE_PARTICLES(particles, reference);
+
+    particles.clear();
+    QVERIFY(particles.empty());
+}
+
+#ifdef MANUAL_TEST
+
+// one frame of an emitter: step every particle and write them all out for the GPU, the old way and the new
+void CpuParticlesTests::benchmarkStep() {
+    const int NUM_FRAMES = 100;
+    std::mt19937 random(4);
+
+    for (int numParticles : { 1000, 10000, 100000 }) {
+        CpuParticles particles;
+        ReferenceParticles reference;
+        for (int i = 0; i < numParticles; i++) {
+            push(particles, reference, randomParticle(random, i));
+        }
+
+        std::vector<GpuParticle> written(numParticles);
+        auto startTime = p_high_resolution_clock::now();
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            particles.integrate(DELTA_TIME);
+            particles.writeGpuParticles(written.data());
+        }
+        auto soaTime = p_high_resolution_clock::now() - startTime;
+
+        std::vector<GpuParticle> transformed;
+        startTime = p_high_resolution_clock::now();
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            for (auto& particle : reference) {
+                particle.integrate(DELTA_TIME);
+            }
+            transformed.clear();
+            transformed.reserve(reference.size());
+            std::transform(reference.begin(), reference.end(), std::back_inserter(transformed), [](const ReferenceParticle& particle) {
+                return GpuParticle { particle.position, glm::vec2(particle.lifetime, particle.seed) };
+            });
+        }
+        auto aosTime = p_high_resolution_clock::now() - startTime;
+
+        auto usecsPerFrame = [&](p_high_resolution_clock::duration duration) {
+            return (float)std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / (float)NUM_FRAMES;
+        };
+        qDebug() << numParticles << "particles: structure of arrays" << usecsPerFrame(soaTime) << "us,"
+            << "deque of structures" << usecsPerFrame(aosTime) << "us per frame";
+    }
+}
+
+#endif // MANUAL_TEST
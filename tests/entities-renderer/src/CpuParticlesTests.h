@@ -0,0 +1,30 @@
+//
+//  CpuParticlesTests.h
+//  tests/entities-renderer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CpuParticlesTests_h
+#define hifi_CpuParticlesTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class CpuParticlesTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testIntegrate();
+    void testExpireAcrossWrap();
+    void testMaxParticles();
+#ifdef MANUAL_TEST
+    void benchmarkStep();
+#endif
+};
+
+#endif // hifi_CpuParticlesTests_h
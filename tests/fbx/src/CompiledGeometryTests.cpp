@@ -0,0 +1,368 @@
+//
+//  CompiledGeometryTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CompiledGeometryTests.h"
+
+#include <cstring>
+#include <limits>
+
+#include <QtCore/QTemporaryFile>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <CompiledGeometry.h>
+#include <FBXReader.h>
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+
+#ifdef MANUAL_TEST
+#include <algorithm>
+#include <memory>
+
+#include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
+#endif
+
+QTEST_MAIN(CompiledGeometryTests)
+
+static FBXJoint makeJoint(const QString& name, int parentIndex) {
+    FBXJoint joint;
+    joint.shapeInfo.avgPoint = glm::vec3(0.1f, 0.2f, 0.3f);
+    joint.shapeInfo.dots = { 0.5f, 0.25f };
+    joint.shapeInfo.points = { glm::vec3(1.0f), glm::vec3(-1.0f) };
+    joint.freeLineage = { parentIndex, -1 };
+    joint.isFree = true;
+    joint.parentIndex = parentIndex;
+    joint.distanceToParent = 1.5f;
+    joint.translation = glm::vec3(1.0f, 2.0f, 3.0f);
+    joint.preTransform = glm::translate(glm::mat4(), glm::vec3(0.0f, 1.0f, 0.0f));
+    joint.preRotation = glm::angleAxis(0.25f, Vectors::UNIT_X);
+    joint.rotation = glm::angleAxis(0.5f, Vectors::UNIT_Y);
+    joint.postRotation = glm::angleAxis(0.75f, Vectors::UNIT_Z);
+    joint.postTransform = glm::scale(glm::mat4(), glm::vec3(2.0f));
+    joint.transform = glm::translate(glm::mat4(), joint.translation);
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.inverseDefaultRotation = glm::inverse(joint.rotation);
+    joint.inverseBindRotation = glm::inverse(joint.preRotation);
+    joint.bindTransform = glm::inverse(joint.transform);
+    joint.name = name;
+    joint.isSkeletonJoint = true;
+    joint.bindTransformFoundInCluster = false;
+    joint.hasGeometricOffset = true;
+    joint.geometricTranslation = glm::vec3(0.0f, 0.0f, 1.0f);
+    joint.geometricRotation = glm::angleAxis(1.0f, Vectors::UNIT_X);
+    joint.geometricScaling = glm::vec3(1.0f, 2.0f, 1.0f);
+    return joint;
+}
+
+static FBXMaterial makeMaterial(const QString& id) {
+    FBXMaterial material(glm::vec3(0.8f, 0.2f, 0.1f), glm::vec3(0.5f), glm::vec3(0.1f), 40.0f, 0.5f);
+    material.materialID = id;
+    material.name = "material " + id;
+    material.albedoTexture.name = "albedo";
+    material.albedoTexture.filename = "textures/albedo.png";
+    material.albedoTexture.transform.setScale(glm::vec3(2.0f, 2.0f, 1.0f));
+    material.albedoTexture.texcoordSet = 0;
+    material.normalTexture.content = QByteArray("\x89PNG\0\1", 6);
+    material.normalTexture.isBumpmap = true;
+    material.normalTexture.texcoordSet = 1;
+    material.useAlbedoMap = true;
+    material.useNormalMap = true;
+
+    material._material = std::make_shared<graphics::Material>();
+    material._material->setAlbedo(material.diffuseColor);
+    material._material->setEmissive(material.emissiveColor);
+    material._material->setRoughness(graphics::Material::shininessToRoughness(material.shininess));
+    material._material->setOpacity(material.opacity);
+    material._material->setUnlit(true);
+    return material;
+}
+
+// a quad in one part, with the GPU mesh built from it the way the readers do
+static FBXMesh makeMesh(const QString& materialID) {
+    FBXMesh mesh;
+    mesh.vertices = { glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) };
+    mesh.normals = QVector<glm::vec3>(4, Vectors::UNIT_Z);
+    mesh.texCoords = { glm::vec2(0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f), glm::vec2(0.0f, 1.0f) };
+    mesh.clusterIndices = QVector<uint16_t>(16, 0);
+    mesh.clusterWeights = QVector<uint16_t>(16, 0);
+    for (int i = 0; i < 4; i++) {
+        mesh.clusterWeights[i * 4] = std::numeric_limits<uint16_t>::max();
+    }
+    mesh.originalIndices = { 0, 1, 2, 3 };
+
+    FBXCluster cluster;
+    cluster.jointIndex = 1;
+    cluster.inverseBindMatrix = glm::translate(glm::mat4(), glm::vec3(-1.0f));
+    cluster.inverseBindTransform = Transform(cluster.inverseBindMatrix);
+    mesh.clusters.append(cluster);
+
+    FBXMeshPart part;
+    part.triangleIndices = { 0, 1, 2, 0, 2, 3 };
+    part.materialID = materialID;
+    mesh.parts.append(part);
+
+    FBXBlendshape blendshape;
+    blendshape.indices = { 2 };
+    blendshape.vertices = { glm::vec3(0.0f, 0.0f, 0.5f) };
+    blendshape.normals = { Vectors::UNIT_X };
+    mesh.blendshapes.append(blendshape);
+
+    mesh.meshExtents = Extents(glm::vec3(0.0f), glm::vec3(1.0f, 1.0f, 0.0f));
+    mesh.modelTransform = glm::translate(glm::mat4(), glm::vec3(0.0f, 0.0f, -1.0f));
+    mesh.meshIndex = 0;
+
+    FBXReader::buildModelMesh(mesh, "test");
+    mesh._mesh->displayName = "quad";
+    return mesh;
+}
+
+static FBXGeometry makeGeometry() {
+    FBXGeometry geometry;
+    geometry.originalURL = "http://example.com/model.fbx";
+    geometry.author = "author";
+    geometry.applicationName = "application";
+    geometry.joints = { makeJoint("Hips", -1), makeJoint("Spine", 0) };
+    geometry.jointIndices = { { "Hips", 1 }, { "Spine", 2 } };
+    geometry.hasSkeletonJoints = true;
+    geometry.materials.insert("1", makeMaterial("1"));
+    geometry.meshes.append(makeMesh("1"));
+    geometry.offset = glm::scale(glm::mat4(), glm::vec3(0.01f));
+    geometry.rootJointIndex = 0;
+    geometry.headJointIndex = 1;
+    geometry.leftEyeSize = 0.5f;
+    geometry.humanIKJointIndices = { 0, 1, -1 };
+    geometry.palmDirection = Vectors::UNIT_NEG_Y;
+    geometry.neckPivot = glm::vec3(0.0f, 1.5f, 0.0f);
+    geometry.bindExtents = Extents(glm::vec3(-1.0f), glm::vec3(1.0f));
+    geometry.meshExtents = geometry.meshes[0].meshExtents;
+
+    FBXAnimationFrame frame;
+    frame.rotations = { glm::quat(), glm::angleAxis(0.5f, Vectors::UNIT_Y) };
+    frame.translations = { glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f) };
+    geometry.animationFrames = { frame, frame };
+
+    geometry.meshIndicesToModelNames.insert(0, "Quad");
+    geometry.blendshapeChannelNames = { "EyeBlink_L" };
+    return geometry;
+}
+
+static void compareViews(const graphics::Mesh::BufferView& actual, const graphics::Mesh::BufferView& expected) {
+    QCOMPARE(actual._buffer != nullptr, expected._buffer != nullptr);
+    if (!expected._buffer) {
+        return;
+    }
+    QCOMPARE(actual._offset, expected._offset);
+    QCOMPARE(actual._size, expected._size);
+    QCOMPARE(actual._stride, expected._stride);
+    QCOMPARE(actual._element.getRaw(), expected._element.getRaw());
+    QCOMPARE(actual._buffer->getSize(), expected._buffer->getSize());
+    QVERIFY(memcmp(actual._buffer->getData(), expected._buffer->getData(), expected._buffer->getSize()) == 0);
+}
+
+static void compareGeometries(const FBXGeometry& actual, const FBXGeometry& expected) {
+    QCOMPARE(actual.originalURL, expected.originalURL);
+    QCOMPARE(actual.author, expected.author);
+    QCOMPARE(actual.applicationName, expected.applicationName);
+    QCOMPARE(actual.jointIndices, expected.jointIndices);
+    QCOMPARE(actual.hasSkeletonJoints, expected.hasSkeletonJoints);
+    QCOMPARE(actual.offset, expected.offset);
+    QCOMPARE(actual.rootJointIndex, expected.rootJointIndex);
+    QCOMPARE(actual.headJointIndex, expected.headJointIndex);
+    QCOMPARE(actual.leftHandJointIndex, expected.leftHandJointIndex);
+    QCOMPARE(actual.leftEyeSize, expected.leftEyeSize);
+    QCOMPARE(actual.humanIKJointIndices, expected.humanIKJointIndices);
+    QCOMPARE(actual.palmDirection, expected.palmDirection);
+    QCOMPARE(actual.neckPivot, expected.neckPivot);
+    QCOMPARE(actual.bindExtents.minimum, expected.bindExtents.minimum);
+    QCOMPARE(actual.meshExtents.maximum, expected.meshExtents.maximum);
+    QCOMPARE(actual.meshIndicesToModelNames, expected.meshIndicesToModelNames);
+    QCOMPARE(actual.blendshapeChannelNames, expected.blendshapeChannelNames);
+
+    QCOMPARE(actual.joints.size(), expected.joints.size());
+    for (int i = 0; i < expected.joints.size(); i++) {
+        const FBXJoint& actualJoint = actual.joints.at(i);
+        const FBXJoint& expectedJoint = expected.joints.at(i);
+        QCOMPARE(actualJoint.name, expectedJoint.name);
+        QCOMPARE(actualJoint.parentIndex, expectedJoint.parentIndex);
+        QCOMPARE(actualJoint.freeLineage, expectedJoint.freeLineage);
+        QCOMPARE(actualJoint.shapeInfo.points, expectedJoint.shapeInfo.points);
+        QCOMPARE(actualJoint.shapeInfo.dots, expectedJoint.shapeInfo.dots);
+        QCOMPARE(actualJoint.rotation, expectedJoint.rotation);
+        QCOMPARE(actualJoint.postTransform, expectedJoint.postTransform);
+        QCOMPARE(actualJoint.bindTransform, expectedJoint.bindTransform);
+        QCOMPARE(actualJoint.geometricScaling, expectedJoint.geometricScaling);
+        QCOMPARE(actualJoint.hasGeometricOffset, expectedJoint.hasGeometricOffset);
+    }
+
+    QCOMPARE(actual.materials.size(), expected.materials.size());
+    for (auto it = expected.materials.constBegin(); it != expected.materials.constEnd(); ++it) {
+        QVERIFY(actual.materials.contains(it.key()));
+        const FBXMaterial& actualMaterial = actual.materials[it.key()];
+        const FBXMaterial& expectedMaterial = it.value();
+        QCOMPARE(actualMaterial.materialID, expectedMaterial.materialID);
+        QCOMPARE(actualMaterial.name, expectedMaterial.name);
+        QCOMPARE(actualMaterial.diffuseColor, expectedMaterial.diffuseColor);
+        QCOMPARE(actualMaterial.shininess, expectedMaterial.shininess);
+        QCOMPARE(actualMaterial.albedoTexture.filename, expectedMaterial.albedoTexture.filename);
+        QCOMPARE(actualMaterial.albedoTexture.transform, expectedMaterial.albedoTexture.transform);
+        QCOMPARE(actualMaterial.normalTexture.content, expectedMaterial.normalTexture.content);
+        QCOMPARE(actualMaterial.normalTexture.isBumpmap, expectedMaterial.normalTexture.isBumpmap);
+        QCOMPARE(actualMaterial.useNormalMap, expectedMaterial.useNormalMap);
+
+        QVERIFY(actualMaterial._material);
+        QCOMPARE(actualMaterial._material->getKey()._flags, expectedMaterial._material->getKey()._flags);
+        QCOMPARE(actualMaterial._material->getAlbedo(), expectedMaterial._material->getAlbedo());
+        QCOMPARE(actualMaterial._material->getRoughness(), expectedMaterial._material->getRoughness());
+        QCOMPARE(actualMaterial._material->getOpacity(), expectedMaterial._material->getOpacity());
+    }
+
+    QCOMPARE(actual.meshes.size(), expected.meshes.size());
+    for (int i = 0; i < expected.meshes.size(); i++) {
+        const FBXMesh& actualMesh = actual.meshes.at(i);
+        const FBXMesh& expectedMesh = expected.meshes.at(i);
+        QCOMPARE(actualMesh.vertices, expectedMesh.vertices);
+        QCOMPARE(actualMesh.normals, expectedMesh.normals);
+        QCOMPARE(actualMesh.tangents, expectedMesh.tangents);
+        QCOMPARE(actualMesh.texCoords, expectedMesh.texCoords);
+        QCOMPARE(actualMesh.clusterIndices, expectedMesh.clusterIndices);
+        QCOMPARE(actualMesh.clusterWeights, expectedMesh.clusterWeights);
+        QCOMPARE(actualMesh.originalIndices, expectedMesh.originalIndices);
+        QCOMPARE(actualMesh.modelTransform, expectedMesh.modelTransform);
+        QCOMPARE(actualMesh.meshIndex, expectedMesh.meshIndex);
+        QCOMPARE(actualMesh.parts.size(), expectedMesh.parts.size());
+        QCOMPARE(actualMesh.parts[0].triangleIndices, expectedMesh.parts[0].triangleIndices);
+        QCOMPARE(actualMesh.parts[0].materialID, expectedMesh.parts[0].materialID);
+        QCOMPARE(actualMesh.clusters.size(), expectedMesh.clusters.size());
+        QCOMPARE(actualMesh.clusters[0].jointIndex, expectedMesh.clusters[0].jointIndex);
+        QCOMPARE(actualMesh.clusters[0].inverseBindMatrix, expectedMesh.clusters[0].inverseBindMatrix);
+        QCOMPARE(actualMesh.blendshapes.size(), expectedMesh.blendshapes.size());
+        QCOMPARE(actualMesh.blendshapes[0].vertices, expectedMesh.blendshapes[0].vertices);
+
+        // the GPU mesh comes back with the same buffers, laid out the same way
+        const auto& actualModelMesh = actualMesh._mesh;
+        const auto& expectedModelMesh = expectedMesh._mesh;
+        QVERIFY(actualModelMesh);
+        compareViews(actualModelMesh->getVertexBuffer(), expectedModelMesh->getVertexBuffer());
+        compareViews(actualModelMesh->getIndexBuffer(), expectedModelMesh->getIndexBuffer());
+        compareViews(actualModelMesh->getPartBuffer(), expectedModelMesh->getPartBuffer());
+        QCOMPARE(actualModelMesh->getNumAttributes(), expectedModelMesh->getNumAttributes());
+        for (int slot = 0; slot < gpu::Stream::NUM_INPUT_SLOTS; slot++) {
+            compareViews(actualModelMesh->getAttributeBuffer(slot), expectedModelMesh->getAttributeBuffer(slot));
+        }
+        // which still share the one attribute buffer
+        QCOMPARE(actualModelMesh->getAttributeBuffer(gpu::Stream::NORMAL)._buffer,
+            actualModelMesh->getAttributeBuffer(gpu::Stream::TEXCOORD)._buffer);
+        QCOMPARE(actualModelMesh->displayName, expectedModelMesh->displayName);
+    }
+
+    QCOMPARE(actual.animationFrames.size(), expected.animationFrames.size());
+    QCOMPARE(actual.animationFrames[1].rotations, expected.animationFrames[1].rotations);
+    QCOMPARE(actual.animationFrames[1].translations, expected.animationFrames[1].translations);
+}
+
+void CompiledGeometryTests::testRoundTrip() {
+    FBXGeometry geometry = makeGeometry();
+    QByteArray compiled = CompiledGeometry::serialize(geometry);
+    FBXGeometry::Pointer unserialized = CompiledGeometry::unserialize(compiled.constData(), compiled.size());
+    QVERIFY(unserialized);
+    compareGeometries(*unserialized, geometry);
+}
+
+void CompiledGeometryTests::testFromFile() {
+    FBXGeometry geometry = makeGeometry();
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(CompiledGeometry::serialize(geometry));
+    file.close();
+
+    FBXGeometry::Pointer unserialized = CompiledGeometry::unserialize(file.fileName());
+    QVERIFY(unserialized);
+    compareGeometries(*unserialized, geometry);
+}
+
+void CompiledGeometryTests::testRejectsCorrupt() {
+    QByteArray compiled = CompiledGeometry::serialize(makeGeometry());
+
+    auto throws = [](const QByteArray& data) {
+        try {
+            CompiledGeometry::unserialize(data.constData(), data.size());
+        } catch (const QString&) {
+            return true;
+        }
+        return false;
+    };
+
+    // cut short anywhere
+    for (int length : { 0, 3, 12, compiled.size() / 3, compiled.size() / 2, compiled.size() - 1 }) {
+        QVERIFY(throws(compiled.left(length)));
+    }
+
+    // from another version
+    QByteArray otherVersion = compiled;
+    otherVersion[8] = otherVersion[8] + 1;
+    QVERIFY(throws(otherVersion));
+
+    // with something left over
+    QVERIFY(throws(compiled + QByteArray(1, '\0')));
+}
+
+#ifdef MANUAL_TEST
+
+// Loads every .fbx under $HIFI_FBX_BENCHMARK_DIR twice, the way ModelCache does: cold, reading the model and compiling
+// the result to a file; then warm, from the compiled file alone.
+void CompiledGeometryTests::benchmarkColdAndWarmLoads() {
+    QString directory = QProcessEnvironment::systemEnvironment().value("HIFI_FBX_BENCHMARK_DIR");
+    if (directory.isEmpty()) {
+        QSKIP("set HIFI_FBX_BENCHMARK_DIR to a directory of sample models");
+    }
+
+    QFileInfoList models;
+    QDirIterator it(directory, { "*.fbx" }, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        models.append(it.fileInfo());
+    }
+    std::sort(models.begin(), models.end(), [](const QFileInfo& a, const QFileInfo& b) { return a.size() < b.size(); });
+
+    const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+    qDebug() << "model, MB, compiled MB, cold ms, warm ms";
+    for (auto& model : models) {
+        QFile file(model.filePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        QByteArray contents = file.readAll();
+
+        QTemporaryFile compiledFile;
+        if (!compiledFile.open()) {
+            continue;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        std::unique_ptr<FBXGeometry> geometry(readFBX(contents, QVariantHash(), model.filePath()));
+        QByteArray compiled = CompiledGeometry::serialize(*geometry);
+        compiledFile.write(compiled);
+        compiledFile.flush();
+        qint64 coldNsecs = timer.nsecsElapsed();
+
+        timer.restart();
+        FBXGeometry::Pointer unserialized = CompiledGeometry::unserialize(compiledFile.fileName());
+        qint64 warmNsecs = timer.nsecsElapsed();
+
+        qDebug() << model.fileName() << (double)model.size() / BYTES_PER_MEGABYTE
+            << (double)compiled.size() / BYTES_PER_MEGABYTE
+            << (double)coldNsecs / NSECS_PER_MSEC << (double)warmNsecs / NSECS_PER_MSEC;
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,30 @@
+//
+//  CompiledGeometryTests.h
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CompiledGeometryTests_h
+#define hifi_CompiledGeometryTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class CompiledGeometryTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRoundTrip();
+    void testFromFile();
+    void testRejectsCorrupt();
+#ifdef MANUAL_TEST
+    void benchmarkColdAndWarmLoads();
+#endif
+};
+
+#endif // hifi_CompiledGeometryTests_h
@@ -0,0 +1,276 @@
+//
+//  FBXReaderTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXReaderTests.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryFile>
+
+#include <FBXReader.h>
+#include <FBXWriter.h>
+
+#ifdef MANUAL_TEST
+#include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#ifndef Q_OS_WIN
+#include <sys/resource.h>
+#endif
+#endif
+
+QTEST_MAIN(FBXReaderTests)
+
+// enough elements that the writer compresses the array
+const int LARGE_ARRAY_SIZE = 3000;
+const int SMALL_ARRAY_SIZE = 12;
+
+template <typename T>
+static QVector<T> makeArray(int size) {
+    QVector<T> values;
+    for (int i = 0; i < size; i++) {
+        values.append((T)(i % 7) * (T)3);
+    }
+    return values;
+}
+
+static FBXNode makeNode(const QByteArray& name, const QVariantList& properties, const FBXNodeList& children = FBXNodeList()) {
+    FBXNode node;
+    node.name = name;
+    node.properties = properties;
+    node.children = children;
+    return node;
+}
+
+// a document with one of every kind of property the binary format has, with arrays both compressed and not
+static FBXNode makeDocument() {
+    FBXNode header = makeNode("FBXHeaderExtension", {
+        QVariant::fromValue((qint16)-12), QVariant::fromValue(true), QVariant::fromValue((qint32)123456),
+        QVariant::fromValue(1.5f), QVariant::fromValue(-2.25), QVariant::fromValue((qint64)1 << 40),
+        QVariant::fromValue(QByteArray("Creator\0\1Name", 14))
+    });
+
+    FBXNode geometry = makeNode("Geometry", { QVariant::fromValue((qint64)42), QVariant::fromValue(QByteArray("Mesh")) }, {
+        makeNode("Vertices", { QVariant::fromValue(makeArray<double>(LARGE_ARRAY_SIZE)) }),
+        makeNode("PolygonVertexIndex", { QVariant::fromValue(makeArray<qint32>(SMALL_ARRAY_SIZE)) }),
+        makeNode("Weights", { QVariant::fromValue(makeArray<float>(LARGE_ARRAY_SIZE)) }),
+        makeNode("KeyTime", { QVariant::fromValue(makeArray<qint64>(LARGE_ARRAY_SIZE)) }),
+        makeNode("Visibility", { QVariant::fromValue(QVector<bool>({ true, false, true })) })
+    });
+
+    FBXNode root;
+    root.children.append(header);
+    root.children.append(makeNode("Objects", QVariantList(), { geometry }));
+    return root;
+}
+
+template <typename T>
+static bool compareArrays(const QVariant& actual, const QVariant& expected) {
+    return actual.value<QVector<T>>() == expected.value<QVector<T>>();
+}
+
+static void compareNodes(const FBXNode& actual, const FBXNode& expected) {
+    QCOMPARE(actual.name, expected.name);
+    QCOMPARE(actual.properties.size(), expected.properties.size());
+    for (int i = 0; i < actual.properties.size(); i++) {
+        const QVariant& actualProperty = actual.properties.at(i);
+        const QVariant& expectedProperty = expected.properties.at(i);
+        QCOMPARE(actualProperty.userType(), expectedProperty.userType());
+
+        int type = expectedProperty.userType();
+        if (type == qMetaTypeId<QVector<double>>()) {
+            QVERIFY(compareArrays<double>(actualProperty, expectedProperty));
+        } else if (type == qMetaTypeId<QVector<float>>()) {
+            QVERIFY(compareArrays<float>(actualProperty, expectedProperty));
+        } else if (type == qMetaTypeId<QVector<qint64>>()) {
+            QVERIFY(compareArrays<qint64>(actualProperty, expectedProperty));
+        } else if (type == qMetaTypeId<QVector<qint32>>()) {
+            QVERIFY(compareArrays<qint32>(actualProperty, expectedProperty));
+        } else if (type == qMetaTypeId<QVector<bool>>()) {
+            QVERIFY(compareArrays<bool>(actualProperty, expectedProperty));
+        } else {
+            QCOMPARE(actualProperty, expectedProperty);
+        }
+    }
+
+    QCOMPARE(actual.children.size(), expected.children.size());
+    for (int i = 0; i < actual.children.size(); i++) {
+        compareNodes(actual.children.at(i), expected.children.at(i));
+    }
+}
+
+void FBXReaderTests::testBinaryRoundTrip() {
+    FBXNode document = makeDocument();
+    QByteArray encoded = FBXWriter::encodeFBX(document);
+
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::ReadOnly);
+    FBXNode parsed = FBXReader::parseFBX(&buffer);
+    compareNodes(parsed, document);
+}
+
+void FBXReaderTests::testBinaryFromFile() {
+    FBXNode document = makeDocument();
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(FBXWriter::encodeFBX(document));
+    file.close();
+
+    // a file is mapped rather than read
+    QFile mappedFile(file.fileName());
+    QVERIFY(mappedFile.open(QIODevice::ReadOnly));
+    FBXNode parsed = FBXReader::parseFBX(&mappedFile);
+    compareNodes(parsed, document);
+}
+
+void FBXReaderTests::testTruncatedBinary() {
+    QByteArray encoded = FBXWriter::encodeFBX(makeDocument());
+
+    // cut off in the middle of the large arrays
+    QByteArray truncated = encoded.left(encoded.size() / 2);
+    QBuffer buffer(&truncated);
+    buffer.open(QIODevice::ReadOnly);
+
+    bool threw = false;
+    try {
+        FBXReader::parseFBX(&buffer);
+    } catch (const QString&) {
+        threw = true;
+    }
+    QVERIFY(threw);
+}
+
+static const FBXNode& findChild(const FBXNode& node, const QByteArray& name) {
+    static const FBXNode NULL_NODE;
+    for (const FBXNode& child : node.children) {
+        if (child.name == name) {
+            return child;
+        }
+    }
+    return NULL_NODE;
+}
+
+void FBXReaderTests::testTypedGeometryArrays() {
+    // compressed vertices and UVs, uncompressed normals and indices
+    FBXNode geometry = makeNode("Geometry", { QVariant::fromValue((qint64)42), QVariant::fromValue(QByteArray("Mesh")) }, {
+        makeNode("Vertices", { QVariant::fromValue(makeArray<double>(LARGE_ARRAY_SIZE)) }),
+        makeNode("PolygonVertexIndex", { QVariant::fromValue(makeArray<qint32>(SMALL_ARRAY_SIZE)) }),
+        makeNode("LayerElementNormal", { QVariant::fromValue((qint32)0) }, {
+            makeNode("Normals", { QVariant::fromValue(makeArray<double>(SMALL_ARRAY_SIZE)) })
+        }),
+        makeNode("LayerElementUV", { QVariant::fromValue((qint32)0) }, {
+            makeNode("UV", { QVariant::fromValue(makeArray<double>(LARGE_ARRAY_SIZE)) })
+        })
+    });
+    FBXNode document;
+    document.children.append(makeNode("Objects", QVariantList(), { geometry }));
+    QByteArray encoded = FBXWriter::encodeFBX(document);
+
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::ReadOnly);
+    FBXNode untyped = findChild(findChild(FBXReader::parseFBX(&buffer), "Objects"), "Geometry");
+    buffer.seek(0);
+    FBXNode typed = findChild(findChild(FBXReader::parseFBX(&buffer, true), "Objects"), "Geometry");
+
+    // the typed values stand in for the properties, and read back the same as converting the properties does
+    const FBXNode& vertices = findChild(typed, "Vertices");
+    QVERIFY(vertices.properties.isEmpty());
+    QCOMPARE(vertices.vec3Values.size(), LARGE_ARRAY_SIZE / 3);
+    QCOMPARE(FBXReader::getVec3Vector(vertices),
+        FBXReader::createVec3Vector(FBXReader::getDoubleVector(findChild(untyped, "Vertices"))));
+
+    const FBXNode& indices = findChild(typed, "PolygonVertexIndex");
+    QVERIFY(indices.properties.isEmpty());
+    QCOMPARE(FBXReader::getIntVector(indices), FBXReader::getIntVector(findChild(untyped, "PolygonVertexIndex")));
+
+    const FBXNode& normals = findChild(findChild(typed, "LayerElementNormal"), "Normals");
+    QVERIFY(normals.properties.isEmpty());
+    QCOMPARE(FBXReader::getVec3Vector(normals),
+        FBXReader::createVec3Vector(FBXReader::getDoubleVector(findChild(findChild(untyped, "LayerElementNormal"), "Normals"))));
+
+    const FBXNode& uvs = findChild(findChild(typed, "LayerElementUV"), "UV");
+    QVERIFY(uvs.properties.isEmpty());
+    QCOMPARE(FBXReader::getTexCoordVector(uvs),
+        FBXReader::createVec2Vector(FBXReader::getDoubleVector(findChild(findChild(untyped, "LayerElementUV"), "UV"))));
+
+    // everything else is read as before
+    QCOMPARE(findChild(typed, "LayerElementUV").properties, findChild(untyped, "LayerElementUV").properties);
+    QCOMPARE(typed.properties, untyped.properties);
+}
+
+#ifdef MANUAL_TEST
+
+static quint64 peakMemoryBytes() {
+#ifdef Q_OS_WIN
+    MemoryInfo info;
+    return getMemoryInfo(info) ? info.processPeakUsedMemoryBytes : 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef Q_OS_MAC
+    return usage.ru_maxrss;
+#else
+    return (quint64)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+// Loads every .fbx under $HIFI_FBX_BENCHMARK_DIR, smallest first so that the growth in the process's peak memory can be
+// put down to each model in turn, and reports the time to parse the file and to extract the geometry from it.
+void FBXReaderTests::benchmarkLoadModels() {
+    QString directory = QProcessEnvironment::systemEnvironment().value("HIFI_FBX_BENCHMARK_DIR");
+    if (directory.isEmpty()) {
+        QSKIP("set HIFI_FBX_BENCHMARK_DIR to a directory of sample models");
+    }
+
+    QFileInfoList models;
+    QDirIterator it(directory, { "*.fbx" }, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        models.append(it.fileInfo());
+    }
+    std::sort(models.begin(), models.end(), [](const QFileInfo& a, const QFileInfo& b) { return a.size() < b.size(); });
+
+    const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+    qDebug() << "model, MB, parse ms, extract ms, peak MB, peak growth MB";
+    for (auto& model : models) {
+        QFile file(model.filePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        QByteArray contents = file.readAll();
+
+        quint64 peakBefore = peakMemoryBytes();
+        QElapsedTimer timer;
+        timer.start();
+
+        QBuffer buffer(&contents);
+        buffer.open(QIODevice::ReadOnly);
+        FBXReader reader;
+        reader._lightmapLevel = 1.0f;
+        reader._rootNode = FBXReader::parseFBX(&buffer, true);
+        qint64 parseNsecs = timer.nsecsElapsed();
+
+        std::unique_ptr<FBXGeometry> geometry(reader.extractFBXGeometry(QVariantHash(), model.filePath()));
+        qint64 extractNsecs = timer.nsecsElapsed() - parseNsecs;
+
+        quint64 peakAfter = peakMemoryBytes();
+        qDebug() << model.fileName() << (double)model.size() / BYTES_PER_MEGABYTE
+            << (double)parseNsecs / NSECS_PER_MSEC << (double)extractNsecs / NSECS_PER_MSEC
+            << (double)peakAfter / BYTES_PER_MEGABYTE << (double)(peakAfter - peakBefore) / BYTES_PER_MEGABYTE;
+    }
+}
+
+#endif // MANUAL_TEST
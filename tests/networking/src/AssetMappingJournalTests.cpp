@@ -0,0 +1,290 @@
+//
+//  AssetMappingJournalTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetMappingJournalTests.h"
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+
+#include <AssetMappingJournal.h>
+
+QTEST_MAIN(AssetMappingJournalTests)
+
+static const QString MAP_FILE_NAME = "map.json";
+
+static AssetUtils::AssetHash hashForIndex(int i) {
+    // any 64 character hex string will do
+    return QString("%1").arg(i, (int)AssetUtils::SHA256_HASH_HEX_LENGTH, 16, QChar('0'));
+}
+
+// what the asset server does on startup: read the map file, then replay the journal on top of it
+static AssetUtils::Mappings loadMappings(const QString& mapFilePath) {
+    AssetUtils::Mappings mappings;
+
+    QFile mapFile { mapFilePath };
+    if (mapFile.open(QIODevice::ReadOnly)) {
+        auto root = QJsonDocument::fromJson(mapFile.readAll()).object();
+        for (auto it = root.begin(); it != root.end(); ++it) {
+            mappings[it.key()] = it.value().toString();
+        }
+    }
+
+    AssetMappingJournal journal { mapFilePath };
+    journal.replay(mappings);
+    return mappings;
+}
+
+void AssetMappingJournalTests::testReplay() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto mapFilePath = dir.filePath(MAP_FILE_NAME);
+
+    AssetUtils::Mappings mappings;
+    {
+        AssetMappingJournal journal { mapFilePath };
+        QVERIFY(journal.replay(mappings));
+
+        journal.set("/a.fbx", hashForIndex(1));
+        journal.set("/b.fbx", hashForIndex(2));
+        QVERIFY(journal.commit());
+
+        // a rename
+        journal.remove("/a.fbx");
+        journal.set("/c.fbx", hashForIndex(1));
+        QVERIFY(journal.commit());
+
+        // rolled back operations are never written
+        journal.set("/d.fbx", hashForIndex(4));
+        journal.rollback();
+        QVERIFY(journal.commit());
+
+        QCOMPARE(journal.getNumOperations(), 4);
+    }
+
+    mappings = loadMappings(mapFilePath);
+    QCOMPARE((int)mappings.size(), 2);
+    QCOMPARE(mappings["/b.fbx"], hashForIndex(2));
+    QCOMPARE(mappings["/c.fbx"], hashForIndex(1));
+
+    // the journal was folded into the map file on replay
+    QVERIFY(QFile::exists(mapFilePath));
+    QCOMPARE(QFileInfo(mapFilePath + ".journal").size(), (qint64)0);
+    QCOMPARE(loadMappings(mapFilePath), mappings);
+}
+
+void AssetMappingJournalTests::testRemoveFolder() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto mapFilePath = dir.filePath(MAP_FILE_NAME);
+
+    {
+        AssetMappingJournal journal { mapFilePath };
+        AssetUtils::Mappings mappings;
+        QVERIFY(journal.replay(mappings));
+
+        journal.set("/folder/a.fbx", hashForIndex(1));
+        journal.set("/folder/sub/b.fbx", hashForIndex(2));
+        journal.set("/folder.fbx", hashForIndex(3));
+        journal.set("/other/c.fbx", hashForIndex(4));
+        QVERIFY(journal.commit());
+
+        journal.remove("/folder/");
+        QVERIFY(journal.commit());
+    }
+
+    auto mappings = loadMappings(mapFilePath);
+    QCOMPARE((int)mappings.size(), 2);
+    QVERIFY(mappings.find("/folder.fbx") != mappings.end());
+    QVERIFY(mappings.find("/other/c.fbx") != mappings.end());
+}
+
+void AssetMappingJournalTests::testTornRecord() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto mapFilePath = dir.filePath(MAP_FILE_NAME);
+    auto journalPath = mapFilePath + ".journal";
+
+    {
+        AssetMappingJournal journal { mapFilePath };
+        AssetUtils::Mappings mappings;
+        QVERIFY(journal.replay(mappings));
+
+        journal.set("/a.fbx", hashForIndex(1));
+        QVERIFY(journal.commit());
+
+        journal.set("/b.fbx", hashForIndex(2));
+        journal.set("/c.fbx", hashForIndex(3));
+        QVERIFY(journal.commit());
+    }
+
+    // cut the second record short, as if the server died in the middle of writing it
+    {
+        QFile file { journalPath };
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(file.size() - 10));
+    }
+
+    auto mappings = loadMappings(mapFilePath);
+    QCOMPARE((int)mappings.size(), 1);
+    QCOMPARE(mappings["/a.fbx"], hashForIndex(1));
+
+    // corrupt a byte of the payload instead, the record is dropped as a whole
+    QVERIFY(QFile::remove(mapFilePath));
+    {
+        AssetMappingJournal journal { mapFilePath };
+        AssetUtils::Mappings empty;
+        QVERIFY(journal.replay(empty));
+
+        journal.set("/a.fbx", hashForIndex(1));
+        QVERIFY(journal.commit());
+        journal.set("/b.fbx", hashForIndex(2));
+        QVERIFY(journal.commit());
+    }
+    {
+        QFile file { journalPath };
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.seek(file.size() - 1));
+        char last;
+        QVERIFY(file.getChar(&last));
+        QVERIFY(file.seek(file.size() - 1));
+        QVERIFY(file.putChar(last ^ 0x1));
+    }
+
+    mappings = loadMappings(mapFilePath);
+    QCOMPARE((int)mappings.size(), 1);
+    QCOMPARE(mappings["/a.fbx"], hashForIndex(1));
+}
+
+void AssetMappingJournalTests::testCompaction() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto mapFilePath = dir.filePath(MAP_FILE_NAME);
+
+    AssetUtils::Mappings expected;
+    {
+        AssetMappingJournal journal { mapFilePath };
+        QVERIFY(journal.replay(expected));
+
+        for (int i = 0; i < 100; ++i) {
+            auto path = QString("/file%1.fbx").arg(i);
+            expected[path] = hashForIndex(i);
+            journal.set(path, expected[path]);
+            QVERIFY(journal.commit());
+        }
+
+        journal.compact(expected);
+        QCOMPARE(journal.getNumOperations(), 0);
+
+        // operations committed while the map file is being written go to the new journal
+        expected.erase("/file0.fbx");
+        journal.remove("/file0.fbx");
+        QVERIFY(journal.commit());
+
+        journal.waitForCompaction();
+        QVERIFY(!journal.isCompacting());
+        QVERIFY(!QFile::exists(mapFilePath + ".journal.compacting"));
+        QCOMPARE(journal.getNumOperations(), 1);
+    }
+
+    QCOMPARE(loadMappings(mapFilePath), expected);
+}
+
+void AssetMappingJournalTests::testReplayAfterInterruptedCompaction() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto mapFilePath = dir.filePath(MAP_FILE_NAME);
+
+    AssetUtils::Mappings expected;
+    {
+        AssetMappingJournal journal { mapFilePath };
+        QVERIFY(journal.replay(expected));
+
+        expected["/a.fbx"] = hashForIndex(1);
+        expected["/b.fbx"] = hashForIndex(2);
+        journal.set("/a.fbx", hashForIndex(1));
+        journal.set("/b.fbx", hashForIndex(2));
+        QVERIFY(journal.commit());
+
+        journal.compact(expected);
+        journal.waitForCompaction();
+
+        expected.erase("/a.fbx");
+        journal.remove("/a.fbx");
+        QVERIFY(journal.commit());
+    }
+
+    // pretend the server died after rotating the journal but before the map file was written:
+    // the map file is stale and both journals are around, some of the operations already being in the map file
+    QVERIFY(QFile::copy(mapFilePath + ".journal", mapFilePath + ".journal.compacting"));
+    {
+        QFile journal { mapFilePath + ".journal" };
+        QVERIFY(journal.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    }
+
+    QCOMPARE(loadMappings(mapFilePath), expected);
+    QVERIFY(!QFile::exists(mapFilePath + ".journal.compacting"));
+
+    // and once more, replaying has to be idempotent
+    QCOMPARE(loadMappings(mapFilePath), expected);
+}
+
+#ifdef MANUAL_TEST
+
+void AssetMappingJournalTests::benchmark() {
+    const int NUM_MAPPINGS[] = { 1000, 10000, 100000 };
+    const int NUM_OPERATIONS = 200;
+
+    qDebug() << "Mappings\tRewrite map.json (ops/s)\tJournal (ops/s)";
+
+    for (auto numMappings : NUM_MAPPINGS) {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto mapFilePath = dir.filePath(MAP_FILE_NAME);
+
+        AssetUtils::Mappings mappings;
+        for (int i = 0; i < numMappings; ++i) {
+            mappings[QString("/folder%1/file%2.fbx").arg(i % 100).arg(i)] = hashForIndex(i);
+        }
+        QVERIFY(AssetMappingJournal::writeMapFile(mapFilePath, mappings));
+
+        // what the asset server used to do: rewrite the whole map file for every operation
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < NUM_OPERATIONS; ++i) {
+            mappings[QString("/new/file%1.fbx").arg(i)] = hashForIndex(i);
+            AssetMappingJournal::writeMapFile(mapFilePath, mappings);
+        }
+        double rewriteRate = NUM_OPERATIONS / (timer.nsecsElapsed() / 1.0e9);
+
+        // append each operation to the journal, compacting in the background as needed
+        AssetMappingJournal journal { mapFilePath };
+        AssetUtils::Mappings replayed = mappings;
+        QVERIFY(journal.replay(replayed));
+
+        int numJournalOperations = NUM_OPERATIONS * 50;
+        timer.restart();
+        for (int i = 0; i < numJournalOperations; ++i) {
+            auto path = QString("/journal/file%1.fbx").arg(i);
+            mappings[path] = hashForIndex(i);
+            journal.set(path, mappings[path]);
+            journal.commit();
+            if (journal.needsCompaction()) {
+                journal.compact(mappings);
+            }
+        }
+        double journalRate = numJournalOperations / (timer.nsecsElapsed() / 1.0e9);
+        journal.waitForCompaction();
+
+        qDebug() << numMappings << "\t" << rewriteRate << "\t" << journalRate;
+    }
+}
+
+#endif // MANUAL_TEST
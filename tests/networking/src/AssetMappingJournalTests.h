@@ -0,0 +1,32 @@
+//
+//  AssetMappingJournalTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetMappingJournalTests_h
+#define hifi_AssetMappingJournalTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class AssetMappingJournalTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testReplay();
+    void testRemoveFolder();
+    void testTornRecord();
+    void testCompaction();
+    void testReplayAfterInterruptedCompaction();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_AssetMappingJournalTests_h
@@ -0,0 +1,205 @@
+//
+//  DomainListCacheTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DomainListCacheTests.h"
+
+#include <QtCore/QDataStream>
+
+#include <DomainListCache.h>
+#include <PortableHighResolutionClock.h>
+
+QTEST_MAIN(DomainListCacheTests)
+
+static SharedNodePointer createNode(NodeType_t type, quint16 port) {
+    HifiSockAddr socket(QHostAddress(QHostAddress::LocalHost), port);
+    return SharedNodePointer(new Node(QUuid::createUuid(), type, socket, socket));
+}
+
+static QByteArray serialize(const Node& node) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << node;
+    return data;
+}
+
+static QSet<QUuid> recordsSince(const DomainListCache& cache, const NodeSet& nodeTypes, quint64 version) {
+    QSet<QUuid> nodeIDs;
+    cache.eachRecordSince(nodeTypes, version, [&](const DomainListCache::Record& record) {
+        nodeIDs.insert(record.node->getUUID());
+    });
+    return nodeIDs;
+}
+
+void DomainListCacheTests::testRecordsByType() {
+    DomainListCache cache;
+    QVERIFY(!cache.hasVersion(0));
+    QVERIFY(cache.hasVersion(cache.getVersion()));
+
+    auto agent = createNode(NodeType::Agent, 1000);
+    auto audioMixer = createNode(NodeType::AudioMixer, 1001);
+    auto avatarMixer = createNode(NodeType::AvatarMixer, 1002);
+    QVERIFY(cache.updateNode(agent));
+    QVERIFY(cache.updateNode(audioMixer));
+    QVERIFY(cache.updateNode(avatarMixer));
+    QCOMPARE(cache.getNumRecords(), 3);
+
+    // a record is the node as it is streamed in a domain list
+    cache.eachRecordSince({ NodeType::AudioMixer }, 0, [&](const DomainListCache::Record& record) {
+        QVERIFY(record.node == audioMixer);
+        QCOMPARE(record.data, serialize(*audioMixer));
+    });
+
+    QCOMPARE(recordsSince(cache, { NodeType::AudioMixer, NodeType::AvatarMixer }, 0),
+        QSet<QUuid>({ audioMixer->getUUID(), avatarMixer->getUUID() }));
+    QCOMPARE(recordsSince(cache, { NodeType::EntityServer }, 0), QSet<QUuid>());
+}
+
+void DomainListCacheTests::testDeltaSinceVersion() {
+    DomainListCache cache;
+    auto audioMixer = createNode(NodeType::AudioMixer, 1000);
+    auto avatarMixer = createNode(NodeType::AvatarMixer, 1001);
+    cache.updateNode(audioMixer);
+    cache.updateNode(avatarMixer);
+
+    NodeSet allTypes { NodeType::AudioMixer, NodeType::AvatarMixer };
+    quint64 version = cache.getVersion();
+    QCOMPARE(recordsSince(cache, allTypes, version), QSet<QUuid>());
+
+    // updating a node that didn't change keeps the version
+    QVERIFY(!cache.updateNode(audioMixer));
+    QCOMPARE(cache.getVersion(), version);
+
+    // a changed node is the only one in a delta from the previous version
+    avatarMixer->setLocalSocket(HifiSockAddr(QHostAddress(QHostAddress::LocalHost), 2000));
+    QVERIFY(cache.updateNode(avatarMixer));
+    QVERIFY(cache.getVersion() > version);
+    QCOMPARE(recordsSince(cache, allTypes, version), QSet<QUuid>({ avatarMixer->getUUID() }));
+
+    NodePermissions permissions;
+    permissions.setAll(true);
+    audioMixer->setPermissions(permissions);
+    QVERIFY(cache.updateNode(audioMixer));
+    QCOMPARE(recordsSince(cache, allTypes, version), QSet<QUuid>({ audioMixer->getUUID(), avatarMixer->getUUID() }));
+    QCOMPARE(recordsSince(cache, allTypes, cache.getVersion()), QSet<QUuid>());
+}
+
+void DomainListCacheTests::testRemoveNode() {
+    DomainListCache cache;
+    std::vector<SharedNodePointer> nodes;
+    for (int i = 0; i < 5; i++) {
+        nodes.push_back(createNode(NodeType::Agent, 1000 + i));
+        cache.updateNode(nodes.back());
+    }
+
+    // remove from the middle, so the last record moves into its place
+    cache.removeNode(nodes[1]->getUUID());
+    cache.removeNode(nodes[1]->getUUID());
+    QCOMPARE(cache.getNumRecords(), 4);
+    QVERIFY(!recordsSince(cache, { NodeType::Agent }, 0).contains(nodes[1]->getUUID()));
+
+    // the moved record is still found by its node
+    quint64 version = cache.getVersion();
+    nodes[4]->setPublicSocket(HifiSockAddr(QHostAddress(QHostAddress::LocalHost), 2000));
+    QVERIFY(cache.updateNode(nodes[4]));
+    QCOMPARE(recordsSince(cache, { NodeType::Agent }, version), QSet<QUuid>({ nodes[4]->getUUID() }));
+
+    // a node that changes type moves to its new group
+    nodes[0]->setType(NodeType::EntityScriptServer);
+    QVERIFY(cache.updateNode(nodes[0]));
+    QCOMPARE(cache.getNumRecords(), 4);
+    QCOMPARE(recordsSince(cache, { NodeType::EntityScriptServer }, 0), QSet<QUuid>({ nodes[0]->getUUID() }));
+    QCOMPARE(recordsSince(cache, { NodeType::Agent }, 0).size(), 3);
+}
+
+#ifdef MANUAL_TEST
+
+void DomainListCacheTests::benchmarkDomainList() {
+    // a domain of 1k nodes: agents and the assignment clients that list them, with every node checking in once
+    const int NUM_NODES = 1000;
+    const int NUM_ASSIGNMENT_CLIENTS = 50;
+    const NodeSet ASSIGNMENT_CLIENT_INTERESTS { NodeType::Agent, NodeType::AudioMixer, NodeType::AvatarMixer,
+        NodeType::EntityServer, NodeType::AssetServer, NodeType::MessagesMixer, NodeType::EntityScriptServer };
+    const NodeSet AGENT_INTERESTS { NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::EntityServer,
+        NodeType::AssetServer, NodeType::MessagesMixer, NodeType::EntityScriptServer };
+    const NodeType_t ASSIGNMENT_TYPES[] { NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::EntityServer,
+        NodeType::AssetServer, NodeType::MessagesMixer, NodeType::EntityScriptServer };
+
+    std::vector<SharedNodePointer> nodes;
+    DomainListCache cache;
+    for (int i = 0; i < NUM_NODES; i++) {
+        NodeType_t type = (i < NUM_ASSIGNMENT_CLIENTS) ? ASSIGNMENT_TYPES[i % 6] : (NodeType_t)NodeType::Agent;
+        nodes.push_back(createNode(type, 1000 + i));
+        cache.updateNode(nodes.back());
+    }
+    auto interestsOf = [&](const SharedNodePointer& node) -> const NodeSet& {
+        return node->getType() == NodeType::Agent ? AGENT_INTERESTS : ASSIGNMENT_CLIENT_INTERESTS;
+    };
+
+    // what sendDomainListToNode did: walk every node, check the interest set and stream the matches
+    QByteArray list;
+    size_t listBytes = 0;
+    auto startTime = p_high_resolution_clock::now();
+    for (auto& node : nodes) {
+        const NodeSet& interests = interestsOf(node);
+        list.resize(0);
+        QDataStream stream(&list, QIODevice::WriteOnly);
+        for (auto& otherNode : nodes) {
+            if (otherNode != node && interests.contains(otherNode->getType())) {
+                stream << *otherNode;
+            }
+        }
+        listBytes += list.size();
+    }
+    auto streamTime = p_high_resolution_clock::now() - startTime;
+
+    // full lists from the cached records
+    size_t cachedBytes = 0;
+    startTime = p_high_resolution_clock::now();
+    for (auto& node : nodes) {
+        list.resize(0);
+        cache.eachRecordSince(interestsOf(node), 0, [&](const DomainListCache::Record& record) {
+            if (record.node != node) {
+                list.append(record.data);
+            }
+        });
+        cachedBytes += list.size();
+    }
+    auto cachedTime = p_high_resolution_clock::now() - startTime;
+    QCOMPARE(cachedBytes, listBytes);
+
+    // deltas, after a handful of nodes changed since the last check in
+    quint64 version = cache.getVersion();
+    for (int i = 0; i < 10; i++) {
+        auto& node = nodes[i * 97];
+        node->setLocalSocket(HifiSockAddr(QHostAddress(QHostAddress::LocalHost), 2000 + i));
+        cache.updateNode(node);
+    }
+    size_t deltaBytes = 0;
+    startTime = p_high_resolution_clock::now();
+    for (auto& node : nodes) {
+        list.resize(0);
+        cache.eachRecordSince(interestsOf(node), version, [&](const DomainListCache::Record& record) {
+            if (record.node != node) {
+                list.append(record.data);
+            }
+        });
+        deltaBytes += list.size();
+    }
+    auto deltaTime = p_high_resolution_clock::now() - startTime;
+
+    auto toMsecs = [](p_high_resolution_clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.0;
+    };
+    qDebug() << "1k node check ins, streamed lists:" << toMsecs(streamTime) << "ms" << listBytes << "bytes";
+    qDebug() << "1k node check ins, cached full lists:" << toMsecs(cachedTime) << "ms" << cachedBytes << "bytes";
+    qDebug() << "1k node check ins, cached deltas:" << toMsecs(deltaTime) << "ms" << deltaBytes << "bytes";
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,30 @@
+//
+//  DomainListCacheTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DomainListCacheTests_h
+#define hifi_DomainListCacheTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class DomainListCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRecordsByType();
+    void testDeltaSinceVersion();
+    void testRemoveNode();
+#ifdef MANUAL_TEST
+    void benchmarkDomainList();
+#endif
+};
+
+#endif // hifi_DomainListCacheTests_h
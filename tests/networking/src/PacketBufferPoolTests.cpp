@@ -0,0 +1,137 @@
+//
+//  PacketBufferPoolTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPoolTests.h"
+
+#include <thread>
+
+#include <NLPacket.h>
+#include <NLPacketList.h>
+#include <PortableHighResolutionClock.h>
+#include <udt/PacketBufferPool.h>
+
+using namespace udt;
+
+QTEST_MAIN(PacketBufferPoolTests)
+
+void PacketBufferPoolTests::testReuse() {
+    auto buffer = PacketBufferPool::acquire();
+    char* data = buffer.get();
+    memset(data, 1, PacketBufferPool::BUFFER_SIZE);
+    PacketBufferPool::release(std::move(buffer));
+
+    // the same thread gets its last buffer back, cleared as far as asked
+    auto startStats = PacketBufferPool::getStats();
+    buffer = PacketBufferPool::acquire(16);
+    QCOMPARE(buffer.get(), data);
+    QCOMPARE(PacketBufferPool::getStats().hits, startStats.hits + 1);
+    QCOMPARE(PacketBufferPool::getStats().outstanding, startStats.outstanding + 1);
+    for (int i = 0; i < 16; i++) {
+        QCOMPARE(buffer[i], (char)0);
+    }
+    QCOMPARE(buffer[16], (char)1);
+    PacketBufferPool::release(std::move(buffer));
+}
+
+void PacketBufferPoolTests::testPacketLifetime() {
+    auto startStats = PacketBufferPool::getStats();
+    {
+        auto packet = NLPacket::create(PacketType::AvatarData);
+        packet->write(QByteArray(100, 'a'));
+        QCOMPARE(PacketBufferPool::getStats().outstanding, startStats.outstanding + 1);
+
+        // a copy has its own buffer, a move takes the buffer along
+        auto copy = NLPacket::createCopy(*packet);
+        QCOMPARE(PacketBufferPool::getStats().outstanding, startStats.outstanding + 2);
+        QCOMPARE(copy->getDataSize(), packet->getDataSize());
+        QCOMPARE(memcmp(copy->getData(), packet->getData(), packet->getDataSize()), 0);
+
+        auto moved = NLPacket::fromBase(std::move(copy));
+        QCOMPARE(PacketBufferPool::getStats().outstanding, startStats.outstanding + 2);
+
+        // and every packet of a packet list draws from the pool
+        auto packetList = NLPacketList::create(PacketType::EntityData, QByteArray(), true, true);
+        packetList->write(QByteArray(3 * NLPacket::maxPayloadSize(PacketType::EntityData), 'b'));
+        packetList->closeCurrentPacket();
+        QCOMPARE(PacketBufferPool::getStats().outstanding, startStats.outstanding + 2 + (qint64)packetList->getNumPackets());
+    }
+    QCOMPARE(PacketBufferPool::getStats().outstanding, startStats.outstanding);
+
+    // new packets are cleared, whatever the buffer held before
+    auto packet = NLPacket::create(PacketType::AvatarData);
+    for (int i = 0; i < packet->getPayloadCapacity(); i++) {
+        QCOMPARE(packet->getPayload()[i], (char)0);
+    }
+}
+
+void PacketBufferPoolTests::testReceivedPacketLifetime() {
+    auto startStats = PacketBufferPool::getStats();
+    {
+        // the socket reads datagrams into pooled buffers and the packets made from them give the buffers back
+        auto buffer = PacketBufferPool::acquire(0);
+        auto sent = NLPacket::create(PacketType::AvatarData);
+        sent->write(QByteArray(100, 'a'));
+        memcpy(buffer.get(), sent->getData(), sent->getDataSize());
+
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), sent->getDataSize(), HifiSockAddr());
+        packet->setIsPacketPooled(true);
+        QCOMPARE(PacketBufferPool::getStats().outstanding, startStats.outstanding + 2);
+
+        auto received = NLPacket::fromBase(std::move(packet));
+        QCOMPARE(received->getType(), PacketType::AvatarData);
+        QCOMPARE(PacketBufferPool::getStats().outstanding, startStats.outstanding + 2);
+    }
+    QCOMPARE(PacketBufferPool::getStats().outstanding, startStats.outstanding);
+}
+
+void PacketBufferPoolTests::testCrossThreadRelease() {
+    const int NUM_BUFFERS = 1000;
+    auto startStats = PacketBufferPool::getStats();
+
+    // packets are usually created on one thread and destroyed on another
+    for (int round = 0; round < 3; round++) {
+        std::vector<std::unique_ptr<char[]>> buffers;
+        for (int i = 0; i < NUM_BUFFERS; i++) {
+            buffers.push_back(PacketBufferPool::acquire());
+        }
+        std::thread releaser([&] {
+            for (auto& buffer : buffers) {
+                PacketBufferPool::release(std::move(buffer));
+            }
+        });
+        releaser.join();
+    }
+
+    // the buffers released on the other thread came back through the depot
+    auto stats = PacketBufferPool::getStats();
+    QCOMPARE(stats.outstanding, startStats.outstanding);
+    QVERIFY(stats.hits - startStats.hits >= (quint64)(2 * NUM_BUFFERS));
+}
+
+#ifdef MANUAL_TEST
+
+void PacketBufferPoolTests::benchmarkCreatePackets() {
+    const int NUM_PACKETS = 1000000;
+
+    PacketBufferPool::resetCounters();
+    auto startTime = p_high_resolution_clock::now();
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        auto packet = NLPacket::create(PacketType::AvatarData);
+        packet->writePrimitive(i);
+    }
+    auto elapsed = p_high_resolution_clock::now() - startTime;
+
+    auto stats = PacketBufferPool::getStats();
+    qDebug() << "created" << NUM_PACKETS << "packets in"
+        << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms,"
+        << stats.hits << "pool hits," << stats.misses << "misses";
+}
+
+#endif // MANUAL_TEST
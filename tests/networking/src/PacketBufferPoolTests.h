@@ -0,0 +1,32 @@
+//
+//  PacketBufferPoolTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBufferPoolTests_h
+#define hifi_PacketBufferPoolTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class PacketBufferPoolTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testReuse();
+    void testPacketLifetime();
+    void testReceivedPacketLifetime();
+    void testCrossThreadRelease();
+
+#ifdef MANUAL_TEST
+    void benchmarkCreatePackets();
+#endif
+};
+
+#endif // hifi_PacketBufferPoolTests_h
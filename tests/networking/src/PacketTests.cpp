@@ -12,7 +12,10 @@
 #include "PacketTests.h"
 #include "../QTestExtensions.h"
 
+#include <QtCore/QCryptographicHash>
+
 #include <NLPacket.h>
+#include <PortableHighResolutionClock.h>
 
 QTEST_MAIN(PacketTests)
 
@@ -180,3 +183,106 @@ void PacketTests::primitiveTest() {
     QCOMPARE(recvPacket->peekPrimitive(&noValue), 0);
     QCOMPARE(recvPacket->readPrimitive(&noValue), 0);
 }
+
+void PacketTests::verificationHashTest() {
+    auto packet = NLPacket::create(PacketType::EntityEdit);
+    QVERIFY(!PacketTypeEnum::getNonVerifiedPackets().contains(packet->getType()));
+    QByteArray payload(500, 0);
+    for (int i = 0; i < payload.size(); i++) {
+        payload[i] = (char)(i * 7);
+    }
+    packet->write(payload);
+
+    QUuid secret = QUuid::createUuid();
+    auto key = NLPacket::verificationKeyForSecret(secret);
+    packet->writeVerificationHash(key);
+    auto recvPacket = copyToReadPacket(packet);
+
+    // the hash written is the one expected for the secret, and only for that secret and verification
+    QCOMPARE(NLPacket::verificationHashInHeader(*recvPacket), NLPacket::hashForPacket(*recvPacket, key));
+    QVERIFY(NLPacket::isVerificationHashValid(*recvPacket, key));
+    QVERIFY(!NLPacket::isVerificationHashValid(*recvPacket, NLPacket::verificationKeyForSecret(QUuid::createUuid())));
+    QVERIFY(!NLPacket::isVerificationHashValid(*recvPacket,
+                                              NLPacket::verificationKeyForSecret(secret, PacketVerificationVersion::MD5)));
+
+    // the SipHash key is the secret in its RFC 4122 layout
+    QByteArray rfcSecret = secret.toRfc4122();
+    SipHash128 rfcKey(reinterpret_cast<const uint8_t*>(rfcSecret.constData()));
+    QByteArray expectedHash(NUM_BYTES_VERIFICATION_HASH, 0);
+    rfcKey.hash(reinterpret_cast<const uint8_t*>(payload.constData()), payload.size(),
+                reinterpret_cast<uint8_t*>(expectedHash.data()));
+    QCOMPARE(NLPacket::verificationHashInHeader(*recvPacket), expectedHash);
+
+    // and any change to the payload is caught
+    recvPacket->getData()[recvPacket->getDataSize() - 1] ^= 1;
+    QVERIFY(!NLPacket::isVerificationHashValid(*recvPacket, key));
+}
+
+void PacketTests::md5VerificationHashTest() {
+    auto packet = NLPacket::create(PacketType::EntityEdit);
+    QByteArray payload(500, 'x');
+    packet->write(payload);
+
+    // nodes that only have MD5 hash the payload followed by the secret
+    QUuid secret = QUuid::createUuid();
+    auto key = NLPacket::verificationKeyForSecret(secret, PacketVerificationVersion::MD5);
+    packet->writeVerificationHash(key);
+    auto recvPacket = copyToReadPacket(packet);
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(payload);
+    hash.addData(secret.toRfc4122());
+    QCOMPARE(NLPacket::verificationHashInHeader(*recvPacket), hash.result());
+    QVERIFY(NLPacket::isVerificationHashValid(*recvPacket, key));
+    QVERIFY(!NLPacket::isVerificationHashValid(*recvPacket, NLPacket::verificationKeyForSecret(secret)));
+}
+
+#ifdef MANUAL_TEST
+
+void PacketTests::verificationHashBenchmark() {
+    const int NUM_PACKETS = 1000000;
+    const int PAYLOAD_SIZES[] = { 64, 256, 1200 };
+
+    QUuid secret = QUuid::createUuid();
+    auto key = NLPacket::verificationKeyForSecret(secret);
+
+    for (int payloadSize : PAYLOAD_SIZES) {
+        auto packet = NLPacket::create(PacketType::EntityEdit);
+        packet->write(QByteArray(payloadSize, 'x'));
+
+        // what every verified packet sent and received used to compute
+        int offset = NLPacket::totalHeaderSize(packet->getType());
+        const char* payload = packet->getData() + offset;
+        auto startTime = p_high_resolution_clock::now();
+        for (int i = 0; i < NUM_PACKETS; i++) {
+            QCryptographicHash hash(QCryptographicHash::Md5);
+            hash.addData(payload, packet->getDataSize() - offset);
+            hash.addData(secret.toRfc4122());
+            hash.result();
+        }
+        auto md5Time = p_high_resolution_clock::now() - startTime;
+
+        startTime = p_high_resolution_clock::now();
+        for (int i = 0; i < NUM_PACKETS; i++) {
+            packet->writeVerificationHash(key);
+        }
+        auto writeTime = p_high_resolution_clock::now() - startTime;
+
+        int numValid = 0;
+        startTime = p_high_resolution_clock::now();
+        for (int i = 0; i < NUM_PACKETS; i++) {
+            numValid += NLPacket::isVerificationHashValid(*packet, key);
+        }
+        auto verifyTime = p_high_resolution_clock::now() - startTime;
+        QCOMPARE(numValid, NUM_PACKETS);
+
+        auto toMBps = [&](p_high_resolution_clock::duration duration) {
+            auto usecs = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+            return (double)payloadSize * NUM_PACKETS / usecs;
+        };
+        qDebug() << payloadSize << "byte payloads - MD5:" << toMBps(md5Time) << "MB/s, write:" << toMBps(writeTime)
+            << "MB/s, verify:" << toMBps(verifyTime) << "MB/s";
+    }
+}
+
+#endif // MANUAL_TEST
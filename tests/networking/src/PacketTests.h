@@ -16,6 +16,8 @@
 
 #include <QtTest/QtTest>
 
+//#define MANUAL_TEST
+
 class PacketTests : public QObject {
     Q_OBJECT
 private slots:
@@ -36,6 +38,16 @@ private slots:
 
     // Test set/get packet type
     void packetTypeTest();
+
+    // Test the keyed hash of verified packets
+    void verificationHashTest();
+    // and of those verified for nodes that only have MD5
+    void md5VerificationHashTest();
+
+#ifdef MANUAL_TEST
+    // Compare the throughput of the verification hash to the MD5 it replaced
+    void verificationHashBenchmark();
+#endif
 };
 
 #endif // hifi_PacketTests_h
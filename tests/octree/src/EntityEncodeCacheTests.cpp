@@ -0,0 +1,122 @@
+//
+//  EntityEncodeCacheTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEncodeCacheTests.h"
+
+#include <functional>
+
+#include <AACube.h>
+#include <DependencyManager.h>
+#include <EntityItemProperties.h>
+#include <EntityTreeElement.h>
+#include <ModelEntityItem.h>
+#include <NodeList.h>
+#include <OctreePacketData.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntityEncodeCacheTests)
+
+namespace {
+
+EntityItemPointer createModel() {
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Model);
+    properties.setModelURL("http://foo.com/foo.fbx");
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    properties.setDimensions(glm::vec3(1.0f));
+    return ModelEntityItem::factory(EntityItemID(QUuid::createUuid()), properties);
+}
+
+// encode the entity as a send thread would, for a viewer that hasn't seen it
+QByteArray encode(const EntityItemPointer& entity) {
+    EncodeBitstreamParams params;
+    OctreePacketData packetData;
+    EntityTreeElementExtraEncodeDataPointer extraEncodeData { new EntityTreeElementExtraEncodeData() };
+
+    OctreeElement::AppendState state = entity->appendEntityData(&packetData, params, extraEncodeData);
+    if (state != OctreeElement::COMPLETED) {
+        return QByteArray();
+    }
+    return QByteArray((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+}
+
+quint64 getHits() {
+    quint64 hits, misses, bytesReused;
+    EntityItem::getEncodeCacheStats(hits, misses, bytesReused);
+    return hits;
+}
+
+}
+
+void EntityEncodeCacheTests::initTestCase() {
+    // EntityItem wants a NodeList for its simulation owner checks
+    DependencyManager::set<NodeList>(NodeType::Unassigned);
+}
+
+void EntityEncodeCacheTests::testHitMatchesEncode() {
+    EntityItemPointer entity = createModel();
+
+    quint64 hits = getHits();
+    QByteArray encoded = encode(entity);
+    QVERIFY(!encoded.isEmpty());
+    QCOMPARE(getHits(), hits);
+
+    QByteArray cached = encode(entity);
+    QCOMPARE(getHits(), hits + 1);
+    QCOMPARE(cached, encoded);
+}
+
+// each change is expected to miss the cache once, with an encoding that reflects the change, which is then reused
+void verifyInvalidates(const EntityItemPointer& entity, std::function<void()> change) {
+    QByteArray before = encode(entity);
+    QCOMPARE(encode(entity), before);
+
+    change();
+
+    quint64 hits = getHits();
+    QByteArray after = encode(entity);
+    QCOMPARE(getHits(), hits);
+    QVERIFY(after != before);
+
+    QCOMPARE(encode(entity), after);
+    QCOMPARE(getHits(), hits + 1);
+}
+
+void EntityEncodeCacheTests::testAnimationFrameInvalidates() {
+    EntityItemPointer entity = createModel();
+    auto model = std::static_pointer_cast<ModelEntityItem>(entity);
+    verifyInvalidates(entity, [&] {
+        model->setAnimationCurrentFrame(12.0f);
+    });
+}
+
+void EntityEncodeCacheTests::testActionDataInvalidates() {
+    EntityItemPointer entity = createModel();
+    verifyInvalidates(entity, [&] {
+        entity->setDynamicData(QByteArray("action data"));
+    });
+}
+
+void EntityEncodeCacheTests::testQueryAACubeInvalidates() {
+    EntityItemPointer entity = createModel();
+    verifyInvalidates(entity, [&] {
+        entity->setQueryAACube(AACube(glm::vec3(-10.0f), 20.0f));
+    });
+}
+
+void EntityEncodeCacheTests::testEditInvalidates() {
+    EntityItemPointer entity = createModel();
+    verifyInvalidates(entity, [&] {
+        EntityItemProperties properties;
+        properties.setName("edited");
+        entity->setProperties(properties);
+        entity->setLastEdited(usecTimestampNow());
+    });
+}
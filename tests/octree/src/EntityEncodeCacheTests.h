@@ -0,0 +1,28 @@
+//
+//  EntityEncodeCacheTests.h
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEncodeCacheTests_h
+#define hifi_EntityEncodeCacheTests_h
+
+#include <QtTest/QtTest>
+
+class EntityEncodeCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testHitMatchesEncode();
+    void testAnimationFrameInvalidates();
+    void testActionDataInvalidates();
+    void testQueryAACubeInvalidates();
+    void testEditInvalidates();
+};
+
+#endif // hifi_EntityEncodeCacheTests_h
@@ -0,0 +1,259 @@
+//
+//  EntitySpatialIndexTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySpatialIndexTests.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <DependencyManager.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <GLMHelpers.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+QTEST_MAIN(EntitySpatialIndexTests)
+
+// a big flat domain: entities spread wide and thin, with a few large ones
+const float DOMAIN_WIDTH = 2000.0f;
+const float DOMAIN_HEIGHT = 20.0f;
+const float MIN_DIMENSION = 0.1f;
+const float MAX_DIMENSION = 4.0f;
+const float LARGE_DIMENSION = 200.0f;
+const int LARGE_ENTITY_INTERVAL = 100;
+
+float randomFloat() {
+    return (float)rand() / (float)RAND_MAX;
+}
+
+glm::vec3 randomPosition() {
+    return glm::vec3(DOMAIN_WIDTH * (randomFloat() - 0.5f), DOMAIN_HEIGHT * randomFloat(),
+        DOMAIN_WIDTH * (randomFloat() - 0.5f));
+}
+
+EntityTreePointer createTree(int numEntities, QVector<EntityItemID>& entityIDs) {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->setIsClient(false);
+
+    srand(1);
+    tree->withWriteLock([&] {
+        for (int i = 0; i < numEntities; i++) {
+            float dimension = (i % LARGE_ENTITY_INTERVAL == 0) ?
+                LARGE_DIMENSION : MIN_DIMENSION + (MAX_DIMENSION - MIN_DIMENSION) * randomFloat();
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setPosition(randomPosition());
+            properties.setDimensions(glm::vec3(dimension));
+
+            EntityItemID entityID(QUuid::createUuid());
+            if (tree->addEntity(entityID, properties)) {
+                entityIDs.push_back(entityID);
+            }
+        }
+    });
+    return tree;
+}
+
+bool countElementsWithEntities(const OctreeElementPointer& element, void* extraData) {
+    if (std::static_pointer_cast<EntityTreeElement>(element)->hasEntities()) {
+        ++*static_cast<size_t*>(extraData);
+    }
+    return true;
+}
+
+QSet<EntityItemID> toIDs(const QVector<EntityItemPointer>& entities) {
+    QSet<EntityItemID> ids;
+    for (auto& entity : entities) {
+        ids.insert(entity->getEntityItemID());
+    }
+    return ids;
+}
+
+ViewFrustum makeFrustum(const glm::vec3& position, float yaw) {
+    ViewFrustum frustum;
+    frustum.setProjection(glm::perspective(PI / 3.0f, 16.0f / 9.0f, 0.1f, 300.0f));
+    frustum.setPosition(position);
+    frustum.setOrientation(glm::angleAxis(yaw, Vectors::UNIT_Y));
+    frustum.setCenterRadius(5.0f);
+    frustum.calculate();
+    return frustum;
+}
+
+void EntitySpatialIndexTests::initTestCase() {
+    // EntityTree::addEntity() wants a NodeList
+    DependencyManager::set<NodeList>(NodeType::Unassigned);
+}
+
+void EntitySpatialIndexTests::testIndexedElements() {
+    const int NUM_ENTITIES = 1000;
+    QVector<EntityItemID> entityIDs;
+    EntityTreePointer tree = createTree(NUM_ENTITIES, entityIDs);
+    QCOMPARE(entityIDs.size(), NUM_ENTITIES);
+
+    // the index holds exactly the elements that hold entities
+    size_t numElements = 0;
+    tree->recurseTreeWithOperation(countElementsWithEntities, &numElements);
+    QVERIFY(numElements > 0);
+    QVERIFY(tree->getSpatialIndex().getNumElements() == numElements);
+
+    // moving entities around keeps it that way
+    tree->withWriteLock([&] {
+        for (int i = 0; i < NUM_ENTITIES; i += 2) {
+            EntityItemProperties properties;
+            properties.setPosition(randomPosition());
+            tree->updateEntity(entityIDs[i], properties);
+        }
+    });
+    numElements = 0;
+    tree->recurseTreeWithOperation(countElementsWithEntities, &numElements);
+    QVERIFY(tree->getSpatialIndex().getNumElements() == numElements);
+
+    tree->withWriteLock([&] {
+        for (int i = 0; i < NUM_ENTITIES / 2; i++) {
+            tree->deleteEntity(entityIDs[i], true);
+        }
+    });
+    numElements = 0;
+    tree->recurseTreeWithOperation(countElementsWithEntities, &numElements);
+    QVERIFY(tree->getSpatialIndex().getNumElements() == numElements);
+
+    tree->eraseAllOctreeElements();
+    QVERIFY(tree->getSpatialIndex().getNumElements() == 0);
+}
+
+void EntitySpatialIndexTests::testQueriesMatchOctree() {
+    const int NUM_ENTITIES = 2000;
+    const int NUM_QUERIES = 100;
+    QVector<EntityItemID> entityIDs;
+    EntityTreePointer tree = createTree(NUM_ENTITIES, entityIDs);
+
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        glm::vec3 center = randomPosition();
+        float radius = (i % 10 == 0) ? 100.0f : 10.0f * randomFloat();
+        AACube cube(center - glm::vec3(radius), 2.0f * radius);
+        AABox box(center, glm::vec3(2.0f * radius, 0.5f * radius, radius));
+        ViewFrustum frustum = makeFrustum(center, TWO_PI * randomFloat());
+
+        QVector<EntityItemPointer> indexed[4];
+        QVector<EntityItemPointer> recursed[4];
+        for (int pass = 0; pass < 2; pass++) {
+            auto& found = (pass == 0) ? indexed : recursed;
+            tree->setSpatialIndexEnabled(pass == 0);
+            tree->withReadLock([&] {
+                tree->findEntities(center, radius, found[0]);
+                tree->findEntities(cube, found[1]);
+                tree->findEntities(box, found[2]);
+                tree->findEntities(frustum, found[3]);
+            });
+        }
+        for (int query = 0; query < 4; query++) {
+            QCOMPARE(indexed[query].size(), recursed[query].size());
+            QCOMPARE(toIDs(indexed[query]), toIDs(recursed[query]));
+        }
+
+        // a flat domain is mostly picked along the ground
+        glm::vec3 direction = glm::normalize(glm::vec3(randomFloat() - 0.5f, -0.1f * randomFloat(), randomFloat() - 0.5f));
+        EntityItemID hitIDs[2];
+        float distances[2];
+        for (int pass = 0; pass < 2; pass++) {
+            tree->setSpatialIndexEnabled(pass == 0);
+            OctreeElementPointer element;
+            BoxFace face;
+            glm::vec3 surfaceNormal;
+            QVariantMap extraInfo;
+            hitIDs[pass] = tree->findRayIntersection(center, direction, QVector<EntityItemID>(), QVector<EntityItemID>(),
+                false, false, false, element, distances[pass], face, surfaceNormal, extraInfo, Octree::Lock);
+        }
+        QCOMPARE(hitIDs[0], hitIDs[1]);
+        QCOMPARE(distances[0], distances[1]);
+    }
+}
+
+#ifdef MANUAL_TEST
+
+void EntitySpatialIndexTests::benchmarkQueries() {
+    const int NUM_QUERIES = 10000;
+    const float QUERY_RADIUS = 10.0f;
+    const int numEntitiesList[] = { 1000, 10000, 100000 };
+
+    for (int numEntities : numEntitiesList) {
+        QVector<EntityItemID> entityIDs;
+        EntityTreePointer tree = createTree(numEntities, entityIDs);
+
+        std::vector<glm::vec3> centers;
+        std::vector<glm::vec3> directions;
+        for (int i = 0; i < NUM_QUERIES; i++) {
+            centers.push_back(randomPosition());
+            directions.push_back(glm::normalize(glm::vec3(randomFloat() - 0.5f, -0.1f * randomFloat(), randomFloat() - 0.5f)));
+        }
+
+        qDebug() << "numEntities =" << numEntities << "numIndexedElements =" << tree->getSpatialIndex().getNumElements();
+        for (int pass = 0; pass < 2; pass++) {
+            tree->setSpatialIndexEnabled(pass == 0);
+
+            size_t numFound = 0;
+            uint64_t startTime = usecTimestampNow();
+            tree->withReadLock([&] {
+                QVector<EntityItemPointer> found;
+                for (int i = 0; i < NUM_QUERIES; i++) {
+                    tree->findEntities(centers[i], QUERY_RADIUS, found);
+                    numFound += found.size();
+                }
+            });
+            uint64_t sphereTime = usecTimestampNow() - startTime;
+
+            startTime = usecTimestampNow();
+            tree->withReadLock([&] {
+                QVector<EntityItemPointer> found;
+                for (int i = 0; i < NUM_QUERIES; i++) {
+                    tree->findEntities(AABox(centers[i], glm::vec3(2.0f * QUERY_RADIUS)), found);
+                    numFound += found.size();
+                }
+            });
+            uint64_t boxTime = usecTimestampNow() - startTime;
+
+            startTime = usecTimestampNow();
+            tree->withReadLock([&] {
+                QVector<EntityItemPointer> found;
+                for (int i = 0; i < NUM_QUERIES; i++) {
+                    tree->findEntities(makeFrustum(centers[i], TWO_PI * (float)i / (float)NUM_QUERIES), found);
+                    numFound += found.size();
+                }
+            });
+            uint64_t frustumTime = usecTimestampNow() - startTime;
+
+            startTime = usecTimestampNow();
+            for (int i = 0; i < NUM_QUERIES; i++) {
+                OctreeElementPointer element;
+                float distance;
+                BoxFace face;
+                glm::vec3 surfaceNormal;
+                QVariantMap extraInfo;
+                tree->findRayIntersection(centers[i], directions[i], QVector<EntityItemID>(), QVector<EntityItemID>(),
+                    false, false, false, element, distance, face, surfaceNormal, extraInfo, Octree::Lock);
+            }
+            uint64_t rayTime = usecTimestampNow() - startTime;
+
+            qDebug() << (pass == 0 ? "  index: " : "  octree:")
+                << "sphere" << (float)sphereTime / (float)NUM_QUERIES << "usec"
+                << "box" << (float)boxTime / (float)NUM_QUERIES << "usec"
+                << "frustum" << (float)frustumTime / (float)NUM_QUERIES << "usec"
+                << "ray" << (float)rayTime / (float)NUM_QUERIES << "usec"
+                << "(found" << numFound << ")";
+        }
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,30 @@
+//
+//  EntitySpatialIndexTests.h
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialIndexTests_h
+#define hifi_EntitySpatialIndexTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class EntitySpatialIndexTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testIndexedElements();
+    void testQueriesMatchOctree();
+#ifdef MANUAL_TEST
+    void benchmarkQueries();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_EntitySpatialIndexTests_h
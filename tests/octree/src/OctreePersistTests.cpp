@@ -0,0 +1,159 @@
+//
+//  OctreePersistTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreePersistTests.h"
+
+#include <QTemporaryDir>
+
+#include <DependencyManager.h>
+#include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <OctreePersistThread.h>
+#include <RecordLog.h>
+
+QTEST_MAIN(OctreePersistTests)
+
+const quint32 VERSION = 1;
+
+void OctreePersistTests::initTestCase() {
+    // EntityTree::addEntity() wants a NodeList
+    DependencyManager::set<NodeList>(NodeType::Unassigned);
+}
+
+void OctreePersistTests::testSnapshotRoundTrip() {
+    const int NUM_ENTITIES = 100;
+
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->setIsClient(false);
+    tree->withWriteLock([&] {
+        for (int i = 0; i < NUM_ENTITIES; i++) {
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setName(QString("box %1").arg(i));
+            properties.setPosition(glm::vec3((float)i, 1.0f, -(float)i));
+            properties.setDimensions(glm::vec3(0.5f));
+            tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+        }
+    });
+
+    Octree::PersistRecords records;
+    tree->withReadLock([&] {
+        tree->encodePersistChanges(records, true);
+    });
+    QCOMPARE(records.size(), NUM_ENTITIES);
+
+    QTemporaryDir dir;
+    QString snapshotFilename = dir.filePath("models.json.gz.snapshot");
+    QUuid persistID = QUuid::createUuid();
+    QVERIFY(OctreePersistThread::writePersistSnapshot(snapshotFilename, tree->expectedVersion(), persistID, 7, records) > 0);
+
+    Octree::PersistRecords readRecords;
+    QUuid readPersistID;
+    qint32 readDataVersion = 0;
+    QVERIFY(OctreePersistThread::readPersistSnapshot(snapshotFilename, QStringList(), tree->expectedVersion(),
+                                                     readRecords, readPersistID, readDataVersion));
+    QCOMPARE(readPersistID, persistID);
+    QCOMPARE(readDataVersion, 7);
+    QVERIFY(readRecords == records);
+
+    // and the records decode back into the same entities
+    EntityTreePointer readTree = std::make_shared<EntityTree>();
+    readTree->createRootElement();
+    readTree->setIsClient(false);
+    readTree->withWriteLock([&] {
+        QVERIFY(readTree->readPersistRecords(readRecords));
+    });
+    for (auto it = records.begin(); it != records.end(); ++it) {
+        auto entity = tree->findEntityByEntityItemID(it.key());
+        auto readEntity = readTree->findEntityByEntityItemID(it.key());
+        QVERIFY(readEntity);
+        QCOMPARE(readEntity->getName(), entity->getName());
+        QVERIFY(readEntity->getWorldPosition() == entity->getWorldPosition());
+        QCOMPARE(readEntity->getCreated(), entity->getCreated());
+    }
+}
+
+void OctreePersistTests::testLogReplay() {
+    QUuid a = QUuid::createUuid();
+    QUuid b = QUuid::createUuid();
+    QUuid c = QUuid::createUuid();
+
+    Octree::PersistRecords records;
+    records[a] = "a1";
+    records[b] = "b1";
+
+    QTemporaryDir dir;
+    QString snapshotFilename = dir.filePath("models.json.gz.snapshot");
+    QString compactingLogFilename = dir.filePath("models.json.gz.log.compacting");
+    QString logFilename = dir.filePath("models.json.gz.log");
+    QUuid persistID = QUuid::createUuid();
+    QVERIFY(OctreePersistThread::writePersistSnapshot(snapshotFilename, VERSION, persistID, 3, records) > 0);
+
+    {
+        // the log being folded into the next snapshot: an edit, a delete and an add
+        RecordLog log { compactingLogFilename };
+        QVERIFY(log.open());
+        Octree::PersistRecords changes;
+        changes[a] = "a2";
+        changes[b] = QByteArray();
+        QVERIFY(OctreePersistThread::appendPersistLog(log, VERSION, 4, changes));
+        changes.clear();
+        changes[c] = "c1";
+        QVERIFY(OctreePersistThread::appendPersistLog(log, VERSION, 5, changes));
+    }
+    {
+        // the current log, with a torn record at the end
+        RecordLog log { logFilename };
+        QVERIFY(log.open());
+        Octree::PersistRecords changes;
+        changes[a] = "a3";
+        QVERIFY(OctreePersistThread::appendPersistLog(log, VERSION, 6, changes));
+        qint64 size = log.size();
+        changes[c] = QByteArray();
+        QVERIFY(OctreePersistThread::appendPersistLog(log, VERSION, 7, changes));
+        qint64 tornSize = size + (log.size() - size) / 2;
+        log.close();
+        QVERIFY(QFile::resize(logFilename, tornSize));
+    }
+
+    Octree::PersistRecords readRecords;
+    QUuid readPersistID;
+    qint32 readDataVersion = 0;
+    QVERIFY(OctreePersistThread::readPersistSnapshot(snapshotFilename, { compactingLogFilename, logFilename }, VERSION,
+                                                     readRecords, readPersistID, readDataVersion));
+    QCOMPARE(readPersistID, persistID);
+    QCOMPARE(readDataVersion, 6);
+    QCOMPARE(readRecords.size(), 2);
+    QCOMPARE(readRecords[a], QByteArray("a3"));
+    QCOMPARE(readRecords[c], QByteArray("c1"));
+    QVERIFY(!readRecords.contains(b));
+}
+
+void OctreePersistTests::testRejectsOtherVersion() {
+    Octree::PersistRecords records;
+    records[QUuid::createUuid()] = "a1";
+
+    QTemporaryDir dir;
+    QString snapshotFilename = dir.filePath("models.json.gz.snapshot");
+    QVERIFY(OctreePersistThread::writePersistSnapshot(snapshotFilename, VERSION, QUuid::createUuid(), 1, records) > 0);
+
+    Octree::PersistRecords readRecords;
+    QUuid readPersistID;
+    qint32 readDataVersion = 0;
+    QVERIFY(!OctreePersistThread::readPersistSnapshot(snapshotFilename, QStringList(), VERSION + 1,
+                                                      readRecords, readPersistID, readDataVersion));
+    QVERIFY(readRecords.isEmpty());
+
+    // nor is a missing snapshot read
+    QVERIFY(!OctreePersistThread::readPersistSnapshot(dir.filePath("missing.snapshot"), QStringList(), VERSION,
+                                                      readRecords, readPersistID, readDataVersion));
+}
@@ -0,0 +1,26 @@
+//
+//  OctreePersistTests.h
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreePersistTests_h
+#define hifi_OctreePersistTests_h
+
+#include <QtTest/QtTest>
+
+class OctreePersistTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testSnapshotRoundTrip();
+    void testLogReplay();
+    void testRejectsOtherVersion();
+};
+
+#endif // hifi_OctreePersistTests_h
@@ -0,0 +1,68 @@
+//
+//  RecordLogTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RecordLogTests.h"
+
+#include <QTemporaryDir>
+
+#include <RecordLog.h>
+
+QTEST_MAIN(RecordLogTests)
+
+static QStringList readAll(const RecordLog& log, qint64& validSize) {
+    QStringList payloads;
+    validSize = log.read([&](const QByteArray& payload) {
+        payloads << QString::fromUtf8(payload);
+        return true;
+    });
+    return payloads;
+}
+
+void RecordLogTests::testTornRecord() {
+    QTemporaryDir dir;
+    RecordLog log { dir.filePath("test.log") };
+    QVERIFY(log.open());
+    QVERIFY(log.append("one"));
+    QVERIFY(log.append("two"));
+    qint64 size = log.size();
+    QVERIFY(log.append("three"));
+    log.close();
+    QVERIFY(QFile::resize(log.getPath(), size + 4));
+
+    qint64 validSize;
+    QCOMPARE(readAll(log, validSize), QStringList({ "one", "two" }));
+    QCOMPARE(validSize, size);
+
+    // reopening drops the torn record, so the next one lines up
+    QVERIFY(log.open(validSize));
+    QVERIFY(log.append("four"));
+    log.close();
+    QCOMPARE(readAll(log, validSize), QStringList({ "one", "two", "four" }));
+}
+
+void RecordLogTests::testRotate() {
+    QTemporaryDir dir;
+    RecordLog log { dir.filePath("test.log") };
+    QVERIFY(log.open());
+    QVERIFY(log.append("one"));
+    QVERIFY(log.rotate());
+    QVERIFY(log.append("two"));
+
+    // the rotated log wasn't removed, so the next rotation appends to it
+    QVERIFY(log.rotate());
+    QVERIFY(log.append("three"));
+    log.close();
+
+    qint64 validSize;
+    QCOMPARE(readAll(log, validSize), QStringList({ "one", "two", "three" }));
+
+    log.removeRotated();
+    QCOMPARE(readAll(log, validSize), QStringList({ "three" }));
+}
@@ -0,0 +1,24 @@
+//
+//  RecordLogTests.h
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RecordLogTests_h
+#define hifi_RecordLogTests_h
+
+#include <QtTest/QtTest>
+
+class RecordLogTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testTornRecord();
+    void testRotate();
+};
+
+#endif // hifi_RecordLogTests_h
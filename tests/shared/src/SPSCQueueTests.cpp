@@ -0,0 +1,91 @@
+//
+//  SPSCQueueTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SPSCQueueTests.h"
+
+#include <memory>
+#include <thread>
+
+#include <SPSCQueue.h>
+
+QTEST_MAIN(SPSCQueueTests)
+
+void SPSCQueueTests::testFIFO() {
+    SPSCQueue<int> queue(8);
+    QVERIFY(queue.isEmpty());
+
+    int value = -1;
+    QVERIFY(!queue.pop(value));
+    QCOMPARE(value, -1);
+
+    // wrap around the slots several times
+    int next = 0;
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 5; i++) {
+            QVERIFY(queue.push(round * 5 + i));
+        }
+        QCOMPARE((int)queue.size(), 5);
+        for (int i = 0; i < 5; i++) {
+            QVERIFY(queue.pop(value));
+            QCOMPARE(value, next++);
+        }
+        QVERIFY(queue.isEmpty());
+    }
+}
+
+void SPSCQueueTests::testFull() {
+    SPSCQueue<std::shared_ptr<int>> queue(5);
+    QCOMPARE((int)queue.capacity(), 8);
+
+    auto item = std::make_shared<int>(42);
+    for (int i = 0; i < 8; i++) {
+        QVERIFY(queue.push(item));
+    }
+    QVERIFY(!queue.push(item));
+    QCOMPARE((int)item.use_count(), 9);
+
+    // popped slots let go of what they held
+    std::shared_ptr<int> value;
+    while (queue.pop(value)) {
+        QCOMPARE(*value, 42);
+    }
+    value.reset();
+    QCOMPARE((int)item.use_count(), 1);
+    QVERIFY(queue.push(item));
+}
+
+void SPSCQueueTests::testConcurrentProducerConsumer() {
+    const int NUM_ITEMS = 1000000;
+    SPSCQueue<int> queue(64);
+
+    std::thread producer([&] {
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int next = 0;
+    int value;
+    bool inOrder = true;
+    while (next < NUM_ITEMS) {
+        if (queue.pop(value)) {
+            inOrder = inOrder && (value == next);
+            ++next;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    QVERIFY(inOrder);
+    QVERIFY(queue.isEmpty());
+}
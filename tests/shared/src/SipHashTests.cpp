@@ -0,0 +1,44 @@
+//
+//  SipHashTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHashTests.h"
+
+#include <SipHash.h>
+
+QTEST_MAIN(SipHashTests)
+
+void SipHashTests::testReferenceVectors() {
+    // from the SipHash reference implementation: key 00 01 .. 0f, messages 00 01 .. (length - 1)
+    struct Vector {
+        int length;
+        const char* hash;
+    };
+    const Vector VECTORS[] = {
+        { 0, "a3817f04ba25a8e66df67214c7550293" },
+        { 1, "da87c1d86b99af44347659119b22fc45" },
+        { 63, "5150d1772f50834a503e069a973fbd7c" }
+    };
+
+    uint8_t key[SipHash128::KEY_SIZE];
+    for (int i = 0; i < SipHash128::KEY_SIZE; i++) {
+        key[i] = (uint8_t)i;
+    }
+    uint8_t message[64];
+    for (int i = 0; i < 64; i++) {
+        message[i] = (uint8_t)i;
+    }
+
+    SipHash128 sipHash(key);
+    for (const Vector& vector : VECTORS) {
+        QByteArray hash(SipHash128::HASH_SIZE, 0);
+        sipHash.hash(message, vector.length, reinterpret_cast<uint8_t*>(hash.data()));
+        QCOMPARE(hash.toHex(), QByteArray(vector.hash));
+    }
+}
@@ -0,0 +1,179 @@
+//
+//  SnapshotPointerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SnapshotPointerTests.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QReadWriteLock>
+
+#include <NumericalConstants.h>
+#include <PortableHighResolutionClock.h>
+#include <SnapshotPointer.h>
+
+QTEST_MAIN(SnapshotPointerTests)
+
+struct TestSnapshot {
+    int generation { 0 };
+    std::vector<std::shared_ptr<int>> values;
+};
+
+static std::shared_ptr<TestSnapshot> makeSnapshot(int generation, int numValues) {
+    auto snapshot = std::make_shared<TestSnapshot>();
+    snapshot->generation = generation;
+    for (int i = 0; i < numValues; i++) {
+        snapshot->values.push_back(std::make_shared<int>(generation));
+    }
+    return snapshot;
+}
+
+void SnapshotPointerTests::testPublish() {
+    SnapshotPointer<TestSnapshot> pointer;
+    QCOMPARE(pointer.get()->generation, 0);
+    QVERIFY(pointer.get()->values.empty());
+
+    pointer.set(makeSnapshot(1, 3));
+    auto held = pointer.get();
+    QCOMPARE(held->generation, 1);
+    QCOMPARE(pointer.get(), held);
+
+    // a held snapshot is unchanged by later ones
+    auto version = pointer.getVersion();
+    pointer.set(makeSnapshot(2, 5));
+    QVERIFY(pointer.getVersion() != version);
+    QCOMPARE(pointer.get()->generation, 2);
+    QCOMPARE(held->generation, 1);
+    QCOMPARE((int)held->values.size(), 3);
+
+    // and the reader's cache doesn't keep an old snapshot alive
+    std::weak_ptr<const TestSnapshot> weakHeld = held;
+    held.reset();
+    QVERIFY(weakHeld.expired());
+}
+
+void SnapshotPointerTests::testSeparateInstances() {
+    // a thread reading from several instances gets each one's own snapshot
+    SnapshotPointer<TestSnapshot> first;
+    SnapshotPointer<TestSnapshot> second;
+    first.set(makeSnapshot(1, 0));
+    second.set(makeSnapshot(2, 0));
+
+    for (int i = 0; i < 3; i++) {
+        QCOMPARE(first.get()->generation, 1);
+        QCOMPARE(second.get()->generation, 2);
+    }
+}
+
+void SnapshotPointerTests::testConcurrentReaders() {
+    const int NUM_READERS = 4;
+    const int NUM_GENERATIONS = 2000;
+
+    SnapshotPointer<TestSnapshot> pointer;
+    std::atomic<bool> isDone { false };
+    std::atomic<int> numErrors { 0 };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < NUM_READERS; i++) {
+        readers.emplace_back([&] {
+            int lastGeneration = 0;
+            while (!isDone.load()) {
+                auto snapshot = pointer.get();
+
+                // generations only move forwards, and every snapshot is whole
+                if (snapshot->generation < lastGeneration) {
+                    ++numErrors;
+                }
+                for (const auto& value : snapshot->values) {
+                    if (*value != snapshot->generation) {
+                        ++numErrors;
+                    }
+                }
+                lastGeneration = snapshot->generation;
+            }
+        });
+    }
+
+    for (int generation = 1; generation <= NUM_GENERATIONS; generation++) {
+        pointer.set(makeSnapshot(generation, 16));
+    }
+    isDone = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    QCOMPARE(numErrors.load(), 0);
+    QCOMPARE(pointer.get()->generation, NUM_GENERATIONS);
+}
+
+#ifdef MANUAL_TEST
+
+void SnapshotPointerTests::benchmarkIteration() {
+    // about a busy domain: threads iterate the nodes many times a frame, while nodes come and go rarely
+    const int NUM_NODES = 200;
+    const int NUM_ITERATIONS = 100000;
+    const int THREAD_COUNTS[] = { 1, 8, 16, 32 };
+
+    auto nodes = makeSnapshot(1, NUM_NODES);
+    QReadWriteLock lock { QReadWriteLock::Recursive };
+    SnapshotPointer<TestSnapshot> pointer;
+    pointer.set(nodes);
+
+    auto runThreads = [&](int numThreads, std::function<int()> iterate) {
+        std::atomic<int> sum { 0 };
+        auto startTime = p_high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; i++) {
+            threads.emplace_back([&] {
+                int threadSum = 0;
+                for (int j = 0; j < NUM_ITERATIONS; j++) {
+                    threadSum += iterate();
+                }
+                sum += threadSum;
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto elapsed = p_high_resolution_clock::now() - startTime;
+        QCOMPARE(sum.load(), numThreads * NUM_ITERATIONS * NUM_NODES);
+
+        // iterations per second, across all threads
+        auto usecs = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        return (double)numThreads * NUM_ITERATIONS / usecs * USECS_PER_SECOND;
+    };
+
+    for (int numThreads : THREAD_COUNTS) {
+        auto lockedRate = runThreads(numThreads, [&] {
+            QReadLocker readLock(&lock);
+            int count = 0;
+            for (const auto& value : nodes->values) {
+                count += *value;
+            }
+            return count;
+        });
+
+        auto snapshotRate = runThreads(numThreads, [&] {
+            auto snapshot = pointer.get();
+            int count = 0;
+            for (const auto& value : snapshot->values) {
+                count += *value;
+            }
+            return count;
+        });
+
+        qDebug() << numThreads << "threads - read locked:" << lockedRate << "iterations/s, snapshot:"
+            << snapshotRate << "iterations/s";
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,30 @@
+//
+//  SnapshotPointerTests.h
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SnapshotPointerTests_h
+#define hifi_SnapshotPointerTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class SnapshotPointerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testPublish();
+    void testSeparateInstances();
+    void testConcurrentReaders();
+#ifdef MANUAL_TEST
+    void benchmarkIteration();
+#endif
+};
+
+#endif // hifi_SnapshotPointerTests_h
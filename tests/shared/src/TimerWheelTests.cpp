@@ -0,0 +1,275 @@
+//
+//  TimerWheelTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TimerWheelTests.h"
+
+#include <random>
+#include <thread>
+
+#include <QtCore/QTimer>
+
+#include <PortableHighResolutionClock.h>
+#include <TimerWheel.h>
+
+QTEST_MAIN(TimerWheelTests)
+
+using TestTimers = TimerWheel<int, int>;
+
+void TimerWheelTests::testFiresInExpiryOrder() {
+    const int NUM_TIMERS = 10000;
+    const TestTimers::Ticks START = 12345;
+    std::mt19937 random(1);
+
+    // delays spread over every level of the wheel
+    TestTimers timers(START);
+    std::vector<TestTimers::Ticks> expiries;
+    for (int i = 0; i < NUM_TIMERS; i++) {
+        quint32 delay = random() % (1 << (8 + 6 * (i % 4)));
+        expiries.push_back(START + delay);
+        timers.add(0, i, START, delay, true);
+    }
+    QCOMPARE((int)timers.size(), NUM_TIMERS);
+
+    int numFired = 0;
+    TestTimers::Ticks now = START;
+    TestTimers::Ticks lastExpiry = 0;
+    bool isOnTime = true;
+    bool isInOrder = true;
+    while (!timers.isEmpty()) {
+        // the wheel never reports its next expiry late
+        TestTimers::Ticks nextExpiry = timers.getNextExpiry();
+        QVERIFY(nextExpiry >= now);
+        now = std::max(nextExpiry, now + random() % 1000);
+        timers.fireDue(now, [&](const int& i) {
+            isOnTime = isOnTime && expiries[i] <= now && expiries[i] >= nextExpiry;
+            isInOrder = isInOrder && expiries[i] >= lastExpiry;
+            lastExpiry = expiries[i];
+            ++numFired;
+        });
+    }
+    QVERIFY(isOnTime);
+    QVERIFY(isInOrder);
+    QCOMPARE(numFired, NUM_TIMERS);
+
+    // stepping a tick at a time, every timer fires on its expiry
+    now++;
+    expiries.clear();
+    for (int i = 0; i < NUM_TIMERS; i++) {
+        quint32 delay = random() % 20000;
+        expiries.push_back(now + delay);
+        timers.add(0, i, now, delay, true);
+    }
+    numFired = 0;
+    for (TestTimers::Ticks tick = now; !timers.isEmpty(); tick++) {
+        timers.fireDue(tick, [&](const int& i) {
+            isOnTime = isOnTime && expiries[i] == tick;
+            ++numFired;
+        });
+    }
+    QVERIFY(isOnTime);
+    QCOMPARE(numFired, NUM_TIMERS);
+}
+
+void TimerWheelTests::testRepeatingTimers() {
+    const quint32 INTERVAL = 10;
+    TestTimers timers;
+    auto id = timers.add(0, 0, 0, INTERVAL, false);
+
+    int numFired = 0;
+    auto countFired = [&](const int&) { ++numFired; };
+    for (TestTimers::Ticks tick = 0; tick <= 100; tick++) {
+        timers.fireDue(tick, countFired);
+    }
+    QCOMPARE(numFired, 10);
+    QVERIFY(timers.contains(id));
+
+    // a timer that fell behind doesn't fire for every interval it missed, and keeps its interval from then on
+    numFired = 0;
+    timers.fireDue(1000, countFired);
+    QCOMPARE(numFired, 1);
+    timers.fireDue(1009, countFired);
+    QCOMPARE(numFired, 1);
+    timers.fireDue(1010, countFired);
+    QCOMPARE(numFired, 2);
+
+    QVERIFY(timers.remove(id));
+    QVERIFY(!timers.contains(id));
+    QVERIFY(timers.isEmpty());
+    QVERIFY(timers.getNextExpiry() == TestTimers::NO_EXPIRY);
+}
+
+void TimerWheelTests::testRemoveTimers() {
+    const int NUM_OWNERS = 10;
+    const int TIMERS_PER_OWNER = 100;
+    TestTimers timers;
+    std::vector<TestTimers::TimerID> ids;
+    for (int i = 0; i < NUM_OWNERS * TIMERS_PER_OWNER; i++) {
+        ids.push_back(timers.add(i % NUM_OWNERS, i, 0, 100 + i, true));
+    }
+
+    QCOMPARE(timers.removeOwner(3), TIMERS_PER_OWNER);
+    QCOMPARE(timers.removeOwner(3), 0);
+    QCOMPARE((int)timers.size(), (NUM_OWNERS - 1) * TIMERS_PER_OWNER);
+    for (int i = 0; i < NUM_OWNERS * TIMERS_PER_OWNER; i++) {
+        QCOMPARE(timers.contains(ids[i]), i % NUM_OWNERS != 3);
+    }
+
+    // ids aren't reused, so a stale id doesn't remove the timer that took its place
+    auto newID = timers.add(3, 0, 0, 100, true);
+    QVERIFY(!timers.remove(ids[3]));
+    QVERIFY(timers.contains(newID));
+
+    // timers can remove others, even ones due at the same time
+    timers.clear();
+    ids.clear();
+    for (int i = 0; i < 10; i++) {
+        ids.push_back(timers.add(0, i, 0, 5, true));
+    }
+    std::vector<int> fired;
+    timers.fireDue(5, [&](const int& i) {
+        fired.push_back(i);
+        timers.remove(ids[i + 1]);
+    });
+    QCOMPARE((int)fired.size(), 5);
+    for (size_t i = 0; i < fired.size(); i++) {
+        QCOMPARE(fired[i], 2 * (int)i);
+    }
+    QVERIFY(timers.isEmpty());
+}
+
+#ifdef MANUAL_TEST
+
+void TimerWheelTests::benchmarkScheduling() {
+    const int NUM_TIMERS = 1000000;
+    std::mt19937 random(1);
+    std::vector<quint32> delays;
+    for (int i = 0; i < NUM_TIMERS; i++) {
+        delays.push_back(random() % 60000);
+    }
+
+    TestTimers timers;
+    std::vector<TestTimers::TimerID> ids(NUM_TIMERS);
+    auto startTime = p_high_resolution_clock::now();
+    for (int i = 0; i < NUM_TIMERS; i++) {
+        ids[i] = timers.add(i % 1000, i, 0, delays[i], true);
+    }
+    auto addTime = p_high_resolution_clock::now() - startTime;
+
+    startTime = p_high_resolution_clock::now();
+    for (int owner = 0; owner < 1000; owner += 2) {
+        timers.removeOwner(owner);
+    }
+    auto removeTime = p_high_resolution_clock::now() - startTime;
+
+    int numFired = 0;
+    startTime = p_high_resolution_clock::now();
+    for (TestTimers::Ticks tick = 0; tick < 60000; tick += 16) {
+        timers.fireDue(tick, [&](const int&) { ++numFired; });
+    }
+    auto fireTime = p_high_resolution_clock::now() - startTime;
+
+    // the same timers, one QTimer each
+    std::vector<QTimer*> qtimers(NUM_TIMERS);
+    startTime = p_high_resolution_clock::now();
+    for (int i = 0; i < NUM_TIMERS; i++) {
+        qtimers[i] = new QTimer();
+        qtimers[i]->setSingleShot(true);
+        qtimers[i]->start(delays[i]);
+    }
+    auto qtimerAddTime = p_high_resolution_clock::now() - startTime;
+    startTime = p_high_resolution_clock::now();
+    for (auto timer : qtimers) {
+        timer->stop();
+        delete timer;
+    }
+    auto qtimerRemoveTime = p_high_resolution_clock::now() - startTime;
+
+    auto nsecsPerTimer = [&](p_high_resolution_clock::duration duration, int numTimers) {
+        return (float)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / (float)numTimers;
+    };
+    qDebug() << "TimerWheel: add" << nsecsPerTimer(addTime, NUM_TIMERS) << "ns"
+        << "removeOwner" << nsecsPerTimer(removeTime, NUM_TIMERS / 2) << "ns"
+        << "fire" << nsecsPerTimer(fireTime, numFired) << "ns per timer";
+    qDebug() << "QTimer: start" << nsecsPerTimer(qtimerAddTime, NUM_TIMERS) << "ns"
+        << "stop" << nsecsPerTimer(qtimerRemoveTime, NUM_TIMERS) << "ns per timer";
+}
+
+void TimerWheelTests::benchmarkFiringJitter() {
+    const int NUM_TIMERS = 10000;
+    const int MAX_DELAY = 2000;
+    std::mt19937 random(1);
+    std::vector<quint32> delays;
+    for (int i = 0; i < NUM_TIMERS; i++) {
+        delays.push_back(random() % MAX_DELAY);
+    }
+
+    auto report = [&](const char* name, const std::vector<qint64>& lateness) {
+        qint64 total = 0;
+        qint64 worst = 0;
+        for (auto usecs : lateness) {
+            total += usecs;
+            worst = std::max(worst, usecs);
+        }
+        qDebug() << name << "fired" << lateness.size() << "timers, average lateness" << total / (qint64)lateness.size()
+            << "usecs, worst" << worst << "usecs";
+    };
+
+    // driven like the script engine drives it: sleep until the next expiry, fire what's due
+    {
+        auto start = p_high_resolution_clock::now();
+        auto getTicks = [&] {
+            return (TestTimers::Ticks)std::chrono::duration_cast<std::chrono::milliseconds>(p_high_resolution_clock::now() - start).count();
+        };
+        TestTimers timers;
+        for (int i = 0; i < NUM_TIMERS; i++) {
+            timers.add(0, i, 0, delays[i], true);
+        }
+        std::vector<qint64> lateness;
+        while (!timers.isEmpty()) {
+            TestTimers::Ticks nextExpiry = timers.getNextExpiry();
+            TestTimers::Ticks now = getTicks();
+            if (nextExpiry > now) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(nextExpiry - now));
+            }
+            timers.fireDue(getTicks(), [&](const int& i) {
+                auto expected = start + std::chrono::milliseconds(delays[i]);
+                lateness.push_back(std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now() - expected).count());
+            });
+        }
+        report("TimerWheel:", lateness);
+    }
+
+    {
+        QEventLoop loop;
+        std::vector<qint64> lateness;
+        std::vector<QTimer*> qtimers;
+        auto start = p_high_resolution_clock::now();
+        for (int i = 0; i < NUM_TIMERS; i++) {
+            QTimer* timer = new QTimer();
+            timer->setSingleShot(true);
+            timer->setTimerType(Qt::PreciseTimer);
+            quint32 delay = delays[i];
+            connect(timer, &QTimer::timeout, [&, delay] {
+                auto expected = start + std::chrono::milliseconds(delay);
+                lateness.push_back(std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now() - expected).count());
+                if ((int)lateness.size() == NUM_TIMERS) {
+                    loop.quit();
+                }
+            });
+            timer->start(delay);
+            qtimers.push_back(timer);
+        }
+        loop.exec();
+        qDeleteAll(qtimers);
+        report("QTimer:", lateness);
+    }
+}
+
+#endif // MANUAL_TEST
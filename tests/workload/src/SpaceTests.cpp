@@ -100,6 +100,76 @@ void SpaceTests::testOverlaps() {
     }
 }
 
+// enough proxies for the classification to be split into parallel chunks, and to leave a remainder for the scalar code
+void SpaceTests::testManyProxies() {
+    workload::Space space;
+
+    std::vector<workload::Space::View> views;
+    views.push_back(workload::Space::View(glm::vec3(0.0f, 0.0f, 0.0f), 10.0f, 20.0f, 30.0f));
+    views.push_back(workload::Space::View(glm::vec3(0.0f, 0.0f, 40.0f), 10.0f, 20.0f, 30.0f));
+    space.setViews(views);
+
+    // proxies along the z axis, every 4th one far enough to be in no region
+    const uint32_t NUM_PROXIES = 50003;
+    const float PROXY_RADIUS = 1.0f;
+    std::vector<int32_t> proxyIds;
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        float z = (i % 4 == 3) ? 1000.0f + (float)i : (float)(i % 64);
+        proxyIds.push_back(space.createProxy(workload::Space::Sphere(0.0f, 0.0f, z, PROXY_RADIUS)));
+    }
+
+    // the region of a proxy at z from the closest view, against the radiuses above
+    auto expectedRegion = [&](float z) -> uint8_t {
+        float distance = std::min(fabsf(z), fabsf(z - 40.0f)) - PROXY_RADIUS;
+        if (distance < 10.0f) {
+            return workload::Space::REGION_NEAR;
+        } else if (distance < 20.0f) {
+            return workload::Space::REGION_MIDDLE;
+        } else if (distance < 30.0f) {
+            return workload::Space::REGION_FAR;
+        }
+        return workload::Space::REGION_UNKNOWN;
+    };
+
+    std::vector<workload::Space::Change> changes;
+    space.categorizeAndGetChanges(changes);
+
+    uint32_t numExpectedChanges = 0;
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        float z = (i % 4 == 3) ? 1000.0f + (float)i : (float)(i % 64);
+        if (expectedRegion(z) != workload::Space::REGION_UNKNOWN) {
+            ++numExpectedChanges;
+        }
+    }
+    QCOMPARE((uint32_t)changes.size(), numExpectedChanges);
+
+    // the changes come in proxy order, whichever chunk they were found in
+    for (size_t i = 0; i < changes.size(); ++i) {
+        int32_t proxyId = changes[i].proxyId;
+        QVERIFY(i == 0 || proxyId > changes[i - 1].proxyId);
+        QVERIFY(proxyId % 4 != 3);
+        QCOMPARE(changes[i].region, expectedRegion((float)(proxyId % 64)));
+        QVERIFY(changes[i].prevRegion == workload::Space::REGION_UNKNOWN);
+    }
+
+    // nothing moved, nothing changes
+    changes.clear();
+    space.categorizeAndGetChanges(changes);
+    QVERIFY(changes.empty());
+
+    // deleted proxies are skipped
+    for (uint32_t i = 0; i < NUM_PROXIES; i += 2) {
+        space.deleteProxy(proxyIds[i]);
+    }
+    space.setViews(std::vector<workload::Space::View>());
+    changes.clear();
+    space.categorizeAndGetChanges(changes);
+    for (auto& change : changes) {
+        QVERIFY(change.proxyId % 2 == 1);
+        QVERIFY(change.region == workload::Space::REGION_UNKNOWN);
+    }
+}
+
 #ifdef MANUAL_TEST
 
 const float WORLD_WIDTH = 1000.0f;
@@ -269,4 +339,41 @@ void SpaceTests::benchmark() {
     std::cout << "];" << std::endl;
 }
 
+// throughput of categorizeAndGetChanges with the views moving every frame, so most proxies are classified again
+void SpaceTests::benchmarkCategorize() {
+    uint32_t numProxies[] = { 10000, 100000, 1000000 };
+    const uint32_t NUM_FRAMES = 20;
+
+    std::cout << "[numProxies, usecPerFrame, proxiesPerSecond] = [" << std::endl;
+    for (uint32_t n : numProxies) {
+        workload::Space space;
+        std::vector<workload::Space::Sphere> proxySpheres;
+        generateSpheres(n, proxySpheres);
+        for (auto& sphere : proxySpheres) {
+            space.createProxy(sphere);
+        }
+
+        std::vector<workload::Space::Change> changes;
+        uint64_t totalTime = 0;
+        for (uint32_t frame = 0; frame < NUM_FRAMES; ++frame) {
+            float offset = 0.1f * WORLD_WIDTH * (float)(frame % 2);
+            glm::vec3 viewPosition(offset, 0.0f, 0.0f);
+            std::vector<workload::Space::View> views;
+            views.push_back(workload::Space::View(viewPosition, 0.25f * WORLD_WIDTH, 0.50f * WORLD_WIDTH, 0.75f * WORLD_WIDTH));
+            views.push_back(workload::Space::View(-viewPosition, 0.25f * WORLD_WIDTH, 0.50f * WORLD_WIDTH, 0.75f * WORLD_WIDTH));
+            space.setViews(views);
+
+            changes.clear();
+            uint64_t startTime = usecTimestampNow();
+            space.categorizeAndGetChanges(changes);
+            totalTime += usecTimestampNow() - startTime;
+        }
+
+        uint64_t usecPerFrame = totalTime / NUM_FRAMES;
+        double proxiesPerSecond = (double)n * USECS_PER_SECOND / (double)std::max(usecPerFrame, (uint64_t)1);
+        std::cout << "    " << n << ", " << usecPerFrame << ", " << proxiesPerSecond << std::endl;
+    }
+    std::cout << "];" << std::endl;
+}
+
 #endif // MANUAL_TEST
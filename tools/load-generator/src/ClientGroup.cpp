@@ -0,0 +1,129 @@
+//
+//  ClientGroup.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ClientGroup.h"
+
+#include <AudioConstants.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+static const float TONE_FREQUENCY = 220.0f; // hertz
+static const float TONE_AMPLITUDE = 0.25f;
+
+ClientGroup::ClientGroup(const SimulationSettings& settings, std::vector<ClientStart> clientStarts,
+                         CodecPluginPointer codec) :
+    _settings(settings),
+    _clientStarts(std::move(clientStarts)),
+    _codec(codec)
+{
+    _voiceFrame.pcm.resize(AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL);
+}
+
+ClientGroup::~ClientGroup() {
+    if (_codec && _encoder) {
+        _codec->releaseEncoder(_encoder);
+    }
+}
+
+void ClientGroup::start() {
+    if (_codec) {
+        _encoder = _codec->createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::MONO);
+        _voiceFrame.codecName = _codec->getName();
+    }
+
+    _timer = new QTimer(this);
+    _timer->setTimerType(Qt::PreciseTimer);
+    _timer->setInterval((int)AudioConstants::NETWORK_FRAME_MSECS);
+    connect(_timer, &QTimer::timeout, this, &ClientGroup::simulate);
+    _timer->start();
+}
+
+void ClientGroup::stop() {
+    if (_timer) {
+        _timer->stop();
+    }
+
+    quint64 now = usecTimestampNow();
+    for (auto& client : _clients) {
+        _finalStats.push_back(client->getStats(now));
+        client->disconnectFromDomain();
+    }
+
+    // the clients' sockets belong to this thread, so they go away here too
+    _clients.clear();
+}
+
+void ClientGroup::simulate() {
+    quint64 now = usecTimestampNow();
+
+    // every frame the timer is late by is a frame the mixers didn't get from us: the generator itself is overloaded
+    if (_lastFrameTime != 0) {
+        quint64 framesElapsed = (now - _lastFrameTime) / AudioConstants::NETWORK_FRAME_USECS;
+        if (framesElapsed > 1) {
+            _numLateFrames.fetch_add(framesElapsed - 1, std::memory_order_relaxed);
+        }
+    }
+    _lastFrameTime = now;
+
+    while (_nextClientStart < _clientStarts.size() && _clientStarts[_nextClientStart].startTime <= now) {
+        _clients.emplace_back(new SimulatedClient(_clientStarts[_nextClientStart].index, _settings));
+        ++_nextClientStart;
+    }
+
+    generateVoice();
+
+    for (auto& client : _clients) {
+        client->simulate(now, _voiceFrame);
+    }
+
+    if (now >= _nextCounterSample) {
+        sampleCounters(now);
+        _nextCounterSample = now + USECS_PER_SECOND;
+    }
+}
+
+void ClientGroup::generateVoice() {
+    // a tone, which unlike silence keeps the codecs and the mixer's attenuation and mixing busy
+    int16_t* samples = reinterpret_cast<int16_t*>(_voiceFrame.pcm.data());
+    const float phaseStep = TWO_PI * TONE_FREQUENCY / AudioConstants::SAMPLE_RATE;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+        samples[i] = (int16_t)(TONE_AMPLITUDE * AudioConstants::MAX_SAMPLE_VALUE * sinf(_tonePhase));
+        _tonePhase += phaseStep;
+        if (_tonePhase > TWO_PI) {
+            _tonePhase -= TWO_PI;
+        }
+    }
+
+    if (_encoder) {
+        _encoder->encode(_voiceFrame.pcm, _voiceFrame.encoded);
+    }
+}
+
+void ClientGroup::sampleCounters(quint64 now) {
+    int numActiveClients = 0;
+    quint64 bytesSent = 0;
+    quint64 bytesReceived = 0;
+
+    for (auto& client : _clients) {
+        ClientStats stats = client->getStats(now);
+        if (stats.isActive) {
+            ++numActiveClients;
+        }
+        bytesSent += stats.bytesSent;
+        for (auto& traffic : stats.received) {
+            bytesReceived += traffic.second.bytesReceived;
+        }
+    }
+
+    _numClients.store((int)_clients.size(), std::memory_order_relaxed);
+    _numActiveClients.store(numActiveClients, std::memory_order_relaxed);
+    _bytesSent.store(bytesSent, std::memory_order_relaxed);
+    _bytesReceived.store(bytesReceived, std::memory_order_relaxed);
+}
@@ -0,0 +1,83 @@
+//
+//  ClientGroup.h
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ClientGroup_h
+#define hifi_ClientGroup_h
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <plugins/CodecPlugin.h>
+#include <plugins/Forward.h>
+
+#include "SimulatedClient.h"
+
+// The clients simulated by one thread. A single timer steps all of them every network audio frame, and the
+//   voice they send is generated and encoded once per frame for the whole group.
+class ClientGroup : public QObject {
+    Q_OBJECT
+public:
+    struct ClientStart {
+        int index;
+        quint64 startTime; // usecTimestampNow() at which the client first checks in
+    };
+
+    ClientGroup(const SimulationSettings& settings, std::vector<ClientStart> clientStarts, CodecPluginPointer codec);
+    ~ClientGroup();
+
+    // sampled once a second, safe to read from any thread
+    int getNumClients() const { return _numClients.load(std::memory_order_relaxed); }
+    int getNumActiveClients() const { return _numActiveClients.load(std::memory_order_relaxed); }
+    quint64 getBytesSent() const { return _bytesSent.load(std::memory_order_relaxed); }
+    quint64 getBytesReceived() const { return _bytesReceived.load(std::memory_order_relaxed); }
+    quint64 getNumLateFrames() const { return _numLateFrames.load(std::memory_order_relaxed); }
+
+    // only valid once stop() has returned
+    const std::vector<ClientStats>& getFinalStats() const { return _finalStats; }
+
+public slots:
+    void start();
+    void stop();
+
+private slots:
+    void simulate();
+
+private:
+    void generateVoice();
+    void sampleCounters(quint64 now);
+
+    const SimulationSettings& _settings;
+    std::vector<ClientStart> _clientStarts;
+    size_t _nextClientStart { 0 };
+    std::vector<std::unique_ptr<SimulatedClient>> _clients;
+
+    QTimer* _timer { nullptr };
+    quint64 _lastFrameTime { 0 };
+    quint64 _nextCounterSample { 0 };
+
+    CodecPluginPointer _codec;
+    Encoder* _encoder { nullptr };
+    VoiceFrame _voiceFrame;
+    float _tonePhase { 0.0f };
+
+    std::atomic<int> _numClients { 0 };
+    std::atomic<int> _numActiveClients { 0 };
+    std::atomic<quint64> _bytesSent { 0 };
+    std::atomic<quint64> _bytesReceived { 0 };
+    std::atomic<quint64> _numLateFrames { 0 };
+
+    std::vector<ClientStats> _finalStats;
+};
+
+#endif // hifi_ClientGroup_h
@@ -0,0 +1,414 @@
+//
+//  LoadGeneratorApp.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadGeneratorApp.h"
+
+#include <algorithm>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QLoggingCategory>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+
+#include <DomainHandler.h>
+#include <NetworkAccessManager.h>
+#include <NetworkLogging.h>
+#include <NumericalConstants.h>
+#include <SharedLogging.h>
+#include <SharedUtil.h>
+#include <plugins/PluginManager.h>
+#include <recording/Clip.h>
+#include <recording/Frame.h>
+#include <shared/NetworkUtils.h>
+
+static const int DEFAULT_NUM_CLIENTS = 100;
+static const float DEFAULT_RAMP_SECONDS = 10.0f;
+static const float DEFAULT_DURATION_SECONDS = 60.0f;
+static const QString DEFAULT_STATS_URL = "http://127.0.0.1:40100";
+static const QString DEFAULT_OUTPUT_PREFIX = "load-generator";
+
+static const int SAMPLE_INTERVAL_MSECS = 1000;
+
+// the numbers worth keeping from each server's stats, as paths into the JSON it sends the domain-server
+static const QHash<QString, QStringList> NODE_STATS_PATHS {
+    { "audio-mixer", {
+        "avg_timing_stats.us_per_frame", "avg_timing_stats.us_per_mix", "avg_timing_stats.us_per_packets",
+        "avg_streams_per_frame", "avg_listeners_per_frame", "throttling_ratio",
+        "io_stats.inbound_bytes_per_s", "io_stats.outbound_bytes_per_s" } },
+    { "avatar-mixer", {
+        "broadcast_loop_rate", "average_listeners_last_second", "throttling_ratio",
+        "slaves_aggregate.timing_6_jobElapsedTime", "slaves_aggregate.sent_5_averageOutboundAvatarKbps",
+        "io_stats.inbound_bytes_per_s", "io_stats.outbound_bytes_per_s" } },
+    { "entity-server", {
+        "io_stats.inbound_bytes_per_s", "io_stats.outbound_bytes_per_s" } }
+};
+
+static bool valueAtPath(const QJsonObject& object, const QString& path, double& value) {
+    QStringList keys = path.split('.');
+    QJsonObject parent = object;
+    for (int i = 0; i < keys.size() - 1; i++) {
+        parent = parent[keys[i]].toObject();
+    }
+
+    QJsonValue leaf = parent[keys.last()];
+    if (leaf.isUndefined() || leaf.isNull()) {
+        return false;
+    }
+
+    // some stats are sent as strings, so go through QVariant, which converts both
+    bool ok = false;
+    value = leaf.toVariant().toDouble(&ok);
+    return ok;
+}
+
+LoadGeneratorApp::LoadGeneratorApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity load generator: connects simulated clients to a local domain "
+                                     "and reports on how its mixers hold up");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption verboseOutput("v", "verbose output");
+    parser.addOption(verboseOutput);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address",
+                                                 "host:port", "127.0.0.1:" + QString::number(DEFAULT_DOMAIN_SERVER_PORT));
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption clientsOption(QStringList() << "n" << "clients", "number of clients to simulate",
+                                           "count", QString::number(DEFAULT_NUM_CLIENTS));
+    parser.addOption(clientsOption);
+
+    const QCommandLineOption threadsOption("threads", "number of threads to simulate the clients on",
+                                           "count", QString::number(QThread::idealThreadCount()));
+    parser.addOption(threadsOption);
+
+    const QCommandLineOption rampOption("ramp", "seconds over which the clients connect",
+                                        "seconds", QString::number(DEFAULT_RAMP_SECONDS));
+    parser.addOption(rampOption);
+
+    const QCommandLineOption durationOption("duration", "seconds to run once every client has connected",
+                                            "seconds", QString::number(DEFAULT_DURATION_SECONDS));
+    parser.addOption(durationOption);
+
+    const QCommandLineOption recordingOption("recording", "avatar recording (.hfr) for the clients to replay, "
+                                             "each from its own offset", "path");
+    parser.addOption(recordingOption);
+
+    const QCommandLineOption codecOption("codec", "audio codec for the clients to negotiate, PCM if not given",
+                                         "name");
+    parser.addOption(codecOption);
+
+    const QCommandLineOption speakingOption("speaking", "share of the clients that talk",
+                                            "ratio", QString::number(_settings.speakingRatio));
+    parser.addOption(speakingOption);
+
+    const QCommandLineOption spreadOption("spread", "radius, in meters, that the clients are spread over",
+                                          "meters", QString::number(_settings.spreadRadius));
+    parser.addOption(spreadOption);
+
+    const QCommandLineOption seedOption("seed", "seed for the clients' random choices", "seed", "0");
+    parser.addOption(seedOption);
+
+    const QCommandLineOption statsURLOption("stats-url", "domain-server HTTP address to poll the mixers' stats from",
+                                            "url", DEFAULT_STATS_URL);
+    parser.addOption(statsURLOption);
+
+    const QCommandLineOption outputOption(QStringList() << "o" << "output", "prefix of the report files",
+                                          "prefix", DEFAULT_OUTPUT_PREFIX);
+    parser.addOption(outputOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    _verbose = parser.isSet(verboseOutput);
+    if (!_verbose) {
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtWarningMsg, false);
+
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtWarningMsg, false);
+    }
+
+    QStringList domainPieces = parser.value(domainAddressOption).split(':');
+    quint16 domainPort = domainPieces.size() > 1 ? domainPieces[1].toUShort() : DEFAULT_DOMAIN_SERVER_PORT;
+    _settings.domainSockAddr = HifiSockAddr(domainPieces[0], domainPort, true);
+    if (_settings.domainSockAddr.getAddress().isNull()) {
+        qCritical() << "Could not resolve the domain-server address" << parser.value(domainAddressOption);
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    // the domain-server hands our local socket out to the mixers, so it has to be one they can reach
+    _settings.localAddress = _settings.domainSockAddr.getAddress().isLoopback() ?
+        QHostAddress(QHostAddress::LocalHost) : getGuessedLocalAddress();
+
+    _settings.speakingRatio = glm::clamp(parser.value(speakingOption).toFloat(), 0.0f, 1.0f);
+    _settings.spreadRadius = std::max(parser.value(spreadOption).toFloat(), 0.0f);
+    _settings.randomSeed = parser.value(seedOption).toUInt();
+
+    if (parser.isSet(recordingOption) && !loadRecording(parser.value(recordingOption))) {
+        qCritical() << "Could not load avatar frames from" << parser.value(recordingOption);
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    CodecPluginPointer codec;
+    if (parser.isSet(codecOption)) {
+        QString codecName = parser.value(codecOption);
+        for (auto& codecPlugin : PluginManager::getInstance()->getCodecPlugins()) {
+            if (codecPlugin->getName() == codecName) {
+                codec = codecPlugin;
+                break;
+            }
+        }
+
+        if (codec) {
+            _settings.codecName = codecName;
+        } else {
+            qWarning() << "No codec plugin named" << codecName << "was found, the clients will send PCM";
+        }
+    }
+
+    _numClients = std::max(parser.value(clientsOption).toInt(), 1);
+    int numThreads = glm::clamp(parser.value(threadsOption).toInt(), 1, _numClients);
+    float rampSeconds = std::max(parser.value(rampOption).toFloat(), 0.0f);
+    float durationSeconds = std::max(parser.value(durationOption).toFloat(), 1.0f);
+
+    _statsURL = QUrl(parser.value(statsURLOption));
+    _outputPrefix = parser.value(outputOption);
+
+    QJsonObject settings;
+    settings["domain"] = _settings.domainSockAddr.toString();
+    settings["clients"] = _numClients;
+    settings["threads"] = numThreads;
+    settings["ramp_s"] = rampSeconds;
+    settings["duration_s"] = durationSeconds;
+    settings["recording"] = parser.value(recordingOption);
+    settings["codec"] = _settings.codecName.isEmpty() ? QString("pcm") : _settings.codecName;
+    settings["speaking_ratio"] = _settings.speakingRatio;
+    settings["spread_m"] = _settings.spreadRadius;
+    settings["seed"] = (double)_settings.randomSeed;
+    _report.setSettings(settings);
+
+    // every client is a socket, so a few thousand of them need a raised open file limit (ulimit -n)
+    qDebug() << "Simulating" << _numClients << "clients on" << numThreads << "threads against"
+        << _settings.domainSockAddr << "- ramping up over" << rampSeconds << "s, then running for" << durationSeconds << "s";
+
+    _startTime = usecTimestampNow();
+    _steadyTime = _startTime + (quint64)(rampSeconds * USECS_PER_SECOND);
+    _endTime = _steadyTime + (quint64)(durationSeconds * USECS_PER_SECOND);
+    _lastSampleTime = _startTime;
+
+    startGroups(_numClients, numThreads, rampSeconds, codec);
+
+    connect(&_sampleTimer, &QTimer::timeout, this, &LoadGeneratorApp::sample);
+    _sampleTimer.start(SAMPLE_INTERVAL_MSECS);
+}
+
+LoadGeneratorApp::~LoadGeneratorApp() {
+    for (auto thread : _threads) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+}
+
+bool LoadGeneratorApp::loadRecording(const QString& path) {
+    auto clip = recording::Clip::fromFile(path);
+    if (!clip) {
+        return false;
+    }
+
+    static const recording::FrameType AVATAR_FRAME_TYPE = recording::Frame::registerFrameType(AvatarData::FRAME_NAME);
+
+    auto motion = std::make_shared<RecordedMotion>();
+    for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame()) {
+        if (frame->type == AVATAR_FRAME_TYPE) {
+            motion->frames.push_back({ frame->timeOffset, frame->data });
+        }
+    }
+
+    if (motion->frames.empty()) {
+        return false;
+    }
+
+    motion->duration = motion->frames.back().timeOffset;
+    _settings.motion = motion;
+    return true;
+}
+
+void LoadGeneratorApp::startGroups(int numClients, int numThreads, float rampSeconds, CodecPluginPointer codec) {
+    // clients start evenly across the ramp, and consecutive ones go to different threads so each thread ramps too
+    std::vector<std::vector<ClientGroup::ClientStart>> clientStarts(numThreads);
+    quint64 rampUsecs = (quint64)(rampSeconds * USECS_PER_SECOND);
+    for (int i = 0; i < numClients; i++) {
+        quint64 startTime = _startTime + rampUsecs * i / numClients;
+        clientStarts[i % numThreads].push_back({ i, startTime });
+    }
+
+    for (int i = 0; i < numThreads; i++) {
+        auto group = new ClientGroup(_settings, std::move(clientStarts[i]), codec);
+        auto thread = new QThread();
+        thread->setObjectName("Load Generator Clients " + QString::number(i));
+        group->moveToThread(thread);
+
+        connect(thread, &QThread::started, group, &ClientGroup::start);
+        connect(thread, &QThread::finished, group, &QObject::deleteLater);
+
+        _groups.push_back(group);
+        _threads.push_back(thread);
+        thread->start();
+    }
+}
+
+void LoadGeneratorApp::sample() {
+    quint64 now = usecTimestampNow();
+
+    int numClients = 0;
+    int numActiveClients = 0;
+    quint64 bytesSent = 0;
+    quint64 bytesReceived = 0;
+    quint64 numLateFrames = 0;
+    for (auto group : _groups) {
+        numClients += group->getNumClients();
+        numActiveClients += group->getNumActiveClients();
+        bytesSent += group->getBytesSent();
+        bytesReceived += group->getBytesReceived();
+        numLateFrames += group->getNumLateFrames();
+    }
+
+    float secondsSinceLastSample = (float)(now - _lastSampleTime) / USECS_PER_SECOND;
+    QJsonObject sample = _mixerValues;
+    sample["clients"] = numClients;
+    sample["clients_active"] = numActiveClients;
+    sample["sent_kbps"] = (double)(bytesSent - _lastBytesSent) / BYTES_PER_KILOBIT / secondsSinceLastSample;
+    sample["received_kbps"] = (double)(bytesReceived - _lastBytesReceived) / BYTES_PER_KILOBIT / secondsSinceLastSample;
+    sample["late_frames"] = (double)numLateFrames;
+
+    _report.addSample((float)(now - _startTime) / USECS_PER_SECOND, sample, now >= _steadyTime);
+
+    if (_verbose) {
+        qDebug() << "clients:" << numActiveClients << "/" << numClients << "active, sent"
+            << sample["sent_kbps"].toDouble() << "kbps, received" << sample["received_kbps"].toDouble() << "kbps,"
+            << numLateFrames << "late frames";
+    }
+
+    _lastSampleTime = now;
+    _lastBytesSent = bytesSent;
+    _lastBytesReceived = bytesReceived;
+
+    if (now >= _endTime) {
+        finish();
+        return;
+    }
+
+    pollMixerStats();
+}
+
+void LoadGeneratorApp::pollMixerStats() {
+    if (!_statsURL.isValid()) {
+        return;
+    }
+
+    QNetworkAccessManager& networkAccessManager = NetworkAccessManager::getInstance();
+    QNetworkReply* nodesReply = networkAccessManager.get(QNetworkRequest(_statsURL.resolved(QUrl("/nodes.json"))));
+    connect(nodesReply, &QNetworkReply::finished, this, [this, nodesReply] {
+        nodesReply->deleteLater();
+        if (nodesReply->error() != QNetworkReply::NoError) {
+            if (_verbose) {
+                qDebug() << "Could not list the domain's nodes:" << nodesReply->errorString();
+            }
+            return;
+        }
+
+        QJsonArray nodes = QJsonDocument::fromJson(nodesReply->readAll()).object()["nodes"].toArray();
+        for (auto node : nodes) {
+            QString nodeType = node.toObject()["type"].toString();
+            QString uuid = node.toObject()["uuid"].toString();
+            if (!NODE_STATS_PATHS.contains(nodeType)) {
+                continue;
+            }
+
+            QNetworkAccessManager& networkAccessManager = NetworkAccessManager::getInstance();
+            QUrl statsURL = _statsURL.resolved(QUrl("/nodes/" + uuid + ".json"));
+            QNetworkReply* statsReply = networkAccessManager.get(QNetworkRequest(statsURL));
+            connect(statsReply, &QNetworkReply::finished, this, [this, statsReply, nodeType] {
+                statsReply->deleteLater();
+                if (statsReply->error() == QNetworkReply::NoError) {
+                    handleNodeStats(nodeType, QJsonDocument::fromJson(statsReply->readAll()).object());
+                }
+            });
+        }
+    });
+}
+
+void LoadGeneratorApp::handleNodeStats(const QString& nodeType, const QJsonObject& stats) {
+    for (auto& path : NODE_STATS_PATHS[nodeType]) {
+        double value;
+        if (valueAtPath(stats, path, value)) {
+            _mixerValues[nodeType + "." + path] = value;
+        }
+    }
+
+    _report.setMixerStats(nodeType, stats);
+}
+
+void LoadGeneratorApp::finish() {
+    _sampleTimer.stop();
+
+    // stop the clients where they live, then gather what they saw
+    std::vector<ClientStats> clientStats;
+    for (auto group : _groups) {
+        QMetaObject::invokeMethod(group, "stop", Qt::BlockingQueuedConnection);
+        auto& groupStats = group->getFinalStats();
+        clientStats.insert(clientStats.end(), groupStats.begin(), groupStats.end());
+    }
+    std::sort(clientStats.begin(), clientStats.end(), [](const ClientStats& a, const ClientStats& b) {
+        return a.index < b.index;
+    });
+
+    int numActiveClients = (int)std::count_if(clientStats.begin(), clientStats.end(), [](const ClientStats& stats) {
+        return stats.isActive;
+    });
+
+    _report.setClientStats(std::move(clientStats));
+    bool wroteReport = _report.write(_outputPrefix);
+
+    // the groups are deleted as their threads finish
+    for (auto thread : _threads) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+    _threads.clear();
+    _groups.clear();
+
+    qDebug() << numActiveClients << "of" << _numClients << "clients connected to every mixer";
+    if (wroteReport) {
+        qDebug() << "Wrote the report to" << _outputPrefix + ".json";
+    }
+
+    exit(wroteReport ? 0 : 1);
+}
@@ -0,0 +1,66 @@
+//
+//  LoadGeneratorApp.h
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LoadGeneratorApp_h
+#define hifi_LoadGeneratorApp_h
+
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+
+#include "ClientGroup.h"
+#include "LoadReport.h"
+
+// Connects a few hundred to a few thousand simulated clients to a local domain, ramping them up over time, and
+//   records what the mixers report about themselves while they carry that load.
+class LoadGeneratorApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    LoadGeneratorApp(int argc, char* argv[]);
+    ~LoadGeneratorApp();
+
+private slots:
+    void sample();
+    void finish();
+
+private:
+    bool loadRecording(const QString& path);
+    void startGroups(int numClients, int numThreads, float rampSeconds, CodecPluginPointer codec);
+    void pollMixerStats();
+    void handleNodeStats(const QString& nodeType, const QJsonObject& stats);
+
+    bool _verbose { false };
+
+    SimulationSettings _settings;
+    std::vector<ClientGroup*> _groups;
+    std::vector<QThread*> _threads;
+    int _numClients { 0 };
+
+    quint64 _startTime { 0 };
+    quint64 _steadyTime { 0 }; // once every client has started
+    quint64 _endTime { 0 };
+    QTimer _sampleTimer;
+
+    quint64 _lastSampleTime { 0 };
+    quint64 _lastBytesSent { 0 };
+    quint64 _lastBytesReceived { 0 };
+
+    QUrl _statsURL;
+    QJsonObject _mixerValues; // the latest of the mixers' numbers, as flat "audio-mixer.us_per_mix" keys
+
+    QString _outputPrefix;
+    LoadReport _report;
+};
+
+#endif // hifi_LoadGeneratorApp_h
@@ -0,0 +1,264 @@
+//
+//  LoadReport.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadReport.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTextStream>
+
+#include <NumericalConstants.h>
+#include <UUID.h>
+
+static const QString ELAPSED_KEY = "elapsed_s";
+
+static const NodeType_t REPORTED_SOURCES[] = {
+    NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::EntityServer, NodeType::DomainServer
+};
+
+// the name the domain-server uses for a node type in its stats, e.g. audio-mixer
+static QString nodeTypeKey(NodeType_t nodeType) {
+    return NodeType::getNodeTypeName(nodeType).toLower().replace(' ', '-');
+}
+
+static double kbps(quint64 bytes, quint64 usecs) {
+    return usecs > 0 ? (double)bytes / BYTES_PER_KILOBIT / ((double)usecs / USECS_PER_SECOND) : 0.0;
+}
+
+static double lossRatio(const TrafficStats& traffic) {
+    return traffic.unreliableExpected > 0 ? (double)traffic.unreliableLost / traffic.unreliableExpected : 0.0;
+}
+
+static QJsonObject distribution(std::vector<double> values) {
+    QJsonObject result;
+    if (values.empty()) {
+        return result;
+    }
+
+    std::sort(values.begin(), values.end());
+    auto percentile = [&](double p) {
+        return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+    };
+
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+
+    result["mean"] = sum / values.size();
+    result["p50"] = percentile(0.50);
+    result["p95"] = percentile(0.95);
+    result["p99"] = percentile(0.99);
+    result["max"] = values.back();
+    return result;
+}
+
+void LoadReport::addSample(float elapsedSeconds, QJsonObject sample, bool isSteady) {
+    sample[ELAPSED_KEY] = elapsedSeconds;
+    _timeline.append(sample);
+    if (isSteady) {
+        _steadySamples.push_back(sample);
+    }
+}
+
+bool LoadReport::write(const QString& prefix) const {
+    QJsonObject root;
+    root["settings"] = _settings;
+    root["summary"] = summarize();
+    root["timeline"] = _timeline;
+    root["clients"] = clientsToJSON();
+    root["mixer_stats"] = _mixerStats;
+
+    QFile jsonFile(prefix + ".json");
+    if (!jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Could not write the load report to" << jsonFile.fileName();
+        return false;
+    }
+    jsonFile.write(QJsonDocument(root).toJson());
+
+    return writeTimelineCSV(prefix + "-timeline.csv") && writeClientsCSV(prefix + "-clients.csv");
+}
+
+QJsonObject LoadReport::summarize() const {
+    QJsonObject summary;
+
+    // the mixers, over the samples taken once every client had started
+    QJsonObject steady;
+    std::set<QString> keys;
+    for (auto& sample : _steadySamples) {
+        for (auto it = sample.begin(); it != sample.end(); ++it) {
+            keys.insert(it.key());
+        }
+    }
+    for (auto& key : keys) {
+        std::vector<double> values;
+        for (auto& sample : _steadySamples) {
+            if (sample.contains(key)) {
+                values.push_back(sample[key].toDouble());
+            }
+        }
+        steady[key] = distribution(values);
+    }
+    summary["steady_state"] = steady;
+    summary["steady_state_samples"] = (int)_steadySamples.size();
+
+    // the clients
+    int numActive = 0;
+    int numDenials = 0;
+    std::vector<double> connectMsecs;
+    std::vector<double> sentKbps;
+    std::map<NodeType_t, std::vector<double>> receivedKbps;
+    std::map<NodeType_t, TrafficStats> receivedTotals;
+
+    for (auto& client : _clientStats) {
+        numDenials += client.connectionDenials;
+        if (!client.isActive) {
+            continue;
+        }
+
+        ++numActive;
+        connectMsecs.push_back((double)client.connectUsecs / USECS_PER_MSEC);
+        sentKbps.push_back(kbps(client.bytesSent, client.activeUsecs));
+
+        for (auto& traffic : client.received) {
+            receivedKbps[traffic.first].push_back(kbps(traffic.second.bytesReceived, client.activeUsecs));
+
+            TrafficStats& total = receivedTotals[traffic.first];
+            total.packetsReceived += traffic.second.packetsReceived;
+            total.bytesReceived += traffic.second.bytesReceived;
+            total.unreliableExpected += traffic.second.unreliableExpected;
+            total.unreliableLost += traffic.second.unreliableLost;
+        }
+    }
+
+    summary["clients"] = (int)_clientStats.size();
+    summary["clients_active"] = numActive;
+    summary["connection_denials"] = numDenials;
+    summary["connect_ms"] = distribution(connectMsecs);
+    summary["sent_kbps_per_client"] = distribution(sentKbps);
+
+    QJsonObject received;
+    for (NodeType_t source : REPORTED_SOURCES) {
+        QJsonObject sourceObject;
+        sourceObject["kbps_per_client"] = distribution(receivedKbps[source]);
+        sourceObject["packets"] = (double)receivedTotals[source].packetsReceived;
+        sourceObject["loss_ratio"] = lossRatio(receivedTotals[source]);
+        received[nodeTypeKey(source)] = sourceObject;
+    }
+    summary["received"] = received;
+
+    return summary;
+}
+
+QJsonArray LoadReport::clientsToJSON() const {
+    QJsonArray clients;
+    for (auto& client : _clientStats) {
+        QJsonObject clientObject;
+        clientObject["index"] = client.index;
+        clientObject["session_uuid"] = uuidStringWithoutCurlyBraces(client.sessionUUID);
+        clientObject["active"] = client.isActive;
+        clientObject["connect_ms"] = (double)client.connectUsecs / USECS_PER_MSEC;
+        clientObject["active_s"] = (double)client.activeUsecs / USECS_PER_SECOND;
+        clientObject["connection_denials"] = client.connectionDenials;
+        clientObject["sent_packets"] = (double)client.packetsSent;
+        clientObject["sent_kbps"] = kbps(client.bytesSent, client.activeUsecs);
+
+        QJsonObject received;
+        for (auto& traffic : client.received) {
+            QJsonObject sourceObject;
+            sourceObject["packets"] = (double)traffic.second.packetsReceived;
+            sourceObject["kbps"] = kbps(traffic.second.bytesReceived, client.activeUsecs);
+            sourceObject["loss_ratio"] = lossRatio(traffic.second);
+            received[nodeTypeKey(traffic.first)] = sourceObject;
+        }
+        clientObject["received"] = received;
+
+        clients.append(clientObject);
+    }
+    return clients;
+}
+
+bool LoadReport::writeTimelineCSV(const QString& path) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Could not write the load report to" << path;
+        return false;
+    }
+
+    // mixer stats can show up part way through, so the columns are every key of every sample, time first
+    std::set<QString> keySet;
+    for (auto sample : _timeline) {
+        for (auto& key : sample.toObject().keys()) {
+            keySet.insert(key);
+        }
+    }
+    keySet.erase(ELAPSED_KEY);
+
+    QStringList keys { ELAPSED_KEY };
+    for (auto& key : keySet) {
+        keys << key;
+    }
+
+    QTextStream stream(&file);
+    stream << keys.join(',') << "\n";
+
+    for (auto sample : _timeline) {
+        QJsonObject sampleObject = sample.toObject();
+        QStringList row;
+        for (auto& key : keys) {
+            row << (sampleObject.contains(key) ? QString::number(sampleObject[key].toDouble()) : QString());
+        }
+        stream << row.join(',') << "\n";
+    }
+    return true;
+}
+
+bool LoadReport::writeClientsCSV(const QString& path) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Could not write the load report to" << path;
+        return false;
+    }
+
+    QTextStream stream(&file);
+    QStringList header { "index", "session_uuid", "active", "connect_ms", "active_s", "connection_denials",
+                         "sent_packets", "sent_kbps" };
+    for (NodeType_t source : REPORTED_SOURCES) {
+        QString key = nodeTypeKey(source);
+        header << key + "_packets" << key + "_kbps" << key + "_loss_ratio";
+    }
+    stream << header.join(',') << "\n";
+
+    for (auto& client : _clientStats) {
+        QStringList row;
+        row << QString::number(client.index) << uuidStringWithoutCurlyBraces(client.sessionUUID)
+            << QString::number(client.isActive ? 1 : 0)
+            << QString::number((double)client.connectUsecs / USECS_PER_MSEC)
+            << QString::number((double)client.activeUsecs / USECS_PER_SECOND)
+            << QString::number(client.connectionDenials)
+            << QString::number(client.packetsSent)
+            << QString::number(kbps(client.bytesSent, client.activeUsecs));
+
+        for (NodeType_t source : REPORTED_SOURCES) {
+            auto it = client.received.find(source);
+            TrafficStats traffic = it != client.received.end() ? it->second : TrafficStats();
+            row << QString::number(traffic.packetsReceived)
+                << QString::number(kbps(traffic.bytesReceived, client.activeUsecs))
+                << QString::number(lossRatio(traffic));
+        }
+        stream << row.join(',') << "\n";
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+//
+//  LoadReport.h
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LoadReport_h
+#define hifi_LoadReport_h
+
+#include <vector>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+#include "SimulatedClient.h"
+
+// Collects a run of the load generator and writes it out for comparing builds:
+//   <prefix>.json has the settings, a summary, the timeline, every client and the mixers' last stats,
+//   <prefix>-timeline.csv has one row a second and <prefix>-clients.csv one row per client.
+class LoadReport {
+public:
+    void setSettings(const QJsonObject& settings) { _settings = settings; }
+
+    // a flat object of numbers, sampled once a second; samples taken after every client started make up the summary
+    void addSample(float elapsedSeconds, QJsonObject sample, bool isSteady);
+
+    void setMixerStats(const QString& nodeType, const QJsonObject& stats) { _mixerStats[nodeType] = stats; }
+    void setClientStats(std::vector<ClientStats> clientStats) { _clientStats = std::move(clientStats); }
+
+    bool write(const QString& prefix) const;
+
+private:
+    QJsonObject summarize() const;
+    QJsonArray clientsToJSON() const;
+
+    bool writeTimelineCSV(const QString& path) const;
+    bool writeClientsCSV(const QString& path) const;
+
+    QJsonObject _settings;
+    QJsonArray _timeline;
+    std::vector<QJsonObject> _steadySamples;
+    QJsonObject _mixerStats;
+    std::vector<ClientStats> _clientStats;
+};
+
+#endif // hifi_LoadReport_h
@@ -0,0 +1,532 @@
+//
+//  SimulatedClient.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SimulatedClient.h"
+
+#include <algorithm>
+#include <random>
+
+#include <QtCore/QDataStream>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <AudioConstants.h>
+#include <GLMHelpers.h>
+#include <LimitedNodeList.h>
+#include <NodeList.h>
+#include <NodePermissions.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+static const quint64 CHECK_IN_INTERVAL_USECS = DOMAIN_SERVER_CHECK_IN_MSECS * USECS_PER_MSEC;
+
+// the rate interface sends its avatar data at
+static const int AVATAR_SENDS_PER_SECOND = 50;
+static const quint64 AVATAR_SEND_INTERVAL_USECS = USECS_PER_SECOND / AVATAR_SENDS_PER_SECOND;
+
+static const float WALK_SPEED = 1.4f; // meters per second
+static const float MIN_WALK_RADIUS = 2.0f;
+static const float MAX_WALK_RADIUS = 6.0f;
+static const float EYE_HEIGHT = 1.6f;
+
+// about the number of joints in the default avatar, all of them swaying so that each send carries joint data
+static const int PROCEDURAL_JOINT_COUNT = 56;
+static const float JOINT_SWAY_ANGLE = 0.3f; // radians
+static const float JOINT_SWAY_FREQUENCY = 0.8f; // hertz
+
+SimulatedClient::SimulatedClient(int index, const SimulationSettings& settings, QObject* parent) :
+    QObject(parent),
+    _index(index),
+    _settings(settings),
+    _socket(this, false),
+    _machineFingerprint(QUuid::createUuid()),
+    _avatar(new AvatarData())
+{
+    _stats.index = index;
+
+    // each client draws from its own seeded generator, so a given client walks and talks the same way in every run
+    std::mt19937 random(settings.randomSeed + index);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    _isSpeaking = unit(random) < settings.speakingRatio;
+
+    float centerAngle = unit(random) * TWO_PI;
+    float centerDistance = sqrtf(unit(random)) * settings.spreadRadius;
+    _walkCenter = glm::vec3(cosf(centerAngle) * centerDistance, 0.0f, sinf(centerAngle) * centerDistance);
+    _walkRadius = MIN_WALK_RADIUS + unit(random) * (MAX_WALK_RADIUS - MIN_WALK_RADIUS);
+    _walkPhase = unit(random) * TWO_PI;
+    _motionOffset = settings.motion ? (quint32)(unit(random) * settings.motion->duration) : 0;
+
+    _viewFrustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO,
+                                                DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP));
+
+    _socket.bind(QHostAddress::AnyIPv4);
+
+    // messages are only counted, so both kinds of packet take the same path
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handlePacket(std::move(packet));
+    });
+    _socket.setMessageHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handlePacket(std::move(packet));
+    });
+}
+
+void SimulatedClient::simulate(quint64 now, const VoiceFrame& voiceFrame) {
+    if (now >= _nextCheckIn) {
+        if (_firstConnectRequest == 0) {
+            _firstConnectRequest = now;
+        }
+
+        sendDomainCheckIn();
+        pingInactiveNodes();
+
+        _nextCheckIn = now + CHECK_IN_INTERVAL_USECS;
+    }
+
+    if (_connectedAt == 0 && isActive()) {
+        _connectedAt = now;
+    }
+
+    sendAudio(voiceFrame);
+
+    if (now >= _nextAvatarSend) {
+        updateMotion(now);
+        sendAvatarData();
+
+        _nextAvatarSend += AVATAR_SEND_INTERVAL_USECS;
+        if (_nextAvatarSend < now) {
+            // we fell behind, don't burst to catch up
+            _nextAvatarSend = now + AVATAR_SEND_INTERVAL_USECS;
+        }
+    }
+
+    if (now >= _nextViewQuery) {
+        sendViewQueries();
+        _nextViewQuery = now + (quint64)(_settings.viewQueryInterval * USECS_PER_SECOND);
+    }
+}
+
+void SimulatedClient::disconnectFromDomain() {
+    if (!_sessionUUID.isNull()) {
+        auto disconnectPacket = NLPacket::create(PacketType::DomainDisconnectRequest, 0);
+        sendPacket(*disconnectPacket, _settings.domainSockAddr, nullptr);
+    }
+}
+
+bool SimulatedClient::isActive() const {
+    if (_sessionUUID.isNull() || _nodes.empty()) {
+        return false;
+    }
+
+    return std::all_of(_nodes.begin(), _nodes.end(), [](const std::pair<const QUuid, ServerNode>& node) {
+        return !node.second.activeSocket.isNull();
+    });
+}
+
+ClientStats SimulatedClient::getStats(quint64 now) const {
+    ClientStats stats = _stats;
+    stats.sessionUUID = _sessionUUID;
+    stats.isActive = isActive();
+
+    if (_connectedAt != 0) {
+        stats.connectUsecs = _connectedAt - _firstConnectRequest;
+        stats.activeUsecs = now - _connectedAt;
+    }
+
+    for (auto& tracker : _sequenceTrackers) {
+        if (tracker.second.hasReceived) {
+            quint64 expected = udt::seqlen(tracker.second.first, tracker.second.last);
+            auto& traffic = stats.received[tracker.second.sourceType];
+            traffic.unreliableExpected += expected;
+            traffic.unreliableLost += expected - std::min(expected, tracker.second.received);
+        }
+    }
+
+    return stats;
+}
+
+void SimulatedClient::handlePacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    ServerNode* sourceNode = nodeForSender(*nlPacket);
+    trackReceived(*nlPacket, sourceNode ? sourceNode->type : NodeType::DomainServer);
+
+    switch (nlPacket->getType()) {
+        case PacketType::DomainList:
+            processDomainList(*nlPacket);
+            break;
+        case PacketType::DomainServerAddedNode: {
+            QByteArray payload = QByteArray::fromRawData(nlPacket->getPayload(), nlPacket->getPayloadSize());
+            QDataStream packetStream(payload);
+            parseNode(packetStream);
+            break;
+        }
+        case PacketType::DomainServerRemovedNode: {
+            QUuid nodeUUID = QUuid::fromRfc4122(nlPacket->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+            _nodes.erase(nodeUUID);
+            break;
+        }
+        case PacketType::DomainConnectionDenied:
+            ++_stats.connectionDenials;
+            break;
+        case PacketType::Ping:
+            if (sourceNode) {
+                processPing(*nlPacket, sourceNode);
+            }
+            break;
+        case PacketType::PingReply:
+            if (sourceNode) {
+                processPingReply(*nlPacket, sourceNode);
+            }
+            break;
+        case PacketType::SelectedAudioFormat:
+            _selectedCodecName = nlPacket->readString();
+            break;
+        default:
+            // mixed audio, bulk avatar data, entity data and the rest are only counted
+            break;
+    }
+}
+
+void SimulatedClient::processDomainList(NLPacket& packet) {
+    QByteArray payload = QByteArray::fromRawData(packet.getPayload(), packet.getPayloadSize());
+    QDataStream packetStream(payload);
+
+    QUuid domainUUID;
+    QUuid sessionUUID;
+    packetStream >> domainUUID >> sessionUUID;
+
+    if (!_domainUUID.isNull() && domainUUID != _domainUUID) {
+        return;
+    }
+    _domainUUID = domainUUID;
+
+    if (sessionUUID != _sessionUUID) {
+        // a new session (the domain-server restarted, or timed us out), so the mixers will have forgotten us too
+        _sessionUUID = sessionUUID;
+        _nodes.clear();
+    }
+
+    NodePermissions permissions;
+    bool isDelta;
+    packetStream >> permissions >> _domainListVersion >> isDelta;
+
+    while (!packetStream.atEnd()) {
+        parseNode(packetStream);
+    }
+}
+
+void SimulatedClient::parseNode(QDataStream& packetStream) {
+    qint8 nodeType;
+    QUuid nodeUUID;
+    QUuid connectionSecret;
+    quint8 verificationVersion;
+    HifiSockAddr publicSocket;
+    HifiSockAddr localSocket;
+    NodePermissions permissions;
+    bool isReplicated;
+
+    packetStream >> nodeType >> nodeUUID >> publicSocket >> localSocket >> permissions >> isReplicated >> connectionSecret
+        >> verificationVersion;
+
+    // if the public socket address is 0 then it's reachable at the same IP as the domain server
+    if (publicSocket.getAddress().isNull()) {
+        publicSocket.setAddress(_settings.domainSockAddr.getAddress());
+    }
+
+    ServerNode& node = _nodes[nodeUUID];
+    node.type = nodeType;
+
+    if (node.publicSocket != publicSocket || node.localSocket != localSocket) {
+        node.publicSocket = publicSocket;
+        node.localSocket = localSocket;
+        node.activeSocket = HifiSockAddr();
+    }
+
+    auto version = static_cast<PacketVerificationVersion>(
+        std::min(verificationVersion, static_cast<quint8>(PacketVerificationVersion::Newest)));
+    if (node.connectionSecret != connectionSecret || node.verificationKey.getVersion() != version) {
+        node.connectionSecret = connectionSecret;
+        node.verificationKey = NLPacket::verificationKeyForSecret(connectionSecret, version);
+    }
+}
+
+void SimulatedClient::processPing(NLPacket& packet, ServerNode* sourceNode) {
+    PingType_t typeFromOriginalPing;
+    quint64 timeFromOriginalPing;
+    packet.readPrimitive(&typeFromOriginalPing);
+    packet.readPrimitive(&timeFromOriginalPing);
+
+    int packetSize = sizeof(PingType_t) + sizeof(quint64) + sizeof(quint64);
+    auto replyPacket = NLPacket::create(PacketType::PingReply, packetSize);
+    replyPacket->writePrimitive(typeFromOriginalPing);
+    replyPacket->writePrimitive(timeFromOriginalPing);
+    replyPacket->writePrimitive(usecTimestampNow());
+
+    sendPacket(*replyPacket, packet.getSenderSockAddr(), sourceNode);
+}
+
+void SimulatedClient::processPingReply(NLPacket& packet, ServerNode* sourceNode) {
+    if (!sourceNode->activeSocket.isNull()) {
+        return;
+    }
+
+    // whichever of the node's sockets answered first is the one we use, as NodeList does
+    sourceNode->activeSocket = packet.getSenderSockAddr();
+
+    if (sourceNode->type == NodeType::AudioMixer && !_settings.codecName.isEmpty()) {
+        negotiateAudioFormat(*sourceNode);
+    }
+}
+
+void SimulatedClient::trackReceived(const udt::Packet& packet, NodeType_t sourceType) {
+    TrafficStats& traffic = _stats.received[sourceType];
+    ++traffic.packetsReceived;
+    traffic.bytesReceived += packet.getDataSize();
+
+    if (packet.isReliable()) {
+        return;
+    }
+
+    // unreliable packets are numbered per destination, so the gaps from each sender are our losses
+    SequenceTracker& tracker = _sequenceTrackers[packet.getSenderSockAddr()];
+    tracker.sourceType = sourceType;
+
+    auto sequenceNumber = packet.getSequenceNumber();
+    if (!tracker.hasReceived) {
+        tracker.hasReceived = true;
+        tracker.first = sequenceNumber;
+        tracker.last = sequenceNumber;
+    } else if (sequenceNumber > tracker.last) {
+        tracker.last = sequenceNumber;
+    }
+    ++tracker.received;
+}
+
+void SimulatedClient::sendDomainCheckIn() {
+    bool isConnected = !_sessionUUID.isNull();
+
+    auto domainPacket = NLPacket::create(isConnected ? PacketType::DomainListRequest : PacketType::DomainConnectRequest);
+    QDataStream packetStream(domainPacket.get());
+
+    if (!isConnected) {
+        // no assignment or ICE client ID
+        packetStream << QUuid();
+
+        QByteArray protocolVersionSig = protocolVersionsSignature();
+        packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+        // no hardware address, and a fingerprint of our own so that the domain-server sees separate machines
+        packetStream << QString() << _machineFingerprint;
+    }
+
+    HifiSockAddr sockAddr(_settings.localAddress, _socket.localPort());
+    QList<NodeType_t> nodeTypesOfInterest;
+    nodeTypesOfInterest << NodeType::AudioMixer << NodeType::AvatarMixer << NodeType::EntityServer;
+
+    packetStream << NodeType::Agent << sockAddr << sockAddr << nodeTypesOfInterest;
+
+    // no place name
+    packetStream << QString();
+
+    if (!isConnected) {
+        // no username or signature, and the newest packet verification we support
+        packetStream << QString() << QByteArray() << static_cast<quint8>(PacketVerificationVersion::Newest);
+    } else {
+        packetStream << _domainListVersion;
+    }
+
+    sendPacket(*domainPacket, _settings.domainSockAddr, nullptr);
+}
+
+void SimulatedClient::pingInactiveNodes() {
+    for (auto& pair : _nodes) {
+        ServerNode& node = pair.second;
+        if (!node.activeSocket.isNull()) {
+            continue;
+        }
+
+        for (PingType_t pingType : { PingType::Local, PingType::Public }) {
+            auto pingPacket = NLPacket::create(PacketType::Ping, sizeof(PingType_t) + sizeof(quint64));
+            pingPacket->writePrimitive(pingType);
+            pingPacket->writePrimitive(usecTimestampNow());
+
+            sendPacket(*pingPacket, pingType == PingType::Local ? node.localSocket : node.publicSocket, &node);
+        }
+    }
+}
+
+void SimulatedClient::negotiateAudioFormat(ServerNode& audioMixer) {
+    auto negotiateFormatPacket = NLPacket::create(PacketType::NegotiateAudioFormat);
+    negotiateFormatPacket->writePrimitive((quint8)1);
+    negotiateFormatPacket->writeString(_settings.codecName);
+
+    sendPacket(*negotiateFormatPacket, audioMixer.activeSocket, &audioMixer);
+}
+
+void SimulatedClient::updateMotion(quint64 now) {
+    double seconds = (double)now / USECS_PER_SECOND;
+
+    if (_settings.motion && !_settings.motion->frames.empty()) {
+        // replay the recording from this client's offset, moved to its own spot
+        const auto& frames = _settings.motion->frames;
+        quint32 frameTime = (quint32)((now / USECS_PER_MSEC + _motionOffset) % std::max(_settings.motion->duration, 1u));
+        auto frame = std::upper_bound(frames.begin(), frames.end(), frameTime,
+            [](quint32 time, const RecordedMotion::Frame& frame) {
+                return time < frame.timeOffset;
+            });
+        if (frame != frames.begin()) {
+            --frame;
+        }
+
+        AvatarData::fromFrame(frame->data, *_avatar, false);
+        _avatar->setWorldPosition(_avatar->getWorldPosition() + _walkCenter);
+        return;
+    }
+
+    // walk around a circle, facing the way we walk
+    float angle = _walkPhase + (float)fmod(seconds * WALK_SPEED / _walkRadius, TWO_PI);
+    glm::vec3 position = _walkCenter + glm::vec3(cosf(angle) * _walkRadius, 0.0f, sinf(angle) * _walkRadius);
+    glm::vec3 direction(-sinf(angle), 0.0f, cosf(angle));
+
+    _avatar->setWorldPosition(position);
+    _avatar->setWorldOrientation(glm::quat(glm::vec3(0.0f, atan2f(-direction.x, -direction.z), 0.0f)));
+
+    float sway = JOINT_SWAY_ANGLE * sinf((float)fmod(TWO_PI * JOINT_SWAY_FREQUENCY * seconds, TWO_PI) + _walkPhase);
+    for (int i = 0; i < PROCEDURAL_JOINT_COUNT; i++) {
+        _avatar->setJointRotation(i, glm::angleAxis(sway * ((i % 2) ? 1.0f : -1.0f), Vectors::UNIT_X));
+    }
+}
+
+void SimulatedClient::sendAudio(const VoiceFrame& voiceFrame) {
+    ServerNode* audioMixer = nodeOfType(NodeType::AudioMixer);
+    if (!audioMixer) {
+        return;
+    }
+
+    auto audioPacket = NLPacket::create(_isSpeaking ? PacketType::MicrophoneAudioNoEcho : PacketType::SilentAudioFrame);
+    audioPacket->writePrimitive(audioMixer->audioSequenceNumber++);
+    audioPacket->writeString(_selectedCodecName);
+
+    if (_isSpeaking) {
+        // mono
+        audioPacket->writePrimitive((quint8)0);
+    } else {
+        // the number of silent samples, so the audio-mixer can uphold timing
+        audioPacket->writePrimitive((int16_t)AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+
+    audioPacket->writePrimitive(_avatar->getWorldPosition());
+    audioPacket->writePrimitive(_avatar->getHeadOrientation());
+    audioPacket->writePrimitive(_avatar->getWorldPosition());
+    audioPacket->writePrimitive(glm::vec3(0));
+
+    if (_isSpeaking) {
+        bool isEncoded = !voiceFrame.codecName.isEmpty() && _selectedCodecName == voiceFrame.codecName;
+        const QByteArray& payload = isEncoded ? voiceFrame.encoded : voiceFrame.pcm;
+        audioPacket->write(payload.constData(), payload.size());
+    }
+
+    sendPacket(*audioPacket, audioMixer->activeSocket, audioMixer);
+}
+
+void SimulatedClient::sendAvatarData() {
+    ServerNode* avatarMixer = nodeOfType(NodeType::AvatarMixer);
+    if (!avatarMixer) {
+        return;
+    }
+
+    // like interface, send a full update now and then to cover for lost packets
+    bool sendAll = randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO;
+    QByteArray avatarByteArray = _avatar->toByteArrayStateful(sendAll ? AvatarData::SendAllData : AvatarData::CullSmallData);
+
+    int maximumByteArraySize = NLPacket::maxPayloadSize(PacketType::AvatarData) - sizeof(AvatarDataSequenceNumber);
+    if (avatarByteArray.size() > maximumByteArraySize) {
+        avatarByteArray = _avatar->toByteArrayStateful(AvatarData::MinimumData, true);
+    }
+
+    _avatar->doneEncoding(!sendAll);
+
+    auto avatarPacket = NLPacket::create(PacketType::AvatarData, avatarByteArray.size() + sizeof(_avatarSequenceNumber));
+    avatarPacket->writePrimitive(_avatarSequenceNumber++);
+    avatarPacket->write(avatarByteArray);
+
+    sendPacket(*avatarPacket, avatarMixer->activeSocket, avatarMixer);
+}
+
+void SimulatedClient::sendViewQueries() {
+    glm::vec3 eyePosition = _avatar->getWorldPosition() + glm::vec3(0.0f, EYE_HEIGHT, 0.0f);
+    _viewFrustum.setPosition(eyePosition);
+    _viewFrustum.setOrientation(_avatar->getWorldOrientation());
+    _viewFrustum.calculate();
+
+    ServerNode* avatarMixer = nodeOfType(NodeType::AvatarMixer);
+    if (avatarMixer) {
+        QByteArray viewFrustumByteArray = _viewFrustum.toByteArray();
+        auto viewFrustumPacket = NLPacket::create(PacketType::ViewFrustum, viewFrustumByteArray.size());
+        viewFrustumPacket->write(viewFrustumByteArray);
+
+        sendPacket(*viewFrustumPacket, avatarMixer->activeSocket, avatarMixer);
+    }
+
+    ServerNode* entityServer = nodeOfType(NodeType::EntityServer);
+    if (entityServer) {
+        _octreeQuery.setCameraPosition(_viewFrustum.getPosition());
+        _octreeQuery.setCameraOrientation(_viewFrustum.getOrientation());
+        _octreeQuery.setCameraFov(_viewFrustum.getFieldOfView());
+        _octreeQuery.setCameraAspectRatio(_viewFrustum.getAspectRatio());
+        _octreeQuery.setCameraNearClip(_viewFrustum.getNearClip());
+        _octreeQuery.setCameraFarClip(_viewFrustum.getFarClip());
+        _octreeQuery.setCameraEyeOffsetPosition(glm::vec3());
+        _octreeQuery.setCameraCenterRadius(_viewFrustum.getCenterRadius());
+
+        auto queryPacket = NLPacket::create(PacketType::EntityQuery);
+        auto packetData = reinterpret_cast<unsigned char*>(queryPacket->getPayload());
+        int packetSize = _octreeQuery.getBroadcastData(packetData);
+        queryPacket->setPayloadSize(packetSize);
+
+        sendPacket(*queryPacket, entityServer->activeSocket, entityServer);
+    }
+}
+
+void SimulatedClient::sendPacket(const NLPacket& packet, const HifiSockAddr& sockAddr, const ServerNode* node) {
+    // fill in the header the way LimitedNodeList::fillPacketHeader does
+    if (!PacketTypeEnum::getNonSourcedPackets().contains(packet.getType())) {
+        packet.writeSourceID(_sessionUUID);
+
+        if (node && !PacketTypeEnum::getNonVerifiedPackets().contains(packet.getType())) {
+            packet.writeVerificationHash(node->verificationKey);
+        }
+    }
+
+    _socket.writePacket(packet, sockAddr);
+
+    ++_stats.packetsSent;
+    _stats.bytesSent += packet.getDataSize();
+}
+
+SimulatedClient::ServerNode* SimulatedClient::nodeOfType(NodeType_t type, bool mustBeActive) {
+    for (auto& pair : _nodes) {
+        if (pair.second.type == type && (!mustBeActive || !pair.second.activeSocket.isNull())) {
+            return &pair.second;
+        }
+    }
+    return nullptr;
+}
+
+SimulatedClient::ServerNode* SimulatedClient::nodeForSender(const NLPacket& packet) {
+    if (PacketTypeEnum::getNonSourcedPackets().contains(packet.getType())) {
+        return nullptr;
+    }
+
+    auto it = _nodes.find(packet.getSourceID());
+    return it != _nodes.end() ? &it->second : nullptr;
+}
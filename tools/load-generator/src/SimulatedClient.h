@@ -0,0 +1,174 @@
+//
+//  SimulatedClient.h
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SimulatedClient_h
+#define hifi_SimulatedClient_h
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QUuid>
+
+#include <glm/glm.hpp>
+
+#include <AvatarData.h>
+#include <NLPacket.h>
+#include <NodeType.h>
+#include <OctreeQuery.h>
+#include <UUIDHasher.h>
+#include <ViewFrustum.h>
+#include <udt/Socket.h>
+
+// the avatar frames of a recording, decoded once and replayed by every client from its own offset
+struct RecordedMotion {
+    struct Frame {
+        quint32 timeOffset; // milliseconds
+        QByteArray data;
+    };
+
+    std::vector<Frame> frames;
+    quint32 duration { 0 };
+};
+
+struct SimulationSettings {
+    HifiSockAddr domainSockAddr;
+    QHostAddress localAddress;
+
+    float speakingRatio { 0.25f }; // share of clients that talk, the others send silent frames
+    float spreadRadius { 20.0f }; // clients walk around centers picked within this distance of the origin
+    float viewQueryInterval { 1.0f }; // seconds between the entity queries and view frustums a client sends
+    QString codecName; // the codec to negotiate with the audio-mixer, PCM if empty
+    quint32 randomSeed { 0 };
+    std::shared_ptr<const RecordedMotion> motion; // procedural motion if not set
+};
+
+// one network frame of voice, encoded once per group and sent by each of its speaking clients
+struct VoiceFrame {
+    QString codecName;
+    QByteArray encoded;
+    QByteArray pcm; // for clients whose audio-mixer didn't select our codec
+};
+
+struct TrafficStats {
+    quint64 packetsReceived { 0 };
+    quint64 bytesReceived { 0 };
+
+    // from the sequence numbers of the unreliable packets, which carry nearly all of the mixer traffic
+    quint64 unreliableExpected { 0 };
+    quint64 unreliableLost { 0 };
+};
+
+struct ClientStats {
+    int index { 0 };
+    QUuid sessionUUID;
+    bool isActive { false };
+
+    quint64 connectUsecs { 0 }; // from the first connect request to hearing from all the mixers
+    quint64 activeUsecs { 0 };
+    int connectionDenials { 0 };
+
+    quint64 packetsSent { 0 };
+    quint64 bytesSent { 0 };
+
+    std::map<NodeType_t, TrafficStats> received; // keyed by the type of the sending node, NodeType::DomainServer for others
+};
+
+// A lightweight agent: a socket and just enough of the node protocol to connect to a domain, get its audio-mixer,
+//   avatar-mixer and entity-server to accept it, then send them avatar data, voice and entity queries at client rates.
+//   NodeList is a per-process singleton, so each client keeps its own small node table instead.
+class SimulatedClient : public QObject {
+    Q_OBJECT
+public:
+    SimulatedClient(int index, const SimulationSettings& settings, QObject* parent = nullptr);
+
+    // called every network audio frame by the client's group
+    void simulate(quint64 now, const VoiceFrame& voiceFrame);
+
+    void disconnectFromDomain();
+
+    bool isActive() const;
+    ClientStats getStats(quint64 now) const;
+
+private:
+    struct ServerNode {
+        NodeType_t type;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr activeSocket;
+        QUuid connectionSecret;
+        NLPacket::VerificationKey verificationKey;
+        quint16 audioSequenceNumber { 0 };
+    };
+
+    struct SequenceTracker {
+        NodeType_t sourceType;
+        bool hasReceived { false };
+        udt::SequenceNumber first;
+        udt::SequenceNumber last;
+        quint64 received { 0 };
+    };
+
+    void handlePacket(std::unique_ptr<udt::Packet> packet);
+    void processDomainList(NLPacket& packet);
+    void parseNode(QDataStream& packetStream);
+    void processPing(NLPacket& packet, ServerNode* sourceNode);
+    void processPingReply(NLPacket& packet, ServerNode* sourceNode);
+    void trackReceived(const udt::Packet& packet, NodeType_t sourceType);
+
+    void sendDomainCheckIn();
+    void pingInactiveNodes();
+    void negotiateAudioFormat(ServerNode& audioMixer);
+
+    void updateMotion(quint64 now);
+    void sendAudio(const VoiceFrame& voiceFrame);
+    void sendAvatarData();
+    void sendViewQueries();
+
+    void sendPacket(const NLPacket& packet, const HifiSockAddr& sockAddr, const ServerNode* node);
+    ServerNode* nodeOfType(NodeType_t type, bool mustBeActive = true);
+    ServerNode* nodeForSender(const NLPacket& packet);
+
+    int _index;
+    const SimulationSettings& _settings;
+    udt::Socket _socket;
+
+    QUuid _machineFingerprint;
+    QUuid _sessionUUID;
+    QUuid _domainUUID;
+    quint64 _domainListVersion { 0 };
+    std::unordered_map<QUuid, ServerNode, UUIDHasher> _nodes;
+    std::unordered_map<HifiSockAddr, SequenceTracker> _sequenceTrackers;
+
+    quint64 _firstConnectRequest { 0 };
+    quint64 _connectedAt { 0 }; // when all the mixers were first active
+    quint64 _nextCheckIn { 0 };
+    quint64 _nextAvatarSend { 0 };
+    quint64 _nextViewQuery { 0 };
+
+    QString _selectedCodecName;
+    bool _isSpeaking;
+
+    std::unique_ptr<AvatarData> _avatar;
+    AvatarDataSequenceNumber _avatarSequenceNumber { 0 };
+    glm::vec3 _walkCenter;
+    float _walkRadius;
+    float _walkPhase;
+    quint32 _motionOffset;
+
+    ViewFrustum _viewFrustum;
+    OctreeQuery _octreeQuery;
+
+    ClientStats _stats;
+};
+
+#endif // hifi_SimulatedClient_h
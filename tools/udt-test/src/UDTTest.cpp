@@ -11,13 +11,17 @@
 
 #include "UDTTest.h"
 
+#include <limits>
+
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 
 #include <udt/Constants.h>
 #include <udt/Packet.h>
 #include <udt/PacketList.h>
 
 #include <LogHandler.h>
+#include <NumericalConstants.h>
 
 const QCommandLineOption PORT_OPTION { "p", "listening port for socket (defaults to random)", "port", 0 };
 const QCommandLineOption TARGET_OPTION {
@@ -56,6 +60,19 @@ const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
 
+const QCommandLineOption PPS_BENCHMARK {
+    "pps-benchmark", "run a local packets per second benchmark of batched (recvmmsg/sendmmsg) vs Qt datagram IO, "
+    "for the given number of seconds per mode", "seconds"
+};
+
+const QCommandLineOption FAIRNESS_BENCHMARK {
+    "fairness-benchmark", "run a local benchmark of aggregate throughput and per-connection fairness of reliable sends, "
+    "for the given number of seconds", "seconds"
+};
+const QCommandLineOption CONNECTIONS {
+    "connections", "number of connections for the fairness benchmark (default is 8)", "connections"
+};
+
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
     "Recv ACK", "Procd ACK", "Recv LACK", "Recv NAK", "Recv TNAK",
@@ -68,10 +85,30 @@ const QStringList SERVER_STATS_TABLE_HEADERS {
     "Recv ACK2", "Duplicates (P)"
 };
 
+const QStringList BENCHMARK_TABLE_HEADERS {
+    " Mode  ", "Sent (P/s)", "Recv (P/s)", "Lost (%)"
+};
+
 UDTTest::UDTTest(int& argc, char** argv) :
     QCoreApplication(argc, argv)
 {
     parseArguments();
+
+    if (_argumentParser.isSet(PPS_BENCHMARK)) {
+        // the benchmark uses its own pair of sockets, none of the other test options apply
+        _benchmarkSeconds = _argumentParser.value(PPS_BENCHMARK).toInt();
+        QMetaObject::invokeMethod(this, "runPacketsPerSecondBenchmark", Qt::QueuedConnection);
+        return;
+    }
+
+    if (_argumentParser.isSet(FAIRNESS_BENCHMARK)) {
+        _fairnessSeconds = _argumentParser.value(FAIRNESS_BENCHMARK).toInt();
+        if (_argumentParser.isSet(CONNECTIONS)) {
+            _numFairnessConnections = _argumentParser.value(CONNECTIONS).toInt();
+        }
+        QMetaObject::invokeMethod(this, "runFairnessBenchmark", Qt::QueuedConnection);
+        return;
+    }
     
     // randomize the seed for packet size randomization
     srand(time(NULL));
@@ -226,7 +263,8 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, PPS_BENCHMARK,
+        FAIRNESS_BENCHMARK, CONNECTIONS
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -333,6 +371,174 @@ void UDTTest::sendPacket() {
     
 }
 
+void UDTTest::runPacketsPerSecondBenchmark() {
+    if (_benchmarkSeconds <= 0) {
+        qCritical() << "The packets per second benchmark needs a duration of at least one second.";
+        quit();
+        return;
+    }
+
+    qDebug() << "Benchmarking" << _maxPacketSize << "byte packets for" << _benchmarkSeconds << "seconds per mode";
+    qDebug() << qPrintable(BENCHMARK_TABLE_HEADERS.join(" | "));
+
+    for (bool batched : { false, true }) {
+        if (batched && !_socket.isBatchedDatagramsEnabled()) {
+            qDebug() << "Batched datagram IO is not available on this platform.";
+            break;
+        }
+
+        BenchmarkResult result = benchmarkPacketsPerSecond(batched);
+
+        int headerIndex = -1;
+        QStringList values {
+            QString(batched ? "batched" : "qt").rightJustified(BENCHMARK_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(result.sentPacketsPerSecond, 'f', 0).rightJustified(BENCHMARK_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(result.receivedPacketsPerSecond, 'f', 0).rightJustified(BENCHMARK_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(result.lostPercentage, 'f', 2).rightJustified(BENCHMARK_TABLE_HEADERS[++headerIndex].size())
+        };
+        qDebug() << qPrintable(values.join(" | "));
+    }
+
+    quit();
+}
+
+UDTTest::BenchmarkResult UDTTest::benchmarkPacketsPerSecond(bool batched) {
+    // packets are written in bursts, as the mixers do when they send a frame
+    static const int PACKETS_PER_BURST = 32;
+    static const int DRAIN_MSECS = 100;
+
+    udt::Socket sender;
+    udt::Socket receiver;
+    sender.setBatchedDatagramsEnabled(batched);
+    receiver.setBatchedDatagramsEnabled(batched);
+
+    sender.bind(QHostAddress::LocalHost);
+    receiver.bind(QHostAddress::LocalHost);
+    HifiSockAddr target { QHostAddress::LocalHost, receiver.localPort() };
+
+    int packetsReceived = 0;
+    receiver.setPacketHandler([&](std::unique_ptr<udt::Packet>) {
+        ++packetsReceived;
+    });
+
+    int payloadSize = std::min(_maxPacketSize - udt::Packet::localHeaderSize(false), udt::Packet::maxPayloadSize(false));
+    QByteArray payload { std::max(payloadSize, 1), 0 };
+
+    int packetsSent = 0;
+    QElapsedTimer timer;
+    timer.start();
+
+    const qint64 benchmarkMsecs = _benchmarkSeconds * MSECS_PER_SECOND;
+    while (timer.elapsed() < benchmarkMsecs) {
+        auto packetList = udt::PacketList::create(PacketType::BulkAvatarData);
+        for (int i = 0; i < PACKETS_PER_BURST; ++i) {
+            packetList->write(payload);
+            packetList->closeCurrentPacket();
+        }
+
+        packetsSent += (int)packetList->getNumPackets();
+        sender.writePacketList(std::move(packetList), target);
+
+        // let the receiver read what has arrived so far
+        processEvents();
+    }
+
+    double elapsedSeconds = (double)timer.elapsed() / MSECS_PER_SECOND;
+
+    // give the receiver a chance to read the packets still in flight
+    QElapsedTimer drainTimer;
+    drainTimer.start();
+    while (drainTimer.elapsed() < DRAIN_MSECS) {
+        processEvents();
+    }
+
+    BenchmarkResult result;
+    result.sentPacketsPerSecond = packetsSent / elapsedSeconds;
+    result.receivedPacketsPerSecond = packetsReceived / elapsedSeconds;
+    result.lostPercentage = packetsSent > 0 ? 100.0 * (packetsSent - packetsReceived) / packetsSent : 0.0;
+    return result;
+}
+
+void UDTTest::runFairnessBenchmark() {
+    static const int NUM_INITIAL_PACKETS = 100; // per connection, topped up every time one goes out
+
+    if (_fairnessSeconds <= 0 || _numFairnessConnections <= 0) {
+        qCritical() << "The fairness benchmark needs a duration of at least one second and at least one connection.";
+        quit();
+        return;
+    }
+
+    qDebug() << "Benchmarking" << _numFairnessConnections << "reliable connections for" << _fairnessSeconds << "seconds";
+
+    _fairnessSender.reset(new udt::Socket);
+    _fairnessSender->bind(QHostAddress::LocalHost);
+
+    _fairnessReceivedBytes.assign(_numFairnessConnections, 0);
+
+    for (int i = 0; i < _numFairnessConnections; ++i) {
+        _fairnessReceivers.emplace_back(new udt::Socket);
+        auto& receiver = _fairnessReceivers.back();
+        receiver->bind(QHostAddress::LocalHost);
+        receiver->setPacketHandler([this, i](std::unique_ptr<udt::Packet> packet) {
+            _fairnessReceivedBytes[i] += packet->getPayloadSize();
+        });
+
+        HifiSockAddr target { QHostAddress::LocalHost, receiver->localPort() };
+        for (int j = 0; j < NUM_INITIAL_PACKETS; ++j) {
+            auto packet = udt::Packet::create(udt::Packet::maxPayloadSize(false), true);
+            packet->setPayloadSize(udt::Packet::maxPayloadSize(false));
+            _fairnessSender->writePacket(std::move(packet), target);
+        }
+
+        // the connection exists now that we've queued packets on it, refill it as they go out
+        _fairnessSender->connectToSendSignal(target, this, SLOT(refillFairnessPacket()));
+    }
+
+    QTimer::singleShot((int)(_fairnessSeconds * MSECS_PER_SECOND), this, &UDTTest::finishFairnessBenchmark);
+}
+
+void UDTTest::refillFairnessPacket() {
+    auto connection = qobject_cast<udt::Connection*>(sender());
+    if (connection && _fairnessSender) {
+        auto packet = udt::Packet::create(udt::Packet::maxPayloadSize(false), true);
+        packet->setPayloadSize(udt::Packet::maxPayloadSize(false));
+        _fairnessSender->writePacket(std::move(packet), connection->getDestination());
+    }
+}
+
+void UDTTest::finishFairnessBenchmark() {
+    static const double MEGABITS_PER_BYTE = 8.0 / 1000000.0;
+
+    // stop sending before looking at the results
+    _fairnessSender.reset();
+
+    double totalMegabits = 0.0;
+    double sumOfSquares = 0.0;
+    double minMegabitsPerSecond = std::numeric_limits<double>::max();
+    double maxMegabitsPerSecond = 0.0;
+
+    for (int i = 0; i < _numFairnessConnections; ++i) {
+        double megabitsPerSecond = _fairnessReceivedBytes[i] * MEGABITS_PER_BYTE / _fairnessSeconds;
+        qDebug() << "Connection" << i << "-" << qPrintable(QString::number(megabitsPerSecond, 'f', 2)) << "Mb/s";
+
+        totalMegabits += megabitsPerSecond;
+        sumOfSquares += megabitsPerSecond * megabitsPerSecond;
+        minMegabitsPerSecond = std::min(minMegabitsPerSecond, megabitsPerSecond);
+        maxMegabitsPerSecond = std::max(maxMegabitsPerSecond, megabitsPerSecond);
+    }
+
+    // Jain's fairness index - 1 when every connection got the same throughput, 1/n when one got all of it
+    double fairness = sumOfSquares > 0.0 ? (totalMegabits * totalMegabits) / (_numFairnessConnections * sumOfSquares) : 0.0;
+
+    qDebug() << "Aggregate throughput:" << qPrintable(QString::number(totalMegabits, 'f', 2)) << "Mb/s";
+    qDebug() << "Per-connection min/max:" << qPrintable(QString::number(minMegabitsPerSecond, 'f', 2)) << "/"
+        << qPrintable(QString::number(maxMegabitsPerSecond, 'f', 2)) << "Mb/s";
+    qDebug() << "Fairness index:" << qPrintable(QString::number(fairness, 'f', 3));
+
+    _fairnessReceivers.clear();
+    quit();
+}
+
 void UDTTest::handleMessage(std::unique_ptr<Message> message) {
     // generate the byte array that should match this message - using the same seed the sender did
     
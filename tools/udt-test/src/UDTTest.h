@@ -38,13 +38,27 @@ public:
 public slots:
     void refillPacket() { sendPacket(); } // adds a new packet to the queue when we are told one is sent
     void sampleStats();
+    void runPacketsPerSecondBenchmark();
+    void runFairnessBenchmark();
+    void refillFairnessPacket(); // tops up the connection that just sent a packet during the fairness benchmark
+    void finishFairnessBenchmark();
     
 private:
+    struct BenchmarkResult {
+        double sentPacketsPerSecond;
+        double receivedPacketsPerSecond;
+        double lostPercentage;
+    };
+
+
     void parseArguments();
     void handleMessage(std::unique_ptr<Message> message);
     
     void sendInitialPackets(); // fills the queue with packets to start
     void sendPacket(); // constructs and sends a packet according to the test parameters
+
+    // sends unreliable packets over loopback between two local sockets, with or without batched datagram IO
+    BenchmarkResult benchmarkPacketsPerSecond(bool batched);
     
     QCommandLineParser _argumentParser;
     udt::Socket _socket;
@@ -71,6 +85,15 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+
+    int _benchmarkSeconds { 0 }; // duration of each mode of the packets per second benchmark
+
+    // the fairness benchmark sends reliable packets from one socket to a number of local receiving sockets
+    int _fairnessSeconds { 0 };
+    int _numFairnessConnections { 8 };
+    std::unique_ptr<udt::Socket> _fairnessSender;
+    std::vector<std::unique_ptr<udt::Socket>> _fairnessReceivers;
+    std::vector<qint64> _fairnessReceivedBytes; // payload bytes received by each receiving socket
 };
 
 #endif // hifi_UDTTest_h